@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * Normalized account number packed into fixed-width integers.
+ *
+ * Built once when an account number is parsed or loaded, the key applies
+ * the same normalization as BankAccount::normalizeAccountNumber (spaces,
+ * tabs and hyphens dropped, letters upper-cased) and stores each remaining
+ * character in 6 bits, ten per word. Comparing or hashing two keys is then
+ * a handful of integer operations instead of re-normalizing both strings.
+ */
+class AccountKey
+{
+public:
+    // Longest normalized account number that still fits in the key
+    static constexpr std::size_t kMaxLength = 30;
+
+    // Pack `raw`; std::nullopt when the normalized number is longer than
+    // kMaxLength or has a character outside [0-9A-Z/._]. Callers fall back
+    // to comparing normalized strings in that case.
+    static std::optional<AccountKey> fromAccountNumber(std::string_view raw);
+
+    // Normalized account number rebuilt from the packed form
+    std::string toString() const;
+
+    std::size_t length() const;
+
+    // Precomputed when the key is built
+    uint64_t hash() const { return hash_value; }
+
+    bool operator==(const AccountKey& other) const
+    {
+        return hash_value == other.hash_value && words == other.words;
+    }
+
+    bool operator!=(const AccountKey& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    static constexpr std::size_t kCharsPerWord = 10;
+    static constexpr std::size_t kWordCount = kMaxLength / kCharsPerWord;
+
+    AccountKey() = default;
+
+    uint64_t hash_value{0};
+    std::array<uint64_t, kWordCount> words{};
+};
+
+template <>
+struct std::hash<AccountKey>
+{
+    std::size_t operator()(const AccountKey& key) const noexcept
+    {
+        return static_cast<std::size_t>(key.hash());
+    }
+};
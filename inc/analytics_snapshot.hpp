@@ -0,0 +1,54 @@
+#pragma once
+
+#include "commons.hpp"
+#include "storage_interface.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Every family, member and bank account laid out as columns, loaded once so
+// dashboards can run many aggregations without touching the database or
+// building BankAccount objects.
+//
+// Families are in ascending Family_ID, members grouped by family in
+// ascending Member_ID and accounts grouped by member in ascending
+// BankAccount_ID. Offsets follow the NetWorthSnapshot convention: the
+// members of family `index` are [family_member_offsets[index],
+// family_member_offsets[index + 1]), and likewise for accounts.
+struct AnalyticsSnapshot
+{
+    std::vector<uint64_t> family_ids;
+    std::vector<std::size_t> family_member_offsets;
+    std::vector<std::size_t> family_account_offsets;
+
+    std::vector<uint64_t> member_ids;
+    std::vector<uint32_t> member_family_index;
+    std::vector<std::size_t> member_account_offsets;
+
+    std::vector<uint64_t> account_ids;
+    std::vector<uint32_t> account_bank_index;
+    std::vector<long long> closing_balances_paise;
+
+    // Distinct Bank_IDs referenced by accounts, ascending;
+    // account_bank_index points into this column
+    std::vector<uint64_t> bank_ids;
+
+    std::size_t familyCount() const { return family_ids.size(); }
+    std::size_t memberCount() const { return member_ids.size(); }
+    std::size_t accountCount() const { return account_ids.size(); }
+
+    void clear();
+
+    // Replace the contents with everything in `storage`, read in one pass
+    // of StorageInterface::visitAccountBalances.
+    commons::Result load(StorageInterface* storage);
+
+    // Closing-balance totals aligned with family_ids, member_ids and
+    // bank_ids. Sums are exact; Overflow is returned (with the offending
+    // totals saturated) when a group does not fit in a long long.
+    commons::Result totalsByFamily(std::vector<long long>* out_totals_paise) const;
+    commons::Result totalsByMember(std::vector<long long>* out_totals_paise) const;
+    commons::Result totalsByBank(std::vector<long long>* out_totals_paise) const;
+
+    commons::Result householdTotal(long long* out_total_paise) const;
+};
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "account_key.hpp"
 #include <string>
 #include <cstdint>
+#include <optional>
 #include <sqlite3.h>
 
 class BankAccount
@@ -12,7 +14,7 @@ public:
     BankAccount(uint64_t bankAccountId,
                 uint64_t bankId,
                 uint64_t memberId,
-                const std::string &accountNumber,
+                std::string accountNumber,
                 long long openingBalancePaise,
                 long long closingBalancePaise);
 
@@ -27,7 +29,11 @@ public:
     void setMemberId(uint64_t id);
 
     const std::string &getAccountNumber() const;
-    void setAccountNumber(const std::string &s);
+    void setAccountNumber(std::string s);
+
+    // Packed normalized form of the account number, refreshed whenever the
+    // number changes; std::nullopt if the number does not fit an AccountKey.
+    const std::optional<AccountKey> &getAccountKey() const;
 
     long long getOpeningBalancePaise() const;
     void setOpeningBalancePaise(long long v);
@@ -55,6 +61,9 @@ public:
     bool operator==(const BankAccount& other) const;
     bool operator!=(const BankAccount& other) const;
 
+    // True when both account numbers normalize to the same value
+    bool hasSameAccountNumber(const BankAccount& other) const;
+
     // Normalize an account number for comparison/storage (remove spaces, hyphens,
     // convert to uppercase). This is stable and deterministic.
     static std::string normalizeAccountNumber(const std::string &raw);
@@ -64,6 +73,7 @@ private:
     uint64_t bank_id{0};
     uint64_t member_id{0};
     std::string account_number;
+    std::optional<AccountKey> account_key;
     long long opening_balance_paise{0};
     long long closing_balance_paise{0};
 };
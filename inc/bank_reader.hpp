@@ -1,8 +1,10 @@
 #pragma once
 
 #include "reader.hpp"
+#include "bank_transaction.hpp"
 #include <optional>
 #include <string>
+#include <vector>
 
 // Base class for bank-specific readers. Derive individual bank readers
 // (e.g. `NatWestReader`, `BarclaysReader`) from this class.
@@ -27,6 +29,15 @@ public:
         std::string accountNumber;
         long long openingBalancePaise{0};
         long long closingBalancePaise{0};
+        // Statement period, when the statement states one. Dated statements
+        // are also recorded in the account's balance history.
+        std::optional<commons::Date> periodStart;
+        std::optional<commons::Date> periodEnd;
+        // Statement lines in the order they appear
+        std::vector<BankTransaction> transactions;
+        // Balance stated after each line, aligned with transactions; empty
+        // unless every line states one
+        std::vector<long long> runningBalancesPaise;
     };
 
     // After parse() has been called, callers can use extractAccountInfo()
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "commons.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// One statement line. Credits are positive and debits negative, so a
+// statement's transactions sum to closing minus opening balance. The
+// counterparty is the payee/payer name when the narration carries one.
+struct BankTransaction
+{
+    commons::Date date;
+    std::string description;
+    long long amount_paise{0};
+    std::string counterparty;
+    // Running balance printed after this line, when the statement has one
+    std::optional<long long> balance_after_paise;
+    // Set by storage from the category rules (0: no rule matched)
+    uint64_t category_id{0};
+};
+
+// Duplicate-detection fingerprints, one per transaction, for lines of
+// `bank_account_id` in statement order. A fingerprint hashes (account,
+// date, amount, balance after, narration) plus the line's occurrence
+// number among identical lines of the span, so two genuine identical
+// payments on one day stay distinct while the same lines downloaded again
+// in an overlapping statement hash the same. The hash is fixed (it is
+// stored in the database), not std::hash.
+std::vector<uint64_t> transactionFingerprints(uint64_t bank_account_id, std::span<const BankTransaction> transactions);
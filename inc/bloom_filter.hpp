@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace commons
+{
+    /**
+     * Bloom filter over 64-bit keys that are already well-mixed hashes.
+     *
+     * mayContain() never returns false for an inserted key; for other keys
+     * it returns true with probability about 1% while no more than the
+     * reserved number of keys has been inserted (10 bits and 7 probes per
+     * key). Keys cannot be removed, so a caller backs the filter with an
+     * exact index and only consults that index when the filter says "maybe".
+     *
+     * Not synchronized.
+     */
+    class BloomFilter
+    {
+    public:
+        // Clear the filter and size it for `expected_keys`
+        void reset(std::size_t expected_keys);
+
+        void insert(uint64_t key);
+        bool mayContain(uint64_t key) const;
+
+        // Keys inserted since reset(), and how many fit at the target rate
+        std::size_t size() const { return key_count; }
+        std::size_t capacity() const { return key_capacity; }
+
+    private:
+        std::vector<uint64_t> words;
+        uint64_t bit_count{0};
+        std::size_t key_count{0};
+        std::size_t key_capacity{0};
+    };
+}
@@ -3,9 +3,14 @@
 #include "bank_reader.hpp"
 #include <optional>
 #include <string>
+#include <vector>
 
 // Concrete reader for Canara Bank CSV statements. It extracts
-// Account Number, Opening Balance and Closing Balance (in paise).
+// Account Number, Opening Balance and Closing Balance (in paise), plus the
+// statement period when present ("Statement Period" as "FROM to TO", or
+// separate "From Date" / "To Date" rows). Rows below the transaction
+// header ("Txn Date", "Description", "Debit", "Credit") become
+// BankTransactions; an optional "Balance" column gives running balances.
 class CanaraBankReader : public BankReader
 {
 public:
@@ -24,9 +29,16 @@ public:
     std::optional<std::string> accountNumber() const { return m_accountNumber; }
     std::optional<long long> openingBalancePaise() const { return m_openingPaise; }
     std::optional<long long> closingBalancePaise() const { return m_closingPaise; }
+    std::optional<commons::Date> periodStart() const { return m_periodStart; }
+    std::optional<commons::Date> periodEnd() const { return m_periodEnd; }
+    const std::vector<BankTransaction>& transactions() const { return m_transactions; }
 
 private:
     std::optional<std::string> m_accountNumber;
     std::optional<long long> m_openingPaise;
     std::optional<long long> m_closingPaise;
+    std::optional<commons::Date> m_periodStart;
+    std::optional<commons::Date> m_periodEnd;
+    std::vector<BankTransaction> m_transactions;
+    std::vector<long long> m_runningBalances;
 };
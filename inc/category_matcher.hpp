@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A named bucket for statement lines (salary, rent, EMI, groceries, ...)
+struct TransactionCategory
+{
+    uint64_t id{0};
+    std::string name;
+};
+
+// Keyword rule: a narration containing `keyword` as whole words belongs to
+// `category_id`. Keywords are split into words like commons::searchTokens,
+// so "house rent" also matches "HOUSE-RENT/APR". When several rules match,
+// the highest priority wins, then the longest keyword, then the oldest rule.
+struct CategoryRule
+{
+    uint64_t rule_id{0};
+    uint64_t category_id{0};
+    std::string keyword;
+    int priority{0};
+};
+
+/**
+ * Aho-Corasick automaton over the keywords of a rule set.
+ *
+ * compile() builds a dense transition table (bytes are first mapped to the
+ * few columns the keywords actually use), so categorize() reads each
+ * narration byte once with one table lookup, however many rules there are.
+ *
+ * Immutable after compile(); concurrent categorize() calls are safe.
+ */
+class CategoryMatcher
+{
+public:
+    // Replace the automaton with one for `rules`. Rules whose keyword has
+    // no words are ignored.
+    void compile(std::span<const CategoryRule> rules);
+
+    // Category of the winning rule for `narration`, or 0 if none matches
+    uint64_t categorize(std::string_view narration) const;
+
+    // Rules that made it into the automaton
+    std::size_t ruleCount() const { return rules.size(); }
+
+private:
+    static constexpr uint32_t kNoRule = UINT32_MAX;
+
+    std::array<uint8_t, 256> byte_column{};
+    std::size_t column_count{1};
+
+    // Row-major [state][column] goto function completed with failure links
+    std::vector<uint32_t> transitions;
+    // Rule whose keyword ends exactly at a state (kNoRule if none) and the
+    // nearest state on the failure chain that has one (0 if none)
+    std::vector<uint32_t> state_rule;
+    std::vector<uint32_t> output_link;
+
+    std::vector<CategoryRule> rules;
+    // Normalised keyword length of each rule (longer keywords win ties)
+    std::vector<std::size_t> keyword_lengths;
+
+    // True if rule `challenger` beats rule `incumbent`
+    bool outranks(uint32_t challenger, uint32_t incumbent) const;
+};
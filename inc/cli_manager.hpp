@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ui_manager.hpp"
+#include "io_interface.hpp"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Non-interactive front end for scripted runs. Each invocation executes one
+ * subcommand against HomeManager and exits, for example:
+ *
+ *   home-financials import --member 12 --bank canara a.csv b.csv
+ *   home-financials networth --family 3 --format=tsv
+ *   home-financials list families --db /path/to/homefinancials.db
+ *
+ * Results go to IOInterface::printLine, errors to printError. run() returns
+ * the process exit code: 0 on success, 1 if any operation failed and 2 on a
+ * usage error.
+ */
+class CLIManager : public UIManager
+{
+public:
+    // Production use: TerminalIO and the default SQLite-backed HomeManager
+    CLIManager();
+
+    // Testing: injected I/O and (optionally) an injected HomeManager
+    explicit CLIManager(std::unique_ptr<IOInterface> io_ptr);
+    CLIManager(std::unique_ptr<IOInterface> io_ptr, std::unique_ptr<HomeManager> home_ptr);
+
+    ~CLIManager() override;
+
+    // Output format selected with --format
+    enum class OutputFormat
+    {
+        Text,
+        Tsv
+    };
+
+    commons::Result addFamily(const std::string& name) override;
+    commons::Result deleteFamily(const uint64_t& family_id) override;
+
+    commons::Result addMember(const uint64_t& family_id, const Member& member) override;
+    commons::Result updateMember(const uint64_t& member_id,
+                                 const std::string& new_name,
+                                 const std::string& new_nickname) override;
+
+    commons::Result deleteMember(const uint64_t& member_id) override;
+    commons::Result deleteMembers(const std::vector<uint64_t>& member_ids) override;
+
+    // Report a failed result through the IOInterface
+    void showError(const commons::Result& res);
+
+    // True if `command` names a subcommand handled by run()
+    static bool isSubcommand(const std::string& command);
+
+    // Execute one subcommand. `args` excludes the program name and starts
+    // with the subcommand.
+    int run(const std::vector<std::string>& args);
+
+    // Print the subcommand synopsis
+    void printUsage();
+
+private:
+    // Parsed command line: `--key value` / `--key=value` options plus
+    // positional arguments in order
+    struct Arguments
+    {
+        std::string command;
+        std::map<std::string, std::string> options;
+        std::vector<std::string> positionals;
+    };
+
+    bool parseArguments(const std::vector<std::string>& args, Arguments* out_args);
+    bool openDatabase(const Arguments& args);
+    bool requireId(const Arguments& args, const std::string& option, uint64_t* out_id);
+
+    int runImport(const Arguments& args);
+    int runNetWorth(const Arguments& args);
+    int runList(const Arguments& args);
+    int runAdd(const Arguments& args);
+    int runDelete(const Arguments& args);
+    int runCashFlow(const Arguments& args);
+    int runRollups(const Arguments& args);
+    int runCategories(const Arguments& args);
+
+    std::unique_ptr<IOInterface> io_ptr;
+    std::unique_ptr<HomeManager> home_ptr;
+    OutputFormat format{OutputFormat::Text};
+};
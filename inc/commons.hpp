@@ -1,10 +1,15 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <span>
 #include <string>
 #include <vector>
 #include <optional>
 
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
 #include <stdexcept>
@@ -18,8 +23,27 @@ namespace commons
         MaxMembersExceeded = 2,
         NotFound = 3,
         DbError = 4,
+        Overflow = 5,
+        Unreconciled = 6,
     };
     
+    // Stable identifier for a Result, used by the machine-readable protocols
+    inline const char* resultName(Result res)
+    {
+        switch (res)
+        {
+            case Result::Ok: return "Ok";
+            case Result::InvalidInput: return "InvalidInput";
+            case Result::MaxMembersExceeded: return "MaxMembersExceeded";
+            case Result::NotFound: return "NotFound";
+            case Result::DbError: return "DbError";
+            case Result::Overflow: return "Overflow";
+            case Result::Unreconciled: return "Unreconciled";
+        }
+
+        return "Unknown";
+    }
+
     // Parse a currency-like string (for example: "Rs.7,43,483.09" or
     // "3,23,527.09") and return the value in paise (1 INR = 100 paise).
     // Returns std::nullopt if the string cannot be parsed.
@@ -101,4 +125,303 @@ namespace commons
         }
     }
 
+    // Format a paise amount as rupees with two decimal places ("-0.05",
+    // "1234.50").
+    inline std::string formatPaise(long long amount_paise)
+    {
+        long long rupees = amount_paise / 100;
+        int paise = static_cast<int>(std::llabs(amount_paise % 100));
+        std::string sign = (amount_paise < 0 && rupees == 0) ? "-" : "";
+        std::string paise_str = (paise < 10 ? "0" : "") + std::to_string(paise);
+        return sign + std::to_string(rupees) + "." + paise_str;
+    }
+
+    // Parse a non-negative whole number used as a database ID. Returns
+    // std::nullopt for empty strings, signs, stray characters or overflow.
+    inline std::optional<uint64_t> parseId(const std::string &s)
+    {
+        if (s.empty() || !std::all_of(s.begin(), s.end(), [](unsigned char ch) { return std::isdigit(ch); }))
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            return static_cast<uint64_t>(std::stoull(s));
+        }
+        catch (const std::exception &)
+        {
+            return std::nullopt;
+        }
+    }
+
+    // Split text into lower-case search tokens: runs of ASCII letters and
+    // digits, with bytes of multi-byte UTF-8 characters kept inside tokens.
+    // For ASCII text this is how the FTS5 unicode61 tokenizer splits
+    // transaction narrations, so both storage backends match the same rows.
+    inline std::vector<std::string> searchTokens(const std::string &text)
+    {
+        std::vector<std::string> tokens;
+        std::string current;
+
+        for (unsigned char ch : text)
+        {
+            if (std::isalnum(ch) || ch >= 0x80)
+            {
+                current.push_back(static_cast<char>(std::tolower(ch)));
+            }
+            else if (!current.empty())
+            {
+                tokens.push_back(std::move(current));
+                current.clear();
+            }
+        }
+
+        if (!current.empty())
+        {
+            tokens.push_back(std::move(current));
+        }
+
+        return tokens;
+    }
+
+    // A category rule keyword as its search tokens, each preceded by one
+    // space. Keywords that normalise alike match the same narrations; the
+    // result is empty when the keyword has no words.
+    inline std::string normalisedKeyword(const std::string &keyword)
+    {
+        std::string normalised;
+
+        for (const std::string &token : searchTokens(keyword))
+        {
+            normalised.push_back(' ');
+            normalised += token;
+        }
+
+        return normalised;
+    }
+
+    // Calendar date (statement periods, net-worth-over-time points)
+    using Date = std::chrono::year_month_day;
+
+    // Parse a statement date. Accepts ISO "2024-04-30" and the day-first
+    // forms used on Indian statements: "30-04-2024", "30/04/2024",
+    // "30-Apr-2024" and "30 Apr 2024". Returns std::nullopt for anything
+    // else, including impossible dates such as "31-04-2024".
+    inline std::optional<Date> parseDate(const std::string &s)
+    {
+        auto number = [&](std::size_t pos, std::size_t len) -> std::optional<int>
+        {
+            if (pos + len > s.size())
+            {
+                return std::nullopt;
+            }
+
+            int value = 0;
+
+            for (std::size_t index = pos; index < pos + len; ++index)
+            {
+                if (!std::isdigit(static_cast<unsigned char>(s[index])))
+                {
+                    return std::nullopt;
+                }
+
+                value = value * 10 + (s[index] - '0');
+            }
+
+            return value;
+        };
+
+        std::optional<int> year;
+        std::optional<int> month;
+        std::optional<int> day;
+
+        if (s.size() == 10 && s[4] == '-' && s[7] == '-')
+        {
+            year = number(0, 4);
+            month = number(5, 2);
+            day = number(8, 2);
+        }
+        else if (s.size() == 10 && (s[2] == '-' || s[2] == '/') && s[5] == s[2])
+        {
+            day = number(0, 2);
+            month = number(3, 2);
+            year = number(6, 4);
+        }
+        else if (s.size() == 11 && (s[2] == '-' || s[2] == ' ') && s[6] == s[2])
+        {
+            static const char* const month_names[] = {"jan", "feb", "mar", "apr", "may", "jun",
+                                                      "jul", "aug", "sep", "oct", "nov", "dec"};
+            std::string name;
+
+            for (std::size_t index = 3; index < 6; ++index)
+            {
+                name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(s[index]))));
+            }
+
+            for (int index = 0; index < 12; ++index)
+            {
+                if (name == month_names[index])
+                {
+                    month = index + 1;
+                }
+            }
+
+            day = number(0, 2);
+            year = number(7, 4);
+        }
+
+        if (!year || !month || !day)
+        {
+            return std::nullopt;
+        }
+
+        Date date{std::chrono::year{*year}, std::chrono::month{static_cast<unsigned>(*month)},
+                  std::chrono::day{static_cast<unsigned>(*day)}};
+
+        if (!date.ok())
+        {
+            return std::nullopt;
+        }
+
+        return date;
+    }
+
+    // Format a date as ISO "YYYY-MM-DD" (the form stored in the database,
+    // which also sorts chronologically as text).
+    inline std::string formatDate(const Date &date)
+    {
+        int year = static_cast<int>(date.year());
+        unsigned month = static_cast<unsigned>(date.month());
+        unsigned day = static_cast<unsigned>(date.day());
+        std::string out = std::to_string(year);
+        out += (month < 10 ? "-0" : "-") + std::to_string(month);
+        out += (day < 10 ? "-0" : "-") + std::to_string(day);
+        return out;
+    }
+
+    // Calendar month ("YYYY-MM"), the grain of the cash-flow rollups
+    using Month = std::chrono::year_month;
+
+    // Parse "YYYY-MM"; std::nullopt for anything else
+    inline std::optional<Month> parseMonth(const std::string &s)
+    {
+        if (s.size() != 7 || s[4] != '-')
+        {
+            return std::nullopt;
+        }
+
+        auto date = parseDate(s + "-01");
+
+        if (!date)
+        {
+            return std::nullopt;
+        }
+
+        return date->year() / date->month();
+    }
+
+    inline std::string formatMonth(const Month &month)
+    {
+        return formatDate(month / std::chrono::day{1}).substr(0, 7);
+    }
+
+    // 128-bit signed integer used for exact intermediate sums. `__extension__`
+    // keeps -Wpedantic quiet about the GCC/Clang builtin type.
+    __extension__ typedef __int128 WideInt;
+
+    // Exact accumulator for paise amounts. Values are summed in 128 bits so
+    // intermediate totals cannot wrap; the final total is range-checked when
+    // it is narrowed back to `long long`.
+    class CheckedAccumulator
+    {
+    public:
+        void add(long long value_paise)
+        {
+            total += value_paise;
+        }
+
+        // Sum a contiguous array. Each value is split into a signed high half
+        // and an unsigned low half which are summed in plain 64-bit lanes;
+        // neither lane can wrap within a block of 2^31 values, so the loop is
+        // free of checks and auto-vectorises. Blocks are folded into the
+        // 128-bit total.
+        void addAll(std::span<const long long> values_paise)
+        {
+            constexpr std::size_t block_size = std::size_t{1} << 31;
+
+            for (std::size_t offset = 0; offset < values_paise.size(); offset += block_size)
+            {
+                auto block = values_paise.subspan(offset, std::min(block_size, values_paise.size() - offset));
+                std::uint64_t low_sum = 0;
+                std::int64_t high_sum = 0;
+
+                for (long long value : block)
+                {
+                    low_sum += static_cast<std::uint64_t>(value) & 0xFFFFFFFFu;
+                    high_sum += static_cast<std::int64_t>(value) >> 32;
+                }
+
+                total += static_cast<WideInt>(high_sum) * (WideInt{1} << 32) + static_cast<WideInt>(low_sum);
+            }
+        }
+
+        void merge(const CheckedAccumulator &other)
+        {
+            total += other.total;
+        }
+
+        WideInt wide() const
+        {
+            return total;
+        }
+
+        // True when the total fits in a `long long`
+        bool fits() const
+        {
+            return total >= std::numeric_limits<long long>::min() &&
+                   total <= std::numeric_limits<long long>::max();
+        }
+
+        // The total clamped to the `long long` range
+        long long saturated() const
+        {
+            if (total > std::numeric_limits<long long>::max())
+            {
+                return std::numeric_limits<long long>::max();
+            }
+
+            if (total < std::numeric_limits<long long>::min())
+            {
+                return std::numeric_limits<long long>::min();
+            }
+
+            return static_cast<long long>(total);
+        }
+
+        // Write the total to out_paise. Returns Result::Overflow (and writes
+        // the saturated value) when it does not fit in a `long long`.
+        Result toPaise(long long *out_paise) const
+        {
+            if (!out_paise)
+            {
+                return Result::InvalidInput;
+            }
+
+            *out_paise = saturated();
+            return fits() ? Result::Ok : Result::Overflow;
+        }
+
+    private:
+        WideInt total{0};
+    };
+
+    // Convenience: exact sum of a contiguous array of paise values.
+    inline Result sumPaise(std::span<const long long> values_paise, long long *out_paise)
+    {
+        CheckedAccumulator accumulator;
+        accumulator.addAll(values_paise);
+        return accumulator.toPaise(out_paise);
+    }
+
 } // namespace commons
@@ -2,6 +2,7 @@
 
 #include "commons.hpp"
 #include "member.hpp"
+#include <utility>
 
 class Family
 {
@@ -10,28 +11,50 @@ private:
     std::string family_name;
     std::vector<Member> members;
 
+    // Sorted flat index of (member ID, position in members), ordered by ID
+    // and then position so repeated IDs (e.g. unsaved members with ID 0)
+    // resolve to the first one like a linear scan would. Kept in step with
+    // every add/remove; members loaded in ID order append in O(1).
+    std::vector<std::pair<uint64_t, std::size_t>> member_index;
+
     Family() = delete; // Prevent default constructor
 
+    void indexLastMember();
+    void rebuildMemberIndex();
+
 public:
     // Constructor for creating new families (before saving to DB)
-    Family(const std::string& name);
+    Family(std::string name);
     
     // Constructor for families retrieved from database (with known ID)
-    Family(uint64_t id, const std::string& name);
+    Family(uint64_t id, std::string name);
     
     virtual ~Family();
 
+    // Spelled out so the virtual destructor does not cost us move semantics
+    Family(const Family&) = default;
+    Family(Family&&) noexcept = default;
+    Family& operator=(const Family&) = default;
+    Family& operator=(Family&&) noexcept = default;
+
     // Add a member to the family
     void addMember(const Member& member);
+    void addMember(Member&& member);
+    // Construct a member with a known ID directly in the member list
+    Member& emplaceMember(uint64_t id, std::string name, std::string nickname);
+    // Pre-size the member list (e.g. from the stored member count)
+    void reserveMembers(std::size_t count);
     // Remove a member from the family by ID
     bool removeMember(const uint64_t& member_id);
 
     uint64_t getId() const;
 
-    std::string getName() const;
+    const std::string& getName() const;
 
-    std::vector<Member> getMembers() const;
+    // Read-only view of the members; copy it only when the family may change
+    const std::vector<Member>& getMembers() const;
 
-    // Get a member by ID
+    // Get a member by ID (O(log n) through the index)
     Member* getMember(const uint64_t& member_id);
+    const Member* getMember(const uint64_t& member_id) const;
 };
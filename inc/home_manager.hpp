@@ -3,6 +3,9 @@
 #include "commons.hpp"
 #include "storage_manager.hpp"
 #include "bank_reader.hpp"
+#include "net_worth.hpp"
+#include "analytics_snapshot.hpp"
+#include "statement_reconciliation.hpp"
 #include <memory>
 #include <string>
 #include <cstdint>
@@ -15,7 +18,12 @@
 class HomeManager
 {
 public:
+    // Uses the SQLite-backed StorageManager
     HomeManager();
+
+    // Uses the provided storage backend (for example MemoryStorage)
+    explicit HomeManager(std::unique_ptr<StorageInterface> storage);
+
     ~HomeManager();
 
     // Family operations (return commons::Result for error reporting)
@@ -29,47 +37,126 @@ public:
     commons::Result addMemberToFamily(const Member &member, const uint64_t family_id);
     commons::Result addMemberToFamily(const Member &member, const uint64_t family_id, uint64_t* out_member_id);
     std::unique_ptr<Member> getMember(const uint64_t member_id);
+
+    // Batched lookups: one storage round-trip, one entry per requested ID
+    // (std::nullopt where the ID does not exist)
+    commons::Result getMembers(std::span<const uint64_t> member_ids, std::vector<std::optional<Member>>* out_members);
+    commons::Result getFamilies(std::span<const uint64_t> family_ids, std::vector<std::optional<Family>>* out_families);
+    commons::Result getBankAccounts(std::span<const uint64_t> bank_account_ids, std::vector<std::optional<BankAccount>>* out_accounts);
     commons::Result updateMember(const uint64_t member_id, const std::string &new_name, const std::string &new_nickname);
     commons::Result deleteMember(const uint64_t member_id);
+    // Delete several members in one transaction; per-ID outcomes go to out_results
+    commons::Result deleteMembers(const std::vector<uint64_t> &member_ids, std::vector<commons::Result>* out_results);
 
     // Listing helpers
     std::vector<Family> listFamilies();
     std::vector<Member> listMembersOfFamily(const uint64_t family_id);
+    // Arena-backed variants for bulk listings (see StorageInterface)
+    std::pmr::vector<FamilyRow> listFamilies(std::pmr::memory_resource* arena);
+    std::pmr::vector<MemberRow> listMembersOfFamily(const uint64_t family_id, std::pmr::memory_resource* arena);
 
     // Net worth helpers: compute net worth (in paise) for a member or family.
     commons::Result computeMemberNetWorth(const uint64_t member_id, long long* out_net_worth_paise);
     commons::Result computeFamilyNetWorth(const uint64_t family_id, long long* out_net_worth_paise);
 
-    // Testing access
-    StorageManager* getStorageManager() { return ptr_storage.get(); }
+    // Household-wide report: per-family and per-member totals for every
+    // family, optionally aggregated on several threads. Only the
+    // single-threaded report is point-in-time consistent (see
+    // NetWorth::computeAllNetWorths).
+    commons::Result computeAllNetWorths(NetWorthSnapshot* out_snapshot, const unsigned thread_count = 1);
+
+    // Columnar copy of all families, members and accounts for dashboards
+    // that run several aggregations (by family, member or bank) in a row.
+    commons::Result loadAnalyticsSnapshot(AnalyticsSnapshot* out_snapshot);
+
+    // Month-end net worth series from the imported statement history
+    commons::Result computeMonthlyNetWorth(const NetWorthScope scope,
+                                           const uint64_t scope_id,
+                                           const std::chrono::year_month first_month,
+                                           const std::chrono::year_month last_month,
+                                           std::vector<NetWorthPoint>* out_points);
+
+    // Monthly credits/debits from the cash-flow rollups, plus maintenance:
+    // rebuild them from the raw transactions or count rows that disagree
+    commons::Result getCashFlow(const NetWorthScope scope,
+                                const uint64_t scope_id,
+                                const commons::Month first_month,
+                                const commons::Month last_month,
+                                std::vector<CashFlowMonth>* out_months);
+    commons::Result rebuildCashFlowRollups();
+    commons::Result checkCashFlowRollups(uint64_t* out_mismatched_rows);
+
+    // Full-text lookup of imported transactions ("all payments to X"),
+    // newest first
+    commons::Result searchTransactions(const std::string& text,
+                                       std::size_t limit,
+                                       std::vector<TransactionMatch>* out_matches);
+
+    // Keyword rules that categorise transactions as they are imported
+    commons::Result addCategoryRule(const std::string& category_name,
+                                    const std::string& keyword,
+                                    int priority,
+                                    uint64_t* out_rule_id = nullptr);
+    commons::Result deleteCategoryRule(const uint64_t rule_id);
+    commons::Result listCategories(std::vector<TransactionCategory>* out_categories);
+    commons::Result listCategoryRules(std::vector<CategoryRule>* out_rules);
+
+    // Add every rule of a rules file: one `Category,Keyword[,Priority]` per
+    // line; blank lines, '#' comments and a leading "Category,..." header
+    // are skipped. The whole file is checked, then saved in one write;
+    // rules already present keep their ID and take the file's priority.
+    commons::Result importCategoryRules(const std::string& path, uint64_t* out_rule_count = nullptr);
+
+    // Re-apply the rules to transactions imported before the last change
+    commons::Result recategorizeTransactions(std::size_t batch_size, uint64_t* out_changed = nullptr);
+
+    // Testing access. getStorageManager() returns nullptr when the backend
+    // is not the SQLite StorageManager.
+    StorageInterface* getStorage() { return ptr_storage.get(); }
+    StorageManager* getStorageManager() { return dynamic_cast<StorageManager*>(ptr_storage.get()); }
 
     // Import a bank statement: parse the file using the provided BankReader
     // and persist the parsed account row for the given member and bank.
     // Overloads accept either a numeric bank_id or a bank name string.
+    // The statement is filed under the member's account with the same bank
+    // and account number when there is one. Lines already stored for that
+    // account are skipped and counted in out_duplicates.
+    // A statement with transaction lines must reconcile first; otherwise
+    // nothing is saved, Unreconciled is returned and out_report (when
+    // given) names the first divergent line. The account, its balance
+    // snapshot and the lines are stored together or not at all.
     commons::Result importBankStatement(BankReader &reader,
                                         const std::string &filePath,
                                         const uint64_t member_id,
                                         const uint64_t bank_id,
-                                        uint64_t* out_bank_account_id = nullptr);
+                                        uint64_t* out_bank_account_id = nullptr,
+                                        ReconciliationReport* out_report = nullptr,
+                                        uint64_t* out_duplicates = nullptr);
 
     commons::Result importBankStatement(BankReader &reader,
                                         const std::string &filePath,
                                         const uint64_t member_id,
                                         const std::string &bank_name,
-                                        uint64_t* out_bank_account_id = nullptr);
+                                        uint64_t* out_bank_account_id = nullptr,
+                                        ReconciliationReport* out_report = nullptr,
+                                        uint64_t* out_duplicates = nullptr);
 
     // Convenience overloads: accept bank id or bank name and let the
     // HomeManager create the appropriate reader using ReaderFactory.
     commons::Result importBankStatement(const std::string &filePath,
                                         const uint64_t member_id,
                                         const uint64_t bank_id,
-                                        uint64_t* out_bank_account_id = nullptr);
+                                        uint64_t* out_bank_account_id = nullptr,
+                                        ReconciliationReport* out_report = nullptr,
+                                        uint64_t* out_duplicates = nullptr);
 
     commons::Result importBankStatement(const std::string &filePath,
                                         const uint64_t member_id,
                                         const std::string &bank_name,
-                                        uint64_t* out_bank_account_id = nullptr);
+                                        uint64_t* out_bank_account_id = nullptr,
+                                        ReconciliationReport* out_report = nullptr,
+                                        uint64_t* out_duplicates = nullptr);
 
 private:
-    std::unique_ptr<StorageManager> ptr_storage;
+    std::unique_ptr<StorageInterface> ptr_storage;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <string>
 
 /**
@@ -17,6 +18,20 @@ public:
     virtual void printLine(const std::string& line) = 0;
     virtual void printError(const std::string& error) = 0;
 
+    // Print a block of lines (for example one screen of a listing). Buffered
+    // implementations emit the whole block with a single write.
+    virtual void printLines(std::span<const std::string> lines)
+    {
+        for (const auto &line : lines)
+        {
+            printLine(line);
+        }
+    }
+
+    // Push any buffered output to the underlying stream. No-op for
+    // unbuffered implementations.
+    virtual void flush() {}
+
     // Input operations
     virtual bool getLine(std::string& line) = 0;
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "home_manager.hpp"
+#include "request_dispatcher.hpp"
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+/**
+ * Headless JSON-lines front end: one request per input line, one response
+ * per output line (see RequestDispatcher for the message format).
+ *
+ * Requests are pipelined. The calling thread reads input while a pool of
+ * workers executes requests against a single warm HomeManager, so responses
+ * may arrive out of order and are matched by their "id". With one worker,
+ * responses keep request order.
+ */
+class JsonLinesServer
+{
+public:
+    // Requests read ahead of the workers before input reading pauses
+    static constexpr std::size_t kMaxPendingRequests = 1024;
+
+    JsonLinesServer(HomeManager& home, std::istream& in, std::ostream& out, unsigned worker_count);
+
+    // Serve until end of input; returns once every response has been written
+    void run();
+
+private:
+    void workerLoop();
+    void writeResponse(const std::string& response);
+
+    RequestDispatcher dispatcher;
+    std::istream& in;
+    std::ostream& out;
+    unsigned worker_count;
+
+    // Work queue shared by the reader and the workers
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::condition_variable space_cv;
+    std::deque<std::string> pending;
+    bool input_done{false};
+
+    // Serialises whole response lines on `out`
+    std::mutex output_mutex;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Minimal JSON document model used by the headless request protocols.
+ *
+ * Numbers keep their source text and are converted on access so 64-bit IDs
+ * and paise amounts round-trip exactly. Objects keep insertion order, which
+ * keeps serialised responses stable and readable.
+ */
+class JsonValue
+{
+public:
+    enum class Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    // Null value
+    JsonValue();
+
+    static JsonValue boolean(bool value);
+    static JsonValue number(long long value);
+    static JsonValue number(uint64_t value);
+    static JsonValue string(const std::string& value);
+    static JsonValue array();
+    static JsonValue object();
+
+    // Parse a complete JSON text. Returns std::nullopt on any syntax error or
+    // trailing garbage.
+    static std::optional<JsonValue> parse(const std::string& text);
+
+    Type type() const { return kind; }
+    bool isNull() const { return kind == Type::Null; }
+
+    // Typed accessors; std::nullopt when the value has another type or the
+    // number does not fit
+    std::optional<bool> asBool() const;
+    std::optional<long long> asInt64() const;
+    std::optional<uint64_t> asUint64() const;
+    std::optional<std::string> asString() const;
+
+    // Array access
+    const std::vector<JsonValue>& items() const { return array_items; }
+    void push(JsonValue value);
+
+    // Object access. find() returns nullptr when the key is absent.
+    const JsonValue* find(const std::string& key) const;
+    void set(const std::string& key, JsonValue value);
+
+    // Compact single-line serialisation
+    std::string dump() const;
+    void dumpTo(std::string& out) const;
+
+private:
+    Type kind{Type::Null};
+    bool bool_value{false};
+
+    // String contents or the literal text of a number
+    std::string text;
+
+    std::vector<JsonValue> array_items;
+    std::vector<std::pair<std::string, JsonValue>> object_members;
+
+    friend class JsonParser;
+};
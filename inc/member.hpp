@@ -13,14 +13,20 @@ private:
     
 public:
     // Constructor for creating new members (before saving to DB)
-    Member(const std::string& name, const std::string& nickname="");
+    Member(std::string name, std::string nickname="");
     
     // Constructor for members retrieved from database (with known ID)
-    Member(uint64_t id, const std::string& name, const std::string& nickname="");
+    Member(uint64_t id, std::string name, std::string nickname="");
     
     virtual ~Member();
 
+    // The user-declared destructor would otherwise suppress the moves
+    Member(const Member&) = default;
+    Member(Member&&) noexcept = default;
+    Member& operator=(const Member&) = default;
+    Member& operator=(Member&&) noexcept = default;
+
     uint64_t getId() const;
-    std::string getName() const;
-    std::string getNickname() const;
+    const std::string& getName() const;
+    const std::string& getNickname() const;
 };
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "commons.hpp"
+#include "storage_interface.hpp"
+#include "bank_account.hpp"
+#include "string_interner.hpp"
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * In-memory implementation of StorageInterface. Nothing touches the disk
+ * unless a snapshot is saved explicitly, which makes it suitable for test
+ * suites, benchmarks and what-if simulations.
+ *
+ * Rows live in contiguous vectors kept in ascending ID order (IDs are handed
+ * out monotonically, so appends preserve the order) and are located by
+ * binary search. Hash maps index members by family and accounts by member.
+ * Family, member and bank names are interned, so records carry 32-bit
+ * handles and repeated names are stored once.
+ * A shared mutex lets readers run concurrently while writers are exclusive.
+ */
+class MemoryStorage : public StorageInterface
+{
+public:
+    // Starts empty with the same prepopulated bank list and category rules
+    // as the SQLite backend
+    MemoryStorage();
+    ~MemoryStorage() override;
+
+    commons::Result saveMemberDataEx(const Member& member, const uint64_t family_id, uint64_t* out_member_id = nullptr) override;
+    commons::Result saveFamilyDataEx(const Family& family, uint64_t* out_family_id = nullptr) override;
+
+    Member* getMemberData(const uint64_t& member_id) override;
+    Family* getFamilyData(const uint64_t& family_id) override;
+    commons::Result getMembersEx(std::span<const uint64_t> member_ids, std::vector<std::optional<Member>>* out_members) override;
+    commons::Result getFamiliesEx(std::span<const uint64_t> family_ids, std::vector<std::optional<Family>>* out_families) override;
+    commons::Result getBankAccountsEx(std::span<const uint64_t> bank_account_ids, std::vector<std::optional<BankAccount>>* out_accounts) override;
+
+    commons::Result deleteMemberDataEx(const uint64_t& member_id) override;
+    commons::Result deleteFamilyDataEx(const uint64_t& family_id) override;
+    commons::Result deleteMembersEx(const std::vector<uint64_t>& member_ids, std::vector<commons::Result>* out_results) override;
+
+    commons::Result updateFamilyDataEx(const uint64_t& family_id, const std::string& new_name) override;
+    commons::Result updateMemberDataEx(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname) override;
+
+    std::vector<Family> listFamilies() override;
+    std::vector<Member> listMembersOfFamily(uint64_t family_id) override;
+    std::pmr::vector<FamilyRow> listFamilies(std::pmr::memory_resource* arena) override;
+    std::pmr::vector<MemberRow> listMembersOfFamily(uint64_t family_id, std::pmr::memory_resource* arena) override;
+
+    commons::Result saveBankAccountEx(uint64_t bank_id,
+                                      uint64_t member_id,
+                                      const std::string &account_number,
+                                      long long opening_paise,
+                                      long long closing_paise,
+                                      uint64_t* out_id = nullptr) override;
+
+    uint64_t getMemberCount(const uint64_t family_id, bool* out_ok = nullptr) override;
+
+    commons::Result getBankIdByName(const std::string &bank_name, uint64_t* out_bank_id) override;
+    commons::Result getBankNameById(const uint64_t bank_id, std::string* out_name) override;
+
+    commons::Result getBankAccountById(const uint64_t bank_account_id, BankAccount* out_row) override;
+    std::vector<BankAccount> listBankAccountsOfMember(const uint64_t member_id) override;
+    std::pmr::vector<BankAccountRow> listBankAccountsOfMember(const uint64_t member_id, std::pmr::memory_resource* arena) override;
+
+    commons::Result visitAccountBalances(const uint64_t first_family_id,
+                                         const uint64_t last_family_id,
+                                         const AccountBalanceVisitor& visitor) override;
+
+    commons::Result getFamilyIdRange(uint64_t* out_first_family_id, uint64_t* out_last_family_id) override;
+
+    commons::Result saveBalanceSnapshotEx(const uint64_t bank_account_id,
+                                          const std::optional<commons::Date>& period_start,
+                                          const commons::Date& period_end,
+                                          long long opening_paise,
+                                          long long closing_paise) override;
+
+    commons::Result getNetWorthAsOfEx(const NetWorthScope scope,
+                                      const uint64_t scope_id,
+                                      std::span<const commons::Date> as_of_dates,
+                                      std::vector<long long>* out_totals_paise) override;
+
+    commons::Result saveTransactionsEx(const uint64_t bank_account_id,
+                                       std::span<const BankTransaction> transactions,
+                                       uint64_t* out_duplicates = nullptr) override;
+
+    commons::Result importStatementEx(const StatementImport& statement,
+                                      uint64_t* out_bank_account_id = nullptr,
+                                      uint64_t* out_duplicates = nullptr) override;
+
+    commons::Result getCashFlowEx(const NetWorthScope scope,
+                                  const uint64_t scope_id,
+                                  const commons::Month& first_month,
+                                  const commons::Month& last_month,
+                                  std::vector<CashFlowMonth>* out_months) override;
+
+    commons::Result rebuildCashFlowRollupsEx() override;
+
+    commons::Result checkCashFlowRollupsEx(uint64_t* out_mismatched_rows) override;
+
+    commons::Result searchTransactionsEx(const std::string& text,
+                                         std::size_t limit,
+                                         std::vector<TransactionMatch>* out_matches) override;
+
+    commons::Result saveCategoryRuleEx(const std::string& category_name,
+                                       const std::string& keyword,
+                                       int priority,
+                                       uint64_t* out_rule_id = nullptr) override;
+
+    commons::Result saveCategoryRulesEx(std::span<const std::string> category_names,
+                                        std::span<const CategoryRule> rules,
+                                        uint64_t* out_added = nullptr) override;
+
+    commons::Result deleteCategoryRuleEx(const uint64_t rule_id) override;
+
+    commons::Result listCategoriesEx(std::vector<TransactionCategory>* out_categories) override;
+
+    commons::Result listCategoryRulesEx(std::vector<CategoryRule>* out_rules) override;
+
+    commons::Result recategorizeTransactionsEx(std::size_t batch_size, uint64_t* out_changed = nullptr) override;
+
+    // Snapshot persistence. saveSnapshot writes the whole store to a binary
+    // file; loadSnapshot replaces the current contents with a file written
+    // by saveSnapshot. Return NotFound when the file cannot be opened and
+    // InvalidInput when it is not a valid snapshot.
+    commons::Result saveSnapshot(const std::string& path);
+    commons::Result loadSnapshot(const std::string& path);
+
+private:
+    struct FamilyRecord
+    {
+        uint64_t id{0};
+        commons::NameHandle name{commons::StringInterner::kEmpty};
+    };
+
+    struct MemberRecord
+    {
+        uint64_t id{0};
+        uint64_t family_id{0};
+        commons::NameHandle name{commons::StringInterner::kEmpty};
+        commons::NameHandle nickname{commons::StringInterner::kEmpty};
+    };
+
+    struct BankRecord
+    {
+        uint64_t id{0};
+        commons::NameHandle name{commons::StringInterner::kEmpty};
+    };
+
+    struct BalanceRecord
+    {
+        std::optional<commons::Date> period_start;
+        commons::Date period_end;
+        long long opening_paise{0};
+        long long closing_paise{0};
+    };
+
+    // Ordered like the SQLite CashFlowRollups primary key, so a member's
+    // month range is one contiguous run of the map
+    struct RollupKey
+    {
+        uint64_t member_id{0};
+        commons::Month month;
+        uint64_t bank_account_id{0};
+
+        auto operator<=>(const RollupKey&) const = default;
+    };
+
+    struct RollupRecord
+    {
+        long long credit_paise{0};
+        uint64_t credit_count{0};
+        long long debit_paise{0};
+        uint64_t debit_count{0};
+
+        // Fold one transaction in; zero amounts only create the row
+        void add(long long amount_paise)
+        {
+            if (amount_paise > 0)
+            {
+                credit_paise += amount_paise;
+                ++credit_count;
+            }
+            else if (amount_paise < 0)
+            {
+                debit_paise -= amount_paise;
+                ++debit_count;
+            }
+        }
+
+        bool operator==(const RollupRecord&) const = default;
+    };
+
+    using RollupMap = std::map<RollupKey, RollupRecord>;
+
+    // Position of a transaction in transactions_by_account
+    struct TransactionRef
+    {
+        uint64_t bank_account_id{0};
+        std::size_t index{0};
+
+        auto operator<=>(const TransactionRef&) const = default;
+    };
+
+    mutable std::shared_mutex data_mutex;
+
+    // Text behind every NameHandle in the records. Append-only while the
+    // store lives (renames leave the old text behind); loadSnapshot starts
+    // a fresh table.
+    commons::StringInterner names;
+
+    std::vector<FamilyRecord> families;
+    std::vector<MemberRecord> members;
+    std::vector<BankAccount> accounts;
+    std::vector<BankRecord> banks;
+
+    // Secondary indexes: member IDs per family and account IDs per member,
+    // each kept in ascending order
+    std::unordered_map<uint64_t, std::vector<uint64_t>> members_by_family;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> accounts_by_member;
+
+    // Balance history per account, ordered by period end
+    std::unordered_map<uint64_t, std::vector<BalanceRecord>> balances_by_account;
+
+    // Statement lines per account in insertion order, and their monthly
+    // rollups (derived data: rebuilt rather than stored in snapshots)
+    std::unordered_map<uint64_t, std::vector<BankTransaction>> transactions_by_account;
+    RollupMap cash_flow_rollups;
+
+    // Inverted index for searchTransactionsEx: search token -> transactions
+    // whose narration or counterparty contains it. Ordered so a prefix is a
+    // contiguous run of keys.
+    std::map<std::string, std::vector<TransactionRef>, std::less<>> search_postings;
+
+    // Fingerprints of the stored transactions per account: the exact
+    // counterpart of the SQLite unique index, so no filter is needed here
+    std::unordered_map<uint64_t, std::unordered_set<uint64_t>> fingerprints_by_account;
+
+    // Categories and keyword rules in ascending ID order. Every rule change
+    // bumps category_rules_version and recompiles category_matcher; the
+    // version each stored line was categorised under is kept parallel to
+    // transactions_by_account.
+    std::vector<TransactionCategory> categories;
+    std::vector<CategoryRule> category_rules;
+    CategoryMatcher category_matcher;
+    uint64_t category_rules_version{1};
+    uint64_t next_category_id{1};
+    uint64_t next_rule_id{1};
+    std::unordered_map<uint64_t, std::vector<uint64_t>> rules_versions_by_account;
+
+    uint64_t next_family_id{1};
+    uint64_t next_member_id{1};
+    uint64_t next_account_id{1};
+
+    // Binary-search lookups; return nullptr when the ID is not stored
+    FamilyRecord* findFamily(uint64_t family_id);
+    MemberRecord* findMember(uint64_t member_id);
+    BankAccount* findAccount(uint64_t bank_account_id);
+    const BankRecord* findBank(uint64_t bank_id) const;
+
+    // Unlocked helpers shared by the public API
+    uint64_t insertMember(uint64_t family_id, std::string_view name, std::string_view nickname);
+    std::string nameOf(commons::NameHandle handle) const { return std::string(names.view(handle)); }
+    void eraseMember(uint64_t member_id);
+    uint64_t insertAccount(uint64_t bank_id, uint64_t member_id, const std::string& account_number,
+                           long long opening_paise, long long closing_paise);
+    void storeBalance(BankAccount& account, const std::optional<commons::Date>& period_start,
+                      const commons::Date& period_end, long long opening_paise, long long closing_paise);
+    uint64_t storeTransactions(const BankAccount& account, std::span<const BankTransaction> transactions);
+
+    // Fold every stored transaction into a fresh rollup map
+    RollupMap aggregateRollups() const;
+
+    // Add one stored transaction to search_postings
+    void indexTransaction(uint64_t bank_account_id, std::size_t index);
+
+    // Rebuild the secondary indexes from the primary vectors
+    void rebuildIndexes();
+
+    // Reset categories and rules to the defaults the SQLite schema seeds
+    void seedDefaultCategories();
+};
@@ -1,9 +1,44 @@
 #pragma once
 
 #include "commons.hpp"
-#include "storage_manager.hpp"
+#include "storage_interface.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
+
+// Household-wide net worth laid out as parallel columns (struct of arrays).
+// Families are ordered by ascending Family_ID; members are grouped by family
+// in ascending Member_ID order so that the members of family `index` are the
+// entries [family_member_offsets[index], family_member_offsets[index + 1]).
+struct NetWorthSnapshot
+{
+    std::vector<uint64_t> family_ids;
+    std::vector<long long> family_totals_paise;
+    std::vector<std::size_t> family_member_offsets;
+
+    std::vector<uint64_t> member_ids;
+    std::vector<uint64_t> member_family_ids;
+    std::vector<long long> member_totals_paise;
+
+    long long household_total_paise{0};
+
+    std::size_t familyCount() const { return family_ids.size(); }
+    std::size_t memberCount() const { return member_ids.size(); }
+
+    void clear();
+
+    // Append the families of `other` (which must all have larger IDs) and
+    // fold its household total into this snapshot.
+    void append(const NetWorthSnapshot& other);
+};
+
+// One point of a net-worth-over-time series
+struct NetWorthPoint
+{
+    commons::Date date;
+    long long net_worth_paise{0};
+};
 
 // NetWorth provides helpers to compute net worth (in paise) for a single
 // member or for an entire family by summing closing balances stored in
@@ -11,7 +46,7 @@
 class NetWorth
 {
 public:
-    explicit NetWorth(StorageManager* storage);
+    explicit NetWorth(StorageInterface* storage);
     ~NetWorth();
 
     // Compute net worth for a member (sum of closing balances). Returns
@@ -23,6 +58,32 @@ public:
     // Compute net worth for a family by summing all members' closing balances.
     commons::Result computeFamilyNetWorth(const uint64_t family_id, long long* out_net_worth_paise);
 
+    // Compute per-family and per-member totals for every family in a single
+    // streaming pass over BankAccounts joined with MemberInfo. With
+    // thread_count > 1 the Family_ID range is split into that many slices
+    // which are aggregated concurrently and then concatenated in order.
+    // Consistency: with one thread the whole report is read in a single read
+    // transaction, so it is a point-in-time snapshot. With several threads
+    // each slice reads in its own transaction on its own connection, so an
+    // import that commits meanwhile may show up in some families' totals
+    // and not others; the household total then mixes database states. Use
+    // thread_count = 1 where the figures must agree with each other.
+    commons::Result computeAllNetWorths(NetWorthSnapshot* out_snapshot, const unsigned thread_count = 1);
+
+    // Net worth of a member or family at the last day of every month from
+    // first_month to last_month inclusive, taken from the recorded statement
+    // balances (see StorageInterface::getNetWorthAsOfEx).
+    commons::Result computeMonthlyNetWorth(const NetWorthScope scope,
+                                           const uint64_t scope_id,
+                                           const std::chrono::year_month first_month,
+                                           const std::chrono::year_month last_month,
+                                           std::vector<NetWorthPoint>* out_points);
+
 private:
-    StorageManager* storage_ptr{nullptr};
+    StorageInterface* storage_ptr{nullptr};
+
+    // Aggregate families in [first_family_id, last_family_id] into out_snapshot
+    commons::Result aggregateFamilyRange(const uint64_t first_family_id,
+                                         const uint64_t last_family_id,
+                                         NetWorthSnapshot* out_snapshot);
 };
@@ -6,7 +6,7 @@
 #include <map>
 #include <mutex>
 #include "bank_reader.hpp"
-#include "storage_manager.hpp"
+#include "storage_interface.hpp"
 
 // ReaderFactory creates concrete BankReader instances for a given bank.
 // It supports runtime registration of reader creators so new bank readers
@@ -24,7 +24,7 @@ public:
     static bool unregisterReader(const std::string &bank_name);
 
     // Create a reader by bank id. Returns nullptr when no reader exists for the bank.
-    static std::unique_ptr<BankReader> createByBankId(StorageManager* storage, uint64_t bank_id);
+    static std::unique_ptr<BankReader> createByBankId(StorageInterface* storage, uint64_t bank_id);
 
     // Create a reader by bank name (case-insensitive). Returns nullptr when unsupported.
     static std::unique_ptr<BankReader> createByBankName(const std::string& bank_name);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "home_manager.hpp"
+#include "json_value.hpp"
+#include <string>
+
+/**
+ * Maps JSON requests onto HomeManager calls. Shared by the headless front
+ * ends (JSON lines over stdio and the Unix socket server).
+ *
+ * A request is an object {"id": ..., "method": "...", "params": {...}}. The
+ * response echoes the id and carries either {"ok": true, "result": ...} or
+ * {"ok": false, "error": "<commons::Result name>", "message": "..."}.
+ *
+ * Methods:
+ *   addFamily {name}                         -> {family_id}
+ *   deleteFamily {family_id}
+ *   addMember {family_id, name, nickname?}   -> {member_id}
+ *   updateMember {member_id, name?, nickname?}
+ *   deleteMember {member_id}
+ *   listFamilies                             -> [{id, name}]
+ *   listMembers {family_id}                  -> [{id, name, nickname}]
+ *   getMembers {member_ids: [...]}           -> [{id, name, nickname} | null]
+ *   import {member_id, bank, file}           -> {bank_account_id, duplicates}
+ *   networth {member_id} | {family_id}       -> {net_worth_paise}
+ *   networth {}                              -> {household_total_paise, families}
+ *
+ * handle() is safe to call from several threads at once.
+ */
+class RequestDispatcher
+{
+public:
+    explicit RequestDispatcher(HomeManager& home);
+
+    // Handle one request line and return one response line (no newline)
+    std::string handleLine(const std::string& line);
+
+    // Handle an already parsed request
+    JsonValue handle(const JsonValue& request);
+
+    // True for methods that never modify data (used to prioritise reads)
+    static bool isReadOnlyMethod(const std::string& method);
+
+private:
+    commons::Result addFamily(const JsonValue& params, JsonValue* out_result);
+    commons::Result deleteFamily(const JsonValue& params, JsonValue* out_result);
+    commons::Result addMember(const JsonValue& params, JsonValue* out_result);
+    commons::Result updateMember(const JsonValue& params, JsonValue* out_result);
+    commons::Result deleteMember(const JsonValue& params, JsonValue* out_result);
+    commons::Result listFamilies(const JsonValue& params, JsonValue* out_result);
+    commons::Result listMembers(const JsonValue& params, JsonValue* out_result);
+    commons::Result getMembers(const JsonValue& params, JsonValue* out_result);
+    commons::Result importStatement(const JsonValue& params, JsonValue* out_result);
+    commons::Result netWorth(const JsonValue& params, JsonValue* out_result);
+
+    HomeManager& home;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "json_value.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * Blocking work queue for the socket server. Read-only requests are served
+ * before writes; to keep writers from starving, a queued write is taken
+ * after every kMaxConsecutiveReads reads.
+ */
+class RequestQueue
+{
+public:
+    // A parsed request together with the connection that sent it
+    struct Item
+    {
+        uint64_t connection_id{0};
+        JsonValue request;
+    };
+
+    static constexpr std::size_t kMaxConsecutiveReads = 8;
+
+    // Queue a request; `read_only` selects the priority lane
+    void push(Item item, bool read_only);
+
+    // Block until an item is available or close() was called. Returns
+    // std::nullopt once closed and drained.
+    std::optional<Item> pop();
+
+    // Wake all waiting workers; pop() drains what is left, then returns nullopt
+    void close();
+
+    std::size_t size() const;
+
+private:
+    mutable std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<Item> reads;
+    std::deque<Item> writes;
+    std::size_t consecutive_reads{0};
+    bool closed{false};
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "home_manager.hpp"
+#include "request_dispatcher.hpp"
+#include "request_queue.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Long-lived daemon serving the RequestDispatcher protocol (one JSON request
+ * per line, one JSON response per line) to many local clients over a Unix
+ * domain socket.
+ *
+ * A single epoll event loop owns every connection and does all socket I/O.
+ * Parsed requests go to a RequestQueue, which hands read-only requests to
+ * the worker pool ahead of writes. Workers post finished responses back to
+ * the loop through an eventfd. Every request shares one HomeManager, so the
+ * database connections stay open and warm for the lifetime of the server.
+ */
+class SocketServer
+{
+public:
+    // Longest accepted request line; longer input closes the connection
+    static constexpr std::size_t kMaxLineLength = 1 << 20;
+
+    // Requests one connection may have queued or running at once; reading
+    // from it pauses at this limit
+    static constexpr std::size_t kMaxInFlight = 64;
+
+    // Unsent output above which reading from a connection pauses
+    static constexpr std::size_t kOutputHighWater = 4 << 20;
+
+    SocketServer(HomeManager& home, const std::string& socket_path, unsigned worker_count);
+    ~SocketServer();
+
+    SocketServer(const SocketServer&) = delete;
+    SocketServer& operator=(const SocketServer&) = delete;
+
+    // Bind the socket, owner-only, and set up epoll. An existing file is
+    // only replaced if it is a socket no server answers on.
+    // Returns false with a message on stderr if anything fails.
+    bool start();
+
+    // Run the event loop on the calling thread until stop() is called
+    void run();
+
+    // Ask run() to return. Async-signal-safe, so it may be called from a
+    // SIGINT/SIGTERM handler or from another thread.
+    void stop();
+
+private:
+    struct Connection
+    {
+        int fd{-1};
+        std::string in_buffer;
+        std::string out_buffer;
+        std::size_t in_flight{0};
+        bool peer_closed{false};
+        // epoll events registered for fd; 0 while it is out of the set
+        uint32_t interest{0};
+    };
+
+    static bool acceptsInput(const Connection& connection);
+
+    void acceptClients();
+    void readClient(uint64_t connection_id);
+    void parseRequests(uint64_t connection_id, Connection& connection);
+    void writeClient(uint64_t connection_id);
+    void closeClient(uint64_t connection_id);
+    void closeIfFinished(uint64_t connection_id);
+    void updateInterest(uint64_t connection_id, Connection& connection);
+    void drainCompletions();
+    void workerLoop();
+
+    RequestDispatcher dispatcher;
+    std::string socket_path;
+    unsigned worker_count;
+
+    int listen_fd{-1};
+    int epoll_fd{-1};
+    int wake_fd{-1};
+    bool owns_socket_file{false};
+    std::atomic<bool> stopping{false};
+
+    // Owned by the event loop thread
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t next_connection_id{2};
+
+    RequestQueue queue;
+
+    // Responses produced by workers, waiting for the event loop
+    std::mutex completed_mutex;
+    std::vector<std::pair<uint64_t, std::string>> completed;
+};
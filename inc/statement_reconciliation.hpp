@@ -0,0 +1,37 @@
+#pragma once
+
+#include "bank_reader.hpp"
+#include "commons.hpp"
+#include <cstddef>
+#include <optional>
+#include <span>
+
+// Outcome of checking a statement's lines against its balances
+struct ReconciliationReport
+{
+    // Opening balance plus every line equals the stated closing balance,
+    // and every stated running balance agrees with the lines before it
+    bool balanced{true};
+
+    // Opening balance plus the sum of the lines
+    long long expected_closing_paise{0};
+
+    // First line whose stated running balance differs from opening balance
+    // plus the lines up to and including it. Only known when the statement
+    // gives a running balance on every line.
+    std::optional<std::size_t> first_divergent_row;
+};
+
+// Reconcile amounts (credits positive) against the opening and closing
+// balances. running_balances_paise is either empty or aligned with
+// amounts_paise. Both checks are branch-free loops over the columns that
+// the compiler vectorises. Overflow when the expected closing balance does
+// not fit in a long long.
+commons::Result reconcileStatement(long long opening_paise,
+                                   long long closing_paise,
+                                   std::span<const long long> amounts_paise,
+                                   std::span<const long long> running_balances_paise,
+                                   ReconciliationReport* out_report);
+
+// Convenience overload over a parsed statement
+commons::Result reconcileStatement(const BankReader::BankAccountInfo& info, ReconciliationReport* out_report);
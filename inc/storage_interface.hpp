@@ -0,0 +1,341 @@
+#pragma once
+
+#include "bank_transaction.hpp"
+#include "category_matcher.hpp"
+#include "commons.hpp"
+#include "family.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class BankAccount;
+
+// One row of the streaming family/member/account join used by aggregate
+// reports. Families without members report member_id 0 and members without
+// accounts report bank_account_id 0; in both cases the balance is 0.
+struct AccountBalanceRow
+{
+    uint64_t family_id{0};
+    uint64_t member_id{0};
+    uint64_t bank_account_id{0};
+    uint64_t bank_id{0};
+    long long closing_balance_paise{0};
+};
+
+// Whose accounts a net-worth-over-time query covers
+enum class NetWorthScope
+{
+    Member,
+    Family,
+};
+
+// Cash flow of one calendar month, read from the pre-aggregated rollups.
+// Debits are reported as a positive outflow; months without transactions
+// are present with zero totals.
+struct CashFlowMonth
+{
+    commons::Month month;
+    long long credit_paise{0};
+    uint64_t credit_count{0};
+    long long debit_paise{0};
+    uint64_t debit_count{0};
+};
+
+// A parsed statement filed by StorageInterface::importStatementEx. The
+// statement goes to `bank_account_id`; when that is 0, to the member's
+// account at the bank whose number matches (see hasSameAccountNumber), or
+// to a new account built from the balances when there is none.
+struct StatementImport
+{
+    uint64_t bank_account_id{0};
+    uint64_t bank_id{0};
+    uint64_t member_id{0};
+    std::string account_number;
+    long long opening_paise{0};
+    long long closing_paise{0};
+    // Recorded in the balance history when the period end is known
+    std::optional<commons::Date> period_start;
+    std::optional<commons::Date> period_end;
+    std::span<const BankTransaction> transactions;
+};
+
+// One hit of a transaction search
+struct TransactionMatch
+{
+    uint64_t bank_account_id{0};
+    uint64_t member_id{0};
+    BankTransaction transaction;
+};
+
+// Plain rows returned by the arena (std::pmr) listing overloads. They are
+// allocator-aware, so a std::pmr::vector of rows puts its strings in the
+// same memory resource as the vector itself: a whole report is carved out
+// of a few large arena blocks and released at once with the arena.
+struct FamilyRow
+{
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    uint64_t id{0};
+    std::pmr::string name;
+
+    FamilyRow(uint64_t id, std::string_view name, allocator_type alloc = {})
+        : id(id), name(name, alloc) {}
+    FamilyRow(const FamilyRow& other, allocator_type alloc)
+        : id(other.id), name(other.name, alloc) {}
+    FamilyRow(FamilyRow&& other, allocator_type alloc)
+        : id(other.id), name(std::move(other.name), alloc) {}
+    FamilyRow(const FamilyRow&) = default;
+    FamilyRow(FamilyRow&&) noexcept = default;
+    FamilyRow& operator=(const FamilyRow&) = default;
+    FamilyRow& operator=(FamilyRow&&) = default;
+};
+
+struct MemberRow
+{
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    uint64_t id{0};
+    std::pmr::string name;
+    std::pmr::string nickname;
+
+    MemberRow(uint64_t id, std::string_view name, std::string_view nickname, allocator_type alloc = {})
+        : id(id), name(name, alloc), nickname(nickname, alloc) {}
+    MemberRow(const MemberRow& other, allocator_type alloc)
+        : id(other.id), name(other.name, alloc), nickname(other.nickname, alloc) {}
+    MemberRow(MemberRow&& other, allocator_type alloc)
+        : id(other.id), name(std::move(other.name), alloc), nickname(std::move(other.nickname), alloc) {}
+    MemberRow(const MemberRow&) = default;
+    MemberRow(MemberRow&&) noexcept = default;
+    MemberRow& operator=(const MemberRow&) = default;
+    MemberRow& operator=(MemberRow&&) = default;
+};
+
+struct BankAccountRow
+{
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    uint64_t id{0};
+    uint64_t bank_id{0};
+    uint64_t member_id{0};
+    std::pmr::string account_number;
+    long long opening_balance_paise{0};
+    long long closing_balance_paise{0};
+
+    BankAccountRow(uint64_t id, uint64_t bank_id, uint64_t member_id, std::string_view account_number,
+                   long long opening_balance_paise, long long closing_balance_paise, allocator_type alloc = {})
+        : id(id), bank_id(bank_id), member_id(member_id), account_number(account_number, alloc),
+          opening_balance_paise(opening_balance_paise), closing_balance_paise(closing_balance_paise) {}
+    BankAccountRow(const BankAccountRow& other, allocator_type alloc)
+        : BankAccountRow(other.id, other.bank_id, other.member_id, other.account_number,
+                         other.opening_balance_paise, other.closing_balance_paise, alloc) {}
+    BankAccountRow(BankAccountRow&& other, allocator_type alloc)
+        : id(other.id), bank_id(other.bank_id), member_id(other.member_id),
+          account_number(std::move(other.account_number), alloc),
+          opening_balance_paise(other.opening_balance_paise), closing_balance_paise(other.closing_balance_paise) {}
+    BankAccountRow(const BankAccountRow&) = default;
+    BankAccountRow(BankAccountRow&&) noexcept = default;
+    BankAccountRow& operator=(const BankAccountRow&) = default;
+    BankAccountRow& operator=(BankAccountRow&&) = default;
+};
+
+/**
+ * Abstract storage backend used by HomeManager and the domain services
+ * (NetWorth, ReaderFactory). StorageManager implements it on top of SQLite;
+ * MemoryStorage keeps everything in RAM for tests and simulations.
+ *
+ * Implementations must be safe to call from several threads at once.
+ */
+class StorageInterface
+{
+public:
+    virtual ~StorageInterface() = default;
+
+    // REQ-3: upper bound on the number of members in one family
+    static constexpr uint64_t kMaxFamilyMembers = 255;
+
+    // Insert a member into an existing family (REQ-3: at most 255 members)
+    virtual commons::Result saveMemberDataEx(const Member& member, const uint64_t family_id, uint64_t* out_member_id = nullptr) = 0;
+
+    // Insert a family together with any members it already holds
+    virtual commons::Result saveFamilyDataEx(const Family& family, uint64_t* out_family_id = nullptr) = 0;
+
+    // Heap-allocated lookups; the caller owns the returned object and
+    // nullptr means not found
+    virtual Member* getMemberData(const uint64_t& member_id) = 0;
+    virtual Family* getFamilyData(const uint64_t& family_id) = 0;
+
+    // Batched lookups: one query round-trip for the whole set of IDs. The
+    // output holds one entry per requested ID, in request order, with
+    // std::nullopt for IDs that do not exist. Returned entities carry their
+    // IDs (families include their members). Returns DbError on failure.
+    virtual commons::Result getMembersEx(std::span<const uint64_t> member_ids, std::vector<std::optional<Member>>* out_members) = 0;
+    virtual commons::Result getFamiliesEx(std::span<const uint64_t> family_ids, std::vector<std::optional<Family>>* out_families) = 0;
+    virtual commons::Result getBankAccountsEx(std::span<const uint64_t> bank_account_ids, std::vector<std::optional<BankAccount>>* out_accounts) = 0;
+
+    virtual commons::Result deleteMemberDataEx(const uint64_t& member_id) = 0;
+    virtual commons::Result deleteFamilyDataEx(const uint64_t& family_id) = 0;
+
+    // Delete several members in one transaction. `out_results` receives one
+    // entry per requested ID (Ok or NotFound; a repeated ID is NotFound after
+    // its first occurrence). Returns DbError, leaving nothing deleted, if the
+    // transaction fails.
+    virtual commons::Result deleteMembersEx(const std::vector<uint64_t>& member_ids, std::vector<commons::Result>* out_results) = 0;
+
+    virtual commons::Result updateFamilyDataEx(const uint64_t& family_id, const std::string& new_name) = 0;
+
+    // Empty strings leave the corresponding field unchanged; both empty is
+    // InvalidInput
+    virtual commons::Result updateMemberDataEx(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname) = 0;
+
+    // Listing helpers for UI, ordered by ID
+    virtual std::vector<Family> listFamilies() = 0;
+    virtual std::vector<Member> listMembersOfFamily(uint64_t family_id) = 0;
+
+    // Arena variants for bulk reports: the vector and every string in it are
+    // allocated from `arena` (typically a std::pmr::monotonic_buffer_resource
+    // that outlives the result). Empty on error.
+    virtual std::pmr::vector<FamilyRow> listFamilies(std::pmr::memory_resource* arena) = 0;
+    virtual std::pmr::vector<MemberRow> listMembersOfFamily(uint64_t family_id, std::pmr::memory_resource* arena) = 0;
+
+    // Persist a parsed bank-account row. Returns a commons::Result and
+    // optional out id of the inserted row.
+    virtual commons::Result saveBankAccountEx(uint64_t bank_id,
+                                              uint64_t member_id,
+                                              const std::string &account_number,
+                                              long long opening_paise,
+                                              long long closing_paise,
+                                              uint64_t* out_id = nullptr) = 0;
+
+    // Return the current number of members in a family. If `out_ok` is
+    // non-null it is set to false on failure (and 0 is returned).
+    virtual uint64_t getMemberCount(const uint64_t family_id, bool* out_ok = nullptr) = 0;
+
+    // Resolve a bank name (case-insensitive) to its Bank_ID, or NotFound
+    virtual commons::Result getBankIdByName(const std::string &bank_name, uint64_t* out_bank_id) = 0;
+
+    // Resolve a Bank_ID to its Bank_Name, or NotFound
+    virtual commons::Result getBankNameById(const uint64_t bank_id, std::string* out_name) = 0;
+
+    // Retrieve a bank account row by its BankAccount_ID, or NotFound
+    virtual commons::Result getBankAccountById(const uint64_t bank_account_id, BankAccount* out_row) = 0;
+
+    // All bank account rows of a member ordered by ID (empty on error)
+    virtual std::vector<BankAccount> listBankAccountsOfMember(const uint64_t member_id) = 0;
+    virtual std::pmr::vector<BankAccountRow> listBankAccountsOfMember(const uint64_t member_id, std::pmr::memory_resource* arena) = 0;
+
+    // Stream every family in [first_family_id, last_family_id] joined with its
+    // members and their bank accounts, ordered by Family_ID, Member_ID and
+    // BankAccount_ID. The visitor is called once per row on the calling
+    // thread.
+    using AccountBalanceVisitor = std::function<void(const AccountBalanceRow&)>;
+    virtual commons::Result visitAccountBalances(const uint64_t first_family_id,
+                                                 const uint64_t last_family_id,
+                                                 const AccountBalanceVisitor& visitor) = 0;
+
+    // Smallest and largest Family_ID currently stored, or NotFound when there
+    // are no families
+    virtual commons::Result getFamilyIdRange(uint64_t* out_first_family_id, uint64_t* out_last_family_id) = 0;
+
+    // Balance history: one snapshot per account per statement period, keyed
+    // by (account, period end). Saving a period again replaces it. When the
+    // period is the account's latest, the BankAccounts balances follow it.
+    virtual commons::Result saveBalanceSnapshotEx(const uint64_t bank_account_id,
+                                                  const std::optional<commons::Date>& period_start,
+                                                  const commons::Date& period_end,
+                                                  long long opening_paise,
+                                                  long long closing_paise) = 0;
+
+    // Net worth of a member or family as of each date: the sum over their
+    // accounts of the closing balance of each account's latest snapshot
+    // ending on or before that date (0 for accounts with none). Totals are
+    // aligned with as_of_dates. NotFound when the member/family does not
+    // exist; Overflow when a total does not fit.
+    virtual commons::Result getNetWorthAsOfEx(const NetWorthScope scope,
+                                              const uint64_t scope_id,
+                                              std::span<const commons::Date> as_of_dates,
+                                              std::vector<long long>* out_totals_paise) = 0;
+
+    // Statement lines of an account. Each insert also folds the amount into
+    // the (member, month, account) cash-flow rollup, so month-range queries
+    // never scan raw transactions. Lines already stored for the account (see
+    // transactionFingerprints) are skipped and counted in out_duplicates, so
+    // overlapping statements can be imported safely. Each saved line is
+    // categorised with the current rules; any category_id passed in is
+    // ignored. NotFound when the account does not exist.
+    virtual commons::Result saveTransactionsEx(const uint64_t bank_account_id,
+                                               std::span<const BankTransaction> transactions,
+                                               uint64_t* out_duplicates = nullptr) = 0;
+
+    // File a whole statement in one transaction: create the account if
+    // needed, save the balance snapshot (see saveBalanceSnapshotEx) and the
+    // lines (see saveTransactionsEx). Without a period end, an existing
+    // account simply takes the statement's balances. Nothing is stored when
+    // any step fails.
+    virtual commons::Result importStatementEx(const StatementImport& statement,
+                                              uint64_t* out_bank_account_id = nullptr,
+                                              uint64_t* out_duplicates = nullptr) = 0;
+
+    // Monthly cash flow of a member or family for [first_month, last_month],
+    // one entry per month in order. NotFound when the member/family does not
+    // exist; InvalidInput when the range is reversed.
+    virtual commons::Result getCashFlowEx(const NetWorthScope scope,
+                                          const uint64_t scope_id,
+                                          const commons::Month& first_month,
+                                          const commons::Month& last_month,
+                                          std::vector<CashFlowMonth>* out_months) = 0;
+
+    // Recompute every rollup from the raw transactions
+    virtual commons::Result rebuildCashFlowRollupsEx() = 0;
+
+    // Compare the rollups with a fresh aggregation of the raw transactions;
+    // out_mismatched_rows is the number of (member, month, account) rows
+    // that differ or are missing on either side (0 when consistent).
+    virtual commons::Result checkCashFlowRollupsEx(uint64_t* out_mismatched_rows) = 0;
+
+    // Transactions whose narration or counterparty contains every word of
+    // `text` (a word matches any token it prefixes, case-insensitively;
+    // see commons::searchTokens). Newest first, then by account, at most
+    // `limit` rows. Text without any word matches nothing.
+    virtual commons::Result searchTransactionsEx(const std::string& text,
+                                                 std::size_t limit,
+                                                 std::vector<TransactionMatch>* out_matches) = 0;
+
+    // Add a keyword rule, creating its category when none has that name
+    // (names compare case-insensitively). InvalidInput when the name or the
+    // keyword contains no words. Existing transactions keep their category
+    // until recategorizeTransactionsEx runs.
+    virtual commons::Result saveCategoryRuleEx(const std::string& category_name,
+                                               const std::string& keyword,
+                                               int priority,
+                                               uint64_t* out_rule_id = nullptr) = 0;
+
+    // Add a batch of rules in one write transaction; rules[i] goes under the
+    // category named category_names[i] (category_id is ignored). A rule
+    // whose category already has a keyword with the same search tokens only
+    // takes the new priority, so loading a rules file twice adds nothing.
+    // InvalidInput (nothing saved) when the spans differ in length or any
+    // name or keyword contains no words. out_added counts the new rules.
+    virtual commons::Result saveCategoryRulesEx(std::span<const std::string> category_names,
+                                                std::span<const CategoryRule> rules,
+                                                uint64_t* out_added = nullptr) = 0;
+
+    // Remove a rule, or NotFound
+    virtual commons::Result deleteCategoryRuleEx(const uint64_t rule_id) = 0;
+
+    // Categories by ascending ID, and rules by ascending Rule_ID
+    virtual commons::Result listCategoriesEx(std::vector<TransactionCategory>* out_categories) = 0;
+    virtual commons::Result listCategoryRulesEx(std::vector<CategoryRule>* out_rules) = 0;
+
+    // Re-apply the current rules to transactions categorised under an older
+    // rule set. Rows are handled `batch_size` per write transaction, so
+    // imports can interleave and an interrupted run resumes where it
+    // stopped. out_changed counts rows whose category changed.
+    virtual commons::Result recategorizeTransactionsEx(std::size_t batch_size, uint64_t* out_changed = nullptr) = 0;
+};
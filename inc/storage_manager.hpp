@@ -1,49 +1,77 @@
 #pragma once
 
+#include "bloom_filter.hpp"
 #include "commons.hpp"
 #include "family.hpp"
+#include "storage_interface.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
 #include <string>
 #include <cstdint>
 
 // forward-declare sqlite3 from the sqlite3 C API
 struct sqlite3;
 
-class StorageManager 
+// StorageManager is the SQLite implementation of StorageInterface and is
+// safe to share between threads. Writes are serialised on a single
+// read/write connection while reads check out one of a small pool of
+// read-only connections. The database runs in WAL mode so readers never
+// block the writer (and vice versa).
+class StorageManager : public StorageInterface
 {
 public:
     StorageManager();
     virtual ~StorageManager();
 
+    // Current schema version, stored in PRAGMA user_version. Bump it together
+    // with a new step in the migration table in storage_manager.cpp.
+    static constexpr int kSchemaVersion = 7;
+
+    // Open the database and migrate its schema if user_version is behind.
+    // Calling it again once connected is a no-op.
     bool initializeDatabase(const std::string& dbPath);
 
+    // PRAGMA user_version of the connected database, or -1 if not connected
+    int getSchemaVersion();
+
     // Backwards-compatible boolean wrappers are kept; prefer the Ex versions
     bool saveMemberData(const Member& member, const uint64_t family_id);
     bool saveFamilyData(const Family& family);
 
     // Extended APIs that return a Result code and optionally an out id
-    commons::Result saveMemberDataEx(const Member& member, const uint64_t family_id, uint64_t* out_member_id = nullptr);
-    commons::Result saveFamilyDataEx(const Family& family, uint64_t* out_family_id = nullptr);
+    commons::Result saveMemberDataEx(const Member& member, const uint64_t family_id, uint64_t* out_member_id = nullptr) override;
+    commons::Result saveFamilyDataEx(const Family& family, uint64_t* out_family_id = nullptr) override;
+
+    Member* getMemberData(const uint64_t& member_id) override;
+    Family* getFamilyData(const uint64_t& family_id) override;
 
-    Member* getMemberData(const uint64_t& member_id);
-    Family* getFamilyData(const uint64_t& family_id);
+    // Batched lookups (see StorageInterface); IDs are sent as chunked IN-lists
+    commons::Result getMembersEx(std::span<const uint64_t> member_ids, std::vector<std::optional<Member>>* out_members) override;
+    commons::Result getFamiliesEx(std::span<const uint64_t> family_ids, std::vector<std::optional<Family>>* out_families) override;
+    commons::Result getBankAccountsEx(std::span<const uint64_t> bank_account_ids, std::vector<std::optional<BankAccount>>* out_accounts) override;
 
     // Update operations (boolean wrappers)
     bool updateFamilyData(const uint64_t& family_id, const std::string& new_name);
     bool updateMemberData(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname);
 
     // Extended delete/update APIs returning Result codes
-    commons::Result deleteMemberDataEx(const uint64_t& member_id);
-    commons::Result deleteFamilyDataEx(const uint64_t& family_id);
+    commons::Result deleteMemberDataEx(const uint64_t& member_id) override;
+    commons::Result deleteFamilyDataEx(const uint64_t& family_id) override;
+    commons::Result deleteMembersEx(const std::vector<uint64_t>& member_ids, std::vector<commons::Result>* out_results) override;
 
-    commons::Result updateFamilyDataEx(const uint64_t& family_id, const std::string& new_name);
-    commons::Result updateMemberDataEx(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname);
+    commons::Result updateFamilyDataEx(const uint64_t& family_id, const std::string& new_name) override;
+    commons::Result updateMemberDataEx(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname) override;
 
     bool deleteMemberData(const uint64_t& member_id);
     bool deleteFamilyData(const uint64_t& family_id);
 
     // Listing helpers for UI
-    std::vector<Family> listFamilies();
-    std::vector<Member> listMembersOfFamily(uint64_t family_id);
+    std::vector<Family> listFamilies() override;
+    std::vector<Member> listMembersOfFamily(uint64_t family_id) override;
+    std::pmr::vector<FamilyRow> listFamilies(std::pmr::memory_resource* arena) override;
+    std::pmr::vector<MemberRow> listMembersOfFamily(uint64_t family_id, std::pmr::memory_resource* arena) override;
     
     // Persist a parsed bank-account row into BankAccounts. Returns a
     // commons::Result and optional out id of the inserted BankAccount row.
@@ -52,7 +80,7 @@ public:
                                       const std::string &account_number,
                                       long long opening_paise,
                                       long long closing_paise,
-                                      uint64_t* out_id = nullptr);
+                                      uint64_t* out_id = nullptr) override;
 
     // Backwards-compatible boolean wrapper
     bool saveBankAccount(uint64_t bank_id,
@@ -62,6 +90,8 @@ public:
                          long long closing_paise);
     
     // Efficient helper: return the current number of members in a family.
+    // Reads FamilyInfo.Member_Count, which triggers keep in step with
+    // MemberInfo, so no rows are counted.
     //
     // Note on types: SQLite exposes integer results as 64-bit values and many
     // APIs in this codebase use 64-bit IDs/counts for consistency with the DB
@@ -74,16 +104,16 @@ public:
     // The function returns the raw count; if `out_ok` is non-null it will be
     // set to true on success and false on failure. On failure the returned
     // value is undefined (0 is returned).
-    uint64_t getMemberCount(const uint64_t family_id, bool* out_ok = nullptr);
+    uint64_t getMemberCount(const uint64_t family_id, bool* out_ok = nullptr) override;
 
     // Resolve a bank name (case-insensitive) to its Bank_ID. Returns
     // commons::Result::Ok and writes to out_bank_id on success, or
     // commons::Result::NotFound when no match exists.
-    commons::Result getBankIdByName(const std::string &bank_name, uint64_t* out_bank_id);
+    commons::Result getBankIdByName(const std::string &bank_name, uint64_t* out_bank_id) override;
 
     // Resolve a Bank_ID to its Bank_Name. Returns Ok and writes to out_name
     // when found, NotFound when the id does not exist, or DbError on DB errors.
-    commons::Result getBankNameById(const uint64_t bank_id, std::string* out_name);
+    commons::Result getBankNameById(const uint64_t bank_id, std::string* out_name) override;
 
     // Use the dedicated BankAccount value/type for persisted bank-account rows
     // (defined in `inc/bank_account.hpp`). The class is fully encapsulated
@@ -92,27 +122,179 @@ public:
     // Retrieve a bank account row by its BankAccount_ID. Returns Ok and
     // populates out_row on success, NotFound when the id does not exist,
     // or DbError on DB errors.
-    commons::Result getBankAccountById(const uint64_t bank_account_id, class BankAccount* out_row);
+    commons::Result getBankAccountById(const uint64_t bank_account_id, BankAccount* out_row) override;
 
     // List all bank account rows that belong to a member. Returns an empty
     // vector on error or when no accounts exist. Prefer using the
     // Result-returning `getBankAccountById` for single-row access; this is a
     // convenience helper used by higher-level features like NetWorth.
-    std::vector<BankAccount> listBankAccountsOfMember(const uint64_t member_id);
+    std::vector<BankAccount> listBankAccountsOfMember(const uint64_t member_id) override;
+    std::pmr::vector<BankAccountRow> listBankAccountsOfMember(const uint64_t member_id, std::pmr::memory_resource* arena) override;
+
+    // Streaming family/member/account join for aggregate reports (see
+    // StorageInterface). Returns Ok, or DbError on DB failures.
+    commons::Result visitAccountBalances(const uint64_t first_family_id,
+                                         const uint64_t last_family_id,
+                                         const AccountBalanceVisitor& visitor) override;
+
+    // Smallest and largest Family_ID currently stored. Returns NotFound when
+    // there are no families.
+    commons::Result getFamilyIdRange(uint64_t* out_first_family_id, uint64_t* out_last_family_id) override;
+
+    commons::Result saveBalanceSnapshotEx(const uint64_t bank_account_id,
+                                          const std::optional<commons::Date>& period_start,
+                                          const commons::Date& period_end,
+                                          long long opening_paise,
+                                          long long closing_paise) override;
+
+    commons::Result getNetWorthAsOfEx(const NetWorthScope scope,
+                                      const uint64_t scope_id,
+                                      std::span<const commons::Date> as_of_dates,
+                                      std::vector<long long>* out_totals_paise) override;
+
+    commons::Result saveTransactionsEx(const uint64_t bank_account_id,
+                                       std::span<const BankTransaction> transactions,
+                                       uint64_t* out_duplicates = nullptr) override;
+
+    commons::Result importStatementEx(const StatementImport& statement,
+                                      uint64_t* out_bank_account_id = nullptr,
+                                      uint64_t* out_duplicates = nullptr) override;
+
+    commons::Result getCashFlowEx(const NetWorthScope scope,
+                                  const uint64_t scope_id,
+                                  const commons::Month& first_month,
+                                  const commons::Month& last_month,
+                                  std::vector<CashFlowMonth>* out_months) override;
+
+    commons::Result rebuildCashFlowRollupsEx() override;
+
+    commons::Result checkCashFlowRollupsEx(uint64_t* out_mismatched_rows) override;
+
+    commons::Result searchTransactionsEx(const std::string& text,
+                                         std::size_t limit,
+                                         std::vector<TransactionMatch>* out_matches) override;
+
+    commons::Result saveCategoryRuleEx(const std::string& category_name,
+                                       const std::string& keyword,
+                                       int priority,
+                                       uint64_t* out_rule_id = nullptr) override;
+
+    commons::Result saveCategoryRulesEx(std::span<const std::string> category_names,
+                                        std::span<const CategoryRule> rules,
+                                        uint64_t* out_added = nullptr) override;
+
+    commons::Result deleteCategoryRuleEx(const uint64_t rule_id) override;
+
+    commons::Result listCategoriesEx(std::vector<TransactionCategory>* out_categories) override;
+
+    commons::Result listCategoryRulesEx(std::vector<CategoryRule>* out_rules) override;
+
+    commons::Result recategorizeTransactionsEx(std::size_t batch_size, uint64_t* out_changed = nullptr) override;
+
+    // Upper bound on the number of read-only connections kept in the pool.
+    // Must be called before the first read to take effect. 0 disables the
+    // pool so reads share the writer connection (one connection per process).
+    void setMaxReadConnections(std::size_t max_connections);
 
 private:
-    // Owned SQLite connection handle (nullptr when not connected)
+    // RAII lease on a read connection. Checks a handle out of the pool on
+    // construction and returns it on destruction. When no read-only handle
+    // can be opened (for example for ":memory:" databases) the lease falls
+    // back to the writer connection and holds the write lock instead.
+    class ReadConnection
+    {
+    public:
+        explicit ReadConnection(StorageManager& owner);
+        ~ReadConnection();
+
+        ReadConnection(const ReadConnection&) = delete;
+        ReadConnection& operator=(const ReadConnection&) = delete;
+
+        sqlite3* get() const { return handle; }
+
+    private:
+        StorageManager& owner;
+        sqlite3* handle{nullptr};
+        bool pooled{false};
+        std::unique_lock<std::recursive_mutex> writer_lock;
+    };
+
+    // Owned SQLite writer connection handle (nullptr when not connected)
     sqlite3* db_handle{nullptr};
 
     // Whether `connect` has been successfully called and a valid handle is present
-    bool connected{false};
+    std::atomic<bool> connected{false};
+
+    // Path of the connected database; read connections are opened against it
+    std::string db_path;
+
+    // Serialises initialisation/teardown of the connections
+    std::mutex init_mutex;
+
+    // Serialises every statement executed on the writer connection. It is
+    // recursive because boolean wrappers delegate to their *Ex variants.
+    std::recursive_mutex write_mutex;
+
+    // Read connection pool: every opened handle lives in `read_pool`, the
+    // ones currently not leased are also listed in `idle_readers`.
+    std::mutex pool_mutex;
+    std::condition_variable pool_cv;
+    std::vector<sqlite3*> read_pool;
+    std::vector<sqlite3*> idle_readers;
+    std::size_t max_read_connections{4};
+
+    // Fingerprints of stored transactions, loaded on the first import and
+    // kept current by saveTransactionsEx. Guarded by write_mutex.
+    commons::BloomFilter transaction_filter;
+    bool transaction_filter_loaded{false};
+
+    // Automaton for the rule set at category_rules_version (-1: none yet).
+    // Recompiled when the stored version moves on. Guarded by write_mutex.
+    CategoryMatcher category_matcher;
+    long long category_rules_version{-1};
 
-    // Connect to the database
+    // Check a read-only connection out of the pool (opening a new one if the
+    // pool is not full yet). Returns nullptr when none can be opened.
+    sqlite3* acquireReadConnection();
+
+    // Return a connection obtained from acquireReadConnection to the pool
+    void releaseReadConnection(sqlite3* handle);
+
+    // Open the writer connection. `connected` is left for initializeDatabase
+    // to set once the schema has been migrated.
     bool connect(const std::string& connectionString);
 
     // Disconnect from the database
     void disconnect();
 
-    // Ensure DB file and tables exist at the provided path
-    void dbInit(const std::string& dbPath);
+    // Apply pending schema migrations on the writer connection
+    bool dbInit();
+
+    // Bodies of saveBankAccountEx, saveBalanceSnapshotEx and
+    // saveTransactionsEx, run with the write lock held so importStatementEx
+    // can chain them in one transaction. Input is already validated.
+    commons::Result insertBankAccount(uint64_t bank_id,
+                                      uint64_t member_id,
+                                      const std::string &account_number,
+                                      long long opening_paise,
+                                      long long closing_paise,
+                                      uint64_t* out_id);
+    commons::Result insertBalanceSnapshot(const uint64_t bank_account_id,
+                                          const std::optional<commons::Date>& period_start,
+                                          const commons::Date& period_end,
+                                          long long opening_paise,
+                                          long long closing_paise);
+    commons::Result insertTransactions(const uint64_t bank_account_id,
+                                       std::span<const BankTransaction> transactions,
+                                       uint64_t* out_duplicates);
+
+    // Account importStatementEx files a statement without an account ID
+    // under (0 when it needs a new one); write transaction held
+    commons::Result findStatementAccount(const StatementImport& statement, uint64_t* out_id);
+
+    // Fill transaction_filter from the database (write lock held)
+    bool loadTransactionFilter();
+
+    // Bring category_matcher up to the stored rule version (write lock held)
+    bool loadCategoryMatcher();
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace commons
+{
+    // Small integer standing in for an interned name
+    using NameHandle = uint32_t;
+
+    /**
+     * Append-only table of distinct strings addressed by NameHandle.
+     *
+     * Each distinct string is stored once; equal names get equal handles, so
+     * grouping or comparing by name is an integer operation. Strings live in
+     * a deque, which never relocates its elements, so views stay valid for
+     * the lifetime of the table (or until clear()).
+     *
+     * Not synchronized: callers serialize intern()/clear() against readers.
+     */
+    class StringInterner
+    {
+    public:
+        // Handle of the empty string, present in every table
+        static constexpr NameHandle kEmpty = 0;
+
+        StringInterner();
+
+        // The map keys view the stored strings, so a copy would point into
+        // the source. Moving hands the deque's blocks over without relocating
+        // any string; a moved-from table must be clear()ed before reuse.
+        StringInterner(const StringInterner&) = delete;
+        StringInterner& operator=(const StringInterner&) = delete;
+        StringInterner(StringInterner&&) = default;
+        StringInterner& operator=(StringInterner&&) = default;
+
+        // Handle for `text`, adding it on first use
+        NameHandle intern(std::string_view text);
+
+        // Handle for `text` if it has been interned
+        std::optional<NameHandle> find(std::string_view text) const;
+
+        // Text of a handle returned by this table
+        std::string_view view(NameHandle handle) const { return strings[handle]; }
+
+        // Number of distinct strings, including the empty string
+        std::size_t size() const { return strings.size(); }
+
+        // Drop every string except the empty one; invalidates views
+        void clear();
+
+    private:
+        std::deque<std::string> strings;
+        std::unordered_map<std::string_view, NameHandle> handles;
+    };
+}
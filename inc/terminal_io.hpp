@@ -1,14 +1,38 @@
 #pragma once
 
 #include "io_interface.hpp"
+#include <cstddef>
+#include <string>
 
 /**
  * Standard terminal I/O implementation using cout/cin.
+ *
+ * In Buffered mode printLine/printLines append to an internal buffer that is
+ * written out in one go before reading input, before printing an error, on
+ * flush(), on destruction and whenever it grows past kFlushThreshold.
  */
 class TerminalIO : public IOInterface 
 {
 public:
+    enum class OutputMode
+    {
+        Immediate,  // flush stdout after every line
+        Buffered    // batch lines and flush at explicit points
+    };
+
+    // Buffered output is flushed once this many bytes are pending
+    static constexpr std::size_t kFlushThreshold = 64 * 1024;
+
+    explicit TerminalIO(OutputMode mode = OutputMode::Immediate);
+    ~TerminalIO() override;
+
     void printLine(const std::string& line) override;
+    void printLines(std::span<const std::string> lines) override;
     void printError(const std::string& error) override;
+    void flush() override;
     bool getLine(std::string& line) override;
+
+private:
+    OutputMode mode;
+    std::string out_buffer;
 };
@@ -32,7 +32,9 @@ public:
         ImportBankStatement = 9,
         ComputeMemberNetWorth = 10,
         ComputeFamilyNetWorth = 11,
-        Exit = 12
+        HouseholdNetWorthReport = 12,
+        SearchTransactions = 13,
+        Exit = 14
     };
 
     commons::Result addFamily(const std::string& name) override;
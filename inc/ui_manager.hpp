@@ -29,7 +29,7 @@ public:
     // This is implemented in the base class so derived classes can reuse it.
     void showError(const commons::Result& res);
 
-protected:
-    // Translate an error code to a human-friendly message.
+    // Translate an error code to a human-friendly message. Public so the
+    // headless protocols can report the same text.
     static std::string errorMessage(const commons::Result& res);
 };
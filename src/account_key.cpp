@@ -0,0 +1,144 @@
+#include "account_key.hpp"
+#include <cctype>
+
+namespace
+{
+    constexpr unsigned kBitsPerChar = 6;
+    constexpr uint64_t kCharMask = (uint64_t{1} << kBitsPerChar) - 1;
+
+    // 0 marks an unused slot, so every packed character has a non-zero code
+    constexpr std::string_view kAlphabet = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ/._";
+
+    /**
+     * @brief Map an upper-cased character to its 6-bit code.
+     *
+     * @param ch Character to encode.
+     * @return uint64_t Code in [1, kAlphabet.size()], or 0 if unsupported.
+     */
+    uint64_t encodeChar(unsigned char ch)
+    {
+        if (ch >= '0' && ch <= '9')
+        {
+            return static_cast<uint64_t>(ch - '0') + 1;
+        }
+
+        if (ch >= 'A' && ch <= 'Z')
+        {
+            return static_cast<uint64_t>(ch - 'A') + 11;
+        }
+
+        std::size_t position = kAlphabet.find(static_cast<char>(ch), 36);
+        return position == std::string_view::npos ? 0 : static_cast<uint64_t>(position) + 1;
+    }
+
+    /**
+     * @brief Finalizer from SplitMix64, used to spread the packed bits.
+     *
+     * @param value Value to mix.
+     * @return uint64_t
+     */
+    uint64_t mix64(uint64_t value)
+    {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ull;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBull;
+        value ^= value >> 31;
+        return value;
+    }
+}
+
+/**
+ * @brief Normalize and pack an account number in a single pass.
+ *
+ * @param raw Account number as printed on the statement.
+ * @return std::optional<AccountKey> Packed key, or std::nullopt if it does not fit.
+ */
+std::optional<AccountKey> AccountKey::fromAccountNumber(std::string_view raw)
+{
+    AccountKey key;
+    std::size_t length = 0;
+
+    for (unsigned char ch : raw)
+    {
+        if (ch == ' ' || ch == '-' || ch == '\t')
+        {
+            continue;
+        }
+
+        uint64_t code = encodeChar(static_cast<unsigned char>(std::toupper(ch)));
+
+        if (code == 0 || length == kMaxLength)
+        {
+            return std::nullopt;
+        }
+
+        // First character in the high bits so words compare like the text
+        std::size_t slot = length % kCharsPerWord;
+        key.words[length / kCharsPerWord] |= code << ((kCharsPerWord - 1 - slot) * kBitsPerChar);
+        ++length;
+    }
+
+    uint64_t hash_value = 0;
+
+    for (uint64_t word : key.words)
+    {
+        hash_value = mix64(hash_value ^ word);
+    }
+
+    key.hash_value = hash_value;
+    return key;
+}
+
+/**
+ * @brief Unpack the normalized account number.
+ *
+ * @return std::string
+ */
+std::string AccountKey::toString() const
+{
+    std::string out;
+    out.reserve(kMaxLength);
+
+    for (uint64_t word : words)
+    {
+        for (std::size_t slot = 0; slot < kCharsPerWord; ++slot)
+        {
+            uint64_t code = (word >> ((kCharsPerWord - 1 - slot) * kBitsPerChar)) & kCharMask;
+
+            if (code == 0)
+            {
+                return out;
+            }
+
+            out.push_back(kAlphabet[code - 1]);
+        }
+    }
+
+    return out;
+}
+
+/**
+ * @brief Number of characters in the normalized account number.
+ *
+ * @return std::size_t
+ */
+std::size_t AccountKey::length() const
+{
+    std::size_t count = 0;
+
+    for (uint64_t word : words)
+    {
+        for (std::size_t slot = 0; slot < kCharsPerWord; ++slot)
+        {
+            if (((word >> ((kCharsPerWord - 1 - slot) * kBitsPerChar)) & kCharMask) == 0)
+            {
+                return count;
+            }
+
+            ++count;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,276 @@
+#include "analytics_snapshot.hpp"
+
+#include <algorithm>
+#include <span>
+#include <unordered_map>
+
+namespace
+{
+    /**
+     * @brief Sum each contiguous run of `values` delimited by `offsets`.
+     *
+     * Every run goes through CheckedAccumulator::addAll, whose inner loop
+     * auto-vectorises.
+     *
+     * @param values Column to aggregate.
+     * @param offsets Run boundaries (size = run count + 1).
+     * @param out_totals Receives one total per run.
+     * @return commons::Result Overflow if any run does not fit.
+     */
+    commons::Result segmentedTotals(const std::vector<long long>& values,
+                                    const std::vector<std::size_t>& offsets,
+                                    std::vector<long long>* out_totals)
+    {
+        std::size_t group_count = offsets.empty() ? 0 : offsets.size() - 1;
+        std::span<const long long> column(values);
+        commons::Result result = commons::Result::Ok;
+        out_totals->assign(group_count, 0);
+
+        for (std::size_t group = 0; group < group_count; ++group)
+        {
+            commons::CheckedAccumulator total;
+            total.addAll(column.subspan(offsets[group], offsets[group + 1] - offsets[group]));
+
+            if (total.toPaise(&(*out_totals)[group]) != commons::Result::Ok)
+            {
+                result = commons::Result::Overflow;
+            }
+        }
+
+        return result;
+    }
+}
+
+/**
+ * @brief Reset the snapshot to an empty state.
+ */
+void AnalyticsSnapshot::clear()
+{
+    family_ids.clear();
+    family_member_offsets.clear();
+    family_account_offsets.clear();
+    member_ids.clear();
+    member_family_index.clear();
+    member_account_offsets.clear();
+    account_ids.clear();
+    account_bank_index.clear();
+    closing_balances_paise.clear();
+    bank_ids.clear();
+}
+
+/**
+ * @brief Load all families, members and accounts into the columns.
+ *
+ * @param storage Backend to read from.
+ * @return commons::Result The snapshot is left empty on failure.
+ */
+commons::Result AnalyticsSnapshot::load(StorageInterface* storage)
+{
+    clear();
+
+    if (!storage)
+    {
+        return commons::Result::DbError;
+    }
+
+    uint64_t first_family_id = 0;
+    uint64_t last_family_id = 0;
+    commons::Result res = storage->getFamilyIdRange(&first_family_id, &last_family_id);
+
+    if (res == commons::Result::NotFound)
+    {
+        return commons::Result::Ok;
+    }
+
+    if (res != commons::Result::Ok)
+    {
+        return res;
+    }
+
+    // Bank indexes are handed out in order of first appearance and renumbered
+    // to ascending Bank_ID once every account has been seen
+    std::unordered_map<uint64_t, uint32_t> bank_index_by_id;
+
+    auto visitor = [&](const AccountBalanceRow& row)
+    {
+        if (family_ids.empty() || family_ids.back() != row.family_id)
+        {
+            family_ids.push_back(row.family_id);
+            family_member_offsets.push_back(member_ids.size());
+            family_account_offsets.push_back(account_ids.size());
+        }
+
+        if (row.member_id == 0)
+        {
+            return;
+        }
+
+        if (member_ids.size() == family_member_offsets.back() || member_ids.back() != row.member_id)
+        {
+            member_ids.push_back(row.member_id);
+            member_family_index.push_back(static_cast<uint32_t>(family_ids.size() - 1));
+            member_account_offsets.push_back(account_ids.size());
+        }
+
+        if (row.bank_account_id == 0)
+        {
+            return;
+        }
+
+        auto [bank, inserted] = bank_index_by_id.try_emplace(row.bank_id, static_cast<uint32_t>(bank_ids.size()));
+
+        if (inserted)
+        {
+            bank_ids.push_back(row.bank_id);
+        }
+
+        account_ids.push_back(row.bank_account_id);
+        account_bank_index.push_back(bank->second);
+        closing_balances_paise.push_back(row.closing_balance_paise);
+    };
+
+    res = storage->visitAccountBalances(first_family_id, last_family_id, visitor);
+
+    if (res != commons::Result::Ok)
+    {
+        clear();
+        return res;
+    }
+
+    family_member_offsets.push_back(member_ids.size());
+    family_account_offsets.push_back(account_ids.size());
+    member_account_offsets.push_back(account_ids.size());
+
+    std::vector<uint64_t> sorted_bank_ids = bank_ids;
+    std::sort(sorted_bank_ids.begin(), sorted_bank_ids.end());
+    std::vector<uint32_t> renumbered(bank_ids.size());
+
+    for (std::size_t index = 0; index < bank_ids.size(); ++index)
+    {
+        auto position = std::lower_bound(sorted_bank_ids.begin(), sorted_bank_ids.end(), bank_ids[index]);
+        renumbered[index] = static_cast<uint32_t>(position - sorted_bank_ids.begin());
+    }
+
+    for (uint32_t &bank_index : account_bank_index)
+    {
+        bank_index = renumbered[bank_index];
+    }
+
+    bank_ids = std::move(sorted_bank_ids);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Total closing balance per family (aligned with family_ids).
+ *
+ * @param out_totals_paise Receives one total per family.
+ * @return commons::Result
+ */
+commons::Result AnalyticsSnapshot::totalsByFamily(std::vector<long long>* out_totals_paise) const
+{
+    if (!out_totals_paise)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    return segmentedTotals(closing_balances_paise, family_account_offsets, out_totals_paise);
+}
+
+/**
+ * @brief Total closing balance per member (aligned with member_ids).
+ *
+ * @param out_totals_paise Receives one total per member.
+ * @return commons::Result
+ */
+commons::Result AnalyticsSnapshot::totalsByMember(std::vector<long long>* out_totals_paise) const
+{
+    if (!out_totals_paise)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    return segmentedTotals(closing_balances_paise, member_account_offsets, out_totals_paise);
+}
+
+/**
+ * @brief Total closing balance per bank (aligned with bank_ids).
+ *
+ * Banks are scattered through the account column, so this scatters into
+ * per-bank lanes instead. Like CheckedAccumulator::addAll, each value is
+ * split into a low and a high 32-bit half summed in separate 64-bit lanes,
+ * which cannot wrap within a block of 2^31 accounts; blocks are folded into
+ * 128-bit totals.
+ *
+ * @param out_totals_paise Receives one total per bank.
+ * @return commons::Result
+ */
+commons::Result AnalyticsSnapshot::totalsByBank(std::vector<long long>* out_totals_paise) const
+{
+    if (!out_totals_paise)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    constexpr std::size_t block_size = std::size_t{1} << 31;
+    std::vector<commons::WideInt> wide_totals(bank_ids.size(), 0);
+    std::vector<uint64_t> low_sums(bank_ids.size());
+    std::vector<int64_t> high_sums(bank_ids.size());
+
+    for (std::size_t offset = 0; offset < closing_balances_paise.size(); offset += block_size)
+    {
+        std::size_t block_end = std::min(closing_balances_paise.size(), offset + block_size);
+        std::fill(low_sums.begin(), low_sums.end(), 0);
+        std::fill(high_sums.begin(), high_sums.end(), 0);
+
+        for (std::size_t account = offset; account < block_end; ++account)
+        {
+            long long value = closing_balances_paise[account];
+            uint32_t bank = account_bank_index[account];
+            low_sums[bank] += static_cast<uint64_t>(value) & 0xFFFFFFFFu;
+            high_sums[bank] += static_cast<int64_t>(value) >> 32;
+        }
+
+        for (std::size_t bank = 0; bank < bank_ids.size(); ++bank)
+        {
+            wide_totals[bank] += static_cast<commons::WideInt>(high_sums[bank]) * (commons::WideInt{1} << 32) +
+                                 static_cast<commons::WideInt>(low_sums[bank]);
+        }
+    }
+
+    commons::Result result = commons::Result::Ok;
+    out_totals_paise->assign(bank_ids.size(), 0);
+
+    for (std::size_t bank = 0; bank < bank_ids.size(); ++bank)
+    {
+        commons::WideInt total = wide_totals[bank];
+        long long& out_total = (*out_totals_paise)[bank];
+
+        if (total > std::numeric_limits<long long>::max())
+        {
+            out_total = std::numeric_limits<long long>::max();
+            result = commons::Result::Overflow;
+        }
+        else if (total < std::numeric_limits<long long>::min())
+        {
+            out_total = std::numeric_limits<long long>::min();
+            result = commons::Result::Overflow;
+        }
+        else
+        {
+            out_total = static_cast<long long>(total);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Total closing balance over every account.
+ *
+ * @param out_total_paise Receives the total.
+ * @return commons::Result
+ */
+commons::Result AnalyticsSnapshot::householdTotal(long long* out_total_paise) const
+{
+    return commons::sumPaise(closing_balances_paise, out_total_paise);
+}
@@ -4,6 +4,7 @@
 #include <sqlite3.h>
 #include <algorithm>
 #include <cctype>
+#include <utility>
 
 /**
  * @brief Construct a new Bank Account:: Bank Account object
@@ -24,13 +25,14 @@ BankAccount::BankAccount() = default;
 BankAccount::BankAccount(uint64_t bankAccountId,
                          uint64_t bankId,
                          uint64_t memberId,
-                         const std::string &accountNumber,
+                         std::string accountNumber,
                          long long openingBalancePaise,
                          long long closingBalancePaise)
     : bank_account_id{bankAccountId},
       bank_id{bankId},
       member_id{memberId},
-      account_number{accountNumber},
+      account_number{std::move(accountNumber)},
+      account_key{AccountKey::fromAccountNumber(account_number)},
       opening_balance_paise{openingBalancePaise},
       closing_balance_paise{closingBalancePaise}
 {
@@ -111,9 +113,20 @@ const std::string &BankAccount::getAccountNumber() const
  * 
  * @param bank_account_str Account number to set
  */
-void BankAccount::setAccountNumber(const std::string &bank_account_str)
+void BankAccount::setAccountNumber(std::string bank_account_str)
 {
-    account_number = bank_account_str;
+    account_number = std::move(bank_account_str);
+    account_key = AccountKey::fromAccountNumber(account_number);
+}
+
+/**
+ * @brief Get the packed account key
+ * 
+ * @return const std::optional<AccountKey>& 
+ */
+const std::optional<AccountKey> &BankAccount::getAccountKey() const
+{
+    return account_key;
 }
 
 /**
@@ -172,7 +185,7 @@ BankAccount BankAccount::fromSqliteRow(sqlite3_stmt* stmt, int baseCol)
     long long opening = static_cast<long long>(sqlite3_column_int64(stmt, baseCol + 4));
     long long closing = static_cast<long long>(sqlite3_column_int64(stmt, baseCol + 5));
 
-    BankAccount bank_account(id, bankId, memberId, acct, opening, closing);
+    BankAccount bank_account(id, bankId, memberId, std::move(acct), opening, closing);
     return bank_account;
 }
 
@@ -271,9 +284,7 @@ bool BankAccount::operator==(const BankAccount& other) const
         return false;
     }
 
-    // Compare normalized account numbers
-    if (normalizeAccountNumber(account_number) != 
-        normalizeAccountNumber(other.account_number))
+    if (!hasSameAccountNumber(other))
     {
         return false;
     }
@@ -302,3 +313,23 @@ bool BankAccount::operator!=(const BankAccount& other) const
 {
     return !(*this == other);
 }
+
+/**
+ * @brief Compare account numbers after normalization
+ * 
+ * Packed keys compare as integers; numbers too long or unusual to pack
+ * fall back to comparing the normalized strings.
+ * 
+ * @param other Other BankAccount to compare with
+ * @return true If the account numbers match
+ * @return false Otherwise
+ */
+bool BankAccount::hasSameAccountNumber(const BankAccount& other) const
+{
+    if (account_key && other.account_key)
+    {
+        return *account_key == *other.account_key;
+    }
+
+    return normalizeAccountNumber(account_number) == normalizeAccountNumber(other.account_number);
+}
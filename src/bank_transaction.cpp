@@ -0,0 +1,77 @@
+#include "bank_transaction.hpp"
+
+#include <unordered_map>
+
+namespace
+{
+    /**
+     * @brief SplitMix64 finaliser: a fast, well-mixed 64-bit permutation.
+     *
+     * @param value Input word.
+     * @return uint64_t Mixed word.
+     */
+    uint64_t mix64(uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Fold one field into a running hash.
+     *
+     * @param hash Hash so far.
+     * @param field Field value.
+     * @return uint64_t Updated hash.
+     */
+    uint64_t combine(uint64_t hash, uint64_t field)
+    {
+        return mix64(hash ^ mix64(field));
+    }
+
+    /**
+     * @brief 64-bit FNV-1a of the narration.
+     *
+     * @param text Narration text.
+     * @return uint64_t Hash of the bytes.
+     */
+    uint64_t narrationHash(const std::string& text)
+    {
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        for (unsigned char ch : text)
+        {
+            hash = (hash ^ ch) * 0x100000001B3ull;
+        }
+
+        return hash;
+    }
+}
+
+/**
+ * @brief Compute the duplicate-detection fingerprint of every line.
+ *
+ * @param bank_account_id Account the lines belong to.
+ * @param transactions Lines in statement order.
+ * @return std::vector<uint64_t> One fingerprint per line.
+ */
+std::vector<uint64_t> transactionFingerprints(uint64_t bank_account_id, std::span<const BankTransaction> transactions)
+{
+    std::vector<uint64_t> fingerprints;
+    fingerprints.reserve(transactions.size());
+    std::unordered_map<uint64_t, uint64_t> occurrences;
+
+    for (const BankTransaction& transaction : transactions)
+    {
+        uint64_t hash = combine(0, bank_account_id);
+        hash = combine(hash, static_cast<uint64_t>(std::chrono::sys_days(transaction.date).time_since_epoch().count()));
+        hash = combine(hash, static_cast<uint64_t>(transaction.amount_paise));
+        hash = combine(hash, transaction.balance_after_paise ? 1 : 0);
+        hash = combine(hash, static_cast<uint64_t>(transaction.balance_after_paise.value_or(0)));
+        hash = combine(hash, narrationHash(transaction.description));
+        fingerprints.push_back(combine(hash, occurrences[hash]++));
+    }
+
+    return fingerprints;
+}
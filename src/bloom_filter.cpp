@@ -0,0 +1,86 @@
+#include "bloom_filter.hpp"
+
+#include <algorithm>
+
+namespace commons
+{
+    namespace
+    {
+        constexpr uint64_t kBitsPerKey = 10;
+        constexpr uint64_t kProbeCount = 7;
+
+        // Second probe stride for double hashing (odd, so it cycles the table)
+        uint64_t probeStride(uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= 0xFF51AFD7ED558CCDull;
+            key ^= key >> 33;
+            return key | 1;
+        }
+    }
+
+    /**
+     * @brief Clear the filter and size it for a number of keys.
+     *
+     * @param expected_keys Keys the filter should hold at about 1% false positives.
+     */
+    void BloomFilter::reset(std::size_t expected_keys)
+    {
+        key_capacity = std::max<std::size_t>(expected_keys, 1024);
+        bit_count = static_cast<uint64_t>(key_capacity) * kBitsPerKey;
+        words.assign(static_cast<std::size_t>((bit_count + 63) / 64), 0);
+        key_count = 0;
+    }
+
+    /**
+     * @brief Add a key.
+     *
+     * @param key Hash to add.
+     */
+    void BloomFilter::insert(uint64_t key)
+    {
+        if (words.empty())
+        {
+            reset(0);
+        }
+
+        uint64_t stride = probeStride(key);
+
+        for (uint64_t probe = 0; probe < kProbeCount; ++probe)
+        {
+            uint64_t bit = (key + probe * stride) % bit_count;
+            words[bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+
+        ++key_count;
+    }
+
+    /**
+     * @brief Test for a key.
+     *
+     * @param key Hash to look up.
+     * @return true if the key may have been inserted.
+     * @return false if it definitely was not.
+     */
+    bool BloomFilter::mayContain(uint64_t key) const
+    {
+        if (words.empty())
+        {
+            return false;
+        }
+
+        uint64_t stride = probeStride(key);
+
+        for (uint64_t probe = 0; probe < kProbeCount; ++probe)
+        {
+            uint64_t bit = (key + probe * stride) % bit_count;
+
+            if ((words[bit / 64] & (uint64_t{1} << (bit % 64))) == 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -105,6 +105,136 @@ namespace
         // trim
         return trim(t);
     }
+
+    /**
+     * @brief Extracts the counterparty from a UPI/NEFT/IMPS/RTGS narration.
+     *
+     * Such narrations are segments separated by '/' (or '-'), for example
+     * "UPI/DR/412345678901/RAVI KUMAR/SBIN/ravi@okaxis". The counterparty is
+     * the first segment after the channel that is neither a direction
+     * marker, a reference number, a bank code nor a VPA.
+     *
+     * @param description Narration text.
+     * @return std::string The counterparty, or empty when none is found.
+     */
+    std::string counterpartyOf(const std::string &description)
+    {
+        char separator = description.find('/') != std::string::npos ? '/' : '-';
+        std::vector<std::string> segments;
+        std::stringstream stream(description);
+        std::string segment;
+
+        while (std::getline(stream, segment, separator))
+        {
+            segments.push_back(trim(segment));
+        }
+
+        if (segments.size() < 2)
+        {
+            return "";
+        }
+
+        std::string channel = segments.front();
+        std::transform(channel.begin(), channel.end(), channel.begin(), [](unsigned char ch) { return std::toupper(ch); });
+
+        if (channel != "UPI" && channel != "NEFT" && channel != "IMPS" && channel != "RTGS")
+        {
+            return "";
+        }
+
+        for (std::size_t index = 1; index < segments.size(); ++index)
+        {
+            const std::string &candidate = segments[index];
+            auto letters = std::count_if(candidate.begin(), candidate.end(), [](unsigned char ch) { return std::isalpha(ch); });
+            auto digits = std::count_if(candidate.begin(), candidate.end(), [](unsigned char ch) { return std::isdigit(ch); });
+            bool bank_code = candidate.size() <= 4 && letters == static_cast<std::ptrdiff_t>(candidate.size());
+
+            if (letters == 0 || digits > letters || bank_code || candidate.find('@') != std::string::npos)
+            {
+                continue;
+            }
+
+            return candidate;
+        }
+
+        return "";
+    }
+
+    // Column positions of the transaction table, found from its header row
+    struct TransactionColumns
+    {
+        std::size_t date{0};
+        std::size_t description{0};
+        std::size_t debit{0};
+        std::size_t credit{0};
+        std::optional<std::size_t> balance;
+    };
+
+    /**
+     * @brief Recognises the header row of the transaction table.
+     *
+     * @param fields Parsed CSV fields of the row.
+     * @return std::optional<TransactionColumns> Column positions, or std::nullopt
+     *         if the row is not a transaction header.
+     */
+    std::optional<TransactionColumns> findTransactionColumns(const std::vector<std::string> &fields)
+    {
+        std::optional<std::size_t> date;
+        std::optional<std::size_t> description;
+        std::optional<std::size_t> debit;
+        std::optional<std::size_t> credit;
+        std::optional<std::size_t> balance;
+
+        for (std::size_t index = 0; index < fields.size(); ++index)
+        {
+            const std::string &name = fields[index];
+
+            if (name == "Txn Date" || name == "Transaction Date")
+            {
+                date = index;
+            }
+            else if (name == "Description" || name == "Narration")
+            {
+                description = index;
+            }
+            else if (name == "Debit" || name == "Withdrawal")
+            {
+                debit = index;
+            }
+            else if (name == "Credit" || name == "Deposit")
+            {
+                credit = index;
+            }
+            else if (name == "Balance")
+            {
+                balance = index;
+            }
+        }
+
+        if (!date || !description || !debit || !credit)
+        {
+            return std::nullopt;
+        }
+
+        return TransactionColumns{*date, *description, *debit, *credit, balance};
+    }
+
+    /**
+     * @brief Parses one amount cell; a blank cell counts as zero.
+     *
+     * @param fields Parsed CSV fields of the row.
+     * @param column Column to read.
+     * @return std::optional<long long> Amount in paise, or std::nullopt if unparsable.
+     */
+    std::optional<long long> amountCell(const std::vector<std::string> &fields, std::size_t column)
+    {
+        if (column >= fields.size() || fields[column].empty())
+        {
+            return 0;
+        }
+
+        return commons::parseMoneyToPaise(fields[column]);
+    }
 } // namespace
 
 /**
@@ -118,7 +248,13 @@ commons::Result CanaraBankReader::parse(std::istream &in)
     m_accountNumber.reset();
     m_openingPaise.reset();
     m_closingPaise.reset();
+    m_periodStart.reset();
+    m_periodEnd.reset();
+    m_transactions.clear();
+    m_runningBalances.clear();
+    bool every_line_has_balance = true;
 
+    std::optional<TransactionColumns> columns;
     std::string line;
 
     while (std::getline(in, line)) 
@@ -129,6 +265,53 @@ commons::Result CanaraBankReader::parse(std::istream &in)
             continue;
         }
 
+        if (!columns)
+        {
+            columns = findTransactionColumns(fields);
+
+            if (columns)
+            {
+                continue;
+            }
+        }
+        else if (columns->date < fields.size())
+        {
+            auto date = commons::parseDate(fields[columns->date]);
+            auto debit = amountCell(fields, columns->debit);
+            auto credit = amountCell(fields, columns->credit);
+
+            if (date && debit && credit)
+            {
+                BankTransaction transaction;
+                transaction.date = *date;
+                transaction.description = columns->description < fields.size() ? fields[columns->description] : "";
+                transaction.amount_paise = *credit - *debit;
+                transaction.counterparty = counterpartyOf(transaction.description);
+
+                std::optional<long long> balance;
+
+                if (columns->balance && *columns->balance < fields.size())
+                {
+                    balance = commons::parseMoneyToPaise(fields[*columns->balance]);
+                }
+
+                transaction.balance_after_paise = balance;
+                m_transactions.push_back(std::move(transaction));
+
+                if (balance && every_line_has_balance)
+                {
+                    m_runningBalances.push_back(*balance);
+                }
+                else
+                {
+                    every_line_has_balance = false;
+                    m_runningBalances.clear();
+                }
+
+                continue;
+            }
+        }
+
         // Look for key rows used in sample CSV
         if (fields.size() >= 2) 
         {
@@ -155,6 +338,24 @@ commons::Result CanaraBankReader::parse(std::istream &in)
                     m_closingPaise = *paise;
                 }
             }
+            else if (key == "Statement Period")
+            {
+                std::size_t separator = val.find(" to ");
+
+                if (separator != std::string::npos)
+                {
+                    m_periodStart = commons::parseDate(trim(val.substr(0, separator)));
+                    m_periodEnd = commons::parseDate(trim(val.substr(separator + 4)));
+                }
+            }
+            else if (key == "From Date")
+            {
+                m_periodStart = commons::parseDate(val);
+            }
+            else if (key == "To Date")
+            {
+                m_periodEnd = commons::parseDate(val);
+            }
         }
     }
 
@@ -182,6 +383,10 @@ std::optional<BankReader::BankAccountInfo> CanaraBankReader::extractAccountInfo(
     info.accountNumber = *m_accountNumber;
     info.openingBalancePaise = *m_openingPaise;
     info.closingBalancePaise = *m_closingPaise;
+    info.periodStart = m_periodStart;
+    info.periodEnd = m_periodEnd;
+    info.transactions = m_transactions;
+    info.runningBalancesPaise = m_runningBalances;
     return info;
 }
 
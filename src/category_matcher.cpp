@@ -0,0 +1,222 @@
+#include "category_matcher.hpp"
+#include "commons.hpp"
+
+#include <cctype>
+#include <deque>
+
+namespace
+{
+    /**
+     * @brief Whether a byte is part of a word (see commons::searchTokens).
+     *
+     * @param byte Narration byte.
+     * @return true for ASCII letters and digits and UTF-8 continuation/lead bytes.
+     */
+    bool isWordByte(unsigned char byte)
+    {
+        return std::isalnum(byte) || byte >= 0x80;
+    }
+}
+
+/**
+ * @brief Build the automaton for a rule set.
+ *
+ * Narrations are scanned as the same normalised text as the keywords:
+ * lower-case words, each preceded by one space. Keywords are inserted into a
+ * trie, then a breadth-first pass fills every missing transition from the
+ * state's failure link, turning the trie into a DFA.
+ *
+ * @param rule_set Rules to compile.
+ */
+void CategoryMatcher::compile(std::span<const CategoryRule> rule_set)
+{
+    rules.clear();
+    keyword_lengths.clear();
+    std::vector<std::string> keywords;
+
+    for (const CategoryRule& rule : rule_set)
+    {
+        std::string keyword = commons::normalisedKeyword(rule.keyword);
+
+        if (!keyword.empty())
+        {
+            rules.push_back(rule);
+            keyword_lengths.push_back(keyword.size());
+            keywords.push_back(std::move(keyword));
+        }
+    }
+
+    // Column 0 stands for every byte no keyword uses
+    byte_column.fill(0);
+    column_count = 1;
+
+    for (const std::string& keyword : keywords)
+    {
+        for (unsigned char byte : keyword)
+        {
+            if (byte_column[byte] == 0)
+            {
+                byte_column[byte] = static_cast<uint8_t>(column_count++);
+            }
+        }
+    }
+
+    // Upper-case letters share the column of their lower-case form
+    for (int byte = 'A'; byte <= 'Z'; ++byte)
+    {
+        byte_column[byte] = byte_column[std::tolower(byte)];
+    }
+
+    transitions.assign(column_count, kNoRule);
+    state_rule.assign(1, kNoRule);
+    output_link.assign(1, 0);
+
+    for (uint32_t rule = 0; rule < keywords.size(); ++rule)
+    {
+        uint32_t state = 0;
+
+        for (unsigned char byte : keywords[rule])
+        {
+            uint32_t& next = transitions[state * column_count + byte_column[byte]];
+
+            if (next == kNoRule)
+            {
+                next = static_cast<uint32_t>(state_rule.size());
+                state_rule.push_back(kNoRule);
+                output_link.push_back(0);
+                transitions.resize(transitions.size() + column_count, kNoRule);
+            }
+
+            state = transitions[state * column_count + byte_column[byte]];
+        }
+
+        // Several rules with one keyword: only the best can ever win
+        if (state_rule[state] == kNoRule || outranks(rule, state_rule[state]))
+        {
+            state_rule[state] = rule;
+        }
+    }
+
+    std::vector<uint32_t> failure(state_rule.size(), 0);
+    std::deque<uint32_t> pending;
+
+    for (std::size_t column = 0; column < column_count; ++column)
+    {
+        uint32_t& next = transitions[column];
+
+        if (next == kNoRule)
+        {
+            next = 0;
+        }
+        else
+        {
+            pending.push_back(next);
+        }
+    }
+
+    while (!pending.empty())
+    {
+        uint32_t state = pending.front();
+        pending.pop_front();
+        uint32_t fallback = failure[state];
+        output_link[state] = state_rule[fallback] != kNoRule ? fallback : output_link[fallback];
+
+        for (std::size_t column = 0; column < column_count; ++column)
+        {
+            uint32_t& next = transitions[state * column_count + column];
+            uint32_t fallback_next = transitions[fallback * column_count + column];
+
+            if (next == kNoRule)
+            {
+                next = fallback_next;
+            }
+            else
+            {
+                failure[next] = fallback_next;
+                pending.push_back(next);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Categorise one narration in a single pass.
+ *
+ * @param narration Statement narration.
+ * @return uint64_t Category of the winning rule, 0 when no rule matches.
+ */
+uint64_t CategoryMatcher::categorize(std::string_view narration) const
+{
+    if (rules.empty())
+    {
+        return 0;
+    }
+
+    const uint8_t space_column = byte_column[static_cast<unsigned char>(' ')];
+    uint32_t state = 0;
+    uint32_t best = kNoRule;
+    bool in_word = false;
+
+    for (std::size_t position = 0; position < narration.size(); ++position)
+    {
+        unsigned char byte = static_cast<unsigned char>(narration[position]);
+
+        if (!isWordByte(byte))
+        {
+            in_word = false;
+            continue;
+        }
+
+        // Any run of separators (and the start of the text) reads as one space
+        if (!in_word)
+        {
+            in_word = true;
+            state = transitions[state * column_count + space_column];
+        }
+
+        state = transitions[state * column_count + byte_column[byte]];
+
+        // Matches must also end at a word end; the next byte decides that
+        if (position + 1 < narration.size() && isWordByte(static_cast<unsigned char>(narration[position + 1])))
+        {
+            continue;
+        }
+
+        for (uint32_t match = state_rule[state] != kNoRule ? state : output_link[state]; match != 0; match = output_link[match])
+        {
+            uint32_t rule = state_rule[match];
+
+            if (best == kNoRule || outranks(rule, best))
+            {
+                best = rule;
+            }
+        }
+    }
+
+    return best == kNoRule ? 0 : rules[best].category_id;
+}
+
+/**
+ * @brief Rule precedence: priority, then keyword length, then age.
+ *
+ * @param challenger Candidate rule index.
+ * @param incumbent Current best rule index.
+ * @return true if the challenger wins.
+ */
+bool CategoryMatcher::outranks(uint32_t challenger, uint32_t incumbent) const
+{
+    const CategoryRule& lhs = rules[challenger];
+    const CategoryRule& rhs = rules[incumbent];
+
+    if (lhs.priority != rhs.priority)
+    {
+        return lhs.priority > rhs.priority;
+    }
+
+    if (keyword_lengths[challenger] != keyword_lengths[incumbent])
+    {
+        return keyword_lengths[challenger] > keyword_lengths[incumbent];
+    }
+
+    return lhs.rule_id < rhs.rule_id;
+}
@@ -0,0 +1,1077 @@
+#include "cli_manager.hpp"
+#include "terminal_io.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <memory_resource>
+#include <set>
+#include <string>
+
+namespace
+{
+    // Options that take a value (`--db PATH` or `--db=PATH`)
+    const std::set<std::string> kValueOptions = {"db", "member", "family", "bank", "format", "from", "to", "priority"};
+
+    // Options that are plain switches
+    const std::set<std::string> kFlagOptions = {"all"};
+
+    // Transactions recategorised per write transaction
+    constexpr std::size_t kRecategorizeBatchSize = 5000;
+}
+
+/**
+ * @brief Construct a new CLIManager::CLIManager object
+ *
+ */
+CLIManager::CLIManager()
+    : CLIManager(std::make_unique<TerminalIO>(TerminalIO::OutputMode::Buffered))
+{
+}
+
+/**
+ * @brief Construct a new CLIManager::CLIManager object
+ *
+ * @param io_ptr Pointer to an IOInterface implementation for I/O operations
+ */
+CLIManager::CLIManager(std::unique_ptr<IOInterface> io_ptr)
+    : CLIManager(std::move(io_ptr), std::make_unique<HomeManager>())
+{
+}
+
+/**
+ * @brief Construct a new CLIManager::CLIManager object
+ *
+ * @param io_ptr Pointer to an IOInterface implementation for I/O operations
+ * @param home_ptr HomeManager to operate on (for example one backed by MemoryStorage)
+ */
+CLIManager::CLIManager(std::unique_ptr<IOInterface> io_ptr, std::unique_ptr<HomeManager> home_ptr)
+    : io_ptr(std::move(io_ptr)), home_ptr(std::move(home_ptr))
+{
+}
+
+/**
+ * @brief Destroy the CLIManager::CLIManager object
+ *
+ */
+CLIManager::~CLIManager()
+{
+}
+
+/**
+ * @brief Show an error message through the IOInterface
+ *
+ * @param res The result containing error information
+ */
+void CLIManager::showError(const commons::Result& res)
+{
+    if (res == commons::Result::Ok)
+    {
+        return; // nothing to show for success
+    }
+
+    io_ptr->printError(errorMessage(res));
+}
+
+/**
+ * @brief Add a new family and print its ID (REQ-1)
+ *
+ * @param name Name of the family to add
+ * @return commons::Result
+ */
+commons::Result CLIManager::addFamily(const std::string& name)
+{
+    uint64_t new_id = 0;
+    commons::Result res = home_ptr->addFamily(Family(name), &new_id);
+
+    if (res != commons::Result::Ok)
+    {
+        showError(res);
+    }
+    else if (format == OutputFormat::Tsv)
+    {
+        io_ptr->printLine(std::to_string(new_id));
+    }
+    else
+    {
+        io_ptr->printLine("Family '" + name + "' added successfully. ID: " + std::to_string(new_id));
+    }
+
+    return res;
+}
+
+/**
+ * @brief Delete a family (REQ-1.1)
+ *
+ * @param family_id ID of the family to delete
+ * @return commons::Result
+ */
+commons::Result CLIManager::deleteFamily(const uint64_t& family_id)
+{
+    commons::Result res = home_ptr->deleteFamily(family_id);
+
+    if (res != commons::Result::Ok)
+    {
+        showError(res);
+    }
+    else if (format == OutputFormat::Text)
+    {
+        io_ptr->printLine("Family " + std::to_string(family_id) + " deleted successfully.");
+    }
+
+    return res;
+}
+
+/**
+ * @brief Add a new member to a family and print its ID (REQ-2)
+ *
+ * @param family_id ID of the family to add the member to
+ * @param member The member to add
+ * @return commons::Result
+ */
+commons::Result CLIManager::addMember(const uint64_t& family_id, const Member& member)
+{
+    uint64_t new_id = 0;
+    commons::Result res = home_ptr->addMemberToFamily(member, family_id, &new_id);
+
+    if (res != commons::Result::Ok)
+    {
+        showError(res);
+    }
+    else if (format == OutputFormat::Tsv)
+    {
+        io_ptr->printLine(std::to_string(new_id));
+    }
+    else
+    {
+        io_ptr->printLine("Member '" + member.getName() + "' added to family " +
+                          std::to_string(family_id) + ". ID: " + std::to_string(new_id));
+    }
+
+    return res;
+}
+
+/**
+ * @brief Update a member's name and/or nickname (REQ-2.1)
+ *
+ * @param member_id ID of the member to update
+ * @param new_name New name (empty leaves it unchanged)
+ * @param new_nickname New nickname (empty leaves it unchanged)
+ * @return commons::Result
+ */
+commons::Result CLIManager::updateMember(const uint64_t& member_id,
+                                         const std::string& new_name,
+                                         const std::string& new_nickname)
+{
+    commons::Result res = home_ptr->updateMember(member_id, new_name, new_nickname);
+
+    if (res != commons::Result::Ok)
+    {
+        showError(res);
+    }
+    else if (format == OutputFormat::Text)
+    {
+        io_ptr->printLine("Member " + std::to_string(member_id) + " updated successfully.");
+    }
+
+    return res;
+}
+
+/**
+ * @brief Delete a member (REQ-2.2)
+ *
+ * @param member_id ID of the member to delete
+ * @return commons::Result
+ */
+commons::Result CLIManager::deleteMember(const uint64_t& member_id)
+{
+    return deleteMembers({member_id});
+}
+
+/**
+ * @brief Delete several members, reporting each ID separately (REQ-2.3)
+ *
+ * @param member_ids IDs of the members to delete
+ * @return commons::Result First failure, or Ok if all were deleted
+ */
+commons::Result CLIManager::deleteMembers(const std::vector<uint64_t>& member_ids)
+{
+    std::vector<commons::Result> results;
+    commons::Result final_res = home_ptr->deleteMembers(member_ids, &results);
+
+    if (final_res != commons::Result::Ok)
+    {
+        io_ptr->printError(errorMessage(final_res));
+        return final_res;
+    }
+
+    for (std::size_t index = 0; index < member_ids.size(); ++index)
+    {
+        const uint64_t member_id = member_ids[index];
+        commons::Result res = results[index];
+
+        if (res != commons::Result::Ok)
+        {
+            io_ptr->printError("Member " + std::to_string(member_id) + ": " + errorMessage(res));
+
+            if (final_res == commons::Result::Ok)
+            {
+                final_res = res;
+            }
+        }
+        else if (format == OutputFormat::Text)
+        {
+            io_ptr->printLine("Member " + std::to_string(member_id) + " deleted.");
+        }
+    }
+
+    return final_res;
+}
+
+/**
+ * @brief Check whether a command-line word is a CLI subcommand.
+ *
+ * @param command First non-program argument
+ * @return true if run() handles it
+ */
+bool CLIManager::isSubcommand(const std::string& command)
+{
+    return command == "import" || command == "networth" || command == "list" ||
+           command == "add" || command == "delete" || command == "cashflow" ||
+           command == "rollups" || command == "categories";
+}
+
+/**
+ * @brief Print the subcommand synopsis.
+ *
+ */
+void CLIManager::printUsage()
+{
+    io_ptr->printLine("Subcommands:");
+    io_ptr->printLine("  import --member ID --bank NAME|ID FILE...");
+    io_ptr->printLine("  networth --member ID | --family ID | --all");
+    io_ptr->printLine("  list families");
+    io_ptr->printLine("  list members --family ID");
+    io_ptr->printLine("  add family NAME");
+    io_ptr->printLine("  add member --family ID NAME [NICKNAME]");
+    io_ptr->printLine("  delete family ID");
+    io_ptr->printLine("  delete member ID...");
+    io_ptr->printLine("  cashflow --member ID | --family ID --from YYYY-MM --to YYYY-MM");
+    io_ptr->printLine("  rollups rebuild | rollups check");
+    io_ptr->printLine("  categories list | categories load FILE | categories recategorize");
+    io_ptr->printLine("  categories add NAME KEYWORD [--priority N] | categories delete RULE_ID");
+    io_ptr->printLine("Common options:");
+    io_ptr->printLine("  --db PATH       Use the database at PATH instead of the default");
+    io_ptr->printLine("  --format=FMT    Output format: text (default) or tsv");
+}
+
+/**
+ * @brief Split arguments into the subcommand, options and positionals.
+ *
+ * @param args Arguments after the program name
+ * @param out_args Parsed result
+ * @return true if every option is known and has its value
+ */
+bool CLIManager::parseArguments(const std::vector<std::string>& args, Arguments* out_args)
+{
+    if (args.empty())
+    {
+        io_ptr->printError("Missing subcommand.");
+        return false;
+    }
+
+    out_args->command = args.front();
+
+    for (std::size_t index = 1; index < args.size(); ++index)
+    {
+        const std::string &arg = args[index];
+
+        // "--" ends option parsing so file names may start with dashes
+        if (arg == "--")
+        {
+            out_args->positionals.insert(out_args->positionals.end(), args.begin() + index + 1, args.end());
+            break;
+        }
+
+        if (arg.rfind("--", 0) != 0)
+        {
+            out_args->positionals.push_back(arg);
+            continue;
+        }
+
+        std::string key = arg.substr(2);
+        std::string value;
+        std::size_t equals = key.find('=');
+        bool has_inline_value = equals != std::string::npos;
+
+        if (has_inline_value)
+        {
+            value = key.substr(equals + 1);
+            key = key.substr(0, equals);
+        }
+
+        if (kFlagOptions.count(key) && !has_inline_value)
+        {
+            out_args->options[key] = "1";
+            continue;
+        }
+
+        if (!kValueOptions.count(key))
+        {
+            io_ptr->printError("Unknown option: '" + arg + "'.");
+            return false;
+        }
+
+        if (!has_inline_value)
+        {
+            if (index + 1 >= args.size())
+            {
+                io_ptr->printError("Option --" + key + " requires a value.");
+                return false;
+            }
+
+            value = args[++index];
+        }
+
+        out_args->options[key] = value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Open the database selected with --db, limited to one connection.
+ *
+ * @param args Parsed arguments
+ * @return true if the storage is ready
+ */
+bool CLIManager::openDatabase(const Arguments& args)
+{
+    auto db_option = args.options.find("db");
+    StorageManager* storage = home_ptr->getStorageManager();
+
+    // Non-SQLite backends (tests) are already usable
+    if (!storage)
+    {
+        if (db_option != args.options.end())
+        {
+            io_ptr->printError("--db is only supported with the SQLite backend.");
+            return false;
+        }
+
+        return true;
+    }
+
+    // A single-threaded run needs no read pool: share the writer connection
+    storage->setMaxReadConnections(0);
+
+    if (!storage->initializeDatabase(db_option != args.options.end() ? db_option->second : ""))
+    {
+        io_ptr->printError("Failed to open the database.");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read a mandatory ID option.
+ *
+ * @param args Parsed arguments
+ * @param option Option name without dashes
+ * @param out_id Parsed ID
+ * @return true if the option is present and a whole number
+ */
+bool CLIManager::requireId(const Arguments& args, const std::string& option, uint64_t* out_id)
+{
+    auto it = args.options.find(option);
+
+    if (it == args.options.end())
+    {
+        io_ptr->printError("Missing required option --" + option + ".");
+        return false;
+    }
+
+    auto parsed = commons::parseId(it->second);
+
+    if (!parsed)
+    {
+        io_ptr->printError("Option --" + option + " must be a non-negative whole number (REQ-4, REQ-5).");
+        return false;
+    }
+
+    *out_id = *parsed;
+    return true;
+}
+
+/**
+ * @brief Execute one subcommand.
+ *
+ * @param args Arguments after the program name, starting with the subcommand
+ * @return int Exit code: 0 success, 1 operation failed, 2 usage error
+ */
+int CLIManager::run(const std::vector<std::string>& args)
+{
+    Arguments parsed;
+
+    if (!parseArguments(args, &parsed) || !isSubcommand(parsed.command))
+    {
+        printUsage();
+        return 2;
+    }
+
+    auto format_option = parsed.options.find("format");
+    format = OutputFormat::Text;
+
+    if (format_option != parsed.options.end())
+    {
+        if (format_option->second == "tsv")
+        {
+            format = OutputFormat::Tsv;
+        }
+        else if (format_option->second == "text")
+        {
+            format = OutputFormat::Text;
+        }
+        else
+        {
+            io_ptr->printError("Unknown format '" + format_option->second + "'; use text or tsv.");
+            return 2;
+        }
+    }
+
+    int exit_code = 0;
+
+    if (!openDatabase(parsed))
+    {
+        exit_code = 1;
+    }
+    else if (parsed.command == "import")
+    {
+        exit_code = runImport(parsed);
+    }
+    else if (parsed.command == "networth")
+    {
+        exit_code = runNetWorth(parsed);
+    }
+    else if (parsed.command == "list")
+    {
+        exit_code = runList(parsed);
+    }
+    else if (parsed.command == "add")
+    {
+        exit_code = runAdd(parsed);
+    }
+    else if (parsed.command == "cashflow")
+    {
+        exit_code = runCashFlow(parsed);
+    }
+    else if (parsed.command == "rollups")
+    {
+        exit_code = runRollups(parsed);
+    }
+    else if (parsed.command == "categories")
+    {
+        exit_code = runCategories(parsed);
+    }
+    else
+    {
+        exit_code = runDelete(parsed);
+    }
+
+    io_ptr->flush();
+    return exit_code;
+}
+
+/**
+ * @brief import --member ID --bank NAME|ID FILE...
+ *
+ * Every file is imported even if an earlier one fails.
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runImport(const Arguments& args)
+{
+    uint64_t member_id = 0;
+    auto bank_option = args.options.find("bank");
+
+    if (!requireId(args, "member", &member_id))
+    {
+        return 2;
+    }
+
+    if (bank_option == args.options.end() || bank_option->second.empty() || args.positionals.empty())
+    {
+        io_ptr->printError("Usage: import --member ID --bank NAME|ID FILE...");
+        return 2;
+    }
+
+    if (!home_ptr->getMember(member_id))
+    {
+        io_ptr->printError("Member id " + std::to_string(member_id) + " not found.");
+        return 1;
+    }
+
+    auto bank_id = commons::parseId(bank_option->second);
+    int exit_code = 0;
+
+    for (const auto &path : args.positionals)
+    {
+        uint64_t bank_account_id = 0;
+        uint64_t duplicates = 0;
+        ReconciliationReport report;
+        commons::Result res = bank_id
+            ? home_ptr->importBankStatement(path, member_id, *bank_id, &bank_account_id, &report, &duplicates)
+            : home_ptr->importBankStatement(path, member_id, bank_option->second, &bank_account_id, &report, &duplicates);
+
+        if (res == commons::Result::Unreconciled)
+        {
+            std::string detail = report.first_divergent_row
+                ? " First divergent transaction: line " + std::to_string(*report.first_divergent_row + 1) + "."
+                : " Transactions add up to a closing balance of " + commons::formatPaise(report.expected_closing_paise) + ".";
+            io_ptr->printError(path + ": " + errorMessage(res) + detail);
+            exit_code = 1;
+        }
+        else if (res != commons::Result::Ok)
+        {
+            io_ptr->printError(path + ": " + errorMessage(res));
+            exit_code = 1;
+        }
+        else if (format == OutputFormat::Tsv)
+        {
+            io_ptr->printLine(path + "\t" + std::to_string(bank_account_id) + "\t" + std::to_string(duplicates));
+        }
+        else
+        {
+            std::string skipped = duplicates
+                ? ". Skipped " + std::to_string(duplicates) + " line(s) already imported"
+                : "";
+            io_ptr->printLine("Imported " + path + ". Bank account ID: " + std::to_string(bank_account_id) + skipped);
+        }
+    }
+
+    return exit_code;
+}
+
+/**
+ * @brief networth --member ID | --family ID | --all
+ *
+ * Text output uses rupees; TSV output uses raw paise so scripts can sum it.
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runNetWorth(const Arguments& args)
+{
+    auto emit = [&](const std::string& kind, const std::string& label, uint64_t record_id, long long total_paise)
+    {
+        if (format == OutputFormat::Tsv)
+        {
+            io_ptr->printLine(kind + "\t" + std::to_string(record_id) + "\t" + std::to_string(total_paise));
+        }
+        else
+        {
+            io_ptr->printLine(label + " " + std::to_string(record_id) + " net worth: " + commons::formatPaise(total_paise));
+        }
+    };
+
+    if (args.options.count("all"))
+    {
+        NetWorthSnapshot snapshot;
+        commons::Result res = home_ptr->computeAllNetWorths(&snapshot);
+
+        if (res != commons::Result::Ok)
+        {
+            showError(res);
+            return 1;
+        }
+
+        for (std::size_t family_index = 0; family_index < snapshot.familyCount(); ++family_index)
+        {
+            emit("family", "Family", snapshot.family_ids[family_index], snapshot.family_totals_paise[family_index]);
+
+            for (std::size_t member_index = snapshot.family_member_offsets[family_index];
+                 member_index < snapshot.family_member_offsets[family_index + 1];
+                 ++member_index)
+            {
+                emit("member", "  Member", snapshot.member_ids[member_index], snapshot.member_totals_paise[member_index]);
+            }
+        }
+
+        if (format == OutputFormat::Tsv)
+        {
+            io_ptr->printLine("household\t0\t" + std::to_string(snapshot.household_total_paise));
+        }
+        else
+        {
+            io_ptr->printLine("Household total: " + commons::formatPaise(snapshot.household_total_paise));
+        }
+
+        return 0;
+    }
+
+    bool by_member = args.options.count("member") > 0;
+    uint64_t record_id = 0;
+
+    if (by_member == (args.options.count("family") > 0))
+    {
+        io_ptr->printError("Usage: networth --member ID | --family ID | --all");
+        return 2;
+    }
+
+    if (!requireId(args, by_member ? "member" : "family", &record_id))
+    {
+        return 2;
+    }
+
+    long long total_paise = 0;
+    commons::Result res = by_member
+        ? home_ptr->computeMemberNetWorth(record_id, &total_paise)
+        : home_ptr->computeFamilyNetWorth(record_id, &total_paise);
+
+    if (res != commons::Result::Ok)
+    {
+        showError(res);
+        return 1;
+    }
+
+    emit(by_member ? "member" : "family", by_member ? "Member" : "Family", record_id, total_paise);
+    return 0;
+}
+
+/**
+ * @brief list families | list members --family ID
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runList(const Arguments& args)
+{
+    std::string what = args.positionals.empty() ? "" : args.positionals.front();
+
+    std::vector<std::string> lines;
+
+    // The rows only live until the lines are built, so they are bump-allocated
+    // from one arena (seeded with a stack buffer) and dropped in a single step.
+    std::array<std::byte, 16384> arena_buffer;
+    std::pmr::monotonic_buffer_resource arena(arena_buffer.data(), arena_buffer.size());
+
+    if (what == "families")
+    {
+        auto families = home_ptr->listFamilies(&arena);
+        lines.reserve(families.size());
+
+        for (const auto &family : families)
+        {
+            std::string line = (format == OutputFormat::Tsv ? "" : "ID: ") + std::to_string(family.id);
+            line.append(format == OutputFormat::Tsv ? "\t" : " - ").append(family.name);
+            lines.push_back(std::move(line));
+        }
+
+        io_ptr->printLines(lines);
+        return 0;
+    }
+
+    if (what != "members")
+    {
+        io_ptr->printError("Usage: list families | list members --family ID");
+        return 2;
+    }
+
+    uint64_t family_id = 0;
+
+    if (!requireId(args, "family", &family_id))
+    {
+        return 2;
+    }
+
+    if (!home_ptr->getFamily(family_id))
+    {
+        showError(commons::Result::NotFound);
+        return 1;
+    }
+
+    auto members = home_ptr->listMembersOfFamily(family_id, &arena);
+    lines.reserve(members.size());
+
+    for (const auto &member : members)
+    {
+        std::string line;
+
+        if (format == OutputFormat::Tsv)
+        {
+            line.append(std::to_string(member.id)).append("\t").append(member.name).append("\t").append(member.nickname);
+        }
+        else
+        {
+            line.append("ID: ").append(std::to_string(member.id)).append(" - ").append(member.name);
+
+            if (!member.nickname.empty())
+            {
+                line.append(" (").append(member.nickname).append(")");
+            }
+        }
+
+        lines.push_back(std::move(line));
+    }
+
+    io_ptr->printLines(lines);
+    return 0;
+}
+
+/**
+ * @brief add family NAME | add member --family ID NAME [NICKNAME]
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runAdd(const Arguments& args)
+{
+    std::string what = args.positionals.empty() ? "" : args.positionals.front();
+
+    if (what == "family" && args.positionals.size() == 2)
+    {
+        return addFamily(args.positionals[1]) == commons::Result::Ok ? 0 : 1;
+    }
+
+    if (what == "member" && (args.positionals.size() == 2 || args.positionals.size() == 3))
+    {
+        uint64_t family_id = 0;
+
+        if (!requireId(args, "family", &family_id))
+        {
+            return 2;
+        }
+
+        std::string nickname = args.positionals.size() == 3 ? args.positionals[2] : "";
+        return addMember(family_id, Member(args.positionals[1], nickname)) == commons::Result::Ok ? 0 : 1;
+    }
+
+    io_ptr->printError("Usage: add family NAME | add member --family ID NAME [NICKNAME]");
+    return 2;
+}
+
+/**
+ * @brief delete family ID | delete member ID...
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runDelete(const Arguments& args)
+{
+    std::string what = args.positionals.empty() ? "" : args.positionals.front();
+    std::vector<uint64_t> ids;
+
+    for (std::size_t index = 1; index < args.positionals.size(); ++index)
+    {
+        auto parsed = commons::parseId(args.positionals[index]);
+
+        if (!parsed)
+        {
+            io_ptr->printError("IDs must be non-negative whole numbers (REQ-4, REQ-5).");
+            return 2;
+        }
+
+        ids.push_back(*parsed);
+    }
+
+    if (what == "family" && ids.size() == 1)
+    {
+        return deleteFamily(ids.front()) == commons::Result::Ok ? 0 : 1;
+    }
+
+    if (what == "member" && !ids.empty())
+    {
+        return deleteMembers(ids) == commons::Result::Ok ? 0 : 1;
+    }
+
+    io_ptr->printError("Usage: delete family ID | delete member ID...");
+    return 2;
+}
+
+/**
+ * @brief cashflow --member ID | --family ID --from YYYY-MM --to YYYY-MM
+ *
+ * One line per month, read from the cash-flow rollups. Text output uses
+ * rupees; TSV output uses raw paise and counts.
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runCashFlow(const Arguments& args)
+{
+    const std::string usage = "Usage: cashflow --member ID | --family ID --from YYYY-MM --to YYYY-MM";
+    bool by_member = args.options.count("member") > 0;
+    uint64_t record_id = 0;
+
+    if (by_member == (args.options.count("family") > 0))
+    {
+        io_ptr->printError(usage);
+        return 2;
+    }
+
+    if (!requireId(args, by_member ? "member" : "family", &record_id))
+    {
+        return 2;
+    }
+
+    auto from_option = args.options.find("from");
+    auto to_option = args.options.find("to");
+    std::optional<commons::Month> first_month;
+    std::optional<commons::Month> last_month;
+
+    if (from_option != args.options.end() && to_option != args.options.end())
+    {
+        first_month = commons::parseMonth(from_option->second);
+        last_month = commons::parseMonth(to_option->second);
+    }
+
+    if (!first_month || !last_month)
+    {
+        io_ptr->printError(usage);
+        return 2;
+    }
+
+    std::vector<CashFlowMonth> months;
+    commons::Result res = home_ptr->getCashFlow(by_member ? NetWorthScope::Member : NetWorthScope::Family,
+                                                record_id, *first_month, *last_month, &months);
+
+    if (res != commons::Result::Ok)
+    {
+        showError(res);
+        return 1;
+    }
+
+    std::vector<std::string> lines;
+    lines.reserve(months.size());
+
+    for (const auto &month : months)
+    {
+        std::string line = commons::formatMonth(month.month);
+
+        if (format == OutputFormat::Tsv)
+        {
+            line.append("\t").append(std::to_string(month.credit_paise));
+            line.append("\t").append(std::to_string(month.credit_count));
+            line.append("\t").append(std::to_string(month.debit_paise));
+            line.append("\t").append(std::to_string(month.debit_count));
+        }
+        else
+        {
+            line.append(" credits: ").append(commons::formatPaise(month.credit_paise));
+            line.append(" (").append(std::to_string(month.credit_count)).append(")");
+            line.append(" debits: ").append(commons::formatPaise(month.debit_paise));
+            line.append(" (").append(std::to_string(month.debit_count)).append(")");
+        }
+
+        lines.push_back(std::move(line));
+    }
+
+    io_ptr->printLines(lines);
+    return 0;
+}
+
+/**
+ * @brief rollups rebuild | rollups check
+ *
+ * `check` exits 1 when any rollup row disagrees with the raw transactions.
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runRollups(const Arguments& args)
+{
+    std::string what = args.positionals.size() == 1 ? args.positionals.front() : "";
+
+    if (what == "rebuild")
+    {
+        commons::Result res = home_ptr->rebuildCashFlowRollups();
+
+        if (res != commons::Result::Ok)
+        {
+            showError(res);
+            return 1;
+        }
+
+        io_ptr->printLine("Cash-flow rollups rebuilt.");
+        return 0;
+    }
+
+    if (what != "check")
+    {
+        io_ptr->printError("Usage: rollups rebuild | rollups check");
+        return 2;
+    }
+
+    uint64_t mismatched_rows = 0;
+    commons::Result res = home_ptr->checkCashFlowRollups(&mismatched_rows);
+
+    if (res != commons::Result::Ok)
+    {
+        showError(res);
+        return 1;
+    }
+
+    if (format == OutputFormat::Tsv)
+    {
+        io_ptr->printLine(std::to_string(mismatched_rows));
+    }
+    else if (mismatched_rows == 0)
+    {
+        io_ptr->printLine("Cash-flow rollups are consistent.");
+    }
+    else
+    {
+        io_ptr->printLine(std::to_string(mismatched_rows) + " cash-flow rollup rows disagree with the transactions; run 'rollups rebuild'.");
+    }
+
+    return mismatched_rows == 0 ? 0 : 1;
+}
+
+/**
+ * @brief categories list | load FILE | add NAME KEYWORD [--priority N] | delete RULE_ID | recategorize
+ *
+ * Rule changes apply to transactions imported afterwards; `recategorize`
+ * brings the ones already stored up to date.
+ *
+ * @param args Parsed arguments
+ * @return int Exit code
+ */
+int CLIManager::runCategories(const Arguments& args)
+{
+    const std::string usage =
+        "Usage: categories list | categories load FILE | categories recategorize | "
+        "categories add NAME KEYWORD [--priority N] | categories delete RULE_ID";
+    std::string what = args.positionals.empty() ? "" : args.positionals.front();
+    std::size_t operands = args.positionals.empty() ? 0 : args.positionals.size() - 1;
+
+    if (what == "list" && operands == 0)
+    {
+        std::vector<TransactionCategory> categories;
+        std::vector<CategoryRule> rules;
+        commons::Result res = home_ptr->listCategories(&categories);
+
+        if (res == commons::Result::Ok)
+        {
+            res = home_ptr->listCategoryRules(&rules);
+        }
+
+        if (res != commons::Result::Ok)
+        {
+            showError(res);
+            return 1;
+        }
+
+        for (const auto &rule : rules)
+        {
+            auto category = std::find_if(categories.begin(), categories.end(), [&](const TransactionCategory &entry)
+                { return entry.id == rule.category_id; });
+            std::string name = category == categories.end() ? "" : category->name;
+
+            if (format == OutputFormat::Tsv)
+            {
+                io_ptr->printLine(std::to_string(rule.rule_id) + "\t" + name + "\t" + rule.keyword + "\t" + std::to_string(rule.priority));
+            }
+            else
+            {
+                io_ptr->printLine("Rule " + std::to_string(rule.rule_id) + ": \"" + rule.keyword + "\" -> " + name +
+                                  " (priority " + std::to_string(rule.priority) + ")");
+            }
+        }
+
+        return 0;
+    }
+
+    if (what == "load" && operands == 1)
+    {
+        uint64_t rule_count = 0;
+        commons::Result res = home_ptr->importCategoryRules(args.positionals[1], &rule_count);
+
+        if (res != commons::Result::Ok)
+        {
+            io_ptr->printError(args.positionals[1] + ": " + errorMessage(res));
+            return 1;
+        }
+
+        io_ptr->printLine(format == OutputFormat::Tsv ? std::to_string(rule_count) : "Added " + std::to_string(rule_count) + " category rules.");
+        return 0;
+    }
+
+    if (what == "add" && operands == 2)
+    {
+        int priority = 0;
+        auto priority_option = args.options.find("priority");
+
+        if (priority_option != args.options.end())
+        {
+            const std::string& text = priority_option->second;
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), priority);
+
+            if (error != std::errc() || end != text.data() + text.size())
+            {
+                io_ptr->printError("Invalid --priority '" + text + "'.");
+                return 2;
+            }
+        }
+
+        uint64_t rule_id = 0;
+        commons::Result res = home_ptr->addCategoryRule(args.positionals[1], args.positionals[2], priority, &rule_id);
+
+        if (res != commons::Result::Ok)
+        {
+            showError(res);
+            return 1;
+        }
+
+        io_ptr->printLine(format == OutputFormat::Tsv ? std::to_string(rule_id) : "Rule ID: " + std::to_string(rule_id));
+        return 0;
+    }
+
+    if (what == "delete" && operands == 1)
+    {
+        auto rule_id = commons::parseId(args.positionals[1]);
+
+        if (!rule_id)
+        {
+            io_ptr->printError(usage);
+            return 2;
+        }
+
+        commons::Result res = home_ptr->deleteCategoryRule(*rule_id);
+
+        if (res == commons::Result::NotFound)
+        {
+            io_ptr->printError("Rule id " + std::to_string(*rule_id) + " not found.");
+            return 1;
+        }
+
+        if (res != commons::Result::Ok)
+        {
+            showError(res);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (what == "recategorize" && operands == 0)
+    {
+        uint64_t changed = 0;
+        commons::Result res = home_ptr->recategorizeTransactions(kRecategorizeBatchSize, &changed);
+
+        if (res != commons::Result::Ok)
+        {
+            showError(res);
+            return 1;
+        }
+
+        io_ptr->printLine(format == OutputFormat::Tsv ? std::to_string(changed) : std::to_string(changed) + " transactions changed category.");
+        return 0;
+    }
+
+    io_ptr->printError(usage);
+    return 2;
+}
@@ -1,13 +1,14 @@
 #include "family.hpp"
 #include <algorithm>
+#include <utility>
 
 /**
  * @brief Construct a new Family:: Family object
  * 
  * @param name Name of the family
  */
-Family::Family(const std::string& name)
-    : family_id(0), family_name(name) 
+Family::Family(std::string name)
+    : family_id(0), family_name(std::move(name)) 
 {
 
 }
@@ -18,8 +19,8 @@ Family::Family(const std::string& name)
  * @param id ID of the family
  * @param name Name of the family
  */
-Family::Family(uint64_t id, const std::string& name)
-    : family_id(id), family_name(name) 
+Family::Family(uint64_t id, std::string name)
+    : family_id(id), family_name(std::move(name)) 
 {
 
 }
@@ -41,6 +42,79 @@ Family::~Family()
 void Family::addMember(const Member& member) 
 {
     members.push_back(member);
+    indexLastMember();
+}
+
+/**
+ * @brief Adds a member to the family, taking over its storage.
+ * 
+ * @param member The member to be moved in.
+ */
+void Family::addMember(Member&& member) 
+{
+    members.push_back(std::move(member));
+    indexLastMember();
+}
+
+/**
+ * @brief Constructs a member in place, avoiding a temporary and its copy.
+ * 
+ * @param id ID of the member.
+ * @param name Name of the member.
+ * @param nickname Nickname of the member.
+ * @return Member& The new member.
+ */
+Member& Family::emplaceMember(uint64_t id, std::string name, std::string nickname)
+{
+    members.emplace_back(id, std::move(name), std::move(nickname));
+    indexLastMember();
+    return members.back();
+}
+
+/**
+ * @brief Reserves space for members about to be added.
+ * 
+ * @param count Expected number of members.
+ */
+void Family::reserveMembers(std::size_t count)
+{
+    members.reserve(count);
+    member_index.reserve(count);
+}
+
+/**
+ * @brief Add the most recently appended member to the index.
+ * 
+ * IDs arriving in ascending order (the storage layer loads members by ID)
+ * are appended; anything else is inserted at its sorted position.
+ */
+void Family::indexLastMember()
+{
+    std::pair<uint64_t, std::size_t> entry(members.back().getId(), members.size() - 1);
+
+    if (member_index.empty() || member_index.back() < entry)
+    {
+        member_index.push_back(entry);
+        return;
+    }
+
+    member_index.insert(std::upper_bound(member_index.begin(), member_index.end(), entry), entry);
+}
+
+/**
+ * @brief Rebuild the index after positions in the member list have shifted.
+ */
+void Family::rebuildMemberIndex()
+{
+    member_index.clear();
+    member_index.reserve(members.size());
+
+    for (std::size_t position = 0; position < members.size(); ++position)
+    {
+        member_index.emplace_back(members[position].getId(), position);
+    }
+
+    std::sort(member_index.begin(), member_index.end());
 }
 
 /**
@@ -52,17 +126,18 @@ void Family::addMember(const Member& member)
  */
 bool Family::removeMember(const uint64_t& member_id) 
 {
-    auto it = std::remove_if(members.begin(), members.end(), [&](const Member& member) {
-        return member.getId() == member_id;
-    });
-
-    if (it != members.end()) 
+    if (!getMember(member_id))
     {
-        members.erase(it, members.end());
-        return true;
+        return false;
     }
 
-    return false;
+    // Erasing keeps the list contiguous and in order; later positions shift
+    std::erase_if(members, [&](const Member& member) {
+        return member.getId() == member_id;
+    });
+
+    rebuildMemberIndex();
+    return true;
 }
 
 /**
@@ -73,16 +148,28 @@ bool Family::removeMember(const uint64_t& member_id)
  */
 Member* Family::getMember(const uint64_t& member_id) 
 {
-    auto it = std::find_if(members.begin(), members.end(), [&](const Member& member) {
-        return member.getId() == member_id;
+    return const_cast<Member*>(std::as_const(*this).getMember(member_id));
+}
+
+/**
+ * @brief Retrieves a member by their ID.
+ * 
+ * @param member_id The ID of the member to retrieve.
+ * @return const Member* Pointer to the member if found, nullptr otherwise.
+ */
+const Member* Family::getMember(const uint64_t& member_id) const
+{
+    auto it = std::lower_bound(member_index.begin(), member_index.end(), member_id,
+                               [](const std::pair<uint64_t, std::size_t>& entry, uint64_t value) {
+        return entry.first < value;
     });
 
-    if (it != members.end()) 
+    if (it == member_index.end() || it->first != member_id)
     {
-        return &(*it);
+        return nullptr;
     }
 
-    return nullptr;
+    return &members[it->second];
 }
 
 /**
@@ -98,18 +185,18 @@ uint64_t Family::getId() const
 /**
  * @brief Get the name of the family.
  * 
- * @return std::string 
+ * @return const std::string& 
  */
-std::string Family::getName() const 
+const std::string& Family::getName() const 
 {
     return family_name;
 }
 /**
  * @brief Get the members of the family.
  * 
- * @return std::vector<Members> 
+ * @return const std::vector<Member>& 
  */
-std::vector<Member> Family::getMembers() const 
+const std::vector<Member>& Family::getMembers() const 
 {
     return members;
 }
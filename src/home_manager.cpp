@@ -1,6 +1,11 @@
 #include "home_manager.hpp"
 #include "reader_factory.hpp"
 #include "net_worth.hpp"
+#include "bank_account.hpp"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
 
 /**
  * @brief Construct a new HomeManager object
@@ -13,6 +18,16 @@ HomeManager::HomeManager()
 	ptr_storage = std::make_unique<StorageManager>();
 }
 
+/**
+ * @brief Construct a HomeManager on top of a caller-provided storage backend
+ *
+ * @param storage Backend to take ownership of; must not be null.
+ */
+HomeManager::HomeManager(std::unique_ptr<StorageInterface> storage)
+	: ptr_storage(std::move(storage))
+{
+}
+
 
 /**
  * @brief Destroy the HomeManager object
@@ -91,29 +106,15 @@ commons::Result HomeManager::deleteFamily(const uint64_t family_id)
  */
 commons::Result HomeManager::addMemberToFamily(const Member &member, const uint64_t family_id)
 {
-	// Fast-path defensive check: enforce REQ-3 (max 255 members) before touching the DB.
-	bool ok = false;
-	uint64_t count = ptr_storage->getMemberCount(family_id, &ok);
-	if (ok)
-	{
-		// Safe cast after validating the business limit. We use uint64_t at
-		// the storage layer to match SQLite's 64-bit results; here we
-		// validate the domain (REQ-3) and then cast to a narrower unsigned
-		// type for local reasoning.
-		if (count >= 255)
-		{
-			return commons::Result::MaxMembersExceeded;
-		}
-		// At this point count < 255 so casting to a narrower integer type would be safe
-	}
-
-	uint64_t id = 0;
-	return ptr_storage->saveMemberDataEx(member, family_id, &id);
+	return addMemberToFamily(member, family_id, nullptr);
 }
 
 /**
  * @brief Add a member to a family and retrieve the created ID.
  * 
+ * The storage layer enforces REQ-3 (max 255 members) as part of the insert,
+ * so no separate count is needed here.
+ * 
  * @param member Member to add.
  * @param family_id ID of the family to add the member to.
  * @param out_member_id Pointer to store the created member ID.
@@ -121,14 +122,6 @@ commons::Result HomeManager::addMemberToFamily(const Member &member, const uint6
  */
 commons::Result HomeManager::addMemberToFamily(const Member &member, const uint64_t family_id, uint64_t* out_member_id)
 {
-	// Fast-path defensive check: enforce REQ-3 (max 255 members) before touching the DB.
-	bool ok = false;
-	uint64_t count = ptr_storage->getMemberCount(family_id, &ok);
-	if (ok && count >= 255)
-	{
-		return commons::Result::MaxMembersExceeded;
-	}
-
 	return ptr_storage->saveMemberDataEx(member, family_id, out_member_id);
 }
 
@@ -145,6 +138,42 @@ std::unique_ptr<Member> HomeManager::getMember(const uint64_t member_id)
 	return std::unique_ptr<Member>(m);
 }
 
+/**
+ * @brief Look up several members at once.
+ * 
+ * @param member_ids Requested IDs.
+ * @param out_members One entry per requested ID, std::nullopt if not found.
+ * @return commons::Result 
+ */
+commons::Result HomeManager::getMembers(std::span<const uint64_t> member_ids, std::vector<std::optional<Member>>* out_members)
+{
+	return ptr_storage->getMembersEx(member_ids, out_members);
+}
+
+/**
+ * @brief Look up several families (with their members) at once.
+ * 
+ * @param family_ids Requested IDs.
+ * @param out_families One entry per requested ID, std::nullopt if not found.
+ * @return commons::Result 
+ */
+commons::Result HomeManager::getFamilies(std::span<const uint64_t> family_ids, std::vector<std::optional<Family>>* out_families)
+{
+	return ptr_storage->getFamiliesEx(family_ids, out_families);
+}
+
+/**
+ * @brief Look up several bank account rows at once.
+ * 
+ * @param bank_account_ids Requested IDs.
+ * @param out_accounts One entry per requested ID, std::nullopt if not found.
+ * @return commons::Result 
+ */
+commons::Result HomeManager::getBankAccounts(std::span<const uint64_t> bank_account_ids, std::vector<std::optional<BankAccount>>* out_accounts)
+{
+	return ptr_storage->getBankAccountsEx(bank_account_ids, out_accounts);
+}
+
 /**
  * @brief Update a member's details.
  * 
@@ -170,6 +199,18 @@ commons::Result HomeManager::deleteMember(const uint64_t member_id)
 	return ptr_storage->deleteMemberDataEx(member_id);
 }
 
+/**
+ * @brief Delete several members at once.
+ * 
+ * @param member_ids IDs of the members to delete.
+ * @param out_results Optional per-ID outcome (Ok or NotFound), aligned with member_ids.
+ * @return commons::Result DbError if the batch could not be committed, else Ok.
+ */
+commons::Result HomeManager::deleteMembers(const std::vector<uint64_t> &member_ids, std::vector<commons::Result>* out_results)
+{
+	return ptr_storage->deleteMembersEx(member_ids, out_results);
+}
+
 /**
  * @brief List all families in the database.
  * 
@@ -191,13 +232,43 @@ std::vector<Member> HomeManager::listMembersOfFamily(const uint64_t family_id)
 	return ptr_storage->listMembersOfFamily(family_id);
 }
 
+/**
+ * @brief List all families, allocating the result from an arena.
+ * 
+ * @param arena Memory resource that must outlive the returned vector
+ * @return std::pmr::vector<FamilyRow> Families ordered by ID
+ */
+std::pmr::vector<FamilyRow> HomeManager::listFamilies(std::pmr::memory_resource* arena)
+{
+	return ptr_storage->listFamilies(arena);
+}
+
+/**
+ * @brief List the members of a family, allocating the result from an arena.
+ * 
+ * @param family_id ID of the family whose members to list
+ * @param arena Memory resource that must outlive the returned vector
+ * @return std::pmr::vector<MemberRow> Members ordered by ID
+ */
+std::pmr::vector<MemberRow> HomeManager::listMembersOfFamily(const uint64_t family_id, std::pmr::memory_resource* arena)
+{
+	return ptr_storage->listMembersOfFamily(family_id, arena);
+}
+
 // Import a bank statement by parsing the file with the provided reader and
-// persisting the parsed account data.
+// persisting the parsed account data. The statement is filed under the
+// member's existing account with the same bank and account number (if any)
+// and recorded in that account's balance history; an undated statement
+// with lines is taken to end on its last line. Statement lines are saved
+// against the resolved account, but only once they reconcile with the
+// statement's balances. Everything is written in one transaction.
 commons::Result HomeManager::importBankStatement(BankReader &reader,
 												const std::string &filePath,
 												const uint64_t member_id,
 												const uint64_t bank_id,
-												uint64_t* out_bank_account_id)
+												uint64_t* out_bank_account_id,
+												ReconciliationReport* out_report,
+												uint64_t* out_duplicates)
 {
 	// Parse the file
 	commons::Result r = reader.parseFile(filePath);
@@ -214,7 +285,50 @@ commons::Result HomeManager::importBankStatement(BankReader &reader,
 	}
 
 	const auto &info = *infoOpt;
-	return ptr_storage->saveBankAccountEx(bank_id, member_id, info.accountNumber, info.openingBalancePaise, info.closingBalancePaise, out_bank_account_id);
+
+	if (!info.transactions.empty())
+	{
+		ReconciliationReport report;
+		r = reconcileStatement(info, &report);
+
+		if (out_report)
+		{
+			*out_report = report;
+		}
+
+		if (r != commons::Result::Ok)
+		{
+			return r;
+		}
+
+		if (!report.balanced)
+		{
+			return commons::Result::Unreconciled;
+		}
+	}
+
+	StatementImport statement;
+	statement.bank_id = bank_id;
+	statement.member_id = member_id;
+	statement.account_number = info.accountNumber;
+	statement.opening_paise = info.openingBalancePaise;
+	statement.closing_paise = info.closingBalancePaise;
+	statement.period_start = info.periodStart;
+	statement.period_end = info.periodEnd;
+	statement.transactions = info.transactions;
+
+	// Without a stated period, the statement runs up to its last line
+	if (!statement.period_end && !info.transactions.empty())
+	{
+		statement.period_end = std::max_element(info.transactions.begin(), info.transactions.end(),
+			[](const BankTransaction &lhs, const BankTransaction &rhs) { return lhs.date < rhs.date; })->date;
+		statement.period_start.reset();
+	}
+
+	// Storage files it under the member's account with this number at this
+	// bank (creating it if needed) in the same write as its balance snapshot
+	// and lines, so re-imports share one account and its duplicate checks
+	return ptr_storage->importStatementEx(statement, out_bank_account_id, out_duplicates);
 }
 
 // Resolve bank name to id then delegate
@@ -222,7 +336,9 @@ commons::Result HomeManager::importBankStatement(BankReader &reader,
 												const std::string &filePath,
 												const uint64_t member_id,
 												const std::string &bank_name,
-												uint64_t* out_bank_account_id)
+												uint64_t* out_bank_account_id,
+												ReconciliationReport* out_report,
+												uint64_t* out_duplicates)
 {
 	uint64_t bank_id = 0;
 	auto r = ptr_storage->getBankIdByName(bank_name, &bank_id);
@@ -230,14 +346,16 @@ commons::Result HomeManager::importBankStatement(BankReader &reader,
 	{
 		return r;
 	}
-	return importBankStatement(reader, filePath, member_id, bank_id, out_bank_account_id);
+	return importBankStatement(reader, filePath, member_id, bank_id, out_bank_account_id, out_report, out_duplicates);
 }
 
 // Convenience: create reader via ReaderFactory using bank id and import
 commons::Result HomeManager::importBankStatement(const std::string &filePath,
 												 const uint64_t member_id,
 												 const uint64_t bank_id,
-												 uint64_t* out_bank_account_id)
+												 uint64_t* out_bank_account_id,
+												 ReconciliationReport* out_report,
+												 uint64_t* out_duplicates)
 {
 	auto reader = ReaderFactory::createByBankId(ptr_storage.get(), bank_id);
 	if (!reader)
@@ -245,14 +363,16 @@ commons::Result HomeManager::importBankStatement(const std::string &filePath,
 		return commons::Result::NotFound; // no reader for this bank
 	}
 
-	return importBankStatement(*reader, filePath, member_id, bank_id, out_bank_account_id);
+	return importBankStatement(*reader, filePath, member_id, bank_id, out_bank_account_id, out_report, out_duplicates);
 }
 
 // Convenience: resolve name -> id then use ReaderFactory to create reader
 commons::Result HomeManager::importBankStatement(const std::string &filePath,
 												 const uint64_t member_id,
 												 const std::string &bank_name,
-												 uint64_t* out_bank_account_id)
+												 uint64_t* out_bank_account_id,
+												 ReconciliationReport* out_report,
+												 uint64_t* out_duplicates)
 {
 	uint64_t bank_id = 0;
 	auto r = ptr_storage->getBankIdByName(bank_name, &bank_id);
@@ -261,7 +381,7 @@ commons::Result HomeManager::importBankStatement(const std::string &filePath,
 		return r;
 	}
 
-	return importBankStatement(filePath, member_id, bank_id, out_bank_account_id);
+	return importBankStatement(filePath, member_id, bank_id, out_bank_account_id, out_report, out_duplicates);
 }
 
 	commons::Result HomeManager::computeMemberNetWorth(const uint64_t member_id, long long* out_net_worth_paise)
@@ -286,3 +406,177 @@ commons::Result HomeManager::importBankStatement(const std::string &filePath,
 		NetWorth nw(ptr_storage.get());
 		return nw.computeFamilyNetWorth(family_id, out_net_worth_paise);
 	}
+
+
+	commons::Result HomeManager::computeAllNetWorths(NetWorthSnapshot* out_snapshot, const unsigned thread_count)
+	{
+		if (!out_snapshot)
+		{
+			return commons::Result::InvalidInput;
+		}
+
+		NetWorth nw(ptr_storage.get());
+		return nw.computeAllNetWorths(out_snapshot, thread_count);
+	}
+
+
+	commons::Result HomeManager::loadAnalyticsSnapshot(AnalyticsSnapshot* out_snapshot)
+	{
+		if (!out_snapshot)
+		{
+			return commons::Result::InvalidInput;
+		}
+
+		return out_snapshot->load(ptr_storage.get());
+	}
+
+
+	commons::Result HomeManager::computeMonthlyNetWorth(const NetWorthScope scope,
+													   const uint64_t scope_id,
+													   const std::chrono::year_month first_month,
+													   const std::chrono::year_month last_month,
+													   std::vector<NetWorthPoint>* out_points)
+	{
+		NetWorth nw(ptr_storage.get());
+		return nw.computeMonthlyNetWorth(scope, scope_id, first_month, last_month, out_points);
+	}
+
+
+	commons::Result HomeManager::getCashFlow(const NetWorthScope scope,
+											 const uint64_t scope_id,
+											 const commons::Month first_month,
+											 const commons::Month last_month,
+											 std::vector<CashFlowMonth>* out_months)
+	{
+		return ptr_storage->getCashFlowEx(scope, scope_id, first_month, last_month, out_months);
+	}
+
+
+	commons::Result HomeManager::rebuildCashFlowRollups()
+	{
+		return ptr_storage->rebuildCashFlowRollupsEx();
+	}
+
+
+	commons::Result HomeManager::checkCashFlowRollups(uint64_t* out_mismatched_rows)
+	{
+		return ptr_storage->checkCashFlowRollupsEx(out_mismatched_rows);
+	}
+
+
+	commons::Result HomeManager::searchTransactions(const std::string& text,
+													std::size_t limit,
+													std::vector<TransactionMatch>* out_matches)
+	{
+		return ptr_storage->searchTransactionsEx(text, limit, out_matches);
+	}
+
+
+	commons::Result HomeManager::addCategoryRule(const std::string& category_name,
+												 const std::string& keyword,
+												 int priority,
+												 uint64_t* out_rule_id)
+	{
+		return ptr_storage->saveCategoryRuleEx(category_name, keyword, priority, out_rule_id);
+	}
+
+
+	commons::Result HomeManager::deleteCategoryRule(const uint64_t rule_id)
+	{
+		return ptr_storage->deleteCategoryRuleEx(rule_id);
+	}
+
+
+	commons::Result HomeManager::listCategories(std::vector<TransactionCategory>* out_categories)
+	{
+		return ptr_storage->listCategoriesEx(out_categories);
+	}
+
+
+	commons::Result HomeManager::listCategoryRules(std::vector<CategoryRule>* out_rules)
+	{
+		return ptr_storage->listCategoryRulesEx(out_rules);
+	}
+
+
+	/**
+	 * @brief Add the keyword rules listed in a rules file.
+	 *
+	 * @param path Rules file (`Category,Keyword[,Priority]` per line).
+	 * @param out_rule_count Optional; receives the number of rules added
+	 *        (rules already present only take the file's priority).
+	 * @return commons::Result NotFound if the file cannot be opened,
+	 *         InvalidInput (nothing saved) if any line is malformed.
+	 */
+	commons::Result HomeManager::importCategoryRules(const std::string& path, uint64_t* out_rule_count)
+	{
+		if (out_rule_count)
+		{
+			*out_rule_count = 0;
+		}
+
+		std::ifstream in(path);
+
+		if (!in.is_open())
+		{
+			return commons::Result::NotFound;
+		}
+
+		std::vector<CategoryRule> rules;
+		std::vector<std::string> category_names;
+		std::string line;
+		bool first_line = true;
+
+		while (std::getline(in, line))
+		{
+			std::vector<std::string> fields;
+			std::stringstream stream(line);
+			std::string field;
+
+			while (std::getline(stream, field, ','))
+			{
+				field.erase(0, field.find_first_not_of(" \t\r"));
+				field.erase(field.find_last_not_of(" \t\r") + 1);
+				fields.push_back(field);
+			}
+
+			bool header = first_line && !fields.empty() && fields[0] == "Category";
+			first_line = false;
+
+			if (fields.empty() || (fields.size() == 1 && fields[0].empty()) || fields[0].starts_with('#') || header)
+			{
+				continue;
+			}
+
+			CategoryRule rule;
+
+			if (fields.size() < 2 || fields.size() > 3 ||
+				commons::searchTokens(fields[0]).empty() || commons::searchTokens(fields[1]).empty())
+			{
+				return commons::Result::InvalidInput;
+			}
+
+			if (fields.size() == 3)
+			{
+				const std::string& text = fields[2];
+				auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), rule.priority);
+
+				if (error != std::errc() || end != text.data() + text.size())
+				{
+					return commons::Result::InvalidInput;
+				}
+			}
+
+			rule.keyword = fields[1];
+			rules.push_back(std::move(rule));
+			category_names.push_back(fields[0]);
+		}
+
+		return ptr_storage->saveCategoryRulesEx(category_names, rules, out_rule_count);
+	}
+
+
+	commons::Result HomeManager::recategorizeTransactions(std::size_t batch_size, uint64_t* out_changed)
+	{
+		return ptr_storage->recategorizeTransactionsEx(batch_size, out_changed);
+	}
@@ -0,0 +1,119 @@
+#include "json_lines_server.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Construct a new JsonLinesServer object.
+ *
+ * @param home HomeManager serving every request; must outlive the server.
+ * @param in Request stream (one JSON object per line).
+ * @param out Response stream.
+ * @param worker_count Number of worker threads (at least 1).
+ */
+JsonLinesServer::JsonLinesServer(HomeManager& home, std::istream& in, std::ostream& out, unsigned worker_count)
+    : dispatcher(home), in(in), out(out), worker_count(std::max(1u, worker_count))
+{
+}
+
+/**
+ * @brief Read requests until end of input and serve them on the worker pool.
+ */
+void JsonLinesServer::run()
+{
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+
+    for (unsigned index = 0; index < worker_count; ++index)
+    {
+        workers.emplace_back(&JsonLinesServer::workerLoop, this);
+    }
+
+    std::string line;
+
+    while (std::getline(in, line))
+    {
+        // Blank lines are keep-alives
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> queue_lock(queue_mutex);
+        space_cv.wait(queue_lock, [this]() { return pending.size() < kMaxPendingRequests; });
+        pending.push_back(std::move(line));
+        queue_lock.unlock();
+        queue_cv.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> queue_lock(queue_mutex);
+        input_done = true;
+    }
+
+    queue_cv.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    out.flush();
+}
+
+/**
+ * @brief Worker thread body: take requests off the queue and answer them.
+ */
+void JsonLinesServer::workerLoop()
+{
+    while (true)
+    {
+        std::string request;
+
+        {
+            std::unique_lock<std::mutex> queue_lock(queue_mutex);
+            queue_cv.wait(queue_lock, [this]() { return !pending.empty() || input_done; });
+
+            if (pending.empty())
+            {
+                return;
+            }
+
+            request = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        space_cv.notify_one();
+        writeResponse(dispatcher.handleLine(request));
+    }
+}
+
+/**
+ * @brief Write one response line.
+ *
+ * The stream is flushed only when no further requests are queued, so a burst
+ * of pipelined requests is answered with few writes while a lone request is
+ * answered immediately.
+ *
+ * @param response Serialised response without newline.
+ */
+void JsonLinesServer::writeResponse(const std::string& response)
+{
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    out << response << '\n';
+
+    // Checked after writing: any request still queued will be answered (and
+    // this check repeated) by a later write, so the last response always flushes
+    bool idle = false;
+
+    {
+        std::lock_guard<std::mutex> queue_lock(queue_mutex);
+        idle = pending.empty();
+    }
+
+    if (idle)
+    {
+        out.flush();
+    }
+}
@@ -0,0 +1,689 @@
+#include "json_value.hpp"
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+
+/**
+ * Recursive-descent parser for JsonValue. Declared a friend of JsonValue so
+ * it can fill in the private members directly.
+ */
+class JsonParser
+{
+public:
+    explicit JsonParser(const std::string& text)
+        : text(text)
+    {
+    }
+
+    /**
+     * @brief Parse the whole input as one JSON value.
+     *
+     * @param out Parsed value.
+     * @return true if the input is exactly one valid JSON value.
+     */
+    bool parseDocument(JsonValue& out)
+    {
+        skipWhitespace();
+
+        if (!parseValue(out, 0))
+        {
+            return false;
+        }
+
+        skipWhitespace();
+        return pos == text.size();
+    }
+
+private:
+    // Nesting limit so hostile input cannot exhaust the stack
+    static constexpr int kMaxDepth = 64;
+
+    const std::string& text;
+    std::size_t pos{0};
+
+    void skipWhitespace()
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+        {
+            ++pos;
+        }
+    }
+
+    bool consume(char expected)
+    {
+        if (pos < text.size() && text[pos] == expected)
+        {
+            ++pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool consumeLiteral(const char* literal)
+    {
+        std::size_t length = std::char_traits<char>::length(literal);
+
+        if (text.compare(pos, length, literal) != 0)
+        {
+            return false;
+        }
+
+        pos += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, int depth)
+    {
+        if (depth > kMaxDepth || pos >= text.size())
+        {
+            return false;
+        }
+
+        switch (text[pos])
+        {
+            case '{':
+                return parseObject(out, depth);
+            case '[':
+                return parseArray(out, depth);
+            case '"':
+                out.kind = JsonValue::Type::String;
+                return parseString(out.text);
+            case 't':
+                out = JsonValue::boolean(true);
+                return consumeLiteral("true");
+            case 'f':
+                out = JsonValue::boolean(false);
+                return consumeLiteral("false");
+            case 'n':
+                out = JsonValue();
+                return consumeLiteral("null");
+            default:
+                return parseNumber(out);
+        }
+    }
+
+    bool parseObject(JsonValue& out, int depth)
+    {
+        out = JsonValue::object();
+        ++pos; // '{'
+        skipWhitespace();
+
+        if (consume('}'))
+        {
+            return true;
+        }
+
+        while (true)
+        {
+            std::string key;
+            JsonValue value;
+            skipWhitespace();
+
+            if (pos >= text.size() || text[pos] != '"' || !parseString(key))
+            {
+                return false;
+            }
+
+            skipWhitespace();
+
+            if (!consume(':'))
+            {
+                return false;
+            }
+
+            skipWhitespace();
+
+            if (!parseValue(value, depth + 1))
+            {
+                return false;
+            }
+
+            out.object_members.emplace_back(std::move(key), std::move(value));
+            skipWhitespace();
+
+            if (consume('}'))
+            {
+                return true;
+            }
+
+            if (!consume(','))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool parseArray(JsonValue& out, int depth)
+    {
+        out = JsonValue::array();
+        ++pos; // '['
+        skipWhitespace();
+
+        if (consume(']'))
+        {
+            return true;
+        }
+
+        while (true)
+        {
+            JsonValue value;
+            skipWhitespace();
+
+            if (!parseValue(value, depth + 1))
+            {
+                return false;
+            }
+
+            out.array_items.push_back(std::move(value));
+            skipWhitespace();
+
+            if (consume(']'))
+            {
+                return true;
+            }
+
+            if (!consume(','))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool parseHex4(uint32_t& code_unit)
+    {
+        if (pos + 4 > text.size())
+        {
+            return false;
+        }
+
+        auto result = std::from_chars(text.data() + pos, text.data() + pos + 4, code_unit, 16);
+
+        if (result.ptr != text.data() + pos + 4)
+        {
+            return false;
+        }
+
+        pos += 4;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code_point)
+    {
+        if (code_point < 0x80)
+        {
+            out.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else if (code_point < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+
+    bool parseString(std::string& out)
+    {
+        ++pos; // opening quote
+
+        while (pos < text.size())
+        {
+            char ch = text[pos++];
+
+            if (ch == '"')
+            {
+                return true;
+            }
+
+            if (static_cast<unsigned char>(ch) < 0x20)
+            {
+                return false; // raw control characters must be escaped
+            }
+
+            if (ch != '\\')
+            {
+                out.push_back(ch);
+                continue;
+            }
+
+            if (pos >= text.size())
+            {
+                return false;
+            }
+
+            char escape = text[pos++];
+
+            switch (escape)
+            {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u':
+                {
+                    uint32_t code_point = 0;
+
+                    if (!parseHex4(code_point))
+                    {
+                        return false;
+                    }
+
+                    // Combine a UTF-16 surrogate pair
+                    if (code_point >= 0xD800 && code_point <= 0xDBFF)
+                    {
+                        uint32_t low = 0;
+
+                        if (!consumeLiteral("\\u") || !parseHex4(low) || low < 0xDC00 || low > 0xDFFF)
+                        {
+                            return false;
+                        }
+
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    else if (code_point >= 0xDC00 && code_point <= 0xDFFF)
+                    {
+                        return false;
+                    }
+
+                    appendUtf8(out, code_point);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        return false; // unterminated
+    }
+
+    bool parseNumber(JsonValue& out)
+    {
+        std::size_t start = pos;
+        auto digits = [&]()
+        {
+            std::size_t first = pos;
+
+            while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])))
+            {
+                ++pos;
+            }
+
+            return pos > first;
+        };
+
+        consume('-');
+
+        if (consume('0'))
+        {
+            // no leading zeros
+        }
+        else if (!digits())
+        {
+            return false;
+        }
+
+        if (consume('.') && !digits())
+        {
+            return false;
+        }
+
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E'))
+        {
+            ++pos;
+
+            if (!consume('+'))
+            {
+                consume('-');
+            }
+
+            if (!digits())
+            {
+                return false;
+            }
+        }
+
+        out.kind = JsonValue::Type::Number;
+        out.text = text.substr(start, pos - start);
+        return true;
+    }
+};
+
+/**
+ * @brief Construct a null JsonValue.
+ */
+JsonValue::JsonValue()
+{
+}
+
+/**
+ * @brief Make a boolean value.
+ */
+JsonValue JsonValue::boolean(bool value)
+{
+    JsonValue result;
+    result.kind = Type::Bool;
+    result.bool_value = value;
+    return result;
+}
+
+/**
+ * @brief Make a number from a signed integer.
+ */
+JsonValue JsonValue::number(long long value)
+{
+    JsonValue result;
+    result.kind = Type::Number;
+    result.text = std::to_string(value);
+    return result;
+}
+
+/**
+ * @brief Make a number from an unsigned integer.
+ */
+JsonValue JsonValue::number(uint64_t value)
+{
+    JsonValue result;
+    result.kind = Type::Number;
+    result.text = std::to_string(value);
+    return result;
+}
+
+/**
+ * @brief Make a string value.
+ */
+JsonValue JsonValue::string(const std::string& value)
+{
+    JsonValue result;
+    result.kind = Type::String;
+    result.text = value;
+    return result;
+}
+
+/**
+ * @brief Make an empty array.
+ */
+JsonValue JsonValue::array()
+{
+    JsonValue result;
+    result.kind = Type::Array;
+    return result;
+}
+
+/**
+ * @brief Make an empty object.
+ */
+JsonValue JsonValue::object()
+{
+    JsonValue result;
+    result.kind = Type::Object;
+    return result;
+}
+
+/**
+ * @brief Parse a complete JSON text.
+ *
+ * @param text Input text (one document).
+ * @return std::optional<JsonValue> The value, or std::nullopt on error.
+ */
+std::optional<JsonValue> JsonValue::parse(const std::string& text)
+{
+    JsonValue result;
+    JsonParser parser(text);
+
+    if (!parser.parseDocument(result))
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Boolean value, or std::nullopt for other types.
+ */
+std::optional<bool> JsonValue::asBool() const
+{
+    if (kind != Type::Bool)
+    {
+        return std::nullopt;
+    }
+
+    return bool_value;
+}
+
+/**
+ * @brief Integer value of a number without fraction or exponent.
+ *
+ * @return std::optional<long long> std::nullopt if not an exact long long.
+ */
+std::optional<long long> JsonValue::asInt64() const
+{
+    long long value = 0;
+
+    if (kind != Type::Number)
+    {
+        return std::nullopt;
+    }
+
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Unsigned integer value of a non-negative whole number.
+ *
+ * @return std::optional<uint64_t> std::nullopt if not an exact uint64_t.
+ */
+std::optional<uint64_t> JsonValue::asUint64() const
+{
+    uint64_t value = 0;
+
+    if (kind != Type::Number || text.empty() || text[0] == '-')
+    {
+        return std::nullopt;
+    }
+
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+/**
+ * @brief String value, or std::nullopt for other types.
+ */
+std::optional<std::string> JsonValue::asString() const
+{
+    if (kind != Type::String)
+    {
+        return std::nullopt;
+    }
+
+    return text;
+}
+
+/**
+ * @brief Append an element to an array.
+ */
+void JsonValue::push(JsonValue value)
+{
+    array_items.push_back(std::move(value));
+}
+
+/**
+ * @brief Look up an object member.
+ *
+ * @param key Member name.
+ * @return const JsonValue* The member, or nullptr when absent.
+ */
+const JsonValue* JsonValue::find(const std::string& key) const
+{
+    for (const auto &member : object_members)
+    {
+        if (member.first == key)
+        {
+            return &member.second;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Set an object member, replacing an existing key.
+ *
+ * @param key Member name.
+ * @param value Member value.
+ */
+void JsonValue::set(const std::string& key, JsonValue value)
+{
+    for (auto &member : object_members)
+    {
+        if (member.first == key)
+        {
+            member.second = std::move(value);
+            return;
+        }
+    }
+
+    object_members.emplace_back(key, std::move(value));
+}
+
+namespace
+{
+    /**
+     * @brief Append a JSON string literal with the required escapes.
+     *
+     * @param out Destination.
+     * @param value Raw (UTF-8) string.
+     */
+    void appendQuoted(std::string& out, const std::string& value)
+    {
+        out.push_back('"');
+
+        for (char ch : value)
+        {
+            switch (ch)
+            {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                default:
+                {
+                    if (static_cast<unsigned char>(ch) < 0x20)
+                    {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(ch));
+                        out += escaped;
+                    }
+                    else
+                    {
+                        out.push_back(ch);
+                    }
+                }
+            }
+        }
+
+        out.push_back('"');
+    }
+}
+
+/**
+ * @brief Compact single-line serialisation.
+ */
+std::string JsonValue::dump() const
+{
+    std::string out;
+    dumpTo(out);
+    return out;
+}
+
+/**
+ * @brief Append the compact serialisation of this value to `out`.
+ *
+ * @param out Destination string.
+ */
+void JsonValue::dumpTo(std::string& out) const
+{
+    switch (kind)
+    {
+        case Type::Null:
+            out += "null";
+            break;
+        case Type::Bool:
+            out += bool_value ? "true" : "false";
+            break;
+        case Type::Number:
+            out += text;
+            break;
+        case Type::String:
+            appendQuoted(out, text);
+            break;
+        case Type::Array:
+        {
+            out.push_back('[');
+
+            for (std::size_t index = 0; index < array_items.size(); ++index)
+            {
+                if (index > 0)
+                {
+                    out.push_back(',');
+                }
+
+                array_items[index].dumpTo(out);
+            }
+
+            out.push_back(']');
+            break;
+        }
+        case Type::Object:
+        {
+            out.push_back('{');
+
+            for (std::size_t index = 0; index < object_members.size(); ++index)
+            {
+                if (index > 0)
+                {
+                    out.push_back(',');
+                }
+
+                appendQuoted(out, object_members[index].first);
+                out.push_back(':');
+                object_members[index].second.dumpTo(out);
+            }
+
+            out.push_back('}');
+            break;
+        }
+    }
+}
@@ -1,6 +1,16 @@
 #include "tui_manager.hpp"
+#include "cli_manager.hpp"
+#include "home_manager.hpp"
+#include "json_lines_server.hpp"
+#include "socket_server.hpp"
+#include "storage_manager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 /**
  * @brief Print usage information for the application.
@@ -9,10 +19,123 @@
  */
 static void printUsage(const char* prog)
 {
-    std::cout << "Usage: " << prog << " [--tui] [--help]\n";
+    std::cout << "Usage: " << prog << " [--tui | --json-lines | --serve SOCKET] [--db PATH] [--workers N] [--startup-time] [--help]\n";
+    std::cout << "       " << prog << " SUBCOMMAND [OPTIONS] [ARGS...]\n";
     std::cout << "Options:\n";
-    std::cout << "  --tui     Launch the terminal-based UI (default)\n";
-    std::cout << "  --help    Show this help message\n";
+    std::cout << "  --tui           Launch the terminal-based UI (default)\n";
+    std::cout << "  --json-lines    Serve JSON requests on stdin, one per line, answering on stdout\n";
+    std::cout << "  --serve SOCKET  Serve the same protocol to many clients on a Unix domain socket\n";
+    std::cout << "  --db PATH       Database for --json-lines/--serve/--startup-time (default: homefinancials.db)\n";
+    std::cout << "  --workers N     Worker threads for --json-lines/--serve (default: one per CPU, max 8)\n";
+    std::cout << "  --startup-time  Open the database, report cold-start time and exit\n";
+    std::cout << "  --help          Show this help message\n";
+    std::cout << "\n";
+
+    CLIManager cli;
+    cli.printUsage();
+}
+
+/**
+ * @brief Open the database and report the time taken since process start.
+ * 
+ * Used to measure cold-start cost for scripted (cron) invocations:
+ * everything up to a usable storage connection is included.
+ * 
+ * @param start Time point captured at the top of main.
+ * @param db_path Database path ("" selects the default).
+ * @return int Process exit code.
+ */
+static int reportStartupTime(std::chrono::steady_clock::time_point start, const std::string& db_path)
+{
+    HomeManager home;
+    StorageManager* storage = home.getStorageManager();
+
+    if (!storage || !storage->initializeDatabase(db_path))
+    {
+        std::cerr << "Failed to open the database." << std::endl;
+        return 1;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Startup time: " << elapsed.count() << " us (schema version " << storage->getSchemaVersion() << ")" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Serve the JSON-lines protocol on stdin/stdout until end of input.
+ * 
+ * @param db_path Database path ("" selects the default).
+ * @param worker_count Number of worker threads.
+ * @return int Process exit code.
+ */
+static int runJsonLines(const std::string& db_path, unsigned worker_count)
+{
+    HomeManager home;
+    StorageManager* storage = home.getStorageManager();
+
+    // Open once up front so every request runs against a warm connection
+    if (!storage || !storage->initializeDatabase(db_path))
+    {
+        std::cerr << "Failed to open the database." << std::endl;
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    JsonLinesServer server(home, std::cin, std::cout, worker_count);
+    server.run();
+    return 0;
+}
+
+// Server stopped by SIGINT/SIGTERM; set while runSocketServer is running
+static SocketServer* active_server = nullptr;
+
+/**
+ * @brief Signal handler asking the socket server to shut down.
+ * 
+ * @param signal_number Received signal (unused).
+ */
+static void stopActiveServer(int /*signal_number*/)
+{
+    if (active_server)
+    {
+        active_server->stop();
+    }
+}
+
+/**
+ * @brief Serve the JSON-lines protocol on a Unix domain socket until SIGINT/SIGTERM.
+ * 
+ * @param socket_path Socket file to listen on.
+ * @param db_path Database path ("" selects the default).
+ * @param worker_count Number of worker threads.
+ * @return int Process exit code.
+ */
+static int runSocketServer(const std::string& socket_path, const std::string& db_path, unsigned worker_count)
+{
+    HomeManager home;
+    StorageManager* storage = home.getStorageManager();
+
+    if (!storage || !storage->initializeDatabase(db_path))
+    {
+        std::cerr << "Failed to open the database." << std::endl;
+        return 1;
+    }
+
+    SocketServer server(home, socket_path, worker_count);
+
+    if (!server.start())
+    {
+        return 1;
+    }
+
+    active_server = &server;
+    std::signal(SIGINT, stopActiveServer);
+    std::signal(SIGTERM, stopActiveServer);
+    server.run();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    active_server = nullptr;
+    return 0;
 }
 
 /**
@@ -24,7 +147,19 @@ static void printUsage(const char* prog)
  */
 int main(int argc, char** argv)
 {
+    const auto start = std::chrono::steady_clock::now();
     bool launch_tui = true; // default for now
+    bool startup_time = false;
+    std::string db_path;
+    std::string socket_path;
+    unsigned worker_count = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+
+    // Scripted runs: execute one subcommand without entering the menu loop
+    if (argc > 1 && CLIManager::isSubcommand(argv[1]))
+    {
+        CLIManager cli;
+        return cli.run(std::vector<std::string>(argv + 1, argv + argc));
+    }
 
     // Simple CLI parsing: recognize --tui and --help. Unknown options
     // will default to launching the TUI but print a hint.
@@ -40,12 +175,49 @@ int main(int argc, char** argv)
         {
             launch_tui = true;
         } 
+        else if (arg == "--json-lines") 
+        {
+            launch_tui = false;
+        } 
+        else if ((arg == "--db" || arg == "--workers" || arg == "--serve") && i + 1 < argc) 
+        {
+            std::string value(argv[++i]);
+
+            if (arg == "--db")
+            {
+                db_path = value;
+            }
+            else if (arg == "--serve")
+            {
+                launch_tui = false;
+                socket_path = value;
+            }
+            else if (auto parsed = commons::parseId(value); parsed && *parsed > 0 && *parsed <= 64)
+            {
+                worker_count = static_cast<unsigned>(*parsed);
+            }
+            else
+            {
+                std::cerr << "--workers must be between 1 and 64." << std::endl;
+                return 2;
+            }
+        } 
+        else if (arg == "--startup-time") 
+        {
+            startup_time = true;
+        } 
         else 
         {
             std::cout << "Unknown option: '" << arg << "' -- defaulting to TUI. Use --help for options." << std::endl;
         }
     }
 
+    // Measured after parsing so a --db anywhere on the line is honoured
+    if (startup_time)
+    {
+        return reportStartupTime(start, db_path);
+    }
+
     if (launch_tui) 
     {
         TUIManager tui;
@@ -53,8 +225,10 @@ int main(int argc, char** argv)
         return 0;
     }
 
-    // Placeholder for future UI types; currently unreachable because
-    // launch_tui defaults to true, but kept to show planned extensibility.
-    std::cout << "No UI selected. Exiting." << std::endl;
-    return 0;
+    if (!socket_path.empty())
+    {
+        return runSocketServer(socket_path, db_path, worker_count);
+    }
+
+    return runJsonLines(db_path, worker_count);
 }
\ No newline at end of file
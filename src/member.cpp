@@ -1,4 +1,5 @@
 #include "member.hpp"
+#include <utility>
 
 /**
  * @brief Construct a new Member:: Member object
@@ -6,8 +7,8 @@
  * @param name member name
  * @param nickname member nickname
  */
-Member::Member(const std::string& name, const std::string& nickname)
-    : member_id(0), member_name(name), member_nickname(nickname) 
+Member::Member(std::string name, std::string nickname)
+    : member_id(0), member_name(std::move(name)), member_nickname(std::move(nickname)) 
 {
 
 }
@@ -19,8 +20,8 @@ Member::Member(const std::string& name, const std::string& nickname)
  * @param name member name
  * @param nickname member nickname
  */
-Member::Member(uint64_t id, const std::string& name, const std::string& nickname)
-    : member_id(id), member_name(name), member_nickname(nickname) 
+Member::Member(uint64_t id, std::string name, std::string nickname)
+    : member_id(id), member_name(std::move(name)), member_nickname(std::move(nickname)) 
 {
 
 }
@@ -47,9 +48,9 @@ uint64_t Member::getId() const
 /**
  * @brief Get the name of the member.
  * 
- * @return std::string 
+ * @return const std::string& 
  */
-std::string Member::getName() const 
+const std::string& Member::getName() const 
 {
     return member_name;
 }
@@ -57,9 +58,9 @@ std::string Member::getName() const
 /**
  * @brief Get the nickname of the member.
  * 
- * @return std::string 
+ * @return const std::string& 
  */
-std::string Member::getNickname() const 
+const std::string& Member::getNickname() const 
 {
     return member_nickname;
 }
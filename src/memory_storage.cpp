@@ -0,0 +1,2109 @@
+#include "memory_storage.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+
+namespace
+{
+    // Magic header identifying a MemoryStorage snapshot file; the seventh
+    // byte is the format version. Version 2 added the shared name table,
+    // version 3 the balance history, version 4 the transactions, version 5
+    // their counterparties, version 6 their running balances and version 7
+    // the category rules. Older versions are still readable.
+    constexpr char kSnapshotMagic[8] = {'H', 'F', 'M', 'E', 'M', 'v', '7', '\n'};
+    constexpr std::size_t kSnapshotVersionByte = 6;
+
+    // Lower bound for rollup range scans
+    constexpr commons::Month kFirstMonth = std::chrono::year::min() / std::chrono::January;
+
+    /**
+     * @brief Case-insensitive ASCII string comparison.
+     *
+     * @param lhs First string.
+     * @param rhs Second string.
+     * @return true if both strings are equal ignoring case.
+     */
+    bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs)
+    {
+        return lhs.size() == rhs.size() &&
+               std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](unsigned char left, unsigned char right)
+                   { return std::tolower(left) == std::tolower(right); });
+    }
+
+    /**
+     * @brief Binary search a vector of records ordered by ascending `id`.
+     *
+     * @param records Records ordered by id.
+     * @param record_id ID to look for.
+     * @return Iterator to the record, or records.end() when absent.
+     */
+    template <typename Records, typename IdOf>
+    auto findById(Records &records, uint64_t record_id, IdOf id_of)
+    {
+        auto it = std::lower_bound(records.begin(), records.end(), record_id, [&](const auto &record, uint64_t value)
+            { return id_of(record) < value; });
+
+        if (it != records.end() && id_of(*it) != record_id)
+        {
+            return records.end();
+        }
+
+        return it;
+    }
+
+    /**
+     * @brief Check that loaded records are strictly ascending by `id` and
+     * that every id is below the next one to be handed out.
+     *
+     * @param records Records as read from a snapshot.
+     * @param next_id Next id the store would assign.
+     * @return true if findById can be used on the records.
+     */
+    template <typename Records, typename IdOf>
+    bool idsAscending(const Records &records, uint64_t next_id, IdOf id_of)
+    {
+        uint64_t previous_id = 0;
+
+        for (const auto &record : records)
+        {
+            if (id_of(record) <= previous_id)
+            {
+                return false;
+            }
+
+            previous_id = id_of(record);
+        }
+
+        return previous_id < next_id;
+    }
+
+    void writeU64(std::ostream &out, uint64_t value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeI64(std::ostream &out, long long value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeString(std::ostream &out, std::string_view value)
+    {
+        writeU64(out, value.size());
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    bool readU64(std::istream &in, uint64_t &value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    bool readI64(std::istream &in, long long &value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    bool readString(std::istream &in, std::string &value)
+    {
+        uint64_t length = 0;
+
+        // Names and account numbers are short; reject obviously corrupt lengths
+        if (!readU64(in, length) || length > (1u << 20))
+        {
+            return false;
+        }
+
+        value.resize(length);
+        return static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(length)));
+    }
+}
+
+/**
+ * @brief Construct an empty in-memory store with the default bank list.
+ */
+MemoryStorage::MemoryStorage()
+{
+    const char* default_banks[] = {"Canara", "SBI", "Axis", "HDFC", "PNB"};
+    uint64_t bank_id = 1;
+
+    for (const char* bank_name : default_banks)
+    {
+        banks.push_back({bank_id++, names.intern(bank_name)});
+    }
+
+    seedDefaultCategories();
+}
+
+/**
+ * @brief Reset categories and rules to the schema version 7 defaults.
+ */
+void MemoryStorage::seedDefaultCategories()
+{
+    categories = {{1, "Salary"}, {2, "Rent"}, {3, "EMI"}, {4, "Groceries"}};
+    category_rules = {
+        {1, 1, "salary"}, {2, 2, "rent"}, {3, 3, "emi"}, {4, 3, "loan repayment"},
+        {5, 4, "grocery"}, {6, 4, "groceries"}, {7, 4, "supermarket"},
+    };
+    next_category_id = 5;
+    next_rule_id = 8;
+    category_rules_version = 1;
+    category_matcher.compile(category_rules);
+}
+
+/**
+ * @brief Destroy the MemoryStorage object.
+ */
+MemoryStorage::~MemoryStorage()
+{
+}
+
+MemoryStorage::FamilyRecord* MemoryStorage::findFamily(uint64_t family_id)
+{
+    auto it = findById(families, family_id, [](const FamilyRecord &record) { return record.id; });
+    return it == families.end() ? nullptr : &(*it);
+}
+
+MemoryStorage::MemberRecord* MemoryStorage::findMember(uint64_t member_id)
+{
+    auto it = findById(members, member_id, [](const MemberRecord &record) { return record.id; });
+    return it == members.end() ? nullptr : &(*it);
+}
+
+BankAccount* MemoryStorage::findAccount(uint64_t bank_account_id)
+{
+    auto it = findById(accounts, bank_account_id, [](const BankAccount &record) { return record.getId(); });
+    return it == accounts.end() ? nullptr : &(*it);
+}
+
+const MemoryStorage::BankRecord* MemoryStorage::findBank(uint64_t bank_id) const
+{
+    auto it = findById(banks, bank_id, [](const BankRecord &record) { return record.id; });
+    return it == banks.end() ? nullptr : &(*it);
+}
+
+/**
+ * @brief Append a member row and index it. Caller holds the write lock.
+ *
+ * @return uint64_t ID of the new member.
+ */
+uint64_t MemoryStorage::insertMember(uint64_t family_id, std::string_view name, std::string_view nickname)
+{
+    uint64_t member_id = next_member_id++;
+    members.push_back({member_id, family_id, names.intern(name), names.intern(nickname)});
+    members_by_family[family_id].push_back(member_id);
+    return member_id;
+}
+
+/**
+ * @brief Remove a member and cascade to its accounts. Caller holds the write lock.
+ *
+ * @param member_id ID of the member to erase.
+ */
+void MemoryStorage::eraseMember(uint64_t member_id)
+{
+    auto account_ids = accounts_by_member.find(member_id);
+
+    if (account_ids != accounts_by_member.end())
+    {
+        for (uint64_t account_id : account_ids->second)
+        {
+            balances_by_account.erase(account_id);
+            transactions_by_account.erase(account_id);
+            fingerprints_by_account.erase(account_id);
+            rules_versions_by_account.erase(account_id);
+        }
+
+        cash_flow_rollups.erase(cash_flow_rollups.lower_bound({member_id, kFirstMonth, 0}),
+                                cash_flow_rollups.lower_bound({member_id + 1, kFirstMonth, 0}));
+        const auto &erased_ids = account_ids->second;
+
+        for (auto posting = search_postings.begin(); posting != search_postings.end();)
+        {
+            std::erase_if(posting->second, [&](const TransactionRef &ref)
+                { return std::find(erased_ids.begin(), erased_ids.end(), ref.bank_account_id) != erased_ids.end(); });
+            posting = posting->second.empty() ? search_postings.erase(posting) : std::next(posting);
+        }
+
+        std::erase_if(accounts, [&](const BankAccount &account)
+            { return account.getMemberId() == member_id; });
+        accounts_by_member.erase(account_ids);
+    }
+
+    auto it = findById(members, member_id, [](const MemberRecord &record) { return record.id; });
+
+    if (it == members.end())
+    {
+        return;
+    }
+
+    auto siblings = members_by_family.find(it->family_id);
+
+    if (siblings != members_by_family.end())
+    {
+        std::erase(siblings->second, member_id);
+    }
+
+    members.erase(it);
+}
+
+/**
+ * @brief Rebuild members_by_family and accounts_by_member from the row vectors.
+ */
+void MemoryStorage::rebuildIndexes()
+{
+    members_by_family.clear();
+    accounts_by_member.clear();
+
+    for (const auto &family : families)
+    {
+        members_by_family[family.id];
+    }
+
+    for (const auto &member : members)
+    {
+        members_by_family[member.family_id].push_back(member.id);
+    }
+
+    for (const auto &account : accounts)
+    {
+        accounts_by_member[account.getMemberId()].push_back(account.getId());
+    }
+}
+
+/**
+ * @brief Aggregate transactions_by_account into rollup rows. Caller holds a lock.
+ *
+ * @return RollupMap One row per (member, month, account) with transactions.
+ */
+MemoryStorage::RollupMap MemoryStorage::aggregateRollups() const
+{
+    RollupMap rollups;
+
+    for (const auto &[account_id, transactions] : transactions_by_account)
+    {
+        auto account = findById(accounts, account_id, [](const BankAccount &record) { return record.getId(); });
+
+        if (account == accounts.end())
+        {
+            continue;
+        }
+
+        for (const auto &transaction : transactions)
+        {
+            RollupKey key{account->getMemberId(), transaction.date.year() / transaction.date.month(), account_id};
+            rollups[key].add(transaction.amount_paise);
+        }
+    }
+
+    return rollups;
+}
+
+/**
+ * @brief Post a stored transaction under each distinct token of its text.
+ *
+ * @param bank_account_id Account holding the transaction.
+ * @param index Position in transactions_by_account[bank_account_id].
+ */
+void MemoryStorage::indexTransaction(uint64_t bank_account_id, std::size_t index)
+{
+    const BankTransaction &transaction = transactions_by_account[bank_account_id][index];
+    std::vector<std::string> tokens = commons::searchTokens(transaction.description);
+    std::vector<std::string> counterparty_tokens = commons::searchTokens(transaction.counterparty);
+    tokens.insert(tokens.end(), counterparty_tokens.begin(), counterparty_tokens.end());
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+    for (auto &token : tokens)
+    {
+        search_postings[std::move(token)].push_back({bank_account_id, index});
+    }
+}
+
+/**
+ * @brief Append an account row and index it. Caller holds the write lock.
+ *
+ * @return uint64_t ID of the new account.
+ */
+uint64_t MemoryStorage::insertAccount(uint64_t bank_id, uint64_t member_id, const std::string& account_number,
+                                      long long opening_paise, long long closing_paise)
+{
+    uint64_t account_id = next_account_id++;
+    accounts.emplace_back(account_id, bank_id, member_id, account_number, opening_paise, closing_paise);
+    accounts_by_member[member_id].push_back(account_id);
+    return account_id;
+}
+
+/**
+ * @brief Upsert a period in the account's balance history, moving the
+ * account balances along when it is the latest. Caller holds the write lock.
+ */
+void MemoryStorage::storeBalance(BankAccount& account, const std::optional<commons::Date>& period_start,
+                                 const commons::Date& period_end, long long opening_paise, long long closing_paise)
+{
+    auto &history = balances_by_account[account.getId()];
+    auto it = std::lower_bound(history.begin(), history.end(), period_end, [](const BalanceRecord &balance, const commons::Date &date)
+        { return balance.period_end < date; });
+
+    if (it != history.end() && it->period_end == period_end)
+    {
+        *it = {period_start, period_end, opening_paise, closing_paise};
+    }
+    else
+    {
+        it = history.insert(it, {period_start, period_end, opening_paise, closing_paise});
+    }
+
+    if (it + 1 == history.end())
+    {
+        account.setOpeningBalancePaise(opening_paise);
+        account.setClosingBalancePaise(closing_paise);
+    }
+}
+
+/**
+ * @brief Append the lines not yet stored for the account, categorising,
+ * indexing and rolling them up. Caller holds the write lock.
+ *
+ * @return uint64_t Number of lines skipped as duplicates.
+ */
+uint64_t MemoryStorage::storeTransactions(const BankAccount& account, std::span<const BankTransaction> transactions)
+{
+    const uint64_t bank_account_id = account.getId();
+    auto &stored = transactions_by_account[bank_account_id];
+    auto &rules_versions = rules_versions_by_account[bank_account_id];
+    auto &known_fingerprints = fingerprints_by_account[bank_account_id];
+    std::vector<uint64_t> fingerprints = transactionFingerprints(bank_account_id, transactions);
+    uint64_t duplicates = 0;
+
+    for (std::size_t line = 0; line < transactions.size(); ++line)
+    {
+        if (!known_fingerprints.insert(fingerprints[line]).second)
+        {
+            ++duplicates;
+            continue;
+        }
+
+        const BankTransaction &transaction = transactions[line];
+        stored.push_back(transaction);
+        stored.back().category_id = category_matcher.categorize(transaction.description);
+        rules_versions.push_back(category_rules_version);
+        indexTransaction(bank_account_id, stored.size() - 1);
+        RollupKey key{account.getMemberId(), transaction.date.year() / transaction.date.month(), bank_account_id};
+        cash_flow_rollups[key].add(transaction.amount_paise);
+    }
+
+    return duplicates;
+}
+
+commons::Result MemoryStorage::saveMemberDataEx(const Member& member, const uint64_t family_id, uint64_t* out_member_id)
+{
+    if (member.getName().empty() || family_id == 0)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+
+    if (!findFamily(family_id))
+    {
+        return commons::Result::NotFound;
+    }
+
+    // Enforce REQ-3 (max 255 members)
+    if (members_by_family[family_id].size() >= kMaxFamilyMembers)
+    {
+        return commons::Result::MaxMembersExceeded;
+    }
+
+    uint64_t member_id = insertMember(family_id, member.getName(), member.getNickname());
+
+    if (out_member_id)
+    {
+        *out_member_id = member_id;
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::saveFamilyDataEx(const Family& family, uint64_t* out_family_id)
+{
+    if (family.getName().empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+
+    uint64_t family_id = next_family_id++;
+    families.push_back({family_id, names.intern(family.getName())});
+    members_by_family[family_id];
+
+    for (const auto &member : family.getMembers())
+    {
+        insertMember(family_id, member.getName(), member.getNickname());
+    }
+
+    if (out_family_id)
+    {
+        *out_family_id = family_id;
+    }
+
+    return commons::Result::Ok;
+}
+
+Member* MemoryStorage::getMemberData(const uint64_t& member_id)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    const MemberRecord* record = findMember(member_id);
+
+    if (!record)
+    {
+        return nullptr;
+    }
+
+    return new Member(record->id, nameOf(record->name), nameOf(record->nickname));
+}
+
+Family* MemoryStorage::getFamilyData(const uint64_t& family_id)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    const FamilyRecord* record = findFamily(family_id);
+
+    if (!record)
+    {
+        return nullptr;
+    }
+
+    Family* family = new Family(record->id, nameOf(record->name));
+    auto member_ids = members_by_family.find(family_id);
+
+    if (member_ids == members_by_family.end())
+    {
+        return family;
+    }
+
+    family->reserveMembers(member_ids->second.size());
+
+    for (uint64_t member_id : member_ids->second)
+    {
+        const MemberRecord* member = findMember(member_id);
+        family->emplaceMember(member->id, nameOf(member->name), nameOf(member->nickname));
+    }
+
+    return family;
+}
+
+commons::Result MemoryStorage::getMembersEx(std::span<const uint64_t> member_ids, std::vector<std::optional<Member>>* out_members)
+{
+    if (!out_members)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    out_members->clear();
+    out_members->reserve(member_ids.size());
+
+    for (uint64_t member_id : member_ids)
+    {
+        const MemberRecord* record = findMember(member_id);
+
+        if (record)
+        {
+            out_members->emplace_back(std::in_place, record->id, nameOf(record->name), nameOf(record->nickname));
+        }
+        else
+        {
+            out_members->emplace_back();
+        }
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::getFamiliesEx(std::span<const uint64_t> family_ids, std::vector<std::optional<Family>>* out_families)
+{
+    if (!out_families)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    out_families->clear();
+    out_families->reserve(family_ids.size());
+
+    for (uint64_t family_id : family_ids)
+    {
+        const FamilyRecord* record = findFamily(family_id);
+
+        if (!record)
+        {
+            out_families->emplace_back();
+            continue;
+        }
+
+        Family &family = out_families->emplace_back(std::in_place, record->id, nameOf(record->name)).value();
+        auto member_ids = members_by_family.find(family_id);
+
+        if (member_ids == members_by_family.end())
+        {
+            continue;
+        }
+
+        family.reserveMembers(member_ids->second.size());
+
+        for (uint64_t member_id : member_ids->second)
+        {
+            const MemberRecord* member = findMember(member_id);
+            family.emplaceMember(member->id, nameOf(member->name), nameOf(member->nickname));
+        }
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::getBankAccountsEx(std::span<const uint64_t> bank_account_ids, std::vector<std::optional<BankAccount>>* out_accounts)
+{
+    if (!out_accounts)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    out_accounts->clear();
+    out_accounts->reserve(bank_account_ids.size());
+
+    for (uint64_t bank_account_id : bank_account_ids)
+    {
+        const BankAccount* account = findAccount(bank_account_id);
+        out_accounts->push_back(account ? std::optional<BankAccount>(*account) : std::nullopt);
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::deleteMemberDataEx(const uint64_t& member_id)
+{
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+
+    if (!findMember(member_id))
+    {
+        return commons::Result::NotFound;
+    }
+
+    eraseMember(member_id);
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::deleteFamilyDataEx(const uint64_t& family_id)
+{
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    auto it = findById(families, family_id, [](const FamilyRecord &record) { return record.id; });
+
+    if (it == families.end())
+    {
+        return commons::Result::NotFound;
+    }
+
+    // Cascade like the SQLite foreign keys: members, then their accounts
+    std::vector<uint64_t> member_ids = members_by_family[family_id];
+
+    for (uint64_t member_id : member_ids)
+    {
+        eraseMember(member_id);
+    }
+
+    members_by_family.erase(family_id);
+    families.erase(it);
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::deleteMembersEx(const std::vector<uint64_t>& member_ids, std::vector<commons::Result>* out_results)
+{
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+
+    if (out_results)
+    {
+        out_results->clear();
+        out_results->reserve(member_ids.size());
+    }
+
+    for (uint64_t member_id : member_ids)
+    {
+        bool found = findMember(member_id) != nullptr;
+
+        if (found)
+        {
+            eraseMember(member_id);
+        }
+
+        if (out_results)
+        {
+            out_results->push_back(found ? commons::Result::Ok : commons::Result::NotFound);
+        }
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::updateFamilyDataEx(const uint64_t& family_id, const std::string& new_name)
+{
+    if (new_name.empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    FamilyRecord* record = findFamily(family_id);
+
+    if (!record)
+    {
+        return commons::Result::NotFound;
+    }
+
+    record->name = names.intern(new_name);
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::updateMemberDataEx(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname)
+{
+    if (new_name.empty() && new_nickname.empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    MemberRecord* record = findMember(member_id);
+
+    if (!record)
+    {
+        return commons::Result::NotFound;
+    }
+
+    if (!new_name.empty())
+    {
+        record->name = names.intern(new_name);
+    }
+
+    if (!new_nickname.empty())
+    {
+        record->nickname = names.intern(new_nickname);
+    }
+
+    return commons::Result::Ok;
+}
+
+std::vector<Family> MemoryStorage::listFamilies()
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::vector<Family> result;
+    result.reserve(families.size());
+
+    for (const auto &family : families)
+    {
+        result.emplace_back(family.id, nameOf(family.name));
+    }
+
+    return result;
+}
+
+std::vector<Member> MemoryStorage::listMembersOfFamily(uint64_t family_id)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::vector<Member> result;
+    auto member_ids = members_by_family.find(family_id);
+
+    if (member_ids == members_by_family.end())
+    {
+        return result;
+    }
+
+    result.reserve(member_ids->second.size());
+
+    for (uint64_t member_id : member_ids->second)
+    {
+        const MemberRecord* member = findMember(member_id);
+        result.emplace_back(member->id, nameOf(member->name), nameOf(member->nickname));
+    }
+
+    return result;
+}
+
+std::pmr::vector<FamilyRow> MemoryStorage::listFamilies(std::pmr::memory_resource* arena)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::pmr::vector<FamilyRow> result(arena);
+    result.reserve(families.size());
+
+    for (const auto &family : families)
+    {
+        result.emplace_back(family.id, names.view(family.name));
+    }
+
+    return result;
+}
+
+std::pmr::vector<MemberRow> MemoryStorage::listMembersOfFamily(uint64_t family_id, std::pmr::memory_resource* arena)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::pmr::vector<MemberRow> result(arena);
+    auto member_ids = members_by_family.find(family_id);
+
+    if (member_ids == members_by_family.end())
+    {
+        return result;
+    }
+
+    result.reserve(member_ids->second.size());
+
+    for (uint64_t member_id : member_ids->second)
+    {
+        const MemberRecord* member = findMember(member_id);
+        result.emplace_back(member->id, names.view(member->name), names.view(member->nickname));
+    }
+
+    return result;
+}
+
+commons::Result MemoryStorage::saveBankAccountEx(uint64_t bank_id,
+                                                 uint64_t member_id,
+                                                 const std::string &account_number,
+                                                 long long opening_paise,
+                                                 long long closing_paise,
+                                                 uint64_t* out_id)
+{
+    if (account_number.empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+
+    if (!findBank(bank_id) || !findMember(member_id))
+    {
+        return commons::Result::NotFound;
+    }
+
+    uint64_t account_id = insertAccount(bank_id, member_id, account_number, opening_paise, closing_paise);
+
+    if (out_id)
+    {
+        *out_id = account_id;
+    }
+
+    return commons::Result::Ok;
+}
+
+uint64_t MemoryStorage::getMemberCount(const uint64_t family_id, bool* out_ok)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    auto member_ids = members_by_family.find(family_id);
+
+    if (out_ok)
+    {
+        *out_ok = true;
+    }
+
+    return member_ids == members_by_family.end() ? 0 : member_ids->second.size();
+}
+
+commons::Result MemoryStorage::getBankIdByName(const std::string &bank_name, uint64_t* out_bank_id)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+
+    for (const auto &bank : banks)
+    {
+        if (equalsIgnoreCase(names.view(bank.name), bank_name))
+        {
+            if (out_bank_id)
+            {
+                *out_bank_id = bank.id;
+            }
+
+            return commons::Result::Ok;
+        }
+    }
+
+    return commons::Result::NotFound;
+}
+
+commons::Result MemoryStorage::getBankNameById(const uint64_t bank_id, std::string* out_name)
+{
+    if (!out_name)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    const BankRecord* bank = findBank(bank_id);
+
+    if (!bank)
+    {
+        return commons::Result::NotFound;
+    }
+
+    *out_name = names.view(bank->name);
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::getBankAccountById(const uint64_t bank_account_id, BankAccount* out_row)
+{
+    if (!out_row)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    const BankAccount* account = findAccount(bank_account_id);
+
+    if (!account)
+    {
+        return commons::Result::NotFound;
+    }
+
+    *out_row = *account;
+    return commons::Result::Ok;
+}
+
+std::vector<BankAccount> MemoryStorage::listBankAccountsOfMember(const uint64_t member_id)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::vector<BankAccount> result;
+    auto account_ids = accounts_by_member.find(member_id);
+
+    if (account_ids == accounts_by_member.end())
+    {
+        return result;
+    }
+
+    result.reserve(account_ids->second.size());
+
+    for (uint64_t account_id : account_ids->second)
+    {
+        result.push_back(*findAccount(account_id));
+    }
+
+    return result;
+}
+
+std::pmr::vector<BankAccountRow> MemoryStorage::listBankAccountsOfMember(const uint64_t member_id, std::pmr::memory_resource* arena)
+{
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::pmr::vector<BankAccountRow> result(arena);
+    auto account_ids = accounts_by_member.find(member_id);
+
+    if (account_ids == accounts_by_member.end())
+    {
+        return result;
+    }
+
+    result.reserve(account_ids->second.size());
+
+    for (uint64_t account_id : account_ids->second)
+    {
+        const BankAccount* account = findAccount(account_id);
+        result.emplace_back(account->getId(), account->getBankId(), account->getMemberId(), account->getAccountNumber(),
+                            account->getOpeningBalancePaise(), account->getClosingBalancePaise());
+    }
+
+    return result;
+}
+
+commons::Result MemoryStorage::visitAccountBalances(const uint64_t first_family_id,
+                                                    const uint64_t last_family_id,
+                                                    const AccountBalanceVisitor& visitor)
+{
+    if (!visitor || first_family_id > last_family_id)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    auto family_it = std::lower_bound(families.begin(), families.end(), first_family_id, [](const FamilyRecord &record, uint64_t value)
+        { return record.id < value; });
+
+    for (; family_it != families.end() && family_it->id <= last_family_id; ++family_it)
+    {
+        AccountBalanceRow row;
+        row.family_id = family_it->id;
+        auto member_ids = members_by_family.find(family_it->id);
+
+        if (member_ids == members_by_family.end() || member_ids->second.empty())
+        {
+            visitor(row);
+            continue;
+        }
+
+        for (uint64_t member_id : member_ids->second)
+        {
+            row.member_id = member_id;
+            row.bank_account_id = 0;
+            row.bank_id = 0;
+            row.closing_balance_paise = 0;
+            auto account_ids = accounts_by_member.find(member_id);
+
+            if (account_ids == accounts_by_member.end() || account_ids->second.empty())
+            {
+                visitor(row);
+                continue;
+            }
+
+            for (uint64_t account_id : account_ids->second)
+            {
+                const BankAccount* account = findAccount(account_id);
+                row.bank_account_id = account->getId();
+                row.bank_id = account->getBankId();
+                row.closing_balance_paise = account->getClosingBalancePaise();
+                visitor(row);
+            }
+        }
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::getFamilyIdRange(uint64_t* out_first_family_id, uint64_t* out_last_family_id)
+{
+    if (!out_first_family_id || !out_last_family_id)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+
+    if (families.empty())
+    {
+        return commons::Result::NotFound;
+    }
+
+    *out_first_family_id = families.front().id;
+    *out_last_family_id = families.back().id;
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Write the whole store to a binary snapshot file.
+ *
+ * Names are written once in a string table and the records refer to them
+ * by handle.
+ *
+ * @param path Destination file (overwritten).
+ * @return commons::Result
+ */
+commons::Result MemoryStorage::saveSnapshot(const std::string& path)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        return commons::Result::NotFound;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+    writeU64(out, next_family_id);
+    writeU64(out, next_member_id);
+    writeU64(out, next_account_id);
+
+    writeU64(out, names.size());
+
+    for (std::size_t handle = 0; handle < names.size(); ++handle)
+    {
+        writeString(out, names.view(static_cast<commons::NameHandle>(handle)));
+    }
+
+    writeU64(out, banks.size());
+
+    for (const auto &bank : banks)
+    {
+        writeU64(out, bank.id);
+        writeU64(out, bank.name);
+    }
+
+    writeU64(out, families.size());
+
+    for (const auto &family : families)
+    {
+        writeU64(out, family.id);
+        writeU64(out, family.name);
+    }
+
+    writeU64(out, members.size());
+
+    for (const auto &member : members)
+    {
+        writeU64(out, member.id);
+        writeU64(out, member.family_id);
+        writeU64(out, member.name);
+        writeU64(out, member.nickname);
+    }
+
+    writeU64(out, accounts.size());
+
+    for (const auto &account : accounts)
+    {
+        writeU64(out, account.getId());
+        writeU64(out, account.getBankId());
+        writeU64(out, account.getMemberId());
+        writeString(out, account.getAccountNumber());
+        writeI64(out, account.getOpeningBalancePaise());
+        writeI64(out, account.getClosingBalancePaise());
+    }
+
+    // Dates as days since 1970-01-01; a missing period start is flagged 0
+    writeU64(out, balances_by_account.size());
+
+    for (const auto &[account_id, history] : balances_by_account)
+    {
+        writeU64(out, account_id);
+        writeU64(out, history.size());
+
+        for (const auto &balance : history)
+        {
+            writeU64(out, balance.period_start ? 1 : 0);
+            writeI64(out, balance.period_start ? std::chrono::sys_days(*balance.period_start).time_since_epoch().count() : 0);
+            writeI64(out, std::chrono::sys_days(balance.period_end).time_since_epoch().count());
+            writeI64(out, balance.opening_paise);
+            writeI64(out, balance.closing_paise);
+        }
+    }
+
+    writeU64(out, transactions_by_account.size());
+
+    for (const auto &[account_id, transactions] : transactions_by_account)
+    {
+        auto rules_versions = rules_versions_by_account.find(account_id);
+        writeU64(out, account_id);
+        writeU64(out, transactions.size());
+
+        for (std::size_t index = 0; index < transactions.size(); ++index)
+        {
+            const BankTransaction &transaction = transactions[index];
+            writeI64(out, std::chrono::sys_days(transaction.date).time_since_epoch().count());
+            writeString(out, transaction.description);
+            writeI64(out, transaction.amount_paise);
+            writeString(out, transaction.counterparty);
+            writeU64(out, transaction.balance_after_paise ? 1 : 0);
+            writeI64(out, transaction.balance_after_paise.value_or(0));
+            writeU64(out, transaction.category_id);
+            writeU64(out, rules_versions != rules_versions_by_account.end() ? rules_versions->second[index] : 0);
+        }
+    }
+
+    writeU64(out, next_category_id);
+    writeU64(out, next_rule_id);
+    writeU64(out, category_rules_version);
+    writeU64(out, categories.size());
+
+    for (const auto &category : categories)
+    {
+        writeU64(out, category.id);
+        writeString(out, category.name);
+    }
+
+    writeU64(out, category_rules.size());
+
+    for (const auto &rule : category_rules)
+    {
+        writeU64(out, rule.rule_id);
+        writeU64(out, rule.category_id);
+        writeString(out, rule.keyword);
+        writeI64(out, rule.priority);
+    }
+
+    return out ? commons::Result::Ok : commons::Result::DbError;
+}
+
+/**
+ * @brief Replace the store contents with a snapshot written by saveSnapshot.
+ *
+ * Also reads version 1 snapshots, which stored every name inline, and
+ * version 2 to 6 ones, which lacked the balance history, transactions,
+ * counterparties, running balances or category rules (those get the
+ * default rules, with every line due for recategorisation). Cash-flow
+ * rollups, the search index and the duplicate fingerprints are recomputed
+ * from the transactions.
+ * The current contents are left untouched when the file is invalid,
+ * including when IDs are out of order or references (a rule's category
+ * among them) do not resolve.
+ *
+ * @param path Snapshot file to load.
+ * @return commons::Result
+ */
+commons::Result MemoryStorage::loadSnapshot(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+
+    if (!in.is_open())
+    {
+        return commons::Result::NotFound;
+    }
+
+    char magic[sizeof(kSnapshotMagic)] = {};
+
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, kSnapshotMagic, kSnapshotVersionByte) != 0 ||
+        magic[kSnapshotVersionByte] < '1' || magic[kSnapshotVersionByte] > kSnapshotMagic[kSnapshotVersionByte] ||
+        magic[sizeof(magic) - 1] != '\n')
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    int version = magic[kSnapshotVersionByte] - '0';
+    bool inline_names = version == 1;
+
+    uint64_t loaded_next_family = 0;
+    uint64_t loaded_next_member = 0;
+    uint64_t loaded_next_account = 0;
+    commons::StringInterner loaded_names;
+    std::vector<commons::NameHandle> file_handles;
+    std::vector<BankRecord> loaded_banks;
+    std::vector<FamilyRecord> loaded_families;
+    std::vector<MemberRecord> loaded_members;
+    std::vector<BankAccount> loaded_accounts;
+    std::unordered_map<uint64_t, std::vector<BalanceRecord>> loaded_balances;
+    std::unordered_map<uint64_t, std::vector<BankTransaction>> loaded_transactions;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> loaded_rules_versions;
+    uint64_t loaded_next_category = 0;
+    uint64_t loaded_next_rule = 0;
+    uint64_t loaded_rules_version = 0;
+    std::vector<TransactionCategory> loaded_categories;
+    std::vector<CategoryRule> loaded_rules;
+    uint64_t row_count = 0;
+
+    // Version 1 stores the text, version 2 an index into the string table
+    auto readName = [&](commons::NameHandle &handle)
+    {
+        if (inline_names)
+        {
+            std::string text;
+
+            if (!readString(in, text))
+            {
+                return false;
+            }
+
+            handle = loaded_names.intern(text);
+            return true;
+        }
+
+        uint64_t index = 0;
+
+        if (!readU64(in, index) || index >= file_handles.size())
+        {
+            return false;
+        }
+
+        handle = file_handles[index];
+        return true;
+    };
+
+    bool ok = readU64(in, loaded_next_family) && readU64(in, loaded_next_member) && readU64(in, loaded_next_account);
+
+    if (!inline_names)
+    {
+        ok = ok && readU64(in, row_count);
+
+        for (uint64_t row = 0; ok && row < row_count; ++row)
+        {
+            std::string text;
+            ok = readString(in, text);
+            file_handles.push_back(loaded_names.intern(text));
+        }
+    }
+
+    ok = ok && readU64(in, row_count);
+
+    for (uint64_t row = 0; ok && row < row_count; ++row)
+    {
+        BankRecord bank;
+        ok = readU64(in, bank.id) && readName(bank.name);
+        loaded_banks.push_back(bank);
+    }
+
+    ok = ok && readU64(in, row_count);
+
+    for (uint64_t row = 0; ok && row < row_count; ++row)
+    {
+        FamilyRecord family;
+        ok = readU64(in, family.id) && readName(family.name);
+        loaded_families.push_back(family);
+    }
+
+    ok = ok && readU64(in, row_count);
+
+    for (uint64_t row = 0; ok && row < row_count; ++row)
+    {
+        MemberRecord member;
+        ok = readU64(in, member.id) && readU64(in, member.family_id) &&
+             readName(member.name) && readName(member.nickname);
+        loaded_members.push_back(member);
+    }
+
+    ok = ok && readU64(in, row_count);
+
+    for (uint64_t row = 0; ok && row < row_count; ++row)
+    {
+        uint64_t account_id = 0;
+        uint64_t bank_id = 0;
+        uint64_t member_id = 0;
+        std::string account_number;
+        long long opening_paise = 0;
+        long long closing_paise = 0;
+        ok = readU64(in, account_id) && readU64(in, bank_id) && readU64(in, member_id) &&
+             readString(in, account_number) && readI64(in, opening_paise) && readI64(in, closing_paise);
+        loaded_accounts.emplace_back(account_id, bank_id, member_id, std::move(account_number), opening_paise, closing_paise);
+    }
+
+    if (version >= 3)
+    {
+        ok = ok && readU64(in, row_count);
+
+        for (uint64_t row = 0; ok && row < row_count; ++row)
+        {
+            uint64_t account_id = 0;
+            uint64_t history_size = 0;
+            ok = readU64(in, account_id) && readU64(in, history_size);
+            auto &history = loaded_balances[account_id];
+
+            for (uint64_t entry = 0; ok && entry < history_size; ++entry)
+            {
+                uint64_t has_start = 0;
+                long long start_days = 0;
+                long long end_days = 0;
+                BalanceRecord balance;
+                ok = readU64(in, has_start) && readI64(in, start_days) && readI64(in, end_days) &&
+                     readI64(in, balance.opening_paise) && readI64(in, balance.closing_paise);
+
+                if (has_start)
+                {
+                    balance.period_start = commons::Date(std::chrono::sys_days(std::chrono::days(start_days)));
+                }
+
+                balance.period_end = commons::Date(std::chrono::sys_days(std::chrono::days(end_days)));
+                history.push_back(balance);
+            }
+        }
+    }
+
+    if (version >= 4)
+    {
+        ok = ok && readU64(in, row_count);
+
+        for (uint64_t row = 0; ok && row < row_count; ++row)
+        {
+            uint64_t account_id = 0;
+            uint64_t transaction_count = 0;
+            ok = readU64(in, account_id) && readU64(in, transaction_count);
+            auto &transactions = loaded_transactions[account_id];
+            // Lines from before category rules are due for recategorisation
+            auto &rules_versions = loaded_rules_versions[account_id];
+
+            for (uint64_t entry = 0; ok && entry < transaction_count; ++entry)
+            {
+                long long days = 0;
+                BankTransaction transaction;
+                uint64_t rules_version = 0;
+                uint64_t has_balance = 0;
+                long long balance_after = 0;
+                ok = readI64(in, days) && readString(in, transaction.description) && readI64(in, transaction.amount_paise) &&
+                     (version < 5 || readString(in, transaction.counterparty)) &&
+                     (version < 6 || (readU64(in, has_balance) && readI64(in, balance_after))) &&
+                     (version < 7 || (readU64(in, transaction.category_id) && readU64(in, rules_version)));
+                transaction.date = commons::Date(std::chrono::sys_days(std::chrono::days(days)));
+
+                if (has_balance)
+                {
+                    transaction.balance_after_paise = balance_after;
+                }
+
+                transactions.push_back(std::move(transaction));
+                rules_versions.push_back(rules_version);
+            }
+        }
+    }
+
+    if (version >= 7)
+    {
+        ok = ok && readU64(in, loaded_next_category) && readU64(in, loaded_next_rule) &&
+             readU64(in, loaded_rules_version) && readU64(in, row_count);
+
+        for (uint64_t row = 0; ok && row < row_count; ++row)
+        {
+            TransactionCategory category;
+            ok = readU64(in, category.id) && readString(in, category.name);
+            loaded_categories.push_back(std::move(category));
+        }
+
+        ok = ok && readU64(in, row_count);
+
+        for (uint64_t row = 0; ok && row < row_count; ++row)
+        {
+            CategoryRule rule;
+            long long priority = 0;
+            ok = readU64(in, rule.rule_id) && readU64(in, rule.category_id) && readString(in, rule.keyword) && readI64(in, priority);
+            rule.priority = static_cast<int>(priority);
+            loaded_rules.push_back(std::move(rule));
+        }
+    }
+
+    // Lookups binary-search the record vectors and follow their references
+    // without checks, so the file must keep both intact
+    auto bank_id_of = [](const BankRecord &record) { return record.id; };
+    auto family_id_of = [](const FamilyRecord &record) { return record.id; };
+    auto member_id_of = [](const MemberRecord &record) { return record.id; };
+    auto account_id_of = [](const BankAccount &record) { return record.getId(); };
+    auto category_id_of = [](const TransactionCategory &record) { return record.id; };
+    auto rule_id_of = [](const CategoryRule &record) { return record.rule_id; };
+
+    ok = ok && idsAscending(loaded_banks, std::numeric_limits<uint64_t>::max(), bank_id_of) &&
+         idsAscending(loaded_families, loaded_next_family, family_id_of) &&
+         idsAscending(loaded_members, loaded_next_member, member_id_of) &&
+         idsAscending(loaded_accounts, loaded_next_account, account_id_of);
+
+    // Categories and rules are only stored from version 7 on
+    ok = ok && (version < 7 || (idsAscending(loaded_categories, loaded_next_category, category_id_of) &&
+                                idsAscending(loaded_rules, loaded_next_rule, rule_id_of)));
+
+    for (std::size_t row = 0; ok && row < loaded_rules.size(); ++row)
+    {
+        ok = findById(loaded_categories, loaded_rules[row].category_id, category_id_of) != loaded_categories.end();
+    }
+
+    for (std::size_t row = 0; ok && row < loaded_members.size(); ++row)
+    {
+        ok = findById(loaded_families, loaded_members[row].family_id, family_id_of) != loaded_families.end();
+    }
+
+    for (std::size_t row = 0; ok && row < loaded_accounts.size(); ++row)
+    {
+        ok = findById(loaded_members, loaded_accounts[row].getMemberId(), member_id_of) != loaded_members.end() &&
+             findById(loaded_banks, loaded_accounts[row].getBankId(), bank_id_of) != loaded_banks.end();
+    }
+
+    auto accountExists = [&](const auto &entry)
+    {
+        return findById(loaded_accounts, entry.first, account_id_of) != loaded_accounts.end();
+    };
+
+    ok = ok && std::all_of(loaded_balances.begin(), loaded_balances.end(), accountExists) &&
+         std::all_of(loaded_transactions.begin(), loaded_transactions.end(), accountExists);
+
+    if (!ok)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    next_family_id = loaded_next_family;
+    next_member_id = loaded_next_member;
+    next_account_id = loaded_next_account;
+    names = std::move(loaded_names);
+    banks = std::move(loaded_banks);
+    families = std::move(loaded_families);
+    members = std::move(loaded_members);
+    accounts = std::move(loaded_accounts);
+    balances_by_account = std::move(loaded_balances);
+    transactions_by_account = std::move(loaded_transactions);
+    rules_versions_by_account = std::move(loaded_rules_versions);
+    rebuildIndexes();
+
+    if (version >= 7)
+    {
+        categories = std::move(loaded_categories);
+        category_rules = std::move(loaded_rules);
+        next_category_id = loaded_next_category;
+        next_rule_id = loaded_next_rule;
+        category_rules_version = loaded_rules_version;
+        category_matcher.compile(category_rules);
+    }
+    else
+    {
+        seedDefaultCategories();
+    }
+
+    cash_flow_rollups = aggregateRollups();
+    search_postings.clear();
+    fingerprints_by_account.clear();
+
+    for (const auto &[account_id, transactions] : transactions_by_account)
+    {
+        for (std::size_t index = 0; index < transactions.size(); ++index)
+        {
+            indexTransaction(account_id, index);
+        }
+
+        // Same convention as the SQLite backfill: the history is one statement
+        std::vector<uint64_t> fingerprints = transactionFingerprints(account_id, transactions);
+        fingerprints_by_account[account_id].insert(fingerprints.begin(), fingerprints.end());
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::saveBalanceSnapshotEx(const uint64_t bank_account_id,
+                                                     const std::optional<commons::Date>& period_start,
+                                                     const commons::Date& period_end,
+                                                     long long opening_paise,
+                                                     long long closing_paise)
+{
+    if (!period_end.ok() || (period_start && (!period_start->ok() || *period_start > period_end)))
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    BankAccount* account = findAccount(bank_account_id);
+
+    if (!account)
+    {
+        return commons::Result::NotFound;
+    }
+
+    storeBalance(*account, period_start, period_end, opening_paise, closing_paise);
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::getNetWorthAsOfEx(const NetWorthScope scope,
+                                                 const uint64_t scope_id,
+                                                 std::span<const commons::Date> as_of_dates,
+                                                 std::vector<long long>* out_totals_paise)
+{
+    if (!out_totals_paise)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    out_totals_paise->clear();
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::vector<uint64_t> member_ids;
+
+    if (scope == NetWorthScope::Member)
+    {
+        if (!findMember(scope_id))
+        {
+            return commons::Result::NotFound;
+        }
+
+        member_ids.push_back(scope_id);
+    }
+    else
+    {
+        if (!findFamily(scope_id))
+        {
+            return commons::Result::NotFound;
+        }
+
+        auto family_members = members_by_family.find(scope_id);
+
+        if (family_members != members_by_family.end())
+        {
+            member_ids = family_members->second;
+        }
+    }
+
+    std::vector<const std::vector<BalanceRecord>*> histories;
+
+    for (uint64_t member_id : member_ids)
+    {
+        auto account_ids = accounts_by_member.find(member_id);
+
+        if (account_ids == accounts_by_member.end())
+        {
+            continue;
+        }
+
+        for (uint64_t account_id : account_ids->second)
+        {
+            auto history = balances_by_account.find(account_id);
+
+            if (history != balances_by_account.end())
+            {
+                histories.push_back(&history->second);
+            }
+        }
+    }
+
+    commons::Result result = commons::Result::Ok;
+    out_totals_paise->reserve(as_of_dates.size());
+
+    for (const commons::Date &as_of : as_of_dates)
+    {
+        commons::CheckedAccumulator total;
+
+        for (const auto* history : histories)
+        {
+            auto after = std::upper_bound(history->begin(), history->end(), as_of, [](const commons::Date &date, const BalanceRecord &balance)
+                { return date < balance.period_end; });
+
+            if (after != history->begin())
+            {
+                total.add(std::prev(after)->closing_paise);
+            }
+        }
+
+        out_totals_paise->push_back(0);
+
+        if (total.toPaise(&out_totals_paise->back()) != commons::Result::Ok)
+        {
+            result = commons::Result::Overflow;
+        }
+    }
+
+    return result;
+}
+
+commons::Result MemoryStorage::saveTransactionsEx(const uint64_t bank_account_id,
+                                                  std::span<const BankTransaction> transactions,
+                                                  uint64_t* out_duplicates)
+{
+    if (out_duplicates)
+    {
+        *out_duplicates = 0;
+    }
+
+    for (const auto &transaction : transactions)
+    {
+        if (!transaction.date.ok())
+        {
+            return commons::Result::InvalidInput;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    BankAccount* account = findAccount(bank_account_id);
+
+    if (!account)
+    {
+        return commons::Result::NotFound;
+    }
+
+    uint64_t duplicates = storeTransactions(*account, transactions);
+
+    if (out_duplicates)
+    {
+        *out_duplicates = duplicates;
+    }
+
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief File a parsed statement under one write lock.
+ *
+ * Every check runs before anything is changed, so a failed import leaves
+ * the store as it was, like the SQLite transaction.
+ */
+commons::Result MemoryStorage::importStatementEx(const StatementImport& statement,
+                                                 uint64_t* out_bank_account_id,
+                                                 uint64_t* out_duplicates)
+{
+    if (out_duplicates)
+    {
+        *out_duplicates = 0;
+    }
+
+    if ((statement.bank_account_id == 0 && statement.account_number.empty()) ||
+        (statement.period_end && (!statement.period_end->ok() ||
+                                  (statement.period_start && (!statement.period_start->ok() || *statement.period_start > *statement.period_end)))))
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    for (const auto &transaction : statement.transactions)
+    {
+        if (!transaction.date.ok())
+        {
+            return commons::Result::InvalidInput;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    uint64_t bank_account_id = statement.bank_account_id;
+
+    if (bank_account_id != 0 ? !findAccount(bank_account_id) : (!findBank(statement.bank_id) || !findMember(statement.member_id)))
+    {
+        return commons::Result::NotFound;
+    }
+
+    // Matched under the write lock, so concurrent imports of one new
+    // account cannot each create a copy of it
+    bool created = false;
+
+    if (bank_account_id == 0)
+    {
+        BankAccount statement_account;
+        statement_account.setAccountNumber(statement.account_number);
+        auto account_ids = accounts_by_member.find(statement.member_id);
+
+        if (account_ids != accounts_by_member.end())
+        {
+            for (uint64_t account_id : account_ids->second)
+            {
+                const BankAccount* candidate = findAccount(account_id);
+
+                if (candidate->getBankId() == statement.bank_id && candidate->hasSameAccountNumber(statement_account))
+                {
+                    bank_account_id = account_id;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (bank_account_id == 0)
+    {
+        bank_account_id = insertAccount(statement.bank_id, statement.member_id, statement.account_number,
+                                        statement.opening_paise, statement.closing_paise);
+        created = true;
+    }
+
+    BankAccount* account = findAccount(bank_account_id);
+
+    if (statement.period_end)
+    {
+        storeBalance(*account, statement.period_start, *statement.period_end, statement.opening_paise, statement.closing_paise);
+    }
+    else if (!created)
+    {
+        account->setOpeningBalancePaise(statement.opening_paise);
+        account->setClosingBalancePaise(statement.closing_paise);
+    }
+
+    uint64_t duplicates = storeTransactions(*account, statement.transactions);
+
+    if (out_bank_account_id)
+    {
+        *out_bank_account_id = bank_account_id;
+    }
+
+    if (out_duplicates)
+    {
+        *out_duplicates = duplicates;
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::getCashFlowEx(const NetWorthScope scope,
+                                             const uint64_t scope_id,
+                                             const commons::Month& first_month,
+                                             const commons::Month& last_month,
+                                             std::vector<CashFlowMonth>* out_months)
+{
+    if (!out_months)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    out_months->clear();
+
+    if (!first_month.ok() || !last_month.ok() || last_month < first_month)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::vector<uint64_t> member_ids;
+
+    if (scope == NetWorthScope::Member)
+    {
+        if (!findMember(scope_id))
+        {
+            return commons::Result::NotFound;
+        }
+
+        member_ids.push_back(scope_id);
+    }
+    else
+    {
+        if (!findFamily(scope_id))
+        {
+            return commons::Result::NotFound;
+        }
+
+        auto family_members = members_by_family.find(scope_id);
+
+        if (family_members != members_by_family.end())
+        {
+            member_ids = family_members->second;
+        }
+    }
+
+    const std::size_t month_count = static_cast<std::size_t>((last_month - first_month).count()) + 1;
+    std::vector<commons::CheckedAccumulator> credits(month_count);
+    std::vector<commons::CheckedAccumulator> debits(month_count);
+    out_months->resize(month_count);
+
+    for (std::size_t index = 0; index < month_count; ++index)
+    {
+        (*out_months)[index].month = first_month + std::chrono::months(static_cast<int>(index));
+    }
+
+    for (uint64_t member_id : member_ids)
+    {
+        auto it = cash_flow_rollups.lower_bound({member_id, first_month, 0});
+
+        for (; it != cash_flow_rollups.end() && it->first.member_id == member_id && it->first.month <= last_month; ++it)
+        {
+            std::size_t index = static_cast<std::size_t>((it->first.month - first_month).count());
+            CashFlowMonth &entry = (*out_months)[index];
+            credits[index].add(it->second.credit_paise);
+            entry.credit_count += it->second.credit_count;
+            debits[index].add(it->second.debit_paise);
+            entry.debit_count += it->second.debit_count;
+        }
+    }
+
+    commons::Result result = commons::Result::Ok;
+
+    for (std::size_t index = 0; index < month_count; ++index)
+    {
+        CashFlowMonth &entry = (*out_months)[index];
+
+        if (credits[index].toPaise(&entry.credit_paise) != commons::Result::Ok ||
+            debits[index].toPaise(&entry.debit_paise) != commons::Result::Ok)
+        {
+            result = commons::Result::Overflow;
+        }
+    }
+
+    return result;
+}
+
+commons::Result MemoryStorage::rebuildCashFlowRollupsEx()
+{
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    cash_flow_rollups = aggregateRollups();
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::checkCashFlowRollupsEx(uint64_t* out_mismatched_rows)
+{
+    if (!out_mismatched_rows)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    RollupMap expected = aggregateRollups();
+    uint64_t mismatched = 0;
+
+    for (const auto &[key, rollup] : cash_flow_rollups)
+    {
+        auto match = expected.find(key);
+
+        if (match == expected.end() || !(match->second == rollup))
+        {
+            ++mismatched;
+        }
+    }
+
+    for (const auto &[key, rollup] : expected)
+    {
+        auto match = cash_flow_rollups.find(key);
+
+        if (match == cash_flow_rollups.end() || !(match->second == rollup))
+        {
+            ++mismatched;
+        }
+    }
+
+    *out_mismatched_rows = mismatched;
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::searchTransactionsEx(const std::string& text,
+                                                    std::size_t limit,
+                                                    std::vector<TransactionMatch>* out_matches)
+{
+    if (!out_matches)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    out_matches->clear();
+    std::vector<std::string> tokens = commons::searchTokens(text);
+
+    if (tokens.empty() || limit == 0)
+    {
+        return commons::Result::Ok;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    std::vector<TransactionRef> hits;
+
+    for (std::size_t token_index = 0; token_index < tokens.size(); ++token_index)
+    {
+        const std::string &token = tokens[token_index];
+        std::vector<TransactionRef> token_hits;
+
+        for (auto it = search_postings.lower_bound(token);
+             it != search_postings.end() && it->first.compare(0, token.size(), token) == 0;
+             ++it)
+        {
+            token_hits.insert(token_hits.end(), it->second.begin(), it->second.end());
+        }
+
+        std::sort(token_hits.begin(), token_hits.end());
+        token_hits.erase(std::unique(token_hits.begin(), token_hits.end()), token_hits.end());
+
+        if (token_index == 0)
+        {
+            hits = std::move(token_hits);
+        }
+        else
+        {
+            std::vector<TransactionRef> common;
+            std::set_intersection(hits.begin(), hits.end(), token_hits.begin(), token_hits.end(), std::back_inserter(common));
+            hits = std::move(common);
+        }
+    }
+
+    auto transactionOf = [&](const TransactionRef &ref) -> const BankTransaction &
+    {
+        return transactions_by_account.at(ref.bank_account_id)[ref.index];
+    };
+
+    std::sort(hits.begin(), hits.end(), [&](const TransactionRef &lhs, const TransactionRef &rhs)
+        {
+            const commons::Date &lhs_date = transactionOf(lhs).date;
+            const commons::Date &rhs_date = transactionOf(rhs).date;
+
+            if (lhs_date != rhs_date)
+            {
+                return lhs_date > rhs_date;
+            }
+
+            if (lhs.bank_account_id != rhs.bank_account_id)
+            {
+                return lhs.bank_account_id < rhs.bank_account_id;
+            }
+
+            return lhs.index > rhs.index;
+        });
+
+    hits.resize(std::min(hits.size(), limit));
+    out_matches->reserve(hits.size());
+
+    for (const TransactionRef &ref : hits)
+    {
+        const BankAccount* account = findAccount(ref.bank_account_id);
+        out_matches->push_back({ref.bank_account_id, account ? account->getMemberId() : 0, transactionOf(ref)});
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::saveCategoryRuleEx(const std::string& category_name,
+                                                  const std::string& keyword,
+                                                  int priority,
+                                                  uint64_t* out_rule_id)
+{
+    if (commons::searchTokens(category_name).empty() || commons::searchTokens(keyword).empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    auto category = std::find_if(categories.begin(), categories.end(), [&](const TransactionCategory &existing)
+        { return equalsIgnoreCase(existing.name, category_name); });
+
+    if (category == categories.end())
+    {
+        categories.push_back({next_category_id++, category_name});
+        category = std::prev(categories.end());
+    }
+
+    uint64_t rule_id = next_rule_id++;
+    category_rules.push_back({rule_id, category->id, keyword, priority});
+    ++category_rules_version;
+    category_matcher.compile(category_rules);
+
+    if (out_rule_id)
+    {
+        *out_rule_id = rule_id;
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::saveCategoryRulesEx(std::span<const std::string> category_names,
+                                                   std::span<const CategoryRule> rules,
+                                                   uint64_t* out_added)
+{
+    if (out_added)
+    {
+        *out_added = 0;
+    }
+
+    if (category_names.size() != rules.size())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    for (std::size_t index = 0; index < rules.size(); ++index)
+    {
+        if (commons::searchTokens(category_names[index]).empty() || commons::searchTokens(rules[index].keyword).empty())
+        {
+            return commons::Result::InvalidInput;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+
+    // Index into category_rules, keyed by category ID and normalised keyword
+    std::unordered_map<std::string, std::size_t> existing;
+
+    for (std::size_t index = 0; index < category_rules.size(); ++index)
+    {
+        const CategoryRule &rule = category_rules[index];
+        existing.emplace(std::to_string(rule.category_id) + commons::normalisedKeyword(rule.keyword), index);
+    }
+
+    // Resolve every category first: a keyword repeated in the batch is one
+    // rule, and it takes the priority of its last occurrence
+    std::vector<uint64_t> category_ids;
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, int> batch_priority;
+    category_ids.reserve(rules.size());
+    keys.reserve(rules.size());
+
+    for (std::size_t index = 0; index < rules.size(); ++index)
+    {
+        const std::string &category_name = category_names[index];
+        auto category = std::find_if(categories.begin(), categories.end(), [&](const TransactionCategory &candidate)
+            { return equalsIgnoreCase(candidate.name, category_name); });
+
+        if (category == categories.end())
+        {
+            categories.push_back({next_category_id++, category_name});
+            category = std::prev(categories.end());
+        }
+
+        category_ids.push_back(category->id);
+        keys.push_back(std::to_string(category->id) + commons::normalisedKeyword(rules[index].keyword));
+        batch_priority[keys.back()] = rules[index].priority;
+    }
+
+    uint64_t added = 0;
+    bool changed = false;
+
+    for (std::size_t index = 0; index < rules.size(); ++index)
+    {
+        const int priority = batch_priority[keys[index]];
+        auto found = existing.find(keys[index]);
+
+        if (found != existing.end())
+        {
+            CategoryRule &rule = category_rules[found->second];
+            changed = changed || rule.priority != priority;
+            rule.priority = priority;
+            continue;
+        }
+
+        existing.emplace(keys[index], category_rules.size());
+        category_rules.push_back({next_rule_id++, category_ids[index], rules[index].keyword, priority});
+        changed = true;
+        ++added;
+    }
+
+    if (changed)
+    {
+        ++category_rules_version;
+        category_matcher.compile(category_rules);
+    }
+
+    if (out_added)
+    {
+        *out_added = added;
+    }
+
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::deleteCategoryRuleEx(const uint64_t rule_id)
+{
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    auto rule = findById(category_rules, rule_id, [](const CategoryRule &record) { return record.rule_id; });
+
+    if (rule == category_rules.end())
+    {
+        return commons::Result::NotFound;
+    }
+
+    category_rules.erase(rule);
+    ++category_rules_version;
+    category_matcher.compile(category_rules);
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::listCategoriesEx(std::vector<TransactionCategory>* out_categories)
+{
+    if (!out_categories)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    *out_categories = categories;
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::listCategoryRulesEx(std::vector<CategoryRule>* out_rules)
+{
+    if (!out_rules)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock(data_mutex);
+    *out_rules = category_rules;
+    return commons::Result::Ok;
+}
+
+commons::Result MemoryStorage::recategorizeTransactionsEx(std::size_t batch_size, uint64_t* out_changed)
+{
+    if (batch_size == 0)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    // One exclusive pass: there is no other writer to make room for
+    std::unique_lock<std::shared_mutex> write_lock(data_mutex);
+    uint64_t changed = 0;
+
+    for (auto &[account_id, transactions] : transactions_by_account)
+    {
+        auto &rules_versions = rules_versions_by_account[account_id];
+
+        for (std::size_t index = 0; index < transactions.size(); ++index)
+        {
+            if (rules_versions[index] >= category_rules_version)
+            {
+                continue;
+            }
+
+            uint64_t category_id = category_matcher.categorize(transactions[index].description);
+
+            if (category_id != transactions[index].category_id)
+            {
+                transactions[index].category_id = category_id;
+                ++changed;
+            }
+
+            rules_versions[index] = category_rules_version;
+        }
+    }
+
+    if (out_changed)
+    {
+        *out_changed = changed;
+    }
+
+    return commons::Result::Ok;
+}
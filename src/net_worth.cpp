@@ -1,10 +1,61 @@
 #include "net_worth.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <memory>
+#include <thread>
 #include "bank_account.hpp"
 
-NetWorth::NetWorth(StorageManager* storage)
+/**
+ * @brief Reset the snapshot to an empty state.
+ */
+void NetWorthSnapshot::clear()
+{
+    family_ids.clear();
+    family_totals_paise.clear();
+    family_member_offsets.clear();
+    member_ids.clear();
+    member_family_ids.clear();
+    member_totals_paise.clear();
+    household_total_paise = 0;
+}
+
+/**
+ * @brief Append another snapshot covering a later Family_ID range.
+ * 
+ * The household total is not touched; recompute it once all slices are in.
+ *
+ * @param other Snapshot to append.
+ */
+void NetWorthSnapshot::append(const NetWorthSnapshot& other)
+{
+    if (other.family_ids.empty())
+    {
+        return;
+    }
+
+    std::size_t member_base = member_ids.size();
+
+    if (family_member_offsets.empty())
+    {
+        family_member_offsets.push_back(0);
+    }
+
+    family_ids.insert(family_ids.end(), other.family_ids.begin(), other.family_ids.end());
+    family_totals_paise.insert(family_totals_paise.end(), other.family_totals_paise.begin(), other.family_totals_paise.end());
+
+    // Skip the leading 0 of `other`; our trailing offset already marks its start
+    for (std::size_t index = 1; index < other.family_member_offsets.size(); ++index)
+    {
+        family_member_offsets.push_back(member_base + other.family_member_offsets[index]);
+    }
+
+    member_ids.insert(member_ids.end(), other.member_ids.begin(), other.member_ids.end());
+    member_family_ids.insert(member_family_ids.end(), other.member_family_ids.begin(), other.member_family_ids.end());
+    member_totals_paise.insert(member_totals_paise.end(), other.member_totals_paise.begin(), other.member_totals_paise.end());
+}
+
+NetWorth::NetWorth(StorageInterface* storage)
 {
     storage_ptr = storage;
 }
@@ -34,16 +85,15 @@ commons::Result NetWorth::computeMemberNetWorth(const uint64_t member_id, long l
     }
 
     // Sum closing balances of all bank accounts for the member
-    long long total_paise = 0;
+    commons::CheckedAccumulator total_paise;
     std::vector<BankAccount> accounts = storage_ptr->listBankAccountsOfMember(member_id);
 
     for (const auto &acct : accounts)
     {
-        total_paise += acct.getClosingBalancePaise();
+        total_paise.add(acct.getClosingBalancePaise());
     }
 
-    *out_net_worth_paise = total_paise;
-    return commons::Result::Ok;
+    return total_paise.toPaise(out_net_worth_paise);
 }
 
 
@@ -67,22 +117,247 @@ commons::Result NetWorth::computeFamilyNetWorth(const uint64_t family_id, long l
         return commons::Result::NotFound;
     }
 
-    long long family_total_paise = 0;
-
-    // Use StorageManager listing of members for this family
-    std::vector<Member> members = storage_ptr->listMembersOfFamily(family_id);
+    commons::CheckedAccumulator family_total_paise;
 
-    for (const auto &member : members)
+    // The family was loaded together with its members (with their IDs)
+    for (const auto &member : f->getMembers())
     {
         uint64_t member_id = member.getId();
         std::vector<BankAccount> accounts = storage_ptr->listBankAccountsOfMember(member_id);
 
         for (const auto &acct : accounts)
         {
-            family_total_paise += acct.getClosingBalancePaise();
+            family_total_paise.add(acct.getClosingBalancePaise());
         }
     }
 
-    *out_net_worth_paise = family_total_paise;
+    return family_total_paise.toPaise(out_net_worth_paise);
+}
+
+
+commons::Result NetWorth::computeAllNetWorths(NetWorthSnapshot* out_snapshot, const unsigned thread_count)
+{
+    if (!out_snapshot || thread_count == 0)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!storage_ptr)
+    {
+        return commons::Result::DbError;
+    }
+
+    out_snapshot->clear();
+
+    uint64_t first_family_id = 0;
+    uint64_t last_family_id = 0;
+    commons::Result range_res = storage_ptr->getFamilyIdRange(&first_family_id, &last_family_id);
+
+    if (range_res == commons::Result::NotFound)
+    {
+        // No families: an empty report is a valid answer
+        return commons::Result::Ok;
+    }
+
+    if (range_res != commons::Result::Ok)
+    {
+        return range_res;
+    }
+
+    uint64_t id_span = last_family_id - first_family_id + 1;
+    uint64_t slice_count = std::min<uint64_t>(thread_count, id_span);
+
+    if (slice_count <= 1)
+    {
+        commons::Result res = aggregateFamilyRange(first_family_id, last_family_id, out_snapshot);
+
+        if (res != commons::Result::Ok)
+        {
+            return res;
+        }
+
+        return commons::sumPaise(out_snapshot->family_totals_paise, &out_snapshot->household_total_paise);
+    }
+
+    // Split the ID range into contiguous slices; each worker streams its own
+    // slice in its own read transaction, so slices may see different commits
+    uint64_t slice_width = id_span / slice_count;
+    std::vector<NetWorthSnapshot> partials(slice_count);
+    std::vector<commons::Result> results(slice_count, commons::Result::Ok);
+    std::vector<std::thread> workers;
+    workers.reserve(slice_count);
+
+    for (uint64_t slice = 0; slice < slice_count; ++slice)
+    {
+        uint64_t slice_first = first_family_id + slice * slice_width;
+        uint64_t slice_last = (slice + 1 == slice_count) ? last_family_id : slice_first + slice_width - 1;
+
+        workers.emplace_back([this, slice, slice_first, slice_last, &partials, &results]()
+        {
+            results[slice] = aggregateFamilyRange(slice_first, slice_last, &partials[slice]);
+        });
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (uint64_t slice = 0; slice < slice_count; ++slice)
+    {
+        if (results[slice] != commons::Result::Ok)
+        {
+            out_snapshot->clear();
+            return results[slice];
+        }
+
+        out_snapshot->append(partials[slice]);
+    }
+
+    // Family totals are contiguous, so the household total takes the vectorised path
+    return commons::sumPaise(out_snapshot->family_totals_paise, &out_snapshot->household_total_paise);
+}
+
+
+commons::Result NetWorth::computeMonthlyNetWorth(const NetWorthScope scope,
+                                                const uint64_t scope_id,
+                                                const std::chrono::year_month first_month,
+                                                const std::chrono::year_month last_month,
+                                                std::vector<NetWorthPoint>* out_points)
+{
+    if (!out_points || !first_month.ok() || !last_month.ok() || first_month > last_month)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!storage_ptr)
+    {
+        return commons::Result::DbError;
+    }
+
+    out_points->clear();
+    std::vector<commons::Date> month_ends;
+
+    for (std::chrono::year_month month = first_month; month <= last_month; month += std::chrono::months(1))
+    {
+        month_ends.push_back(commons::Date(month / std::chrono::last));
+    }
+
+    std::vector<long long> totals;
+    commons::Result res = storage_ptr->getNetWorthAsOfEx(scope, scope_id, month_ends, &totals);
+
+    if (res != commons::Result::Ok && res != commons::Result::Overflow)
+    {
+        return res;
+    }
+
+    out_points->reserve(month_ends.size());
+
+    for (std::size_t index = 0; index < month_ends.size(); ++index)
+    {
+        out_points->push_back({month_ends[index], totals[index]});
+    }
+
+    return res;
+}
+
+
+commons::Result NetWorth::aggregateFamilyRange(const uint64_t first_family_id,
+                                               const uint64_t last_family_id,
+                                               NetWorthSnapshot* out_snapshot)
+{
+    out_snapshot->clear();
+    out_snapshot->family_member_offsets.push_back(0);
+
+    // Groups are summed exactly and only narrowed to paise when they close
+    commons::CheckedAccumulator family_total;
+    commons::CheckedAccumulator member_total;
+    bool member_open = false;
+    bool overflowed = false;
+
+    auto close_member = [&]()
+    {
+        if (member_open && member_total.toPaise(&out_snapshot->member_totals_paise.back()) != commons::Result::Ok)
+        {
+            overflowed = true;
+        }
+
+        member_total = commons::CheckedAccumulator();
+        member_open = false;
+    };
+
+    auto close_family = [&]()
+    {
+        close_member();
+
+        if (family_total.toPaise(&out_snapshot->family_totals_paise.back()) != commons::Result::Ok)
+        {
+            overflowed = true;
+        }
+
+        family_total = commons::CheckedAccumulator();
+    };
+
+    // Rows arrive ordered by family then member, so a change of ID closes the
+    // previous group and opens a new one.
+    auto visitor = [&](const AccountBalanceRow& row)
+    {
+        if (out_snapshot->family_ids.empty() || out_snapshot->family_ids.back() != row.family_id)
+        {
+            if (!out_snapshot->family_ids.empty())
+            {
+                close_family();
+                out_snapshot->family_member_offsets.push_back(out_snapshot->member_ids.size());
+            }
+
+            out_snapshot->family_ids.push_back(row.family_id);
+            out_snapshot->family_totals_paise.push_back(0);
+        }
+
+        if (row.member_id == 0)
+        {
+            return;
+        }
+
+        std::size_t family_first_member = out_snapshot->family_member_offsets.back();
+        bool new_member = out_snapshot->member_ids.size() == family_first_member ||
+                          out_snapshot->member_ids.back() != row.member_id;
+
+        if (new_member)
+        {
+            close_member();
+            out_snapshot->member_ids.push_back(row.member_id);
+            out_snapshot->member_family_ids.push_back(row.family_id);
+            out_snapshot->member_totals_paise.push_back(0);
+            member_open = true;
+        }
+
+        member_total.add(row.closing_balance_paise);
+        family_total.add(row.closing_balance_paise);
+    };
+
+    commons::Result res = storage_ptr->visitAccountBalances(first_family_id, last_family_id, visitor);
+
+    if (res != commons::Result::Ok)
+    {
+        out_snapshot->clear();
+        return res;
+    }
+
+    if (out_snapshot->family_ids.empty())
+    {
+        out_snapshot->family_member_offsets.clear();
+        return commons::Result::Ok;
+    }
+
+    close_family();
+    out_snapshot->family_member_offsets.push_back(out_snapshot->member_ids.size());
+
+    if (overflowed)
+    {
+        out_snapshot->clear();
+        return commons::Result::Overflow;
+    }
+
     return commons::Result::Ok;
 }
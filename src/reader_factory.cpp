@@ -122,7 +122,7 @@ std::unique_ptr<BankReader> ReaderFactory::createByBankName(const std::string& b
  * @param bank_id Bank ID.
  * @return std::unique_ptr<BankReader> 
  */
-std::unique_ptr<BankReader> ReaderFactory::createByBankId(StorageManager* storage, uint64_t bank_id)
+std::unique_ptr<BankReader> ReaderFactory::createByBankId(StorageInterface* storage, uint64_t bank_id)
 {
     if (!storage)
     {
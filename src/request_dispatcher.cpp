@@ -0,0 +1,473 @@
+#include "request_dispatcher.hpp"
+#include "ui_manager.hpp"
+#include <map>
+
+namespace
+{
+    /**
+     * @brief Read an unsigned integer parameter.
+     *
+     * @param params Request params object.
+     * @param key Parameter name.
+     * @return std::optional<uint64_t> std::nullopt when missing or not a whole number.
+     */
+    std::optional<uint64_t> idParam(const JsonValue& params, const std::string& key)
+    {
+        const JsonValue* value = params.find(key);
+        return value ? value->asUint64() : std::nullopt;
+    }
+
+    /**
+     * @brief Read a string parameter, defaulting to empty when absent.
+     *
+     * @param params Request params object.
+     * @param key Parameter name.
+     * @return std::string
+     */
+    std::string stringParam(const JsonValue& params, const std::string& key)
+    {
+        const JsonValue* value = params.find(key);
+        return value ? value->asString().value_or("") : "";
+    }
+
+    /**
+     * @brief Build a failure response.
+     *
+     * @param request_id Echoed request id (null when unknown).
+     * @param res Failure code.
+     * @param message Human-readable explanation.
+     * @return JsonValue
+     */
+    JsonValue errorResponse(const JsonValue& request_id, commons::Result res, const std::string& message)
+    {
+        JsonValue response = JsonValue::object();
+        response.set("id", request_id);
+        response.set("ok", JsonValue::boolean(false));
+        response.set("error", JsonValue::string(commons::resultName(res)));
+        response.set("message", JsonValue::string(message));
+        return response;
+    }
+}
+
+/**
+ * @brief Construct a new RequestDispatcher object.
+ *
+ * @param home HomeManager shared by every request; must outlive the dispatcher.
+ */
+RequestDispatcher::RequestDispatcher(HomeManager& home)
+    : home(home)
+{
+}
+
+/**
+ * @brief Check whether a method only reads data.
+ *
+ * @param method Request method name.
+ * @return true for list and net worth queries.
+ */
+bool RequestDispatcher::isReadOnlyMethod(const std::string& method)
+{
+    return method == "listFamilies" || method == "listMembers" || method == "getMembers" || method == "networth";
+}
+
+/**
+ * @brief Parse and handle one request line.
+ *
+ * @param line Raw request text.
+ * @return std::string Serialised response (without trailing newline).
+ */
+std::string RequestDispatcher::handleLine(const std::string& line)
+{
+    auto request = JsonValue::parse(line);
+
+    if (!request)
+    {
+        return errorResponse(JsonValue(), commons::Result::InvalidInput, "Malformed JSON.").dump();
+    }
+
+    return handle(*request).dump();
+}
+
+/**
+ * @brief Dispatch a parsed request to its handler.
+ *
+ * @param request Request object.
+ * @return JsonValue Response object.
+ */
+JsonValue RequestDispatcher::handle(const JsonValue& request)
+{
+    using Handler = commons::Result (RequestDispatcher::*)(const JsonValue&, JsonValue*);
+    static const std::map<std::string, Handler> handlers =
+    {
+        {"addFamily", &RequestDispatcher::addFamily},
+        {"deleteFamily", &RequestDispatcher::deleteFamily},
+        {"addMember", &RequestDispatcher::addMember},
+        {"updateMember", &RequestDispatcher::updateMember},
+        {"deleteMember", &RequestDispatcher::deleteMember},
+        {"listFamilies", &RequestDispatcher::listFamilies},
+        {"listMembers", &RequestDispatcher::listMembers},
+        {"getMembers", &RequestDispatcher::getMembers},
+        {"import", &RequestDispatcher::importStatement},
+        {"networth", &RequestDispatcher::netWorth}
+    };
+
+    const JsonValue* id_value = request.find("id");
+    JsonValue request_id = id_value ? *id_value : JsonValue();
+
+    if (request.type() != JsonValue::Type::Object)
+    {
+        return errorResponse(request_id, commons::Result::InvalidInput, "Request must be a JSON object.");
+    }
+
+    const JsonValue* method_value = request.find("method");
+    std::string method = method_value ? method_value->asString().value_or("") : "";
+    auto handler = handlers.find(method);
+
+    if (handler == handlers.end())
+    {
+        return errorResponse(request_id, commons::Result::InvalidInput, "Unknown method '" + method + "'.");
+    }
+
+    const JsonValue* params_value = request.find("params");
+    JsonValue params = params_value ? *params_value : JsonValue::object();
+
+    if (params.type() != JsonValue::Type::Object)
+    {
+        return errorResponse(request_id, commons::Result::InvalidInput, "params must be a JSON object.");
+    }
+
+    JsonValue result = JsonValue::object();
+    commons::Result res = (this->*(handler->second))(params, &result);
+
+    if (res != commons::Result::Ok)
+    {
+        return errorResponse(request_id, res, UIManager::errorMessage(res));
+    }
+
+    JsonValue response = JsonValue::object();
+    response.set("id", request_id);
+    response.set("ok", JsonValue::boolean(true));
+    response.set("result", std::move(result));
+    return response;
+}
+
+/**
+ * @brief addFamily {name} -> {family_id}
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::addFamily(const JsonValue& params, JsonValue* out_result)
+{
+    uint64_t family_id = 0;
+    commons::Result res = home.addFamily(Family(stringParam(params, "name")), &family_id);
+
+    if (res == commons::Result::Ok)
+    {
+        out_result->set("family_id", JsonValue::number(family_id));
+    }
+
+    return res;
+}
+
+/**
+ * @brief deleteFamily {family_id}
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::deleteFamily(const JsonValue& params, JsonValue* out_result)
+{
+    (void)out_result;
+    auto family_id = idParam(params, "family_id");
+    return family_id ? home.deleteFamily(*family_id) : commons::Result::InvalidInput;
+}
+
+/**
+ * @brief addMember {family_id, name, nickname?} -> {member_id}
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::addMember(const JsonValue& params, JsonValue* out_result)
+{
+    auto family_id = idParam(params, "family_id");
+    uint64_t member_id = 0;
+
+    if (!family_id)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    Member member(stringParam(params, "name"), stringParam(params, "nickname"));
+    commons::Result res = home.addMemberToFamily(member, *family_id, &member_id);
+
+    if (res == commons::Result::Ok)
+    {
+        out_result->set("member_id", JsonValue::number(member_id));
+    }
+
+    return res;
+}
+
+/**
+ * @brief updateMember {member_id, name?, nickname?}; empty fields are left unchanged
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::updateMember(const JsonValue& params, JsonValue* out_result)
+{
+    (void)out_result;
+    auto member_id = idParam(params, "member_id");
+
+    if (!member_id)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    return home.updateMember(*member_id, stringParam(params, "name"), stringParam(params, "nickname"));
+}
+
+/**
+ * @brief deleteMember {member_id}
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::deleteMember(const JsonValue& params, JsonValue* out_result)
+{
+    (void)out_result;
+    auto member_id = idParam(params, "member_id");
+    return member_id ? home.deleteMember(*member_id) : commons::Result::InvalidInput;
+}
+
+/**
+ * @brief listFamilies -> [{id, name}]
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::listFamilies(const JsonValue& params, JsonValue* out_result)
+{
+    (void)params;
+    JsonValue families = JsonValue::array();
+
+    for (const auto &family : home.listFamilies())
+    {
+        JsonValue entry = JsonValue::object();
+        entry.set("id", JsonValue::number(family.getId()));
+        entry.set("name", JsonValue::string(family.getName()));
+        families.push(std::move(entry));
+    }
+
+    *out_result = std::move(families);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief listMembers {family_id} -> [{id, name, nickname}]
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::listMembers(const JsonValue& params, JsonValue* out_result)
+{
+    auto family_id = idParam(params, "family_id");
+
+    if (!family_id)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    JsonValue members = JsonValue::array();
+
+    for (const auto &member : home.listMembersOfFamily(*family_id))
+    {
+        JsonValue entry = JsonValue::object();
+        entry.set("id", JsonValue::number(member.getId()));
+        entry.set("name", JsonValue::string(member.getName()));
+        entry.set("nickname", JsonValue::string(member.getNickname()));
+        members.push(std::move(entry));
+    }
+
+    *out_result = std::move(members);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief getMembers {member_ids: [...]} -> [{id, name, nickname} | null], one per ID
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::getMembers(const JsonValue& params, JsonValue* out_result)
+{
+    const JsonValue* ids_value = params.find("member_ids");
+
+    if (!ids_value || ids_value->type() != JsonValue::Type::Array)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    std::vector<uint64_t> member_ids;
+    member_ids.reserve(ids_value->items().size());
+
+    for (const auto &item : ids_value->items())
+    {
+        auto member_id = item.asUint64();
+
+        if (!member_id)
+        {
+            return commons::Result::InvalidInput;
+        }
+
+        member_ids.push_back(*member_id);
+    }
+
+    std::vector<std::optional<Member>> found;
+    commons::Result res = home.getMembers(member_ids, &found);
+
+    if (res != commons::Result::Ok)
+    {
+        return res;
+    }
+
+    JsonValue members = JsonValue::array();
+
+    for (const auto &member : found)
+    {
+        if (!member)
+        {
+            members.push(JsonValue());
+            continue;
+        }
+
+        JsonValue entry = JsonValue::object();
+        entry.set("id", JsonValue::number(member->getId()));
+        entry.set("name", JsonValue::string(member->getName()));
+        entry.set("nickname", JsonValue::string(member->getNickname()));
+        members.push(std::move(entry));
+    }
+
+    *out_result = std::move(members);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief import {member_id, bank, file} -> {bank_account_id, duplicates}; bank is a Bank_ID or name
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::importStatement(const JsonValue& params, JsonValue* out_result)
+{
+    auto member_id = idParam(params, "member_id");
+    std::string file = stringParam(params, "file");
+    const JsonValue* bank = params.find("bank");
+
+    if (!member_id || file.empty() || !bank)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    uint64_t bank_account_id = 0;
+    uint64_t duplicates = 0;
+    commons::Result res = commons::Result::InvalidInput;
+
+    // "bank" may be a Bank_ID or a bank name
+    if (auto bank_id = bank->asUint64())
+    {
+        res = home.importBankStatement(file, *member_id, *bank_id, &bank_account_id, nullptr, &duplicates);
+    }
+    else if (auto bank_name = bank->asString())
+    {
+        res = home.importBankStatement(file, *member_id, *bank_name, &bank_account_id, nullptr, &duplicates);
+    }
+
+    if (res == commons::Result::Ok)
+    {
+        out_result->set("bank_account_id", JsonValue::number(bank_account_id));
+        out_result->set("duplicates", JsonValue::number(duplicates));
+    }
+
+    return res;
+}
+
+/**
+ * @brief networth {member_id} | {family_id} -> {net_worth_paise}; with neither, the household report
+ *
+ * @param params Request params object.
+ * @param out_result Result payload on success.
+ * @return commons::Result
+ */
+commons::Result RequestDispatcher::netWorth(const JsonValue& params, JsonValue* out_result)
+{
+    long long total_paise = 0;
+
+    if (params.find("member_id") || params.find("family_id"))
+    {
+        auto member_id = idParam(params, "member_id");
+        auto family_id = idParam(params, "family_id");
+
+        if (!member_id && !family_id)
+        {
+            return commons::Result::InvalidInput;
+        }
+
+        commons::Result res = member_id
+            ? home.computeMemberNetWorth(*member_id, &total_paise)
+            : home.computeFamilyNetWorth(*family_id, &total_paise);
+
+        if (res == commons::Result::Ok)
+        {
+            out_result->set("net_worth_paise", JsonValue::number(total_paise));
+        }
+
+        return res;
+    }
+
+    NetWorthSnapshot snapshot;
+    commons::Result res = home.computeAllNetWorths(&snapshot);
+
+    if (res != commons::Result::Ok)
+    {
+        return res;
+    }
+
+    JsonValue families = JsonValue::array();
+
+    for (std::size_t family_index = 0; family_index < snapshot.familyCount(); ++family_index)
+    {
+        JsonValue family = JsonValue::object();
+        JsonValue members = JsonValue::array();
+
+        for (std::size_t member_index = snapshot.family_member_offsets[family_index];
+             member_index < snapshot.family_member_offsets[family_index + 1];
+             ++member_index)
+        {
+            JsonValue member = JsonValue::object();
+            member.set("id", JsonValue::number(snapshot.member_ids[member_index]));
+            member.set("net_worth_paise", JsonValue::number(snapshot.member_totals_paise[member_index]));
+            members.push(std::move(member));
+        }
+
+        family.set("id", JsonValue::number(snapshot.family_ids[family_index]));
+        family.set("net_worth_paise", JsonValue::number(snapshot.family_totals_paise[family_index]));
+        family.set("members", std::move(members));
+        families.push(std::move(family));
+    }
+
+    out_result->set("household_total_paise", JsonValue::number(snapshot.household_total_paise));
+    out_result->set("families", std::move(families));
+    return commons::Result::Ok;
+}
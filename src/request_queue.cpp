@@ -0,0 +1,64 @@
+#include "request_queue.hpp"
+
+/**
+ * @brief Queue a request.
+ *
+ * @param item Parsed request and originating connection.
+ * @param read_only True for requests that never modify data.
+ */
+void RequestQueue::push(Item item, bool read_only)
+{
+    {
+        std::lock_guard<std::mutex> queue_lock(queue_mutex);
+        (read_only ? reads : writes).push_back(std::move(item));
+    }
+
+    queue_cv.notify_one();
+}
+
+/**
+ * @brief Take the next request, preferring reads.
+ *
+ * @return std::optional<RequestQueue::Item> std::nullopt once closed and empty.
+ */
+std::optional<RequestQueue::Item> RequestQueue::pop()
+{
+    std::unique_lock<std::mutex> queue_lock(queue_mutex);
+    queue_cv.wait(queue_lock, [this]() { return closed || !reads.empty() || !writes.empty(); });
+
+    if (reads.empty() && writes.empty())
+    {
+        return std::nullopt;
+    }
+
+    bool take_write = reads.empty() || (!writes.empty() && consecutive_reads >= kMaxConsecutiveReads);
+    std::deque<Item> &lane = take_write ? writes : reads;
+    Item item = std::move(lane.front());
+    lane.pop_front();
+    consecutive_reads = take_write ? 0 : consecutive_reads + 1;
+    return item;
+}
+
+/**
+ * @brief Stop accepting waits; workers drain the remaining items and exit.
+ */
+void RequestQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> queue_lock(queue_mutex);
+        closed = true;
+    }
+
+    queue_cv.notify_all();
+}
+
+/**
+ * @brief Number of queued requests.
+ *
+ * @return std::size_t
+ */
+std::size_t RequestQueue::size() const
+{
+    std::lock_guard<std::mutex> queue_lock(queue_mutex);
+    return reads.size() + writes.size();
+}
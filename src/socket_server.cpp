@@ -0,0 +1,609 @@
+#include "socket_server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    // epoll user data for the two non-client descriptors
+    constexpr uint64_t kListenId = 0;
+    constexpr uint64_t kWakeId = 1;
+
+    constexpr int kMaxEvents = 64;
+    constexpr std::size_t kReadChunk = 64 * 1024;
+
+    /**
+     * @brief Serialise a response and terminate it with a newline.
+     *
+     * @param response Response object.
+     * @return std::string
+     */
+    std::string responseLine(const JsonValue& response)
+    {
+        std::string line;
+        response.dumpTo(line);
+        line.push_back('\n');
+        return line;
+    }
+}
+
+/**
+ * @brief Construct a new SocketServer object.
+ *
+ * @param home HomeManager shared by every request; must outlive the server.
+ * @param socket_path Filesystem path of the Unix domain socket.
+ * @param worker_count Number of worker threads (at least 1).
+ */
+SocketServer::SocketServer(HomeManager& home, const std::string& socket_path, unsigned worker_count)
+    : dispatcher(home), socket_path(socket_path), worker_count(std::max(1u, worker_count))
+{
+}
+
+/**
+ * @brief Destroy the SocketServer object, closing every descriptor and
+ * removing the socket file.
+ */
+SocketServer::~SocketServer()
+{
+    for (auto &entry : connections)
+    {
+        ::close(entry.second.fd);
+    }
+
+    if (listen_fd >= 0)
+    {
+        ::close(listen_fd);
+    }
+
+    if (owns_socket_file)
+    {
+        ::unlink(socket_path.c_str());
+    }
+
+    if (epoll_fd >= 0)
+    {
+        ::close(epoll_fd);
+    }
+
+    if (wake_fd >= 0)
+    {
+        ::close(wake_fd);
+    }
+}
+
+/**
+ * @brief Create, bind and register the listening socket and wakeup eventfd.
+ *
+ * @return true if the server is ready to run.
+ */
+bool SocketServer::start()
+{
+    sockaddr_un address{};
+
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Invalid socket path: '" << socket_path << "'" << std::endl;
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (listen_fd < 0 || epoll_fd < 0 || wake_fd < 0)
+    {
+        std::cerr << "Failed to create server descriptors: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // A previous run may have left its socket file behind. Anything else at
+    // the path (a mistyped database path, a live server) is left alone.
+    struct stat existing{};
+
+    if (::lstat(socket_path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            std::cerr << "Refusing to replace '" << socket_path << "': not a socket" << std::endl;
+            return false;
+        }
+
+        int probe_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        bool stale = probe_fd >= 0 &&
+                     ::connect(probe_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 &&
+                     errno == ECONNREFUSED;
+
+        if (probe_fd >= 0)
+        {
+            ::close(probe_fd);
+        }
+
+        if (!stale)
+        {
+            std::cerr << "Refusing to replace '" << socket_path << "': a server is already listening on it" << std::endl;
+            return false;
+        }
+
+        ::unlink(socket_path.c_str());
+    }
+
+    // Requests can read and import server-side files, so only the owner may
+    // connect. The socket file takes its mode from the umask at bind time.
+    mode_t previous_mask = ::umask(0177);
+    bool bound = ::bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    int bind_error = errno;
+    ::umask(previous_mask);
+
+    if (!bound)
+    {
+        std::cerr << "Failed to bind '" << socket_path << "': " << std::strerror(bind_error) << std::endl;
+        return false;
+    }
+
+    owns_socket_file = true;
+
+    if (::listen(listen_fd, SOMAXCONN) != 0)
+    {
+        std::cerr << "Failed to listen on '" << socket_path << "': " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epoll_event listen_event{};
+    listen_event.events = EPOLLIN;
+    listen_event.data.u64 = kListenId;
+
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.u64 = kWakeId;
+
+    if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen_event) != 0 ||
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event) != 0)
+    {
+        std::cerr << "Failed to register with epoll: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Request the event loop to exit.
+ */
+void SocketServer::stop()
+{
+    stopping = true;
+
+    if (wake_fd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = ::write(wake_fd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+/**
+ * @brief Event loop: accept clients, read requests, write responses.
+ *
+ * Returns after stop(); requests still queued are finished by the workers
+ * but their responses are discarded.
+ */
+void SocketServer::run()
+{
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+
+    for (unsigned index = 0; index < worker_count; ++index)
+    {
+        workers.emplace_back(&SocketServer::workerLoop, this);
+    }
+
+    epoll_event events[kMaxEvents];
+
+    while (!stopping)
+    {
+        int ready = ::epoll_wait(epoll_fd, events, kMaxEvents, -1);
+
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int index = 0; index < ready; ++index)
+        {
+            uint64_t event_id = events[index].data.u64;
+            uint32_t flags = events[index].events;
+
+            if (event_id == kListenId)
+            {
+                acceptClients();
+                continue;
+            }
+
+            if (event_id == kWakeId)
+            {
+                uint64_t counter = 0;
+                ssize_t drained = ::read(wake_fd, &counter, sizeof(counter));
+                (void)drained;
+                drainCompletions();
+                continue;
+            }
+
+            if (flags & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            {
+                readClient(event_id);
+            }
+
+            // Hang-ups also reach the writer: a connection that stopped
+            // reading is closed there once its send fails
+            if ((flags & (EPOLLOUT | EPOLLHUP | EPOLLERR)) && connections.count(event_id))
+            {
+                writeClient(event_id);
+            }
+        }
+    }
+
+    queue.close();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Accept every pending client connection.
+ */
+void SocketServer::acceptClients()
+{
+    while (true)
+    {
+        int client_fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (client_fd < 0)
+        {
+            // EAGAIN: backlog empty. Anything else: skip this round.
+            return;
+        }
+
+        uint64_t connection_id = next_connection_id++;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = connection_id;
+
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &event) != 0)
+        {
+            ::close(client_fd);
+            continue;
+        }
+
+        Connection &connection = connections[connection_id];
+        connection.fd = client_fd;
+        connection.interest = EPOLLIN;
+    }
+}
+
+/**
+ * @brief Read available input and queue every complete request line.
+ *
+ * Reading stops while the connection is at kMaxInFlight or its output is
+ * above kOutputHighWater; the rest stays in the socket until the client
+ * catches up.
+ *
+ * @param connection_id Client connection.
+ */
+void SocketServer::readClient(uint64_t connection_id)
+{
+    auto it = connections.find(connection_id);
+
+    if (it == connections.end())
+    {
+        return;
+    }
+
+    Connection &connection = it->second;
+    char chunk[kReadChunk];
+
+    while (acceptsInput(connection))
+    {
+        ssize_t received = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+
+        if (received > 0)
+        {
+            connection.in_buffer.append(chunk, static_cast<std::size_t>(received));
+            parseRequests(connection_id, connection);
+
+            // Unless a limit held complete lines back, what is left is one partial line
+            if (connection.in_buffer.size() > kMaxLineLength && connection.in_buffer.find('\n') == std::string::npos)
+            {
+                closeClient(connection_id);
+                return;
+            }
+
+            continue;
+        }
+
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (received == 0)
+        {
+            connection.peer_closed = true;
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            closeClient(connection_id);
+            return;
+        }
+
+        break;
+    }
+
+    if (!connection.out_buffer.empty())
+    {
+        writeClient(connection_id);
+        return;
+    }
+
+    updateInterest(connection_id, connection);
+    closeIfFinished(connection_id);
+}
+
+/**
+ * @brief Whether the connection may take more input.
+ *
+ * @param connection Client state.
+ * @return true unless the peer hung up or a per-connection limit is reached.
+ */
+bool SocketServer::acceptsInput(const Connection& connection)
+{
+    return !connection.peer_closed && connection.in_flight < kMaxInFlight &&
+           connection.out_buffer.size() < kOutputHighWater;
+}
+
+/**
+ * @brief Queue the complete request lines in the input buffer.
+ *
+ * Malformed lines are answered directly by the loop; valid requests go to
+ * the workers, read-only ones in the priority lane. Lines past the
+ * in-flight or output limit stay buffered for a later call.
+ *
+ * @param connection_id Client connection.
+ * @param connection Its state.
+ */
+void SocketServer::parseRequests(uint64_t connection_id, Connection& connection)
+{
+    std::size_t line_start = 0;
+    std::size_t newline = 0;
+
+    while (connection.in_flight < kMaxInFlight && connection.out_buffer.size() < kOutputHighWater &&
+           (newline = connection.in_buffer.find('\n', line_start)) != std::string::npos)
+    {
+        std::string line = connection.in_buffer.substr(line_start, newline - line_start);
+        line_start = newline + 1;
+
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+
+        auto request = JsonValue::parse(line);
+
+        if (!request)
+        {
+            connection.out_buffer += dispatcher.handleLine(line);
+            connection.out_buffer.push_back('\n');
+            continue;
+        }
+
+        const JsonValue* method = request->find("method");
+        bool read_only = method && RequestDispatcher::isReadOnlyMethod(method->asString().value_or(""));
+        ++connection.in_flight;
+        queue.push({connection_id, std::move(*request)}, read_only);
+    }
+
+    connection.in_buffer.erase(0, line_start);
+}
+
+/**
+ * @brief Write as much pending output as the socket accepts.
+ *
+ * @param connection_id Client connection.
+ */
+void SocketServer::writeClient(uint64_t connection_id)
+{
+    auto it = connections.find(connection_id);
+
+    if (it == connections.end())
+    {
+        return;
+    }
+
+    Connection &connection = it->second;
+    std::size_t offset = 0;
+
+    while (offset < connection.out_buffer.size())
+    {
+        ssize_t sent = ::send(connection.fd, connection.out_buffer.data() + offset,
+                              connection.out_buffer.size() - offset, MSG_NOSIGNAL);
+
+        if (sent > 0)
+        {
+            offset += static_cast<std::size_t>(sent);
+            continue;
+        }
+
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+
+        closeClient(connection_id);
+        return;
+    }
+
+    connection.out_buffer.erase(0, offset);
+
+    // Lines held back by a limit may fit now
+    if (!connection.in_buffer.empty())
+    {
+        parseRequests(connection_id, connection);
+    }
+
+    updateInterest(connection_id, connection);
+    closeIfFinished(connection_id);
+}
+
+/**
+ * @brief Watch for input only while the connection accepts it and for
+ * writability only while output is pending.
+ *
+ * A connection waiting for neither leaves the epoll set: hang-ups are
+ * reported whatever the mask, and level-triggered they would spin the loop.
+ *
+ * @param connection_id Client connection.
+ * @param connection Its state.
+ */
+void SocketServer::updateInterest(uint64_t connection_id, Connection& connection)
+{
+    uint32_t interest = (acceptsInput(connection) ? EPOLLIN : 0u) | (connection.out_buffer.empty() ? 0u : EPOLLOUT);
+
+    if (interest == connection.interest)
+    {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = interest;
+    event.data.u64 = connection_id;
+    int operation = interest == 0 ? EPOLL_CTL_DEL : (connection.interest == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+    ::epoll_ctl(epoll_fd, operation, connection.fd, &event);
+    connection.interest = interest;
+}
+
+/**
+ * @brief Close a connection whose peer has hung up once it is fully answered.
+ *
+ * @param connection_id Client connection.
+ */
+void SocketServer::closeIfFinished(uint64_t connection_id)
+{
+    auto it = connections.find(connection_id);
+
+    if (it != connections.end() && it->second.peer_closed &&
+        it->second.in_flight == 0 && it->second.out_buffer.empty())
+    {
+        closeClient(connection_id);
+    }
+}
+
+/**
+ * @brief Drop a connection. Responses still in flight for it are discarded.
+ *
+ * @param connection_id Client connection.
+ */
+void SocketServer::closeClient(uint64_t connection_id)
+{
+    auto it = connections.find(connection_id);
+
+    if (it == connections.end())
+    {
+        return;
+    }
+
+    if (it->second.interest != 0)
+    {
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    }
+
+    ::close(it->second.fd);
+    connections.erase(it);
+}
+
+/**
+ * @brief Move worker responses into their connections' output buffers.
+ */
+void SocketServer::drainCompletions()
+{
+    std::vector<std::pair<uint64_t, std::string>> ready;
+
+    {
+        std::lock_guard<std::mutex> completed_lock(completed_mutex);
+        ready.swap(completed);
+    }
+
+    std::vector<uint64_t> touched;
+
+    for (auto &response : ready)
+    {
+        auto it = connections.find(response.first);
+
+        if (it == connections.end())
+        {
+            continue;
+        }
+
+        it->second.out_buffer += response.second;
+        --it->second.in_flight;
+        touched.push_back(response.first);
+    }
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    for (uint64_t connection_id : touched)
+    {
+        writeClient(connection_id);
+    }
+}
+
+/**
+ * @brief Worker thread body: execute queued requests and post the responses.
+ */
+void SocketServer::workerLoop()
+{
+    while (auto item = queue.pop())
+    {
+        std::string line = responseLine(dispatcher.handle(item->request));
+        bool was_empty = false;
+
+        {
+            std::lock_guard<std::mutex> completed_lock(completed_mutex);
+            was_empty = completed.empty();
+            completed.emplace_back(item->connection_id, std::move(line));
+        }
+
+        // One wakeup per batch: the loop drains everything posted since
+        if (was_empty)
+        {
+            uint64_t one = 1;
+            ssize_t written = ::write(wake_fd, &one, sizeof(one));
+            (void)written;
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#include "statement_reconciliation.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Find the first line whose running balance breaks the chain.
+     *
+     * Balance i must equal balance i-1 (the opening balance for line 0)
+     * plus amount i. That adjacent-difference form has no loop-carried
+     * dependency, unlike a prefix sum: each block ORs together the XOR of
+     * every actual and expected difference, which vectorises, and only a
+     * block with a non-zero result is rescanned to locate the line.
+     * Differences are taken modulo 2^64, which is exact for equality.
+     *
+     * @param opening_paise Opening balance.
+     * @param amounts Line amounts.
+     * @param balances Stated running balances, aligned with amounts.
+     * @return std::optional<std::size_t> Index of the first divergent line.
+     */
+    std::optional<std::size_t> firstBalanceMismatch(long long opening_paise,
+                                                    std::span<const long long> amounts,
+                                                    std::span<const long long> balances)
+    {
+        constexpr std::size_t block_size = 1024;
+
+        if (amounts.empty())
+        {
+            return std::nullopt;
+        }
+
+        if (static_cast<uint64_t>(balances[0]) - static_cast<uint64_t>(opening_paise) != static_cast<uint64_t>(amounts[0]))
+        {
+            return 0;
+        }
+
+        for (std::size_t block_start = 1; block_start < amounts.size(); block_start += block_size)
+        {
+            std::size_t block_end = std::min(amounts.size(), block_start + block_size);
+            uint64_t mismatch = 0;
+
+            for (std::size_t row = block_start; row < block_end; ++row)
+            {
+                mismatch |= (static_cast<uint64_t>(balances[row]) - static_cast<uint64_t>(balances[row - 1])) ^
+                            static_cast<uint64_t>(amounts[row]);
+            }
+
+            if (mismatch == 0)
+            {
+                continue;
+            }
+
+            for (std::size_t row = block_start; row < block_end; ++row)
+            {
+                if (static_cast<uint64_t>(balances[row]) - static_cast<uint64_t>(balances[row - 1]) != static_cast<uint64_t>(amounts[row]))
+                {
+                    return row;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Check that the lines of a statement account for its balances.
+ *
+ * @param opening_paise Opening balance.
+ * @param closing_paise Stated closing balance.
+ * @param amounts_paise Line amounts, credits positive.
+ * @param running_balances_paise Stated balance after each line, or empty.
+ * @param out_report Receives the outcome.
+ * @return commons::Result Ok even when unbalanced; the report says which.
+ */
+commons::Result reconcileStatement(long long opening_paise,
+                                   long long closing_paise,
+                                   std::span<const long long> amounts_paise,
+                                   std::span<const long long> running_balances_paise,
+                                   ReconciliationReport* out_report)
+{
+    if (!out_report || (!running_balances_paise.empty() && running_balances_paise.size() != amounts_paise.size()))
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    *out_report = ReconciliationReport{};
+    commons::CheckedAccumulator expected_closing;
+    expected_closing.add(opening_paise);
+    expected_closing.addAll(amounts_paise);
+    commons::Result res = expected_closing.toPaise(&out_report->expected_closing_paise);
+
+    if (res != commons::Result::Ok)
+    {
+        out_report->balanced = false;
+        return res;
+    }
+
+    if (!running_balances_paise.empty())
+    {
+        out_report->first_divergent_row = firstBalanceMismatch(opening_paise, amounts_paise, running_balances_paise);
+    }
+
+    out_report->balanced = !out_report->first_divergent_row && out_report->expected_closing_paise == closing_paise;
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Reconcile a parsed statement.
+ *
+ * @param info Statement returned by BankReader::extractAccountInfo.
+ * @param out_report Receives the outcome.
+ * @return commons::Result
+ */
+commons::Result reconcileStatement(const BankReader::BankAccountInfo& info, ReconciliationReport* out_report)
+{
+    std::vector<long long> amounts_paise(info.transactions.size());
+    std::transform(info.transactions.begin(), info.transactions.end(), amounts_paise.begin(),
+                   [](const BankTransaction& transaction) { return transaction.amount_paise; });
+
+    return reconcileStatement(info.openingBalancePaise, info.closingBalancePaise,
+                              amounts_paise, info.runningBalancesPaise, out_report);
+}
@@ -1,18 +1,573 @@
 #include "storage_manager.hpp"
 #include "bank_account.hpp"
+#include "bank_transaction.hpp"
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <sqlite3.h>
 
+namespace
+{
+    // One step of the schema history. Steps are applied in order to bring a
+    // database from its recorded PRAGMA user_version up to kSchemaVersion.
+    // Version 1 is written with IF NOT EXISTS / OR IGNORE so it also adopts
+    // databases created before versioning was introduced.
+    struct SchemaMigration
+    {
+        int version;
+        const char* sql;
+        // Optional data step run after `sql`, for values SQL cannot compute
+        bool (*backfill)(sqlite3* db) = nullptr;
+    };
+
+    bool backfillTransactionFingerprints(sqlite3* db);
+
+    const SchemaMigration kSchemaMigrations[] =
+    {
+        {
+            1, R"(
+            CREATE TABLE IF NOT EXISTS FamilyInfo (
+            Family_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            Family_Name TEXT NOT NULL
+            );
+
+            CREATE TABLE IF NOT EXISTS MemberInfo (
+            Member_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            Family_ID INTEGER NOT NULL,
+            Member_Name TEXT NOT NULL,
+            Member_Nick_Name TEXT,
+            FOREIGN KEY(Family_ID) REFERENCES FamilyInfo(Family_ID) ON DELETE CASCADE
+            );
+
+            CREATE TABLE IF NOT EXISTS BankList (
+            Bank_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            Bank_Name TEXT NOT NULL UNIQUE
+            );
+
+            CREATE TABLE IF NOT EXISTS BankAccounts (
+            BankAccount_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            Bank_ID INTEGER NOT NULL,
+            Member_ID INTEGER NOT NULL,
+            Account_Number TEXT NOT NULL,
+            Opening_Balance INTEGER NOT NULL,
+            Closing_Balance INTEGER NOT NULL,
+            FOREIGN KEY(Bank_ID) REFERENCES BankList(Bank_ID),
+            FOREIGN KEY(Member_ID) REFERENCES MemberInfo(Member_ID) ON DELETE CASCADE
+            );
+
+            CREATE INDEX IF NOT EXISTS MemberInfo_Family_Index ON MemberInfo (Family_ID);
+            CREATE INDEX IF NOT EXISTS BankAccounts_Member_Index ON BankAccounts (Member_ID);
+
+            INSERT OR IGNORE INTO BankList (Bank_Name)
+            VALUES ('Canara'), ('SBI'), ('Axis'), ('HDFC'), ('PNB');
+            )"
+        },
+        {
+            // Family size kept by triggers so the REQ-3 cap is checked
+            // inside the member INSERT instead of with a COUNT per add
+            2, R"(
+            ALTER TABLE FamilyInfo ADD COLUMN Member_Count INTEGER NOT NULL DEFAULT 0;
+
+            UPDATE FamilyInfo SET Member_Count =
+            (SELECT COUNT(1) FROM MemberInfo WHERE MemberInfo.Family_ID = FamilyInfo.Family_ID);
+
+            CREATE TRIGGER MemberInfo_Count_Insert AFTER INSERT ON MemberInfo
+            BEGIN
+            UPDATE FamilyInfo SET Member_Count = Member_Count + 1 WHERE Family_ID = NEW.Family_ID;
+            END;
+
+            CREATE TRIGGER MemberInfo_Count_Delete AFTER DELETE ON MemberInfo
+            BEGIN
+            UPDATE FamilyInfo SET Member_Count = Member_Count - 1 WHERE Family_ID = OLD.Family_ID;
+            END;
+
+            CREATE TRIGGER MemberInfo_Count_Move AFTER UPDATE OF Family_ID ON MemberInfo
+            BEGIN
+            UPDATE FamilyInfo SET Member_Count = Member_Count - 1 WHERE Family_ID = OLD.Family_ID;
+            UPDATE FamilyInfo SET Member_Count = Member_Count + 1 WHERE Family_ID = NEW.Family_ID;
+            END;
+            )"
+        },
+        {
+            // Balance history per statement period. Dates are ISO text so
+            // they sort chronologically; the unique index makes "latest
+            // snapshot on or before D" a single seek per account.
+            3, R"(
+            CREATE TABLE BalanceSnapshots (
+            Snapshot_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            BankAccount_ID INTEGER NOT NULL,
+            Period_Start TEXT,
+            Period_End TEXT NOT NULL,
+            Opening_Balance INTEGER NOT NULL,
+            Closing_Balance INTEGER NOT NULL,
+            FOREIGN KEY(BankAccount_ID) REFERENCES BankAccounts(BankAccount_ID) ON DELETE CASCADE
+            );
+
+            CREATE UNIQUE INDEX BalanceSnapshots_Account_End ON BalanceSnapshots (BankAccount_ID, Period_End);
+            )"
+        },
+        {
+            // Statement lines plus monthly cash-flow rollups kept by
+            // triggers. The rollup key leads with (member, month) so a
+            // member's month range is one contiguous index scan, and a
+            // family's is one scan per member.
+            4, R"(
+            CREATE TABLE Transactions (
+            Transaction_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            BankAccount_ID INTEGER NOT NULL,
+            Txn_Date TEXT NOT NULL,
+            Description TEXT NOT NULL DEFAULT '',
+            Amount INTEGER NOT NULL,
+            FOREIGN KEY(BankAccount_ID) REFERENCES BankAccounts(BankAccount_ID) ON DELETE CASCADE
+            );
+
+            CREATE INDEX Transactions_Account_Date ON Transactions (BankAccount_ID, Txn_Date);
+
+            CREATE TABLE CashFlowRollups (
+            Member_ID INTEGER NOT NULL,
+            Month TEXT NOT NULL,
+            BankAccount_ID INTEGER NOT NULL,
+            Credit_Total INTEGER NOT NULL DEFAULT 0,
+            Credit_Count INTEGER NOT NULL DEFAULT 0,
+            Debit_Total INTEGER NOT NULL DEFAULT 0,
+            Debit_Count INTEGER NOT NULL DEFAULT 0,
+            PRIMARY KEY (Member_ID, Month, BankAccount_ID),
+            FOREIGN KEY(BankAccount_ID) REFERENCES BankAccounts(BankAccount_ID) ON DELETE CASCADE
+            ) WITHOUT ROWID;
+
+            CREATE INDEX CashFlowRollups_Account ON CashFlowRollups (BankAccount_ID);
+
+            CREATE TRIGGER Transactions_Rollup_Insert AFTER INSERT ON Transactions
+            BEGIN
+            INSERT OR IGNORE INTO CashFlowRollups (Member_ID, Month, BankAccount_ID)
+            SELECT Member_ID, substr(NEW.Txn_Date, 1, 7), NEW.BankAccount_ID
+            FROM BankAccounts WHERE BankAccount_ID = NEW.BankAccount_ID;
+            UPDATE CashFlowRollups SET
+            Credit_Total = Credit_Total + max(NEW.Amount, 0),
+            Credit_Count = Credit_Count + (NEW.Amount > 0),
+            Debit_Total = Debit_Total + max(-NEW.Amount, 0),
+            Debit_Count = Debit_Count + (NEW.Amount < 0)
+            WHERE Member_ID = (SELECT Member_ID FROM BankAccounts WHERE BankAccount_ID = NEW.BankAccount_ID)
+            AND Month = substr(NEW.Txn_Date, 1, 7) AND BankAccount_ID = NEW.BankAccount_ID;
+            END;
+
+            CREATE TRIGGER Transactions_Rollup_Delete AFTER DELETE ON Transactions
+            BEGIN
+            UPDATE CashFlowRollups SET
+            Credit_Total = Credit_Total - max(OLD.Amount, 0),
+            Credit_Count = Credit_Count - (OLD.Amount > 0),
+            Debit_Total = Debit_Total - max(-OLD.Amount, 0),
+            Debit_Count = Debit_Count - (OLD.Amount < 0)
+            WHERE Member_ID = (SELECT Member_ID FROM BankAccounts WHERE BankAccount_ID = OLD.BankAccount_ID)
+            AND Month = substr(OLD.Txn_Date, 1, 7) AND BankAccount_ID = OLD.BankAccount_ID;
+            DELETE FROM CashFlowRollups
+            WHERE BankAccount_ID = OLD.BankAccount_ID AND Month = substr(OLD.Txn_Date, 1, 7)
+            AND NOT EXISTS (SELECT 1 FROM Transactions WHERE BankAccount_ID = OLD.BankAccount_ID
+            AND Txn_Date BETWEEN substr(OLD.Txn_Date, 1, 7) || '-01' AND substr(OLD.Txn_Date, 1, 7) || '-31');
+            END;
+            )"
+        },
+        {
+            // Full-text index over narration and counterparty. It is an
+            // external-content FTS5 table (the text lives only in
+            // Transactions) kept in step by triggers, so rows are indexed
+            // inside the import transaction that inserts them.
+            5, R"(
+            ALTER TABLE Transactions ADD COLUMN Counterparty TEXT NOT NULL DEFAULT '';
+
+            CREATE VIRTUAL TABLE TransactionSearch USING fts5(
+            Description, Counterparty, content='Transactions', content_rowid='Transaction_ID'
+            );
+
+            INSERT INTO TransactionSearch (TransactionSearch) VALUES ('rebuild');
+
+            CREATE TRIGGER Transactions_Search_Insert AFTER INSERT ON Transactions
+            BEGIN
+            INSERT INTO TransactionSearch (rowid, Description, Counterparty)
+            VALUES (NEW.Transaction_ID, NEW.Description, NEW.Counterparty);
+            END;
+
+            CREATE TRIGGER Transactions_Search_Delete AFTER DELETE ON Transactions
+            BEGIN
+            INSERT INTO TransactionSearch (TransactionSearch, rowid, Description, Counterparty)
+            VALUES ('delete', OLD.Transaction_ID, OLD.Description, OLD.Counterparty);
+            END;
+            )"
+        },
+        {
+            // Duplicate detection for overlapping statements. Every row
+            // carries the fingerprint from transactionFingerprints(), unique
+            // per account; rows imported before this version are
+            // fingerprinted by backfillTransactionFingerprints.
+            6, R"(
+            ALTER TABLE Transactions ADD COLUMN Balance_After INTEGER;
+            ALTER TABLE Transactions ADD COLUMN Fingerprint INTEGER;
+
+            CREATE UNIQUE INDEX Transactions_Account_Fingerprint ON Transactions (BankAccount_ID, Fingerprint);
+            )",
+            backfillTransactionFingerprints
+        },
+        {
+            // Keyword categorisation. Triggers bump CategoryRuleVersion on
+            // every rule change and each transaction records the version it
+            // was categorised under, so recategorising after a change only
+            // visits rows with an older version (all existing rows here).
+            7, R"(
+            CREATE TABLE Categories (
+            Category_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            Category_Name TEXT NOT NULL UNIQUE COLLATE NOCASE
+            );
+
+            CREATE TABLE CategoryRules (
+            Rule_ID INTEGER PRIMARY KEY AUTOINCREMENT,
+            Category_ID INTEGER NOT NULL,
+            Keyword TEXT NOT NULL,
+            Priority INTEGER NOT NULL DEFAULT 0,
+            FOREIGN KEY(Category_ID) REFERENCES Categories(Category_ID) ON DELETE CASCADE
+            );
+
+            CREATE TABLE CategoryRuleVersion (
+            Singleton INTEGER PRIMARY KEY CHECK (Singleton = 1),
+            Version INTEGER NOT NULL
+            );
+
+            INSERT INTO Categories (Category_Name)
+            VALUES ('Salary'), ('Rent'), ('EMI'), ('Groceries');
+
+            INSERT INTO CategoryRules (Category_ID, Keyword)
+            VALUES (1, 'salary'), (2, 'rent'), (3, 'emi'), (3, 'loan repayment'),
+            (4, 'grocery'), (4, 'groceries'), (4, 'supermarket');
+
+            INSERT INTO CategoryRuleVersion (Singleton, Version) VALUES (1, 1);
+
+            CREATE TRIGGER CategoryRules_Version_Insert AFTER INSERT ON CategoryRules
+            BEGIN
+            UPDATE CategoryRuleVersion SET Version = Version + 1;
+            END;
+
+            CREATE TRIGGER CategoryRules_Version_Update AFTER UPDATE ON CategoryRules
+            BEGIN
+            UPDATE CategoryRuleVersion SET Version = Version + 1;
+            END;
+
+            CREATE TRIGGER CategoryRules_Version_Delete AFTER DELETE ON CategoryRules
+            BEGIN
+            UPDATE CategoryRuleVersion SET Version = Version + 1;
+            END;
+
+            ALTER TABLE Transactions ADD COLUMN Category_ID INTEGER;
+            ALTER TABLE Transactions ADD COLUMN Rules_Version INTEGER NOT NULL DEFAULT 0;
+
+            CREATE INDEX Transactions_Rules_Version ON Transactions (Rules_Version);
+            )"
+        }
+    };
+
+    // Aggregation of the raw transactions into rollup rows, shared by the
+    // rebuild and the consistency check so both agree on the definition
+    constexpr const char* kCashFlowAggregateSql =
+        "SELECT b.Member_ID, substr(t.Txn_Date, 1, 7), t.BankAccount_ID, "
+        "SUM(max(t.Amount, 0)), SUM(t.Amount > 0), SUM(max(-t.Amount, 0)), SUM(t.Amount < 0) "
+        "FROM Transactions t JOIN BankAccounts b ON b.BankAccount_ID = t.BankAccount_ID "
+        "GROUP BY b.Member_ID, substr(t.Txn_Date, 1, 7), t.BankAccount_ID";
+
+    // Bound parameters per IN-list. Older SQLite builds cap a statement at
+    // 999 variables, so large batches are split into several queries.
+    constexpr std::size_t kMaxIdsPerQuery = 500;
+
+    /**
+     * @brief Collect the distinct IDs of a batch request.
+     * 
+     * @param ids Requested IDs, possibly repeated.
+     * @param out_first_position Receives each distinct ID's first index in `ids`.
+     * @return std::vector<uint64_t> Distinct IDs in request order.
+     */
+    std::vector<uint64_t> distinctIds(std::span<const uint64_t> ids, std::unordered_map<uint64_t, std::size_t>* out_first_position)
+    {
+        std::vector<uint64_t> distinct;
+        distinct.reserve(ids.size());
+        out_first_position->reserve(ids.size());
+
+        for (std::size_t index = 0; index < ids.size(); ++index)
+        {
+            if (out_first_position->emplace(ids[index], index).second)
+            {
+                distinct.push_back(ids[index]);
+            }
+        }
+
+        return distinct;
+    }
+
+    /**
+     * @brief Run `sql_prefix (?, ?, ...) sql_suffix` for each chunk of IDs.
+     * 
+     * @param db Open SQLite handle.
+     * @param sql_prefix SQL up to and including "IN".
+     * @param sql_suffix SQL after the parameter list (may be empty).
+     * @param ids Distinct IDs to bind.
+     * @param on_row Called for every result row.
+     * @return true if every chunk ran to completion.
+     */
+    bool forEachIdChunkRow(sqlite3* db,
+                           const std::string& sql_prefix,
+                           const std::string& sql_suffix,
+                           std::span<const uint64_t> ids,
+                           const std::function<void(sqlite3_stmt*)>& on_row)
+    {
+        for (std::size_t chunk_start = 0; chunk_start < ids.size(); chunk_start += kMaxIdsPerQuery)
+        {
+            std::size_t chunk_size = std::min(kMaxIdsPerQuery, ids.size() - chunk_start);
+            std::string sql = sql_prefix + " (?";
+
+            for (std::size_t index = 1; index < chunk_size; ++index)
+            {
+                sql += ",?";
+            }
+
+            sql += ") " + sql_suffix + ";";
+            sqlite3_stmt* stmt = nullptr;
+
+            if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+            {
+                return false;
+            }
+
+            for (std::size_t index = 0; index < chunk_size; ++index)
+            {
+                sqlite3_bind_int64(stmt, static_cast<int>(index + 1), static_cast<sqlite3_int64>(ids[chunk_start + index]));
+            }
+
+            int ret_code = SQLITE_ROW;
+
+            while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
+            {
+                on_row(stmt);
+            }
+
+            sqlite3_finalize(stmt);
+
+            if (ret_code != SQLITE_DONE)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Copy results for repeated IDs from the first occurrence.
+     * 
+     * @param ids Requested IDs.
+     * @param first_position First index of each distinct ID.
+     * @param results Output aligned with `ids`; only first occurrences are filled on entry.
+     */
+    template <typename T>
+    void fillRepeatedIds(std::span<const uint64_t> ids,
+                         const std::unordered_map<uint64_t, std::size_t>& first_position,
+                         std::vector<std::optional<T>>& results)
+    {
+        if (first_position.size() == ids.size())
+        {
+            return;
+        }
+
+        for (std::size_t index = 0; index < ids.size(); ++index)
+        {
+            std::size_t first = first_position.at(ids[index]);
+
+            if (first != index)
+            {
+                results[index] = results[first];
+            }
+        }
+    }
+
+    /**
+     * @brief Read text column, mapping NULL to an empty string.
+     * 
+     * @param stmt Statement positioned on a row.
+     * @param column Column index.
+     * @return std::string
+     */
+    std::string columnText(sqlite3_stmt* stmt, int column)
+    {
+        const unsigned char* text = sqlite3_column_text(stmt, column);
+        return text ? reinterpret_cast<const char*>(text) : std::string();
+    }
+
+    /**
+     * @brief View a text column in place (valid until the next step/finalize).
+     * 
+     * @param stmt Statement positioned on a row.
+     * @param column Column index.
+     * @return std::string_view Empty for NULL.
+     */
+    std::string_view columnView(sqlite3_stmt* stmt, int column)
+    {
+        const unsigned char* text = sqlite3_column_text(stmt, column);
+
+        if (!text)
+        {
+            return std::string_view();
+        }
+
+        return std::string_view(reinterpret_cast<const char*>(text), static_cast<size_t>(sqlite3_column_bytes(stmt, column)));
+    }
+
+    /**
+     * @brief Read the trigger-maintained member count of a family.
+     * 
+     * @param db Open SQLite handle.
+     * @param family_id Family to look up.
+     * @param out_count Receives the count (0 when the family does not exist).
+     * @param out_ok Set to false on a database error.
+     * @return true if the family exists.
+     */
+    bool familyMemberCount(sqlite3* db, uint64_t family_id, uint64_t* out_count, bool* out_ok)
+    {
+        sqlite3_stmt* stmt = nullptr;
+        *out_count = 0;
+        *out_ok = false;
+
+        if (sqlite3_prepare_v2(db, "SELECT Member_Count FROM FamilyInfo WHERE Family_ID = ?;", -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            return false;
+        }
+
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
+        int ret_code = sqlite3_step(stmt);
+        bool exists = ret_code == SQLITE_ROW;
+
+        if (exists)
+        {
+            *out_count = static_cast<uint64_t>(std::max<sqlite3_int64>(0, sqlite3_column_int64(stmt, 0)));
+        }
+
+        *out_ok = exists || ret_code == SQLITE_DONE;
+        sqlite3_finalize(stmt);
+        return exists;
+    }
+
+    /**
+     * @brief Read PRAGMA user_version from a connection.
+     * 
+     * @param db Open SQLite handle.
+     * @return int The stored version, or -1 on error.
+     */
+    int readUserVersion(sqlite3* db)
+    {
+        sqlite3_stmt* stmt = nullptr;
+        int version = -1;
+
+        if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            return version;
+        }
+
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            version = sqlite3_column_int(stmt, 0);
+        }
+
+        sqlite3_finalize(stmt);
+        return version;
+    }
+
+    /**
+     * @brief Fingerprint every existing transaction of the database.
+     * 
+     * Each account's history is fingerprinted as one statement in
+     * Transaction_ID order, so lines already imported twice get distinct
+     * occurrence numbers and do not trip the unique index.
+     * 
+     * @param db Writer connection, inside the migration transaction.
+     * @return true if every row was updated.
+     */
+    bool backfillTransactionFingerprints(sqlite3* db)
+    {
+        sqlite3_stmt* select_stmt = nullptr;
+        sqlite3_stmt* update_stmt = nullptr;
+        const char* select_sql =
+            "SELECT Transaction_ID, BankAccount_ID, Txn_Date, Description, Amount "
+            "FROM Transactions ORDER BY BankAccount_ID, Transaction_ID;";
+
+        if (sqlite3_prepare_v2(db, select_sql, -1, &select_stmt, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(db, "UPDATE Transactions SET Fingerprint = ? WHERE Transaction_ID = ?;", -1, &update_stmt, nullptr) != SQLITE_OK)
+        {
+            sqlite3_finalize(select_stmt);
+            return false;
+        }
+
+        uint64_t account_id = 0;
+        std::vector<sqlite3_int64> row_ids;
+        std::vector<BankTransaction> history;
+        bool ok = true;
+
+        auto flush = [&]()
+        {
+            std::vector<uint64_t> fingerprints = transactionFingerprints(account_id, history);
+
+            for (std::size_t index = 0; ok && index < fingerprints.size(); ++index)
+            {
+                sqlite3_bind_int64(update_stmt, 1, static_cast<sqlite3_int64>(fingerprints[index]));
+                sqlite3_bind_int64(update_stmt, 2, row_ids[index]);
+                ok = sqlite3_step(update_stmt) == SQLITE_DONE;
+                sqlite3_reset(update_stmt);
+            }
+
+            row_ids.clear();
+            history.clear();
+        };
+
+        int ret_code = SQLITE_ROW;
+
+        while (ok && (ret_code = sqlite3_step(select_stmt)) == SQLITE_ROW)
+        {
+            uint64_t row_account_id = static_cast<uint64_t>(sqlite3_column_int64(select_stmt, 1));
+
+            if (row_account_id != account_id)
+            {
+                flush();
+                account_id = row_account_id;
+            }
+
+            BankTransaction transaction;
+            transaction.date = commons::parseDate(columnText(select_stmt, 2)).value_or(commons::Date{});
+            transaction.description = columnText(select_stmt, 3);
+            transaction.amount_paise = static_cast<long long>(sqlite3_column_int64(select_stmt, 4));
+            row_ids.push_back(sqlite3_column_int64(select_stmt, 0));
+            history.push_back(std::move(transaction));
+        }
+
+        if (ok)
+        {
+            flush();
+        }
+
+        sqlite3_finalize(select_stmt);
+        sqlite3_finalize(update_stmt);
+        return ok && ret_code == SQLITE_DONE;
+    }
+}
+
 /**
  * @brief Construct a new Storage Manager:: Storage Manager object
  */
 StorageManager::StorageManager() 
 {
+    // One reader per hardware thread, within sensible bounds for SQLite
+    std::size_t hardware_threads = std::thread::hardware_concurrency();
+    max_read_connections = std::clamp<std::size_t>(hardware_threads, 2, 8);
 }
 
 /**
@@ -33,6 +588,14 @@ StorageManager::~StorageManager()
  */
 bool StorageManager::initializeDatabase(const std::string& dbPath) 
 {
+    std::lock_guard<std::mutex> init_lock(init_mutex);
+
+    // Another thread may have completed lazy initialisation while we waited
+    if (connected)
+    {
+        return true;
+    }
+
     // Determine database path. If caller provided a path (non-empty and not the
     // placeholder), use it. Otherwise, try to infer project root and use
     // project_root/homefinancials.db
@@ -56,447 +619,2575 @@ bool StorageManager::initializeDatabase(const std::string& dbPath)
             projectRoot = fs::current_path();
         }
 
-        fs::path dbPathFs = projectRoot / "homefinancials.db";
-        chosenPath = dbPathFs.string();
+        fs::path dbPathFs = projectRoot / "homefinancials.db";
+        chosenPath = dbPathFs.string();
+    }
+
+    // Create parent directories if needed
+    try 
+    {
+        std::filesystem::path parent = std::filesystem::path(chosenPath).parent_path();
+
+        if (!parent.empty() && !std::filesystem::exists(parent)) 
+        {
+            std::filesystem::create_directories(parent);
+        }
+    } 
+    catch (const std::exception &e) 
+    {
+        std::cerr << "Failed to create DB parent directories: " << e.what() << std::endl;
+    }
+
+    // Open the writer connection, then bring the schema up to date on it
+    if (!connect(chosenPath))
+    {
+        return false;
+    }
+
+    if (!dbInit())
+    {
+        disconnect();
+        return false;
+    }
+
+    // Lazy callers skip initialisation once this is set, so it is only
+    // published after the schema is current
+    connected = true;
+    return true;
+}
+
+/**
+ * @brief Return the schema version recorded in the database header.
+ * 
+ * @return int PRAGMA user_version, or -1 when not connected or on error.
+ */
+int StorageManager::getSchemaVersion()
+{
+    if (!connected)
+    {
+        return -1;
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+    return readUserVersion(db_handle);
+}
+
+/**
+ * @brief Bring the schema on the writer connection up to kSchemaVersion.
+ * 
+ * Reads PRAGMA user_version first and returns immediately when the schema is
+ * current, so a warm start costs a single header read. Otherwise the pending
+ * migration steps run in one IMMEDIATE transaction (so concurrent processes
+ * cannot migrate twice) and user_version is bumped before commit.
+ * 
+ * @return true if the schema is current.
+ * @return false if a migration step failed (nothing is applied).
+ */
+bool StorageManager::dbInit()
+{
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    if (readUserVersion(db_handle) >= kSchemaVersion)
+    {
+        return true;
+    }
+
+    char* errmsg = nullptr;
+
+    if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, &errmsg) != SQLITE_OK)
+    {
+        std::cerr << "Failed to begin schema migration: " << (errmsg ? errmsg : "") << std::endl;
+        sqlite3_free(errmsg);
+        return false;
+    }
+
+    // Another process may have migrated between the check and the lock
+    int current_version = readUserVersion(db_handle);
+
+    for (const auto &migration : kSchemaMigrations)
+    {
+        if (migration.version <= current_version)
+        {
+            continue;
+        }
+
+        if (sqlite3_exec(db_handle, migration.sql, nullptr, nullptr, &errmsg) != SQLITE_OK)
+        {
+            std::cerr << "Schema migration to version " << migration.version << " failed: " << (errmsg ? errmsg : "") << std::endl;
+            sqlite3_free(errmsg);
+            sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+
+        if (migration.backfill && !migration.backfill(db_handle))
+        {
+            std::cerr << "Schema migration to version " << migration.version << " failed to backfill existing rows" << std::endl;
+            sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
+    const std::string set_version = "PRAGMA user_version = " + std::to_string(kSchemaVersion) + ";";
+
+    if (sqlite3_exec(db_handle, set_version.c_str(), nullptr, nullptr, &errmsg) != SQLITE_OK ||
+        sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, &errmsg) != SQLITE_OK)
+    {
+        std::cerr << "Failed to commit schema migration: " << (errmsg ? errmsg : "") << std::endl;
+        sqlite3_free(errmsg);
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Save member data to the database.
+ * 
+ * @param member Member to save.
+ * @param family_id ID of the family the member belongs to.
+ * @return true if save was successful.
+ * @return false if save failed.
+ */
+bool StorageManager::saveMemberData(const Member& member, const uint64_t family_id) 
+{
+    return saveMemberDataEx(member, family_id, nullptr) == commons::Result::Ok;
+}
+
+/**
+ * @brief Save family data to the database.
+ * 
+ * @param family family
+ * @return true if save was successful.
+ * @return false if save failed.
+ */
+bool StorageManager::saveFamilyData(const Family& family) 
+{
+    return saveFamilyDataEx(family, nullptr) == commons::Result::Ok;
+}
+
+/**
+ * @brief Get member data by ID.
+ * 
+ * @param member_id Member ID to retrieve.
+ * @return Member* 
+ */
+Member* StorageManager::getMemberData(const uint64_t& member_id) 
+{
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return nullptr;
+        } 
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return nullptr;
+    }
+
+    const char* sql = "SELECT Member_ID, Family_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Member_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Failed to prepare select member: " << sqlite3_errmsg(read_db) << std::endl;
+        return nullptr;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
+    ret_code = sqlite3_step(stmt);
+
+    if (ret_code == SQLITE_ROW) 
+    {
+        Member* m = new Member(member_id, columnText(stmt, 2), columnText(stmt, 3));
+        sqlite3_finalize(stmt);
+        return m;
+    }
+
+    sqlite3_finalize(stmt);
+    return nullptr;
+}
+
+/**
+ * @brief Get family data by ID.
+ * 
+ * @param family_id ID of the family to retrieve.
+ * @return Family* 
+ */
+Family* StorageManager::getFamilyData(const uint64_t& family_id) 
+{
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return nullptr;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return nullptr;
+    }
+
+    // Family row and its members in one statement. The LEFT JOIN yields a
+    // single row with NULL member columns for a family without members.
+    const char* sql =
+        "SELECT f.Family_Name, f.Member_Count, m.Member_ID, m.Member_Name, m.Member_Nick_Name "
+        "FROM FamilyInfo f LEFT JOIN MemberInfo m ON m.Family_ID = f.Family_ID "
+        "WHERE f.Family_ID = ? ORDER BY m.Member_ID;";
+    sqlite3_stmt* stmt = nullptr;
+
+    int ret_code = sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr);
+    
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Failed to prepare select family: " << sqlite3_errmsg(read_db) << std::endl;
+        return nullptr;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
+    Family* family = nullptr;
+
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW) 
+    {
+        if (!family)
+        {
+            family = new Family(family_id, columnText(stmt, 0));
+            family->reserveMembers(static_cast<std::size_t>(std::max<sqlite3_int64>(0, sqlite3_column_int64(stmt, 1))));
+        }
+
+        if (sqlite3_column_type(stmt, 2) != SQLITE_NULL)
+        {
+            family->emplaceMember(static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)), columnText(stmt, 3), columnText(stmt, 4));
+        }
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_DONE)
+    {
+        delete family;
+        return nullptr;
+    }
+
+    return family;
+}
+
+/**
+ * @brief Look up several members with one IN-list query.
+ * 
+ * @param member_ids Requested IDs (repeats allowed).
+ * @param out_members One entry per requested ID; std::nullopt if not found.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::getMembersEx(std::span<const uint64_t> member_ids, std::vector<std::optional<Member>>* out_members)
+{
+    if (!out_members)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    out_members->assign(member_ids.size(), std::nullopt);
+
+    if (member_ids.empty())
+    {
+        return commons::Result::Ok;
+    }
+
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        } 
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    std::unordered_map<uint64_t, std::size_t> first_position;
+    std::vector<uint64_t> distinct = distinctIds(member_ids, &first_position);
+
+    bool ok = forEachIdChunkRow(read_db,
+        "SELECT Member_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Member_ID IN", "",
+        distinct,
+        [&](sqlite3_stmt* stmt)
+        {
+            uint64_t member_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+            (*out_members)[first_position.at(member_id)].emplace(member_id, columnText(stmt, 1), columnText(stmt, 2));
+        });
+
+    if (!ok)
+    {
+        return commons::Result::DbError;
+    }
+
+    fillRepeatedIds(member_ids, first_position, *out_members);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Look up several families and their members with two IN-list queries.
+ * 
+ * @param family_ids Requested IDs (repeats allowed).
+ * @param out_families One entry per requested ID; std::nullopt if not found.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::getFamiliesEx(std::span<const uint64_t> family_ids, std::vector<std::optional<Family>>* out_families)
+{
+    if (!out_families)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    out_families->assign(family_ids.size(), std::nullopt);
+
+    if (family_ids.empty())
+    {
+        return commons::Result::Ok;
+    }
+
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        } 
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    std::unordered_map<uint64_t, std::size_t> first_position;
+    std::vector<uint64_t> distinct = distinctIds(family_ids, &first_position);
+
+    bool ok = forEachIdChunkRow(read_db,
+        "SELECT Family_ID, Family_Name, Member_Count FROM FamilyInfo WHERE Family_ID IN", "",
+        distinct,
+        [&](sqlite3_stmt* stmt)
+        {
+            uint64_t family_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+            Family &family = (*out_families)[first_position.at(family_id)].emplace(family_id, columnText(stmt, 1));
+            family.reserveMembers(static_cast<std::size_t>(std::max<sqlite3_int64>(0, sqlite3_column_int64(stmt, 2))));
+        });
+
+    ok = ok && forEachIdChunkRow(read_db,
+        "SELECT Family_ID, Member_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Family_ID IN", "ORDER BY Member_ID",
+        distinct,
+        [&](sqlite3_stmt* stmt)
+        {
+            uint64_t family_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+            std::optional<Family> &family = (*out_families)[first_position.at(family_id)];
+
+            if (family)
+            {
+                family->emplaceMember(static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)), columnText(stmt, 2), columnText(stmt, 3));
+            }
+        });
+
+    if (!ok)
+    {
+        return commons::Result::DbError;
+    }
+
+    fillRepeatedIds(family_ids, first_position, *out_families);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Look up several bank account rows with one IN-list query.
+ * 
+ * @param bank_account_ids Requested IDs (repeats allowed).
+ * @param out_accounts One entry per requested ID; std::nullopt if not found.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::getBankAccountsEx(std::span<const uint64_t> bank_account_ids, std::vector<std::optional<BankAccount>>* out_accounts)
+{
+    if (!out_accounts)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    out_accounts->assign(bank_account_ids.size(), std::nullopt);
+
+    if (bank_account_ids.empty())
+    {
+        return commons::Result::Ok;
+    }
+
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        } 
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    std::unordered_map<uint64_t, std::size_t> first_position;
+    std::vector<uint64_t> distinct = distinctIds(bank_account_ids, &first_position);
+
+    bool ok = forEachIdChunkRow(read_db,
+        "SELECT BankAccount_ID, Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance FROM BankAccounts WHERE BankAccount_ID IN", "",
+        distinct,
+        [&](sqlite3_stmt* stmt)
+        {
+            uint64_t bank_account_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+            BankAccount &account = (*out_accounts)[first_position.at(bank_account_id)].emplace();
+            account.setId(bank_account_id);
+            account.setBankId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)));
+            account.setMemberId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)));
+            account.setAccountNumber(columnText(stmt, 3));
+            account.setOpeningBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 4)));
+            account.setClosingBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 5)));
+        });
+
+    if (!ok)
+    {
+        return commons::Result::DbError;
+    }
+
+    fillRepeatedIds(bank_account_ids, first_position, *out_accounts);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Delete member data by ID.
+ * 
+ * @param member_id ID of the member to delete.
+ * @return true if deletion was successful.
+ * @return false if deletion failed.
+ */
+bool StorageManager::deleteMemberData(const uint64_t& member_id) 
+{
+    if (!connected) 
+    {
+        if (!initializeDatabase("")) 
+        {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* sql = "DELETE FROM MemberInfo WHERE Member_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Failed to prepare delete member: " << sqlite3_errmsg(db_handle) << std::endl;
+        return false;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
+    ret_code = sqlite3_step(stmt);
+    bool success = (ret_code == SQLITE_DONE && sqlite3_changes(db_handle) > 0);
+    sqlite3_finalize(stmt);
+
+    return success;
+}
+
+/**
+ * @brief Delete family data by ID.
+ * 
+ * @param family_id ID of the family to delete.
+ * @return true if deletion was successful.
+ * @return false if deletion failed.
+ */
+bool StorageManager::deleteFamilyData(const uint64_t& family_id) 
+{
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* sql = "DELETE FROM FamilyInfo WHERE Family_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Failed to prepare delete family: " << sqlite3_errmsg(db_handle) << std::endl;
+        return false;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
+    ret_code = sqlite3_step(stmt);
+    bool success = (ret_code == SQLITE_DONE && sqlite3_changes(db_handle) > 0);
+    sqlite3_finalize(stmt);
+
+    return success;
+}
+
+/**
+ * @brief Delete several members in a single write transaction.
+ * 
+ * The IDs are staged in a temp table so one DELETE ... IN (SELECT ...)
+ * removes them all (cascading to their bank accounts) and the batch costs
+ * one commit instead of one per member.
+ * 
+ * @param member_ids IDs of the members to delete.
+ * @param out_results Optional per-ID outcome, aligned with member_ids.
+ * @return commons::Result Ok once committed, DbError if rolled back.
+ */
+commons::Result StorageManager::deleteMembersEx(const std::vector<uint64_t>& member_ids, std::vector<commons::Result>* out_results)
+{
+    if (out_results)
+    {
+        out_results->assign(member_ids.size(), commons::Result::NotFound);
+    }
+
+    if (member_ids.empty())
+    {
+        return commons::Result::Ok;
+    }
+
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        } 
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* setup_sql =
+        "CREATE TEMP TABLE IF NOT EXISTS PendingMemberDeletes (Member_ID INTEGER PRIMARY KEY);"
+        "BEGIN IMMEDIATE;";
+
+    if (sqlite3_exec(db_handle, setup_sql, nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    auto rollback = [this]()
+    {
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return commons::Result::DbError;
+    };
+
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(db_handle, "INSERT OR IGNORE INTO temp.PendingMemberDeletes (Member_ID) VALUES (?);", -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return rollback();
+    }
+
+    for (uint64_t member_id : member_ids)
+    {
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
+
+        if (sqlite3_step(stmt) != SQLITE_DONE)
+        {
+            sqlite3_finalize(stmt);
+            return rollback();
+        }
+
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+
+    // Which of the staged IDs exist, so each can be reported individually
+    const char* existing_sql =
+        "SELECT Member_ID FROM MemberInfo WHERE Member_ID IN (SELECT Member_ID FROM temp.PendingMemberDeletes);";
+
+    if (sqlite3_prepare_v2(db_handle, existing_sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return rollback();
+    }
+
+    std::unordered_set<uint64_t> existing;
+    int ret_code = SQLITE_ROW;
+
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        existing.insert(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)));
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_DONE)
+    {
+        return rollback();
+    }
+
+    const char* delete_sql =
+        "DELETE FROM MemberInfo WHERE Member_ID IN (SELECT Member_ID FROM temp.PendingMemberDeletes);"
+        "DELETE FROM temp.PendingMemberDeletes;"
+        "COMMIT;";
+
+    if (sqlite3_exec(db_handle, delete_sql, nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        return rollback();
+    }
+
+    if (out_results)
+    {
+        for (std::size_t index = 0; index < member_ids.size(); ++index)
+        {
+            // erase() succeeds once per ID, so repeats report NotFound
+            if (existing.erase(member_ids[index]) > 0)
+            {
+                (*out_results)[index] = commons::Result::Ok;
+            }
+        }
+    }
+
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Update family data.
+ * 
+ * @param family_id ID of the family to update.
+ * @param new_name Name to update to.
+ * @return true if update was successful.
+ * @return false if update failed.
+ */
+bool StorageManager::updateFamilyData(const uint64_t& family_id, const std::string& new_name)
+{
+    if (!connected) 
+    {
+        if (!initializeDatabase("")) 
+        {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* sql = "UPDATE FamilyInfo SET Family_Name = ? WHERE Family_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Failed to prepare update family: " << sqlite3_errmsg(db_handle) << std::endl;
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, new_name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(family_id));
+    ret_code = sqlite3_step(stmt);
+    bool success = (ret_code == SQLITE_DONE && sqlite3_changes(db_handle) > 0);
+    sqlite3_finalize(stmt);
+
+    return success;
+}
+
+/**
+ * @brief Update member data.
+ * 
+ * @param member_id ID of the member to update.
+ * @param new_name Name to update to.
+ * @param new_nickname Nickname to update to.
+ * @return true 
+ * @return false 
+ */
+bool StorageManager::updateMemberData(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname)
+{
+    // Delegate to Ex version, reuse logic but convert commons::Result to bool
+    auto result = updateMemberDataEx(member_id, new_name, new_nickname);
+    return result == commons::Result::Ok;
+}
+
+/**
+ * @brief Save family data to the database.
+ * 
+ * @param family Family to save.
+ * @param out_family_id ID output parameter.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::saveFamilyDataEx(const Family& family, uint64_t* out_family_id)
+{
+    if (family.getName().empty()) 
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* sql = "INSERT INTO FamilyInfo (Family_Name) VALUES (?);";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK) 
+    {
+        return commons::Result::DbError;
+    }
+
+    ret_code = sqlite3_bind_text(stmt, 1, family.getName().c_str(), -1, SQLITE_STATIC);
+    
+    if (ret_code != SQLITE_OK) 
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    ret_code = sqlite3_step(stmt);
+
+    if (ret_code != SQLITE_DONE) 
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_int64 family_id = sqlite3_last_insert_rowid(db_handle);
+
+    // Insert members if any
+    const auto &members = family.getMembers();
+
+    for (const auto &m : members) 
+    {
+        const char* msql = "INSERT INTO MemberInfo (Family_ID, Member_Name, Member_Nick_Name) VALUES (?, ?, ?);";
+        sqlite3_stmt* mstmt = nullptr;
+        ret_code = sqlite3_prepare_v2(db_handle, msql, -1, &mstmt, nullptr);
+
+        if (ret_code != SQLITE_OK) 
+        {
+            // continue inserting others but mark DB error
+            sqlite3_finalize(mstmt);
+            continue;
+        }
+
+        sqlite3_bind_int64(mstmt, 1, family_id);
+        sqlite3_bind_text(mstmt, 2, m.getName().c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(mstmt, 3, m.getNickname().c_str(), -1, SQLITE_STATIC);
+        ret_code = sqlite3_step(mstmt);
+        sqlite3_finalize(mstmt);
+    }
+
+    if (out_family_id) *out_family_id = static_cast<uint64_t>(family_id);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Save member data to the database.
+ * 
+ * @param member Member to save.
+ * @param family_id ID of the family the member belongs to.
+ * @param out_member_id Member ID output parameter.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::saveMemberDataEx(const Member& member, const uint64_t family_id, uint64_t* out_member_id)
+{
+    if (member.getName().empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (family_id == 0)
+    {
+        return commons::Result::InvalidInput;
+    } 
+
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    // Existence and the REQ-3 cap (max 255 members) are checked by the
+    // INSERT itself against the trigger-maintained Member_Count
+    const char* sql =
+        "INSERT INTO MemberInfo (Family_ID, Member_Name, Member_Nick_Name) "
+        "SELECT Family_ID, ?, ? FROM FamilyInfo WHERE Family_ID = ? AND Member_Count < ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    // The member outlives the statement, so SQLite need not copy the text
+    sqlite3_bind_text(stmt, 1, member.getName().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, member.getNickname().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(family_id));
+    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(kMaxFamilyMembers));
+
+    ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_DONE) 
+    {
+        return commons::Result::DbError;
+    }
+
+    if (sqlite3_changes(db_handle) == 0)
+    {
+        // Nothing inserted: tell a missing family apart from a full one
+        bool ok = false;
+        uint64_t current_count = 0;
+        bool exists = familyMemberCount(db_handle, family_id, &current_count, &ok);
+
+        if (!ok)
+        {
+            return commons::Result::DbError;
+        }
+
+        return exists ? commons::Result::MaxMembersExceeded : commons::Result::NotFound;
+    }
+
+    if (out_member_id)
+    {
+        *out_member_id = static_cast<uint64_t>(sqlite3_last_insert_rowid(db_handle));
+    } 
+
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Save a parsed bank account row into BankAccounts.
+ *
+ * This validates that the referenced Bank and Member exist, then inserts
+ * the row. Balances are expected in paise (integer cents).
+ */
+commons::Result StorageManager::saveBankAccountEx(uint64_t bank_id,
+                                                 uint64_t member_id,
+                                                 const std::string &account_number,
+                                                 long long opening_paise,
+                                                 long long closing_paise,
+                                                 uint64_t* out_id)
+{
+    if (account_number.empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    return insertBankAccount(bank_id, member_id, account_number, opening_paise, closing_paise, out_id);
+}
+
+/**
+ * @brief Insert a BankAccounts row after checking its bank and member.
+ * 
+ * Runs on the writer with the write lock held, either on its own or
+ * inside the caller's transaction.
+ * 
+ * @return commons::Result NotFound if the bank or member does not exist.
+ */
+commons::Result StorageManager::insertBankAccount(uint64_t bank_id,
+                                                  uint64_t member_id,
+                                                  const std::string &account_number,
+                                                  long long opening_paise,
+                                                  long long closing_paise,
+                                                  uint64_t* out_id)
+{
+    // Ensure bank exists
+    const char* bank_check_sql = "SELECT 1 FROM BankList WHERE Bank_ID = ?;";
+    sqlite3_stmt* bank_stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, bank_check_sql, -1, &bank_stmt, nullptr);
+    if (ret_code != SQLITE_OK)
+    {
+        if (bank_stmt) sqlite3_finalize(bank_stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(bank_stmt, 1, static_cast<sqlite3_int64>(bank_id));
+    ret_code = sqlite3_step(bank_stmt);
+    sqlite3_finalize(bank_stmt);
+    if (ret_code != SQLITE_ROW)
+    {
+        return commons::Result::NotFound;
+    }
+
+    // Ensure member exists
+    const char* member_check_sql = "SELECT 1 FROM MemberInfo WHERE Member_ID = ?;";
+    sqlite3_stmt* member_stmt = nullptr;
+    ret_code = sqlite3_prepare_v2(db_handle, member_check_sql, -1, &member_stmt, nullptr);
+    if (ret_code != SQLITE_OK)
+    {
+        if (member_stmt) sqlite3_finalize(member_stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(member_stmt, 1, static_cast<sqlite3_int64>(member_id));
+    ret_code = sqlite3_step(member_stmt);
+    sqlite3_finalize(member_stmt);
+    if (ret_code != SQLITE_ROW)
+    {
+        return commons::Result::NotFound;
+    }
+
+    const char* insert_sql = "INSERT INTO BankAccounts (Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance) VALUES (?, ?, ?, ?, ?);";
+    sqlite3_stmt* insert_stmt = nullptr;
+    ret_code = sqlite3_prepare_v2(db_handle, insert_sql, -1, &insert_stmt, nullptr);
+    if (ret_code != SQLITE_OK)
+    {
+        if (insert_stmt) sqlite3_finalize(insert_stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(insert_stmt, 1, static_cast<sqlite3_int64>(bank_id));
+    sqlite3_bind_int64(insert_stmt, 2, static_cast<sqlite3_int64>(member_id));
+    sqlite3_bind_text(insert_stmt, 3, account_number.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(insert_stmt, 4, static_cast<sqlite3_int64>(opening_paise));
+    sqlite3_bind_int64(insert_stmt, 5, static_cast<sqlite3_int64>(closing_paise));
+
+    ret_code = sqlite3_step(insert_stmt);
+    if (ret_code != SQLITE_DONE)
+    {
+        sqlite3_finalize(insert_stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_finalize(insert_stmt);
+
+    if (out_id)
+    {
+        *out_id = static_cast<uint64_t>(sqlite3_last_insert_rowid(db_handle));
+    }
+
+    return commons::Result::Ok;
+}
+
+bool StorageManager::saveBankAccount(uint64_t bank_id,
+                                    uint64_t member_id,
+                                    const std::string &account_number,
+                                    long long opening_paise,
+                                    long long closing_paise)
+{
+    return saveBankAccountEx(bank_id, member_id, account_number, opening_paise, closing_paise, nullptr) == commons::Result::Ok;
+}
+
+/**
+ * @brief Delete member data.
+ * 
+ * @param member_id ID of the member to delete.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::deleteMemberDataEx(const uint64_t& member_id)
+{
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        } 
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* sql = "DELETE FROM MemberInfo WHERE Member_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    } 
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
+    ret_code = sqlite3_step(stmt);
+
+    if (ret_code != SQLITE_DONE) 
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    int changes = sqlite3_changes(db_handle);
+    sqlite3_finalize(stmt);
+
+    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
+}
+
+/**
+ * @brief Delete family data.
+ * 
+ * @param family_id ID of the family to delete.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::deleteFamilyDataEx(const uint64_t& family_id)
+{
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* sql = "DELETE FROM FamilyInfo WHERE Family_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
+    ret_code = sqlite3_step(stmt);
+
+    if (ret_code != SQLITE_DONE) 
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    int changes = sqlite3_changes(db_handle);
+    sqlite3_finalize(stmt);
+
+    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
+}
+
+/**
+ * @brief Update family data.
+ * 
+ * @param family_id ID of the family to update.
+ * @param new_name Name to update to.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::updateFamilyDataEx(const uint64_t& family_id, const std::string& new_name)
+{
+    if (new_name.empty())
+    {
+        return commons::Result::InvalidInput;
+    }
+    
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        } 
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    const char* sql = "UPDATE FamilyInfo SET Family_Name = ? WHERE Family_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    } 
+
+    sqlite3_bind_text(stmt, 1, new_name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(family_id));
+    ret_code = sqlite3_step(stmt);
+
+    if (ret_code != SQLITE_DONE) 
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    int changes = sqlite3_changes(db_handle);
+    sqlite3_finalize(stmt);
+
+    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
+}
+
+/**
+ * @brief Update member data.
+ * 
+ * @param member_id ID of the member to update.
+ * @param new_name Name to update to.
+ * @param new_nickname Nickname to update to.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::updateMemberDataEx(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname)
+{
+    // Check if we have at least one field to update
+    bool update_name = !new_name.empty();
+    bool update_nickname = !new_nickname.empty();
+    if (!update_name && !update_nickname)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected) 
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    // Build dynamic SQL based on what needs to be updated
+    std::string sql = "UPDATE MemberInfo SET ";
+    if (update_name)
+    {
+        sql += "Member_Name = ?";
+        if (update_nickname)
+        {
+            sql += ", ";
+        }
+    }
+    if (update_nickname)
+    {
+        sql += "Member_Nick_Name = ?";
+    }
+    sql += " WHERE Member_ID = ?;";
+
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(db_handle, sql.c_str(), -1, &stmt, nullptr);
+
+    if (ret_code != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    } 
+
+    int param_index = 1;
+    if (update_name)
+    {
+        sqlite3_bind_text(stmt, param_index++, new_name.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    if (update_nickname)
+    {
+        sqlite3_bind_text(stmt, param_index++, new_nickname.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    sqlite3_bind_int64(stmt, param_index, static_cast<sqlite3_int64>(member_id));
+    ret_code = sqlite3_step(stmt);
+
+    if (ret_code != SQLITE_DONE) 
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    int changes = sqlite3_changes(db_handle);
+    sqlite3_finalize(stmt);
+
+    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
+}
+
+/**
+ * @brief Connect to the database.
+ * 
+ * @param connectionString SQLite database file path.
+ * @return true if connection was successful.
+ * @return false if connection failed.
+ */
+bool StorageManager::connect(const std::string& connectionString) 
+{
+    // If already connected and same path, return true. If different path, close and reopen.
+    if (db_handle) 
+    {
+        // Note: no stored path is kept; caller should manage connections if using multiple DBs.
+        return true;
+    }
+
+    // Open SQLite DB (read/write, create if missing)
+    int ret_code = sqlite3_open_v2(connectionString.c_str(), &db_handle, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Failed to open SQLite DB '" << connectionString << "': " << (db_handle ? sqlite3_errmsg(db_handle) : "(no handle)") << std::endl;
+        if (db_handle) 
+        {
+            sqlite3_close(db_handle);
+            db_handle = nullptr;
+        }
+
+        connected = false;
+        return false;
+    }
+
+    // Enable foreign keys
+    char* errmsg = nullptr;
+    ret_code = sqlite3_exec(db_handle, "PRAGMA foreign_keys = ON;", nullptr, nullptr, &errmsg);
+    
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Warning: failed to enable foreign keys: " << (errmsg ? errmsg : "") << std::endl;
+        if (errmsg) sqlite3_free(errmsg);
+        // Not fatal; proceed
+    }
+
+    // WAL lets the read-only pool connections run alongside the writer
+    errmsg = nullptr;
+    ret_code = sqlite3_exec(db_handle, "PRAGMA journal_mode = WAL;", nullptr, nullptr, &errmsg);
+
+    if (ret_code != SQLITE_OK) 
+    {
+        std::cerr << "Warning: failed to enable WAL journal mode: " << (errmsg ? errmsg : "") << std::endl;
+        if (errmsg) sqlite3_free(errmsg);
+        // Not fatal; readers fall back to the writer connection
+    }
+
+    sqlite3_busy_timeout(db_handle, 5000);
+
+    db_path = connectionString;
+    return true;
+}
+
+/**
+ * @brief Disconnect from the database.
+ * 
+ */
+void StorageManager::disconnect() 
+{
+    // Unpublish first so lazy callers stop picking up the closing handles
+    connected = false;
+
+    {
+        std::lock_guard<std::mutex> pool_lock(pool_mutex);
+
+        // Close readers before the writer so the final close can checkpoint the WAL
+        for (sqlite3* reader : read_pool)
+        {
+            sqlite3_close(reader);
+        }
+
+        read_pool.clear();
+        idle_readers.clear();
+        db_path.clear();
+    }
+
+    if (db_handle) 
+    {
+        sqlite3_close(db_handle);
+        db_handle = nullptr;
+    }
+
+    // The next database starts with a fresh filter and automaton
+    transaction_filter_loaded = false;
+    category_rules_version = -1;
+}
+
+/**
+ * @brief Set the maximum number of pooled read-only connections.
+ * 
+ * @param max_connections Upper bound on concurrently open read connections (0 = use the writer).
+ */
+void StorageManager::setMaxReadConnections(std::size_t max_connections)
+{
+    std::lock_guard<std::mutex> pool_lock(pool_mutex);
+    max_read_connections = max_connections;
+}
+
+/**
+ * @brief Check a read-only connection out of the pool.
+ * 
+ * Reuses an idle connection when available, opens a new one while the pool
+ * is below its limit and otherwise waits for another thread to release one.
+ *
+ * @return sqlite3* Read-only handle, or nullptr if none could be opened.
+ */
+sqlite3* StorageManager::acquireReadConnection()
+{
+    std::unique_lock<std::mutex> pool_lock(pool_mutex);
+
+    // In-memory databases are private to their connection; readers cannot share
+    // them. A zero limit means the caller asked for the writer connection only.
+    if (db_path.empty() || db_path == ":memory:" || max_read_connections == 0)
+    {
+        return nullptr;
+    }
+
+    while (idle_readers.empty() && read_pool.size() >= max_read_connections)
+    {
+        pool_cv.wait(pool_lock);
+    }
+
+    if (!idle_readers.empty())
+    {
+        sqlite3* reader = idle_readers.back();
+        idle_readers.pop_back();
+        return reader;
+    }
+
+    sqlite3* reader = nullptr;
+    int ret_code = sqlite3_open_v2(db_path.c_str(), &reader, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+
+    if (ret_code != SQLITE_OK)
+    {
+        std::cerr << "Failed to open read connection: " << (reader ? sqlite3_errmsg(reader) : "(no handle)") << std::endl;
+        if (reader)
+        {
+            sqlite3_close(reader);
+        }
+        return nullptr;
+    }
+
+    sqlite3_busy_timeout(reader, 5000);
+    read_pool.push_back(reader);
+    return reader;
+}
+
+/**
+ * @brief Return a read-only connection to the pool.
+ * 
+ * @param handle Handle previously obtained from acquireReadConnection.
+ */
+void StorageManager::releaseReadConnection(sqlite3* handle)
+{
+    {
+        std::lock_guard<std::mutex> pool_lock(pool_mutex);
+        idle_readers.push_back(handle);
+    }
+
+    pool_cv.notify_one();
+}
+
+/**
+ * @brief Lease a read connection from the owning StorageManager.
+ * 
+ * @param owner StorageManager whose pool to draw from.
+ */
+StorageManager::ReadConnection::ReadConnection(StorageManager& owner)
+    : owner(owner)
+{
+    handle = owner.acquireReadConnection();
+
+    if (handle)
+    {
+        pooled = true;
+        return;
+    }
+
+    // No pooled reader available: share the writer under its lock
+    writer_lock = std::unique_lock<std::recursive_mutex>(owner.write_mutex);
+    handle = owner.db_handle;
+}
+
+/**
+ * @brief Return the leased connection to the pool.
+ */
+StorageManager::ReadConnection::~ReadConnection()
+{
+    if (pooled)
+    {
+        owner.releaseReadConnection(handle);
+    }
+}
+
+/**
+ * @brief List all families in the database.
+ * 
+ * @return std::vector<Family> Vector of families with IDs
+ */
+std::vector<Family> StorageManager::listFamilies()
+{
+    std::vector<Family> families;
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return families;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return families;
+    }
+
+    const char* sql = "SELECT Family_ID, Family_Name FROM FamilyInfo ORDER BY Family_ID;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return families;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        uint64_t id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        const unsigned char* name = sqlite3_column_text(stmt, 1);
+        std::string name_str = name ? reinterpret_cast<const char*>(name) : std::string();
+        families.emplace_back(id, std::move(name_str));
+    }
+    sqlite3_finalize(stmt);
+    return families;
+}
+
+/**
+ * @brief List all members of a specific family.
+ * 
+ * @param family_id ID of the family whose members to list
+ * @return std::vector<Member> Vector of members with IDs
+ */
+std::vector<Member> StorageManager::listMembersOfFamily(uint64_t family_id)
+{
+    std::vector<Member> members;
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return members;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return members;
+    }
+
+    const char* sql = "SELECT Member_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Family_ID = ? ORDER BY Member_ID;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return members;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        uint64_t id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        const unsigned char* name = sqlite3_column_text(stmt, 1);
+        const unsigned char* nick = sqlite3_column_text(stmt, 2);
+        std::string name_str = name ? reinterpret_cast<const char*>(name) : std::string();
+        std::string nick_str = nick ? reinterpret_cast<const char*>(nick) : std::string();
+        members.emplace_back(id, std::move(name_str), std::move(nick_str));
+    }
+    sqlite3_finalize(stmt);
+    return members;
+}
+
+/**
+ * @brief List all families into a caller-supplied memory resource.
+ * 
+ * Names are copied straight from SQLite's column buffer into the arena, so
+ * no intermediate std::string is built per row.
+ * 
+ * @param arena Memory resource for the vector and its strings.
+ * @return std::pmr::vector<FamilyRow> Families ordered by ID (empty on error).
+ */
+std::pmr::vector<FamilyRow> StorageManager::listFamilies(std::pmr::memory_resource* arena)
+{
+    std::pmr::vector<FamilyRow> families(arena);
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return families;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return families;
+    }
+
+    const char* sql = "SELECT Family_ID, Family_Name FROM FamilyInfo ORDER BY Family_ID;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return families;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        families.emplace_back(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)), columnView(stmt, 1));
+    }
+    sqlite3_finalize(stmt);
+    return families;
+}
+
+/**
+ * @brief List the members of a family into a caller-supplied memory resource.
+ * 
+ * @param family_id ID of the family whose members to list
+ * @param arena Memory resource for the vector and its strings.
+ * @return std::pmr::vector<MemberRow> Members ordered by ID (empty on error).
+ */
+std::pmr::vector<MemberRow> StorageManager::listMembersOfFamily(uint64_t family_id, std::pmr::memory_resource* arena)
+{
+    std::pmr::vector<MemberRow> members(arena);
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return members;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return members;
+    }
+
+    // Member_Count is kept by triggers, so it sizes the vector in one step
+    // instead of leaving abandoned growth buffers behind in the arena.
+    uint64_t member_count = 0;
+    bool count_ok = true;
+
+    if (familyMemberCount(read_db, family_id, &member_count, &count_ok))
+    {
+        members.reserve(static_cast<size_t>(member_count));
+    }
+
+    const char* sql = "SELECT Member_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Family_ID = ? ORDER BY Member_ID;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return members;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        members.emplace_back(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)), columnView(stmt, 1), columnView(stmt, 2));
+    }
+    sqlite3_finalize(stmt);
+    return members;
+}
+
+uint64_t StorageManager::getMemberCount(const uint64_t family_id, bool* out_ok)
+{
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            if (out_ok) *out_ok = false;
+            return 0;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        if (out_ok) *out_ok = false;
+        return 0;
+    }
+
+    // An unknown family has no members
+    bool ok = false;
+    uint64_t count = 0;
+    familyMemberCount(read_db, family_id, &count, &ok);
+
+    if (out_ok) *out_ok = ok;
+    return count;
+}
+
+commons::Result StorageManager::getBankIdByName(const std::string &bank_name, uint64_t* out_bank_id)
+{
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    const char* sql = "SELECT Bank_ID FROM BankList WHERE lower(Bank_Name) = lower(?) LIMIT 1;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr);
+    if (ret_code != SQLITE_OK)
+    {
+        if (stmt) sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_text(stmt, 1, bank_name.c_str(), -1, SQLITE_TRANSIENT);
+    ret_code = sqlite3_step(stmt);
+
+    if (ret_code != SQLITE_ROW)
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::NotFound;
+    }
+
+    sqlite3_int64 id = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    if (out_bank_id) *out_bank_id = static_cast<uint64_t>(id);
+    return commons::Result::Ok;
+}
+
+commons::Result StorageManager::getBankNameById(const uint64_t bank_id, std::string* out_name)
+{
+    if (!out_name)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    const char* sql = "SELECT Bank_Name FROM BankList WHERE Bank_ID = ? LIMIT 1;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr);
+    if (ret_code != SQLITE_OK)
+    {
+        if (stmt) sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_id));
+    ret_code = sqlite3_step(stmt);
+    if (ret_code != SQLITE_ROW)
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::NotFound;
+    }
+
+    const unsigned char* txt = sqlite3_column_text(stmt, 0);
+    *out_name = txt ? reinterpret_cast<const char*>(txt) : std::string();
+    sqlite3_finalize(stmt);
+    return commons::Result::Ok;
+}
+
+commons::Result StorageManager::getBankAccountById(const uint64_t bank_account_id, BankAccount* out_row)
+{
+    if (!out_row)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    const char* sql = "SELECT BankAccount_ID, Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance FROM BankAccounts WHERE BankAccount_ID = ? LIMIT 1;";
+    sqlite3_stmt* stmt = nullptr;
+    int ret_code = sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr);
+    if (ret_code != SQLITE_OK)
+    {
+        if (stmt) sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_account_id));
+    ret_code = sqlite3_step(stmt);
+    if (ret_code != SQLITE_ROW)
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::NotFound;
+    }
+
+    out_row->setId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)));
+    out_row->setBankId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)));
+    out_row->setMemberId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)));
+    const unsigned char* acct = sqlite3_column_text(stmt, 3);
+    out_row->setAccountNumber(acct ? reinterpret_cast<const char*>(acct) : std::string());
+    out_row->setOpeningBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 4)));
+    out_row->setClosingBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 5)));
+
+    sqlite3_finalize(stmt);
+    return commons::Result::Ok;
+}
+
+std::vector<BankAccount> StorageManager::listBankAccountsOfMember(const uint64_t member_id)
+{
+    std::vector<BankAccount> rows;
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return rows;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return rows;
+    }
+
+    const char* sql = "SELECT BankAccount_ID, Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance FROM BankAccounts WHERE Member_ID = ? ORDER BY BankAccount_ID;";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return rows;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        BankAccount bankAccount;
+        bankAccount.setId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)));
+        bankAccount.setBankId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)));
+        bankAccount.setMemberId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)));
+        const unsigned char* acct = sqlite3_column_text(stmt, 3);
+        bankAccount.setAccountNumber(acct ? reinterpret_cast<const char*>(acct) : std::string());
+        bankAccount.setOpeningBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 4)));
+        bankAccount.setClosingBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 5)));
+        rows.push_back(std::move(bankAccount));
+    }
+
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+/**
+ * @brief List the bank accounts of a member into a caller-supplied memory resource.
+ * 
+ * @param member_id Owner of the accounts.
+ * @param arena Memory resource for the vector and its strings.
+ * @return std::pmr::vector<BankAccountRow> Accounts ordered by ID (empty on error).
+ */
+std::pmr::vector<BankAccountRow> StorageManager::listBankAccountsOfMember(const uint64_t member_id, std::pmr::memory_resource* arena)
+{
+    std::pmr::vector<BankAccountRow> rows(arena);
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return rows;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return rows;
+    }
+
+    const char* sql = "SELECT BankAccount_ID, Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance FROM BankAccounts WHERE Member_ID = ? ORDER BY BankAccount_ID;";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return rows;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        rows.emplace_back(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)),
+                          static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)),
+                          static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)),
+                          columnView(stmt, 3),
+                          static_cast<long long>(sqlite3_column_int64(stmt, 4)),
+                          static_cast<long long>(sqlite3_column_int64(stmt, 5)));
+    }
+
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+/**
+ * @brief Stream the family/member/account join for a range of families.
+ * 
+ * @param first_family_id First Family_ID of the range (inclusive).
+ * @param last_family_id Last Family_ID of the range (inclusive).
+ * @param visitor Callback invoked once per joined row.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::visitAccountBalances(const uint64_t first_family_id,
+                                                     const uint64_t last_family_id,
+                                                     const AccountBalanceVisitor& visitor)
+{
+    if (!visitor || first_family_id > last_family_id)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    const char* sql =
+        "SELECT f.Family_ID, m.Member_ID, b.BankAccount_ID, b.Bank_ID, b.Closing_Balance "
+        "FROM FamilyInfo f "
+        "LEFT JOIN MemberInfo m ON m.Family_ID = f.Family_ID "
+        "LEFT JOIN BankAccounts b ON b.Member_ID = m.Member_ID "
+        "WHERE f.Family_ID BETWEEN ? AND ? "
+        "ORDER BY f.Family_ID, m.Member_ID, b.BankAccount_ID;";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(first_family_id));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(last_family_id));
+
+    AccountBalanceRow row;
+    int ret_code = SQLITE_OK;
+
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        // NULL columns from the outer joins read back as 0
+        row.family_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        row.member_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+        row.bank_account_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 2));
+        row.bank_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 3));
+        row.closing_balance_paise = static_cast<long long>(sqlite3_column_int64(stmt, 4));
+        visitor(row);
+    }
+
+    sqlite3_finalize(stmt);
+    return (ret_code == SQLITE_DONE) ? commons::Result::Ok : commons::Result::DbError;
+}
+
+/**
+ * @brief Get the smallest and largest stored Family_ID.
+ * 
+ * @param out_first_family_id Receives the smallest Family_ID.
+ * @param out_last_family_id Receives the largest Family_ID.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::getFamilyIdRange(uint64_t* out_first_family_id, uint64_t* out_last_family_id)
+{
+    if (!out_first_family_id || !out_last_family_id)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
+    {
+        return commons::Result::DbError;
+    }
+
+    const char* sql = "SELECT MIN(Family_ID), MAX(Family_ID) FROM FamilyInfo;";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    if (sqlite3_step(stmt) != SQLITE_ROW)
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    if (sqlite3_column_type(stmt, 0) == SQLITE_NULL)
+    {
+        sqlite3_finalize(stmt);
+        return commons::Result::NotFound;
+    }
+
+    *out_first_family_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+    *out_last_family_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+    sqlite3_finalize(stmt);
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Record an account's balances for one statement period.
+ * 
+ * Upserts on (BankAccount_ID, Period_End) and, in the same transaction,
+ * copies the balances to the BankAccounts row unless a later period is
+ * already on file.
+ * 
+ * @param bank_account_id Account the statement belongs to.
+ * @param period_start First day of the period, if known.
+ * @param period_end Last day of the period.
+ * @param opening_paise Opening balance of the period.
+ * @param closing_paise Closing balance of the period.
+ * @return commons::Result NotFound if the account does not exist.
+ */
+commons::Result StorageManager::saveBalanceSnapshotEx(const uint64_t bank_account_id,
+                                                      const std::optional<commons::Date>& period_start,
+                                                      const commons::Date& period_end,
+                                                      long long opening_paise,
+                                                      long long closing_paise)
+{
+    if (!period_end.ok() || (period_start && (!period_start->ok() || *period_start > period_end)))
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    if (!connected)
+    {
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    auto rollback = [this](commons::Result res)
+    {
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return res;
+    };
+
+    commons::Result res = insertBalanceSnapshot(bank_account_id, period_start, period_end, opening_paise, closing_paise);
+
+    if (res != commons::Result::Ok)
+    {
+        return rollback(res);
+    }
+
+    if (sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        return rollback(commons::Result::DbError);
+    }
+
+    return commons::Result::Ok;
+}
+
+/**
+ * @brief Upsert a balance snapshot and refresh the account row if the
+ * period is its latest.
+ * 
+ * Runs inside the caller's write transaction with the write lock held.
+ * 
+ * @return commons::Result NotFound if the account does not exist.
+ */
+commons::Result StorageManager::insertBalanceSnapshot(const uint64_t bank_account_id,
+                                                      const std::optional<commons::Date>& period_start,
+                                                      const commons::Date& period_end,
+                                                      long long opening_paise,
+                                                      long long closing_paise)
+{
+    const std::string start_text = period_start ? commons::formatDate(*period_start) : std::string();
+    const std::string end_text = commons::formatDate(period_end);
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(db_handle, "SELECT 1 FROM BankAccounts WHERE BankAccount_ID = ?;", -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_account_id));
+    int ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_ROW)
+    {
+        return ret_code == SQLITE_DONE ? commons::Result::NotFound : commons::Result::DbError;
+    }
+
+    const char* upsert_sql =
+        "INSERT INTO BalanceSnapshots (BankAccount_ID, Period_Start, Period_End, Opening_Balance, Closing_Balance) "
+        "VALUES (?, ?, ?, ?, ?) "
+        "ON CONFLICT (BankAccount_ID, Period_End) DO UPDATE SET "
+        "Period_Start = excluded.Period_Start, Opening_Balance = excluded.Opening_Balance, "
+        "Closing_Balance = excluded.Closing_Balance;";
+
+    if (sqlite3_prepare_v2(db_handle, upsert_sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_account_id));
+
+    if (period_start)
+    {
+        sqlite3_bind_text(stmt, 2, start_text.c_str(), static_cast<int>(start_text.size()), SQLITE_STATIC);
+    }
+    else
+    {
+        sqlite3_bind_null(stmt, 2);
+    }
+
+    sqlite3_bind_text(stmt, 3, end_text.c_str(), static_cast<int>(end_text.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(opening_paise));
+    sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(closing_paise));
+    ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_DONE)
+    {
+        return commons::Result::DbError;
+    }
+
+    const char* refresh_sql =
+        "UPDATE BankAccounts SET Opening_Balance = ?, Closing_Balance = ? "
+        "WHERE BankAccount_ID = ? AND NOT EXISTS "
+        "(SELECT 1 FROM BalanceSnapshots WHERE BankAccount_ID = ? AND Period_End > ?);";
+
+    if (sqlite3_prepare_v2(db_handle, refresh_sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
     }
 
-    // Ensure tables exist at the chosen path
-    dbInit(chosenPath);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(opening_paise));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(closing_paise));
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(bank_account_id));
+    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(bank_account_id));
+    sqlite3_bind_text(stmt, 5, end_text.c_str(), static_cast<int>(end_text.size()), SQLITE_STATIC);
+    ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
 
-    // Try to connect to the database
-    return connect(chosenPath);
+    return ret_code == SQLITE_DONE ? commons::Result::Ok : commons::Result::DbError;
 }
 
 /**
- * @brief Initialize DB file and tables at the provided path.
+ * @brief Net worth of a member or family as of each requested date.
+ * 
+ * One prepared statement is stepped per date; for every account of the
+ * scope it seeks BalanceSnapshots_Account_End for the latest period ending
+ * on or before the date.
  * 
- * @param dbPathStr Path to the database file.
+ * @param scope Member or family.
+ * @param scope_id Member_ID or Family_ID.
+ * @param as_of_dates Dates to evaluate, in any order.
+ * @param out_totals_paise Receives one total per date.
+ * @return commons::Result 
  */
-void StorageManager::dbInit(const std::string& dbPathStr)
+commons::Result StorageManager::getNetWorthAsOfEx(const NetWorthScope scope,
+                                                  const uint64_t scope_id,
+                                                  std::span<const commons::Date> as_of_dates,
+                                                  std::vector<long long>* out_totals_paise)
 {
-    namespace fs = std::filesystem;
-    fs::path dbPath = fs::path(dbPathStr);
-    fs::path projectRoot = dbPath.parent_path();
+    if (!out_totals_paise)
+    {
+        return commons::Result::InvalidInput;
+    }
 
-    std::cout << "Initializing SQLite DB at: " << dbPath << std::endl;
+    out_totals_paise->clear();
 
-    // Create parent directories if needed
-    try 
+    if (!connected)
     {
-        if (!projectRoot.empty() && !fs::exists(projectRoot)) 
+        if (!initializeDatabase(""))
         {
-            fs::create_directories(projectRoot);
+            return commons::Result::DbError;
         }
-    } 
-    catch (const std::exception &e) 
-    {
-        std::cerr << "Failed to create DB parent directories: " << e.what() << std::endl;
     }
 
-    // SQL statements to create only the required tables: FamilyInfo and MemberInfo
-    const std::vector<std::pair<const char*, const char*>> table_ddls = 
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
+
+    if (!read_db)
     {
-        {
-            "FamilyInfo", R"(
-            CREATE TABLE IF NOT EXISTS FamilyInfo (
-            Family_ID INTEGER PRIMARY KEY AUTOINCREMENT,
-            Family_Name TEXT NOT NULL
-            );
-            )"
-        },
+        return commons::Result::DbError;
+    }
 
-        {
-            "MemberInfo", R"(
-            CREATE TABLE IF NOT EXISTS MemberInfo (
-            Member_ID INTEGER PRIMARY KEY AUTOINCREMENT,
-            Family_ID INTEGER NOT NULL,
-            Member_Name TEXT NOT NULL,
-            Member_Nick_Name TEXT,
-            FOREIGN KEY(Family_ID) REFERENCES FamilyInfo(Family_ID) ON DELETE CASCADE
-            );
-            )"
-        }
-        ,
-        {
-            "BankList", R"(
-            CREATE TABLE IF NOT EXISTS BankList (
-            Bank_ID INTEGER PRIMARY KEY AUTOINCREMENT,
-            Bank_Name TEXT NOT NULL UNIQUE
-            );
-            )"
-        },
+    const char* exists_sql = (scope == NetWorthScope::Member)
+        ? "SELECT 1 FROM MemberInfo WHERE Member_ID = ?;"
+        : "SELECT 1 FROM FamilyInfo WHERE Family_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
 
-        {
-            "BankAccounts", R"(
-            CREATE TABLE IF NOT EXISTS BankAccounts (
-            BankAccount_ID INTEGER PRIMARY KEY AUTOINCREMENT,
-            Bank_ID INTEGER NOT NULL,
-            Member_ID INTEGER NOT NULL,
-            Account_Number TEXT NOT NULL,
-            Opening_Balance INTEGER NOT NULL,
-            Closing_Balance INTEGER NOT NULL,
-            FOREIGN KEY(Bank_ID) REFERENCES BankList(Bank_ID),
-            FOREIGN KEY(Member_ID) REFERENCES MemberInfo(Member_ID) ON DELETE CASCADE
-            );
-            )"
-        }
-    };
+    if (sqlite3_prepare_v2(read_db, exists_sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        return commons::Result::DbError;
+    }
 
-    sqlite3* db = nullptr;
-    int ret_code = sqlite3_open(dbPath.string().c_str(), &db);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(scope_id));
+    int ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
 
-    if (ret_code != SQLITE_OK) 
+    if (ret_code != SQLITE_ROW)
     {
-        std::cerr << "Cannot open SQLite DB: " << (db ? sqlite3_errmsg(db) : "(no handle)") << std::endl;
-        if (db) sqlite3_close(db);
-        return;
+        return (ret_code == SQLITE_DONE) ? commons::Result::NotFound : commons::Result::DbError;
     }
 
-    // Enable foreign key enforcement
-    char* errmsg = nullptr;
-    ret_code = sqlite3_exec(db, "PRAGMA foreign_keys = ON;", nullptr, nullptr, &errmsg);
+    std::string sql =
+        "SELECT (SELECT s.Closing_Balance FROM BalanceSnapshots s "
+        "WHERE s.BankAccount_ID = b.BankAccount_ID AND s.Period_End <= ?1 "
+        "ORDER BY s.Period_End DESC LIMIT 1) "
+        "FROM BankAccounts b WHERE ";
+    sql += (scope == NetWorthScope::Member)
+        ? "b.Member_ID = ?2;"
+        : "b.Member_ID IN (SELECT Member_ID FROM MemberInfo WHERE Family_ID = ?2);";
 
-    if (ret_code != SQLITE_OK) 
+    if (sqlite3_prepare_v2(read_db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
     {
-        std::cerr << "Failed to enable foreign keys: " << (errmsg ? errmsg : "") << std::endl;
-        sqlite3_free(errmsg);
+        return commons::Result::DbError;
     }
 
-    for (const auto &p : table_ddls) 
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(scope_id));
+    out_totals_paise->reserve(as_of_dates.size());
+    commons::Result result = commons::Result::Ok;
+
+    for (const commons::Date& as_of : as_of_dates)
     {
-        ret_code = sqlite3_exec(db, p.second, nullptr, nullptr, &errmsg);
+        const std::string as_of_text = commons::formatDate(as_of);
+        sqlite3_bind_text(stmt, 1, as_of_text.c_str(), static_cast<int>(as_of_text.size()), SQLITE_TRANSIENT);
+        commons::CheckedAccumulator total;
 
-        if (ret_code != SQLITE_OK) 
-        {
-            std::cerr << "Error creating table '" << p.first << "': " << (errmsg ? errmsg : "") << std::endl;
-            sqlite3_free(errmsg);
-        } 
-        else 
+        // Accounts with no snapshot yet read back NULL, i.e. 0
+        while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
         {
-            std::cout << "Checked/created table: " << p.first << std::endl;
+            total.add(static_cast<long long>(sqlite3_column_int64(stmt, 0)));
         }
-    }
 
-    // Prepopulate BankList with known banks if it's empty.
-    const char* countBanksSql = "SELECT COUNT(1) FROM BankList;";
-    sqlite3_stmt* countStmt = nullptr;
-    ret_code = sqlite3_prepare_v2(db, countBanksSql, -1, &countStmt, nullptr);
-
-    if (ret_code == SQLITE_OK)
-    {
-        ret_code = sqlite3_step(countStmt);
+        sqlite3_reset(stmt);
 
-        if (ret_code == SQLITE_ROW)
+        if (ret_code != SQLITE_DONE)
         {
-            sqlite3_int64 bankCount = sqlite3_column_int64(countStmt, 0);
-            if (bankCount == 0)
-            {
-                const char* insertSql = "INSERT INTO BankList (Bank_Name) VALUES (?);";
-                sqlite3_stmt* insStmt = nullptr;
-                const char* banks[] = {"Canara", "SBI", "Axis", "HDFC", "PNB"};
+            sqlite3_finalize(stmt);
+            out_totals_paise->clear();
+            return commons::Result::DbError;
+        }
 
-                for (const char* bn : banks)
-                {
-                    // Ensure stmt pointer does not carry over from previous iteration
-                    insStmt = nullptr;
-                    if (sqlite3_prepare_v2(db, insertSql, -1, &insStmt, nullptr) == SQLITE_OK)
-                    {
-                        sqlite3_bind_text(insStmt, 1, bn, -1, SQLITE_TRANSIENT);
-                        ret_code = sqlite3_step(insStmt);
-                        
-                        if (ret_code != SQLITE_DONE)
-                        {
-                            std::cerr << "Failed to insert bank '" << bn << "': " << sqlite3_errmsg(db) << std::endl;
-                        }
-                        sqlite3_finalize(insStmt);
-                    }
-                    else
-                    {
-                        std::cerr << "Failed to prepare insert for bank '" << bn << "': " << sqlite3_errmsg(db) << std::endl;
-                    }
-                }
-            }
+        out_totals_paise->push_back(0);
+
+        if (total.toPaise(&out_totals_paise->back()) != commons::Result::Ok)
+        {
+            result = commons::Result::Overflow;
         }
-        sqlite3_finalize(countStmt);
     }
 
-    sqlite3_close(db);
+    sqlite3_finalize(stmt);
+    return result;
 }
 
 /**
- * @brief Save member data to the database.
+ * @brief Load the fingerprint of every stored transaction into the filter.
  * 
- * @param member Member to save.
- * @param family_id ID of the family the member belongs to.
- * @return true if save was successful.
- * @return false if save failed.
- */
-bool StorageManager::saveMemberData(const Member& member, const uint64_t family_id) 
-{
-    return saveMemberDataEx(member, family_id, nullptr) == commons::Result::Ok;
-}
-
-/**
- * @brief Save family data to the database.
+ * Sized for twice the current row count so ingest can grow for a while
+ * before the next reload. Reads only the fingerprint index. The caller holds
+ * the write lock.
  * 
- * @param family family
- * @return true if save was successful.
- * @return false if save failed.
+ * @return true if the filter is loaded.
  */
-bool StorageManager::saveFamilyData(const Family& family) 
+bool StorageManager::loadTransactionFilter()
 {
-    return saveFamilyDataEx(family, nullptr) == commons::Result::Ok;
-}
+    sqlite3_stmt* stmt = nullptr;
 
-/**
- * @brief Get member data by ID.
- * 
- * @param member_id Member ID to retrieve.
- * @return Member* 
- */
-Member* StorageManager::getMemberData(const uint64_t& member_id) 
-{
-    if (!connected) 
+    if (sqlite3_prepare_v2(db_handle, "SELECT Fingerprint FROM Transactions WHERE Fingerprint IS NOT NULL;", -1, &stmt, nullptr) != SQLITE_OK)
     {
-        if (!initializeDatabase(""))
-        {
-            return nullptr;
-        } 
+        return false;
     }
 
-    const char* sql = "SELECT Member_ID, Family_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Member_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    std::vector<uint64_t> fingerprints;
+    int ret_code = SQLITE_DONE;
 
-    if (ret_code != SQLITE_OK) 
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
     {
-        std::cerr << "Failed to prepare select member: " << sqlite3_errmsg(db_handle) << std::endl;
-        return nullptr;
+        fingerprints.push_back(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)));
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
-    ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    transaction_filter_loaded = ret_code == SQLITE_DONE;
 
-    if (ret_code == SQLITE_ROW) 
+    if (transaction_filter_loaded)
     {
-        const unsigned char* name = sqlite3_column_text(stmt, 2);
-        const unsigned char* nick = sqlite3_column_text(stmt, 3);
-        std::string sname = name ? reinterpret_cast<const char*>(name) : std::string();
-        std::string snick = nick ? reinterpret_cast<const char*>(nick) : std::string();
-        Member* m = new Member(sname, snick);
-        // Note: Member::member_id cannot be set (private). Caller may rely on DB ids separately.
-        sqlite3_finalize(stmt);
-        return m;
+        transaction_filter.reset(fingerprints.size() * 2);
+
+        for (uint64_t fingerprint : fingerprints)
+        {
+            transaction_filter.insert(fingerprint);
+        }
     }
 
-    sqlite3_finalize(stmt);
-    return nullptr;
+    return transaction_filter_loaded;
 }
 
 /**
- * @brief Get family data by ID.
+ * @brief Save the statement lines of an account in one transaction.
  * 
- * @param family_id ID of the family to retrieve.
- * @return Family* 
+ * Lines already stored for the account (same fingerprint, e.g. from an
+ * overlapping statement) are skipped. The in-memory Bloom filter answers
+ * "new" for almost every fresh line without touching the database; only
+ * "maybe" answers cost a probe of the Transactions_Account_Fingerprint
+ * index, and the unique index itself rejects anything the filter missed
+ * (rows written by another process). The Transactions_Rollup_Insert
+ * trigger folds each inserted row into its CashFlowRollups row as part of
+ * the same insert. Each line is categorised by the compiled rule automaton
+ * on the way in.
+ * 
+ * @param bank_account_id Account the lines belong to.
+ * @param transactions Lines to append.
+ * @param out_duplicates Optional; receives the number of lines skipped.
+ * @return commons::Result NotFound if the account does not exist.
  */
-Family* StorageManager::getFamilyData(const uint64_t& family_id) 
+commons::Result StorageManager::saveTransactionsEx(const uint64_t bank_account_id,
+                                                   std::span<const BankTransaction> transactions,
+                                                   uint64_t* out_duplicates)
 {
-    if (!connected) 
+    if (out_duplicates)
     {
-        if (!initializeDatabase(""))
+        *out_duplicates = 0;
+    }
+
+    for (const BankTransaction& transaction : transactions)
+    {
+        if (!transaction.date.ok())
         {
-            return nullptr;
+            return commons::Result::InvalidInput;
         }
     }
 
-    const char* fsql = "SELECT Family_ID, Family_Name FROM FamilyInfo WHERE Family_ID = ?;";
-    sqlite3_stmt* fstmt = nullptr;
-
-    int ret_code = sqlite3_prepare_v2(db_handle, fsql, -1, &fstmt, nullptr);
-    
-    if (ret_code != SQLITE_OK) 
+    if (!connected)
     {
-        std::cerr << "Failed to prepare select family: " << sqlite3_errmsg(db_handle) << std::endl;
-        return nullptr;
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
     }
 
-    sqlite3_bind_int64(fstmt, 1, static_cast<sqlite3_int64>(family_id));
-    ret_code = sqlite3_step(fstmt);
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
 
-    if (ret_code != SQLITE_ROW) 
+    if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(fstmt);
-        return nullptr;
+        return commons::Result::DbError;
     }
 
-    const unsigned char* fname = sqlite3_column_text(fstmt, 1);
-    std::string sname = fname ? reinterpret_cast<const char*>(fname) : std::string();
-    Family* family = new Family(sname);
-    sqlite3_finalize(fstmt);
+    auto rollback = [this](commons::Result res)
+    {
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return res;
+    };
 
-    // Load members
-    const char* msql = "SELECT Member_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Family_ID = ?;";
-    sqlite3_stmt* mstmt = nullptr;
-    ret_code = sqlite3_prepare_v2(db_handle, msql, -1, &mstmt, nullptr);
+    uint64_t duplicates = 0;
+    commons::Result res = insertTransactions(bank_account_id, transactions, &duplicates);
 
-    if (ret_code == SQLITE_OK) 
+    if (res != commons::Result::Ok)
     {
-        sqlite3_bind_int64(mstmt, 1, static_cast<sqlite3_int64>(family_id));
+        return rollback(res);
+    }
 
-        while ((ret_code = sqlite3_step(mstmt)) == SQLITE_ROW) 
-        {
-            const unsigned char* mname = sqlite3_column_text(mstmt, 1);
-            const unsigned char* mnick = sqlite3_column_text(mstmt, 2);
-            std::string ms = mname ? reinterpret_cast<const char*>(mname) : std::string();
-            std::string mns = mnick ? reinterpret_cast<const char*>(mnick) : std::string();
-            Member m(ms, mns);
-            family->addMember(m);
-        }
+    if (sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        return rollback(commons::Result::DbError);
+    }
 
-        sqlite3_finalize(mstmt);
+    if (out_duplicates)
+    {
+        *out_duplicates = duplicates;
     }
 
-    return family;
+    return commons::Result::Ok;
 }
 
 /**
- * @brief Delete member data by ID.
+ * @brief Insert statement lines, skipping the ones already stored.
  * 
- * @param member_id ID of the member to delete.
- * @return true if deletion was successful.
- * @return false if deletion failed.
+ * Runs inside the caller's write transaction with the write lock held.
+ * Fingerprints added to the filter stay there if the caller rolls back,
+ * which only costs an extra probe later.
+ * 
+ * @param bank_account_id Account the lines belong to.
+ * @param transactions Lines to append (dates already validated).
+ * @param out_duplicates Receives the number of lines skipped.
+ * @return commons::Result NotFound if the account does not exist.
  */
-bool StorageManager::deleteMemberData(const uint64_t& member_id) 
+commons::Result StorageManager::insertTransactions(const uint64_t bank_account_id,
+                                                   std::span<const BankTransaction> transactions,
+                                                   uint64_t* out_duplicates)
 {
-    if (!connected) 
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(db_handle, "SELECT 1 FROM BankAccounts WHERE BankAccount_ID = ?;", -1, &stmt, nullptr) != SQLITE_OK)
     {
-        if (!initializeDatabase("")) 
-        {
-            return false;
-        }
+        return commons::Result::DbError;
     }
 
-    const char* sql = "DELETE FROM MemberInfo WHERE Member_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_account_id));
+    int ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
 
-    if (ret_code != SQLITE_OK) 
+    if (ret_code != SQLITE_ROW)
     {
-        std::cerr << "Failed to prepare delete member: " << sqlite3_errmsg(db_handle) << std::endl;
-        return false;
+        return ret_code == SQLITE_DONE ? commons::Result::NotFound : commons::Result::DbError;
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
-    ret_code = sqlite3_step(stmt);
-    bool success = (ret_code == SQLITE_DONE && sqlite3_changes(db_handle) > 0);
-    sqlite3_finalize(stmt);
+    if ((!transaction_filter_loaded && !loadTransactionFilter()) || !loadCategoryMatcher())
+    {
+        return commons::Result::DbError;
+    }
 
-    return success;
-}
+    const char* insert_sql =
+        "INSERT OR IGNORE INTO Transactions "
+        "(BankAccount_ID, Txn_Date, Description, Amount, Counterparty, Balance_After, Fingerprint, Category_ID, Rules_Version) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);";
+    sqlite3_stmt* probe_stmt = nullptr;
 
-/**
- * @brief Delete family data by ID.
- * 
- * @param family_id ID of the family to delete.
- * @return true if deletion was successful.
- * @return false if deletion failed.
- */
-bool StorageManager::deleteFamilyData(const uint64_t& family_id) 
-{
-    if (!connected) 
+    if (sqlite3_prepare_v2(db_handle, insert_sql, -1, &stmt, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_handle, "SELECT 1 FROM Transactions WHERE BankAccount_ID = ? AND Fingerprint = ?;", -1, &probe_stmt, nullptr) != SQLITE_OK)
     {
-        if (!initializeDatabase(""))
+        sqlite3_finalize(stmt);
+        return commons::Result::DbError;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_account_id));
+    sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(category_rules_version));
+    sqlite3_bind_int64(probe_stmt, 1, static_cast<sqlite3_int64>(bank_account_id));
+    std::vector<uint64_t> fingerprints = transactionFingerprints(bank_account_id, transactions);
+    uint64_t duplicates = 0;
+
+    for (std::size_t index = 0; index < transactions.size(); ++index)
+    {
+        const BankTransaction& transaction = transactions[index];
+        const sqlite3_int64 fingerprint = static_cast<sqlite3_int64>(fingerprints[index]);
+
+        if (transaction_filter.mayContain(fingerprints[index]))
+        {
+            sqlite3_bind_int64(probe_stmt, 2, fingerprint);
+            ret_code = sqlite3_step(probe_stmt);
+            sqlite3_reset(probe_stmt);
+
+            if (ret_code == SQLITE_ROW)
+            {
+                ++duplicates;
+                continue;
+            }
+
+            if (ret_code != SQLITE_DONE)
+            {
+                sqlite3_finalize(stmt);
+                sqlite3_finalize(probe_stmt);
+                return commons::Result::DbError;
+            }
+        }
+
+        const std::string date_text = commons::formatDate(transaction.date);
+        sqlite3_bind_text(stmt, 2, date_text.c_str(), static_cast<int>(date_text.size()), SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, transaction.description.c_str(), static_cast<int>(transaction.description.size()), SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(transaction.amount_paise));
+        sqlite3_bind_text(stmt, 5, transaction.counterparty.c_str(), static_cast<int>(transaction.counterparty.size()), SQLITE_STATIC);
+
+        if (transaction.balance_after_paise)
+        {
+            sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(*transaction.balance_after_paise));
+        }
+        else
+        {
+            sqlite3_bind_null(stmt, 6);
+        }
+
+        sqlite3_bind_int64(stmt, 7, fingerprint);
+        uint64_t category_id = category_matcher.categorize(transaction.description);
+
+        if (category_id != 0)
+        {
+            sqlite3_bind_int64(stmt, 8, static_cast<sqlite3_int64>(category_id));
+        }
+        else
+        {
+            sqlite3_bind_null(stmt, 8);
+        }
+
+        ret_code = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+
+        if (ret_code != SQLITE_DONE)
         {
-            return false;
+            sqlite3_finalize(stmt);
+            sqlite3_finalize(probe_stmt);
+            return commons::Result::DbError;
         }
-    }
 
-    const char* sql = "DELETE FROM FamilyInfo WHERE Family_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+        // OR IGNORE: the unique index caught a duplicate the filter did not know
+        if (sqlite3_changes(db_handle) == 0)
+        {
+            ++duplicates;
+            continue;
+        }
 
-    if (ret_code != SQLITE_OK) 
-    {
-        std::cerr << "Failed to prepare delete family: " << sqlite3_errmsg(db_handle) << std::endl;
-        return false;
+        // Past the sizing target the false-positive rate climbs; reload larger
+        if (transaction_filter.size() >= transaction_filter.capacity() && !loadTransactionFilter())
+        {
+            sqlite3_finalize(stmt);
+            sqlite3_finalize(probe_stmt);
+            return commons::Result::DbError;
+        }
+
+        transaction_filter.insert(fingerprints[index]);
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
-    ret_code = sqlite3_step(stmt);
-    bool success = (ret_code == SQLITE_DONE && sqlite3_changes(db_handle) > 0);
     sqlite3_finalize(stmt);
-
-    return success;
+    sqlite3_finalize(probe_stmt);
+    *out_duplicates = duplicates;
+    return commons::Result::Ok;
 }
 
 /**
- * @brief Update family data.
+ * @brief Find the member's account at the statement's bank with the same
+ * account number. Runs inside the caller's write transaction.
  * 
- * @param family_id ID of the family to update.
- * @param new_name Name to update to.
- * @return true if update was successful.
- * @return false if update failed.
+ * @param statement Statement being filed.
+ * @param out_id Receives the matching BankAccount_ID, or 0 if none matches.
+ * @return commons::Result 
  */
-bool StorageManager::updateFamilyData(const uint64_t& family_id, const std::string& new_name)
+commons::Result StorageManager::findStatementAccount(const StatementImport& statement, uint64_t* out_id)
 {
-    if (!connected) 
+    *out_id = 0;
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(db_handle, "SELECT BankAccount_ID, Account_Number FROM BankAccounts WHERE Member_ID = ? AND Bank_ID = ? ORDER BY BankAccount_ID;",
+                           -1, &stmt, nullptr) != SQLITE_OK)
     {
-        if (!initializeDatabase("")) 
-        {
-            return false;
-        }
+        return commons::Result::DbError;
     }
 
-    const char* sql = "UPDATE FamilyInfo SET Family_Name = ? WHERE Family_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(statement.member_id));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(statement.bank_id));
+    const std::string account_number = BankAccount::normalizeAccountNumber(statement.account_number);
+    int ret_code = SQLITE_ROW;
 
-    if (ret_code != SQLITE_OK) 
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
     {
-        std::cerr << "Failed to prepare update family: " << sqlite3_errmsg(db_handle) << std::endl;
-        return false;
+        const unsigned char* text = sqlite3_column_text(stmt, 1);
+
+        if (text && BankAccount::normalizeAccountNumber(reinterpret_cast<const char*>(text)) == account_number)
+        {
+            *out_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+            break;
+        }
     }
 
-    sqlite3_bind_text(stmt, 1, new_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(family_id));
-    ret_code = sqlite3_step(stmt);
-    bool success = (ret_code == SQLITE_DONE && sqlite3_changes(db_handle) > 0);
     sqlite3_finalize(stmt);
-
-    return success;
+    return ret_code == SQLITE_ROW || ret_code == SQLITE_DONE ? commons::Result::Ok : commons::Result::DbError;
 }
 
 /**
- * @brief Update member data.
+ * @brief File a parsed statement in one IMMEDIATE transaction.
  * 
- * @param member_id ID of the member to update.
- * @param new_name Name to update to.
- * @param new_nickname Nickname to update to.
- * @return true 
- * @return false 
- */
-bool StorageManager::updateMemberData(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname)
-{
-    // Delegate to Ex version, reuse logic but convert commons::Result to bool
-    auto result = updateMemberDataEx(member_id, new_name, new_nickname);
-    return result == commons::Result::Ok;
-}
-
-/**
- * @brief Save family data to the database.
+ * The account row (when new), the balance snapshot and the lines commit
+ * together, so a failed import leaves nothing behind and can simply be
+ * retried. Without an account ID the statement's account is looked up
+ * inside the transaction before one is created.
  * 
- * @param family Family to save.
- * @param out_family_id ID output parameter.
- * @return commons::Result 
+ * @param statement Statement to file.
+ * @param out_bank_account_id Optional; receives the account it was filed under.
+ * @param out_duplicates Optional; receives the number of lines skipped.
+ * @return commons::Result NotFound if the account, bank or member does not exist.
  */
-commons::Result StorageManager::saveFamilyDataEx(const Family& family, uint64_t* out_family_id)
+commons::Result StorageManager::importStatementEx(const StatementImport& statement,
+                                                  uint64_t* out_bank_account_id,
+                                                  uint64_t* out_duplicates)
 {
-    if (family.getName().empty()) 
+    if (out_duplicates)
+    {
+        *out_duplicates = 0;
+    }
+
+    if ((statement.bank_account_id == 0 && statement.account_number.empty()) ||
+        (statement.period_end && (!statement.period_end->ok() ||
+                                  (statement.period_start && (!statement.period_start->ok() || *statement.period_start > *statement.period_end)))))
     {
         return commons::Result::InvalidInput;
     }
 
-    if (!connected) 
+    for (const BankTransaction& transaction : statement.transactions)
+    {
+        if (!transaction.date.ok())
+        {
+            return commons::Result::InvalidInput;
+        }
+    }
+
+    if (!connected)
     {
         if (!initializeDatabase(""))
         {
@@ -504,82 +3195,122 @@ commons::Result StorageManager::saveFamilyDataEx(const Family& family, uint64_t*
         }
     }
 
-    const char* sql = "INSERT INTO FamilyInfo (Family_Name) VALUES (?);";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
 
-    if (ret_code != SQLITE_OK) 
+    if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
         return commons::Result::DbError;
     }
 
-    ret_code = sqlite3_bind_text(stmt, 1, family.getName().c_str(), -1, SQLITE_TRANSIENT);
-    
-    if (ret_code != SQLITE_OK) 
+    auto rollback = [this](commons::Result res)
     {
-        sqlite3_finalize(stmt);
-        return commons::Result::DbError;
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return res;
+    };
+
+    uint64_t bank_account_id = statement.bank_account_id;
+    uint64_t duplicates = 0;
+    bool created = false;
+    commons::Result res = commons::Result::Ok;
+
+    // Matched inside the write transaction, so concurrent imports of one
+    // new account (in this or another process) cannot each create a copy
+    if (bank_account_id == 0)
+    {
+        res = findStatementAccount(statement, &bank_account_id);
     }
 
-    ret_code = sqlite3_step(stmt);
+    if (res == commons::Result::Ok && bank_account_id == 0)
+    {
+        res = insertBankAccount(statement.bank_id, statement.member_id, statement.account_number,
+                                statement.opening_paise, statement.closing_paise, &bank_account_id);
+        created = true;
+    }
 
-    if (ret_code != SQLITE_DONE) 
+    if (res == commons::Result::Ok && statement.period_end)
+    {
+        res = insertBalanceSnapshot(bank_account_id, statement.period_start, *statement.period_end,
+                                    statement.opening_paise, statement.closing_paise);
+    }
+    else if (res == commons::Result::Ok && !created)
     {
+        // An undated statement cannot be placed in the history; it is taken
+        // as the account's current balances. A missing account is reported
+        // by insertTransactions.
+        sqlite3_stmt* stmt = nullptr;
+
+        if (sqlite3_prepare_v2(db_handle, "UPDATE BankAccounts SET Opening_Balance = ?, Closing_Balance = ? WHERE BankAccount_ID = ?;",
+                               -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            return rollback(commons::Result::DbError);
+        }
+
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(statement.opening_paise));
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(statement.closing_paise));
+        sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(bank_account_id));
+        res = sqlite3_step(stmt) == SQLITE_DONE ? commons::Result::Ok : commons::Result::DbError;
         sqlite3_finalize(stmt);
-        return commons::Result::DbError;
     }
 
-    sqlite3_finalize(stmt);
-    sqlite3_int64 family_id = sqlite3_last_insert_rowid(db_handle);
+    if (res == commons::Result::Ok)
+    {
+        res = insertTransactions(bank_account_id, statement.transactions, &duplicates);
+    }
 
-    // Insert members if any
-    auto members = family.getMembers();
+    if (res != commons::Result::Ok)
+    {
+        return rollback(res);
+    }
 
-    for (const auto &m : members) 
+    if (sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        const char* msql = "INSERT INTO MemberInfo (Family_ID, Member_Name, Member_Nick_Name) VALUES (?, ?, ?);";
-        sqlite3_stmt* mstmt = nullptr;
-        ret_code = sqlite3_prepare_v2(db_handle, msql, -1, &mstmt, nullptr);
+        return rollback(commons::Result::DbError);
+    }
 
-        if (ret_code != SQLITE_OK) 
-        {
-            // continue inserting others but mark DB error
-            sqlite3_finalize(mstmt);
-            continue;
-        }
+    if (out_bank_account_id)
+    {
+        *out_bank_account_id = bank_account_id;
+    }
 
-        sqlite3_bind_int64(mstmt, 1, family_id);
-        sqlite3_bind_text(mstmt, 2, m.getName().c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(mstmt, 3, m.getNickname().c_str(), -1, SQLITE_TRANSIENT);
-        ret_code = sqlite3_step(mstmt);
-        sqlite3_finalize(mstmt);
+    if (out_duplicates)
+    {
+        *out_duplicates = duplicates;
     }
 
-    if (out_family_id) *out_family_id = static_cast<uint64_t>(family_id);
     return commons::Result::Ok;
 }
 
 /**
- * @brief Save member data to the database.
+ * @brief Monthly cash flow of a member or family over a month range.
  * 
- * @param member Member to save.
- * @param family_id ID of the family the member belongs to.
- * @param out_member_id Member ID output parameter.
+ * Reads only CashFlowRollups: a range scan of its primary key per member.
+ * 
+ * @param scope Member or family.
+ * @param scope_id Member_ID or Family_ID.
+ * @param first_month First month of the range.
+ * @param last_month Last month of the range (inclusive).
+ * @param out_months Receives one entry per month.
  * @return commons::Result 
  */
-commons::Result StorageManager::saveMemberDataEx(const Member& member, const uint64_t family_id, uint64_t* out_member_id)
+commons::Result StorageManager::getCashFlowEx(const NetWorthScope scope,
+                                              const uint64_t scope_id,
+                                              const commons::Month& first_month,
+                                              const commons::Month& last_month,
+                                              std::vector<CashFlowMonth>* out_months)
 {
-    if (member.getName().empty())
+    if (!out_months)
     {
         return commons::Result::InvalidInput;
     }
 
-    if (family_id == 0)
+    out_months->clear();
+
+    if (!first_month.ok() || !last_month.ok() || last_month < first_month)
     {
         return commons::Result::InvalidInput;
-    } 
+    }
 
-    if (!connected) 
+    if (!connected)
     {
         if (!initializeDatabase(""))
         {
@@ -587,221 +3318,233 @@ commons::Result StorageManager::saveMemberDataEx(const Member& member, const uin
         }
     }
 
-    // Check family exists
-    const char* check_sql = "SELECT 1 FROM FamilyInfo WHERE Family_ID = ?;";
-    sqlite3_stmt* check_stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, check_sql, -1, &check_stmt, nullptr);
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
 
-    if (ret_code != SQLITE_OK)
+    if (!read_db)
     {
         return commons::Result::DbError;
-    } 
-
-    sqlite3_bind_int64(check_stmt, 1, static_cast<sqlite3_int64>(family_id));
-    ret_code = sqlite3_step(check_stmt);
-    sqlite3_finalize(check_stmt);
+    }
 
-    if (ret_code != SQLITE_ROW)
-    {
-        return commons::Result::NotFound;
-    } 
+    const char* exists_sql = (scope == NetWorthScope::Member)
+        ? "SELECT 1 FROM MemberInfo WHERE Member_ID = ?;"
+        : "SELECT 1 FROM FamilyInfo WHERE Family_ID = ?;";
+    sqlite3_stmt* stmt = nullptr;
 
-    // Check current number of members in the family to enforce REQ-3 (max 255 members)
-    bool ok = false;
-    uint64_t current_count = getMemberCount(family_id, &ok);
-    if (!ok)
+    if (sqlite3_prepare_v2(read_db, exists_sql, -1, &stmt, nullptr) != SQLITE_OK)
     {
         return commons::Result::DbError;
     }
-    if (current_count >= 255)
-    {
-        return commons::Result::MaxMembersExceeded;
-    }
 
-    const char* sql = "INSERT INTO MemberInfo (Family_ID, Member_Name, Member_Nick_Name) VALUES (?, ?, ?);";
-    sqlite3_stmt* stmt = nullptr;
-    ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(scope_id));
+    int ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
 
-    if (ret_code != SQLITE_OK)
+    if (ret_code != SQLITE_ROW)
     {
-        return commons::Result::DbError;
+        return (ret_code == SQLITE_DONE) ? commons::Result::NotFound : commons::Result::DbError;
     }
-    
-
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
-    sqlite3_bind_text(stmt, 2, member.getName().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, member.getNickname().c_str(), -1, SQLITE_TRANSIENT);
 
-    ret_code = sqlite3_step(stmt);
+    std::string sql =
+        "SELECT Month, Credit_Total, Credit_Count, Debit_Total, Debit_Count FROM CashFlowRollups WHERE ";
+    sql += (scope == NetWorthScope::Member)
+        ? "Member_ID = ?1 "
+        : "Member_ID IN (SELECT Member_ID FROM MemberInfo WHERE Family_ID = ?1) ";
+    sql += "AND Month BETWEEN ?2 AND ?3;";
 
-    if (ret_code != SQLITE_DONE) 
+    if (sqlite3_prepare_v2(read_db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(stmt);
         return commons::Result::DbError;
     }
 
-    sqlite3_finalize(stmt);
-
-    if (out_member_id)
-    {
-        *out_member_id = static_cast<uint64_t>(sqlite3_last_insert_rowid(db_handle));
-    } 
+    const std::string first_text = commons::formatMonth(first_month);
+    const std::string last_text = commons::formatMonth(last_month);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(scope_id));
+    sqlite3_bind_text(stmt, 2, first_text.c_str(), static_cast<int>(first_text.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, last_text.c_str(), static_cast<int>(last_text.size()), SQLITE_STATIC);
 
-    return commons::Result::Ok;
-}
+    const std::size_t month_count = static_cast<std::size_t>((last_month - first_month).count()) + 1;
+    std::vector<commons::CheckedAccumulator> credits(month_count);
+    std::vector<commons::CheckedAccumulator> debits(month_count);
+    out_months->resize(month_count);
 
-/**
- * @brief Save a parsed bank account row into BankAccounts.
- *
- * This validates that the referenced Bank and Member exist, then inserts
- * the row. Balances are expected in paise (integer cents).
- */
-commons::Result StorageManager::saveBankAccountEx(uint64_t bank_id,
-                                                 uint64_t member_id,
-                                                 const std::string &account_number,
-                                                 long long opening_paise,
-                                                 long long closing_paise,
-                                                 uint64_t* out_id)
-{
-    if (account_number.empty())
+    for (std::size_t index = 0; index < month_count; ++index)
     {
-        return commons::Result::InvalidInput;
+        (*out_months)[index].month = first_month + std::chrono::months(static_cast<int>(index));
     }
 
-    if (!connected)
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
     {
-        if (!initializeDatabase(""))
+        auto month = commons::parseMonth(columnText(stmt, 0));
+
+        if (!month)
         {
-            return commons::Result::DbError;
+            continue;
         }
-    }
 
-    // Ensure bank exists
-    const char* bank_check_sql = "SELECT 1 FROM BankList WHERE Bank_ID = ?;";
-    sqlite3_stmt* bank_stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, bank_check_sql, -1, &bank_stmt, nullptr);
-    if (ret_code != SQLITE_OK)
-    {
-        if (bank_stmt) sqlite3_finalize(bank_stmt);
-        return commons::Result::DbError;
+        std::size_t index = static_cast<std::size_t>((*month - first_month).count());
+        CashFlowMonth& entry = (*out_months)[index];
+        credits[index].add(static_cast<long long>(sqlite3_column_int64(stmt, 1)));
+        entry.credit_count += static_cast<uint64_t>(sqlite3_column_int64(stmt, 2));
+        debits[index].add(static_cast<long long>(sqlite3_column_int64(stmt, 3)));
+        entry.debit_count += static_cast<uint64_t>(sqlite3_column_int64(stmt, 4));
     }
 
-    sqlite3_bind_int64(bank_stmt, 1, static_cast<sqlite3_int64>(bank_id));
-    ret_code = sqlite3_step(bank_stmt);
-    sqlite3_finalize(bank_stmt);
-    if (ret_code != SQLITE_ROW)
-    {
-        return commons::Result::NotFound;
-    }
+    sqlite3_finalize(stmt);
 
-    // Ensure member exists
-    const char* member_check_sql = "SELECT 1 FROM MemberInfo WHERE Member_ID = ?;";
-    sqlite3_stmt* member_stmt = nullptr;
-    ret_code = sqlite3_prepare_v2(db_handle, member_check_sql, -1, &member_stmt, nullptr);
-    if (ret_code != SQLITE_OK)
+    if (ret_code != SQLITE_DONE)
     {
-        if (member_stmt) sqlite3_finalize(member_stmt);
+        out_months->clear();
         return commons::Result::DbError;
     }
 
-    sqlite3_bind_int64(member_stmt, 1, static_cast<sqlite3_int64>(member_id));
-    ret_code = sqlite3_step(member_stmt);
-    sqlite3_finalize(member_stmt);
-    if (ret_code != SQLITE_ROW)
+    commons::Result result = commons::Result::Ok;
+
+    for (std::size_t index = 0; index < month_count; ++index)
     {
-        return commons::Result::NotFound;
+        CashFlowMonth& entry = (*out_months)[index];
+
+        if (credits[index].toPaise(&entry.credit_paise) != commons::Result::Ok ||
+            debits[index].toPaise(&entry.debit_paise) != commons::Result::Ok)
+        {
+            result = commons::Result::Overflow;
+        }
     }
 
-    const char* insert_sql = "INSERT INTO BankAccounts (Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance) VALUES (?, ?, ?, ?, ?);";
-    sqlite3_stmt* insert_stmt = nullptr;
-    ret_code = sqlite3_prepare_v2(db_handle, insert_sql, -1, &insert_stmt, nullptr);
-    if (ret_code != SQLITE_OK)
+    return result;
+}
+
+/**
+ * @brief Recompute CashFlowRollups from the Transactions table.
+ * 
+ * @return commons::Result 
+ */
+commons::Result StorageManager::rebuildCashFlowRollupsEx()
+{
+    if (!connected)
     {
-        if (insert_stmt) sqlite3_finalize(insert_stmt);
-        return commons::Result::DbError;
+        if (!initializeDatabase(""))
+        {
+            return commons::Result::DbError;
+        }
     }
 
-    sqlite3_bind_int64(insert_stmt, 1, static_cast<sqlite3_int64>(bank_id));
-    sqlite3_bind_int64(insert_stmt, 2, static_cast<sqlite3_int64>(member_id));
-    sqlite3_bind_text(insert_stmt, 3, account_number.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(insert_stmt, 4, static_cast<sqlite3_int64>(opening_paise));
-    sqlite3_bind_int64(insert_stmt, 5, static_cast<sqlite3_int64>(closing_paise));
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
 
-    ret_code = sqlite3_step(insert_stmt);
-    if (ret_code != SQLITE_DONE)
+    if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(insert_stmt);
         return commons::Result::DbError;
     }
 
-    sqlite3_finalize(insert_stmt);
+    const std::string sql =
+        std::string("DELETE FROM CashFlowRollups; "
+                    "INSERT INTO CashFlowRollups (Member_ID, Month, BankAccount_ID, "
+                    "Credit_Total, Credit_Count, Debit_Total, Debit_Count) ") +
+        kCashFlowAggregateSql + ";";
 
-    if (out_id)
+    if (sqlite3_exec(db_handle, sql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK ||
+        sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        *out_id = static_cast<uint64_t>(sqlite3_last_insert_rowid(db_handle));
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return commons::Result::DbError;
     }
 
     return commons::Result::Ok;
 }
 
-bool StorageManager::saveBankAccount(uint64_t bank_id,
-                                    uint64_t member_id,
-                                    const std::string &account_number,
-                                    long long opening_paise,
-                                    long long closing_paise)
-{
-    return saveBankAccountEx(bank_id, member_id, account_number, opening_paise, closing_paise, nullptr) == commons::Result::Ok;
-}
-
 /**
- * @brief Delete member data.
+ * @brief Count rollup rows that disagree with the raw transactions.
  * 
- * @param member_id ID of the member to delete.
+ * A symmetric difference (EXCEPT both ways) between CashFlowRollups and a
+ * fresh aggregation, read in one snapshot so concurrent imports cannot
+ * produce false positives.
+ * 
+ * @param out_mismatched_rows Receives the number of differing rows.
  * @return commons::Result 
  */
-commons::Result StorageManager::deleteMemberDataEx(const uint64_t& member_id)
+commons::Result StorageManager::checkCashFlowRollupsEx(uint64_t* out_mismatched_rows)
 {
-    if (!connected) 
+    if (!out_mismatched_rows)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    *out_mismatched_rows = 0;
+
+    if (!connected)
     {
         if (!initializeDatabase(""))
         {
             return commons::Result::DbError;
-        } 
+        }
     }
 
-    const char* sql = "DELETE FROM MemberInfo WHERE Member_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
 
-    if (ret_code != SQLITE_OK)
+    if (!read_db)
     {
         return commons::Result::DbError;
-    } 
+    }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
-    ret_code = sqlite3_step(stmt);
+    const std::string stored =
+        "SELECT Member_ID, Month, BankAccount_ID, Credit_Total, Credit_Count, Debit_Total, Debit_Count "
+        "FROM CashFlowRollups";
+    const std::string sql =
+        "SELECT (SELECT COUNT(1) FROM (" + stored + " EXCEPT " + kCashFlowAggregateSql + ")) + "
+        "(SELECT COUNT(1) FROM (" + std::string(kCashFlowAggregateSql) + " EXCEPT " + stored + "));";
+    sqlite3_stmt* stmt = nullptr;
 
-    if (ret_code != SQLITE_DONE) 
+    if (sqlite3_prepare_v2(read_db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(stmt);
         return commons::Result::DbError;
     }
 
-    int changes = sqlite3_changes(db_handle);
-    sqlite3_finalize(stmt);
+    int ret_code = sqlite3_step(stmt);
 
-    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
+    if (ret_code == SQLITE_ROW)
+    {
+        *out_mismatched_rows = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+    }
+
+    sqlite3_finalize(stmt);
+    return (ret_code == SQLITE_ROW) ? commons::Result::Ok : commons::Result::DbError;
 }
 
 /**
- * @brief Delete family data.
+ * @brief Full-text search over transaction narrations and counterparties.
  * 
- * @param family_id ID of the family to delete.
+ * Each word of `text` becomes a quoted FTS5 prefix term and the terms are
+ * ANDed, so user input never reaches the MATCH parser as syntax.
+ * 
+ * @param text Words to look for.
+ * @param limit Maximum number of matches.
+ * @param out_matches Receives the matches, newest first.
  * @return commons::Result 
  */
-commons::Result StorageManager::deleteFamilyDataEx(const uint64_t& family_id)
+commons::Result StorageManager::searchTransactionsEx(const std::string& text,
+                                                     std::size_t limit,
+                                                     std::vector<TransactionMatch>* out_matches)
 {
-    if (!connected) 
+    if (!out_matches)
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    out_matches->clear();
+    std::string match_expression;
+
+    for (const std::string& token : commons::searchTokens(text))
+    {
+        match_expression.append(match_expression.empty() ? "\"" : " \"").append(token).append("\"*");
+    }
+
+    if (match_expression.empty() || limit == 0)
+    {
+        return commons::Result::Ok;
+    }
+
+    if (!connected)
     {
         if (!initializeDatabase(""))
         {
@@ -809,96 +3552,158 @@ commons::Result StorageManager::deleteFamilyDataEx(const uint64_t& family_id)
         }
     }
 
-    const char* sql = "DELETE FROM FamilyInfo WHERE Family_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
 
-    if (ret_code != SQLITE_OK)
+    if (!read_db)
     {
         return commons::Result::DbError;
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
-    ret_code = sqlite3_step(stmt);
+    const char* sql =
+        "SELECT t.BankAccount_ID, b.Member_ID, t.Txn_Date, t.Description, t.Amount, t.Counterparty, t.Balance_After, t.Category_ID "
+        "FROM TransactionSearch s "
+        "JOIN Transactions t ON t.Transaction_ID = s.rowid "
+        "JOIN BankAccounts b ON b.BankAccount_ID = t.BankAccount_ID "
+        "WHERE TransactionSearch MATCH ? "
+        "ORDER BY t.Txn_Date DESC, t.BankAccount_ID, t.Transaction_ID DESC LIMIT ?;";
+    sqlite3_stmt* stmt = nullptr;
 
-    if (ret_code != SQLITE_DONE) 
+    if (sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(stmt);
         return commons::Result::DbError;
     }
 
-    int changes = sqlite3_changes(db_handle);
+    sqlite3_bind_text(stmt, 1, match_expression.c_str(), static_cast<int>(match_expression.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(std::min<std::size_t>(limit, std::numeric_limits<sqlite3_int64>::max())));
+    int ret_code = SQLITE_DONE;
+
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        auto date = commons::parseDate(columnText(stmt, 2));
+
+        if (!date)
+        {
+            continue;
+        }
+
+        TransactionMatch match;
+        match.bank_account_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        match.member_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+        match.transaction.date = *date;
+        match.transaction.description = columnText(stmt, 3);
+        match.transaction.amount_paise = static_cast<long long>(sqlite3_column_int64(stmt, 4));
+        match.transaction.counterparty = columnText(stmt, 5);
+
+        if (sqlite3_column_type(stmt, 6) != SQLITE_NULL)
+        {
+            match.transaction.balance_after_paise = static_cast<long long>(sqlite3_column_int64(stmt, 6));
+        }
+
+        match.transaction.category_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 7));
+        out_matches->push_back(std::move(match));
+    }
+
     sqlite3_finalize(stmt);
 
-    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
+    if (ret_code != SQLITE_DONE)
+    {
+        out_matches->clear();
+        return commons::Result::DbError;
+    }
+
+    return commons::Result::Ok;
 }
 
 /**
- * @brief Update family data.
+ * @brief Recompile category_matcher if the stored rules have changed.
  * 
- * @param family_id ID of the family to update.
- * @param new_name Name to update to.
- * @return commons::Result 
+ * A single-row read when they have not. The caller holds the write lock,
+ * normally inside a write transaction so rules and rows agree.
+ * 
+ * @return true if the matcher is current.
  */
-commons::Result StorageManager::updateFamilyDataEx(const uint64_t& family_id, const std::string& new_name)
+bool StorageManager::loadCategoryMatcher()
 {
-    if (new_name.empty())
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(db_handle, "SELECT Version FROM CategoryRuleVersion WHERE Singleton = 1;", -1, &stmt, nullptr) != SQLITE_OK)
     {
-        return commons::Result::InvalidInput;
+        return false;
     }
-    
-    if (!connected) 
+
+    long long version = -1;
+
+    if (sqlite3_step(stmt) == SQLITE_ROW)
     {
-        if (!initializeDatabase(""))
-        {
-            return commons::Result::DbError;
-        } 
+        version = static_cast<long long>(sqlite3_column_int64(stmt, 0));
     }
 
-    const char* sql = "UPDATE FamilyInfo SET Family_Name = ? WHERE Family_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
+    sqlite3_finalize(stmt);
 
-    if (ret_code != SQLITE_OK)
+    if (version < 0)
     {
-        return commons::Result::DbError;
-    } 
+        return false;
+    }
 
-    sqlite3_bind_text(stmt, 1, new_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(family_id));
-    ret_code = sqlite3_step(stmt);
+    if (version == category_rules_version)
+    {
+        return true;
+    }
 
-    if (ret_code != SQLITE_DONE) 
+    if (sqlite3_prepare_v2(db_handle, "SELECT Rule_ID, Category_ID, Keyword, Priority FROM CategoryRules ORDER BY Rule_ID;", -1, &stmt, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(stmt);
-        return commons::Result::DbError;
+        return false;
+    }
+
+    std::vector<CategoryRule> rules;
+    int ret_code = SQLITE_DONE;
+
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        CategoryRule rule;
+        rule.rule_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        rule.category_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+        rule.keyword = columnText(stmt, 2);
+        rule.priority = sqlite3_column_int(stmt, 3);
+        rules.push_back(std::move(rule));
     }
 
-    int changes = sqlite3_changes(db_handle);
     sqlite3_finalize(stmt);
 
-    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
+    if (ret_code != SQLITE_DONE)
+    {
+        return false;
+    }
+
+    category_matcher.compile(rules);
+    category_rules_version = version;
+    return true;
 }
 
 /**
- * @brief Update member data.
+ * @brief Add a keyword rule, creating its category if needed.
  * 
- * @param member_id ID of the member to update.
- * @param new_name Name to update to.
- * @param new_nickname Nickname to update to.
- * @return commons::Result 
+ * The CategoryRules_Version_Insert trigger bumps the rule version, which
+ * marks every existing transaction for recategorisation.
+ * 
+ * @param category_name Category the rule assigns.
+ * @param keyword Words to look for in narrations.
+ * @param priority Higher priorities win over other matching rules.
+ * @param out_rule_id Optional; receives the new Rule_ID.
+ * @return commons::Result InvalidInput if the name or keyword has no words.
  */
-commons::Result StorageManager::updateMemberDataEx(const uint64_t& member_id, const std::string& new_name, const std::string& new_nickname)
+commons::Result StorageManager::saveCategoryRuleEx(const std::string& category_name,
+                                                   const std::string& keyword,
+                                                   int priority,
+                                                   uint64_t* out_rule_id)
 {
-    // Check if we have at least one field to update
-    bool update_name = !new_name.empty();
-    bool update_nickname = !new_nickname.empty();
-    if (!update_name && !update_nickname)
+    if (commons::searchTokens(category_name).empty() || commons::searchTokens(keyword).empty())
     {
         return commons::Result::InvalidInput;
     }
 
-    if (!connected) 
+    if (!connected)
     {
         if (!initializeDatabase(""))
         {
@@ -906,232 +3711,269 @@ commons::Result StorageManager::updateMemberDataEx(const uint64_t& member_id, co
         }
     }
 
-    // Build dynamic SQL based on what needs to be updated
-    std::string sql = "UPDATE MemberInfo SET ";
-    if (update_name)
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        sql += "Member_Name = ?";
-        if (update_nickname)
-        {
-            sql += ", ";
-        }
+        return commons::Result::DbError;
     }
-    if (update_nickname)
+
+    auto rollback = [this](commons::Result res)
     {
-        sql += "Member_Nick_Name = ?";
-    }
-    sql += " WHERE Member_ID = ?;";
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return res;
+    };
 
     sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql.c_str(), -1, &stmt, nullptr);
-
-    if (ret_code != SQLITE_OK)
-    {
-        return commons::Result::DbError;
-    } 
 
-    int param_index = 1;
-    if (update_name)
+    if (sqlite3_prepare_v2(db_handle, "INSERT OR IGNORE INTO Categories (Category_Name) VALUES (?);", -1, &stmt, nullptr) != SQLITE_OK)
     {
-        sqlite3_bind_text(stmt, param_index++, new_name.c_str(), -1, SQLITE_TRANSIENT);
+        return rollback(commons::Result::DbError);
     }
-    if (update_nickname)
+
+    sqlite3_bind_text(stmt, 1, category_name.c_str(), static_cast<int>(category_name.size()), SQLITE_STATIC);
+    int ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_DONE)
     {
-        sqlite3_bind_text(stmt, param_index++, new_nickname.c_str(), -1, SQLITE_TRANSIENT);
+        return rollback(commons::Result::DbError);
     }
-    sqlite3_bind_int64(stmt, param_index, static_cast<sqlite3_int64>(member_id));
-    ret_code = sqlite3_step(stmt);
 
-    if (ret_code != SQLITE_DONE) 
+    const char* insert_sql =
+        "INSERT INTO CategoryRules (Category_ID, Keyword, Priority) "
+        "SELECT Category_ID, ?, ? FROM Categories WHERE Category_Name = ?;";
+
+    if (sqlite3_prepare_v2(db_handle, insert_sql, -1, &stmt, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(stmt);
-        return commons::Result::DbError;
+        return rollback(commons::Result::DbError);
     }
 
-    int changes = sqlite3_changes(db_handle);
+    sqlite3_bind_text(stmt, 1, keyword.c_str(), static_cast<int>(keyword.size()), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, priority);
+    sqlite3_bind_text(stmt, 3, category_name.c_str(), static_cast<int>(category_name.size()), SQLITE_STATIC);
+    ret_code = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
-    return (changes > 0) ? commons::Result::Ok : commons::Result::NotFound;
-}
-
-/**
- * @brief Connect to the database.
- * 
- * @param connectionString SQLite database file path.
- * @return true if connection was successful.
- * @return false if connection failed.
- */
-bool StorageManager::connect(const std::string& connectionString) 
-{
-    // If already connected and same path, return true. If different path, close and reopen.
-    if (connected && db_handle) 
+    if (ret_code != SQLITE_DONE || sqlite3_changes(db_handle) != 1)
     {
-        // Note: no stored path is kept; caller should manage connections if using multiple DBs.
-        return true;
+        return rollback(commons::Result::DbError);
     }
 
-    // Open SQLite DB (read/write, create if missing)
-    int ret_code = sqlite3_open_v2(connectionString.c_str(), &db_handle, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
-    
-    if (ret_code != SQLITE_OK) 
-    {
-        std::cerr << "Failed to open SQLite DB '" << connectionString << "': " << (db_handle ? sqlite3_errmsg(db_handle) : "(no handle)") << std::endl;
-        if (db_handle) 
-        {
-            sqlite3_close(db_handle);
-            db_handle = nullptr;
-        }
+    uint64_t rule_id = static_cast<uint64_t>(sqlite3_last_insert_rowid(db_handle));
 
-        connected = false;
-        return false;
+    if (sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        return rollback(commons::Result::DbError);
     }
 
-    // Enable foreign keys
-    char* errmsg = nullptr;
-    ret_code = sqlite3_exec(db_handle, "PRAGMA foreign_keys = ON;", nullptr, nullptr, &errmsg);
-    
-    if (ret_code != SQLITE_OK) 
+    if (out_rule_id)
     {
-        std::cerr << "Warning: failed to enable foreign keys: " << (errmsg ? errmsg : "") << std::endl;
-        if (errmsg) sqlite3_free(errmsg);
-        // Not fatal; proceed
+        *out_rule_id = rule_id;
     }
 
-    connected = true;
-    return true;
+    return commons::Result::Ok;
 }
 
 /**
- * @brief Disconnect from the database.
+ * @brief Add a batch of keyword rules in one write transaction.
+ * 
+ * Rules already present under the same category with a keyword of the
+ * same search tokens are updated in place (priority only), so reloading a
+ * rules file neither duplicates rules nor bumps the rule version needlessly.
  * 
+ * @param category_names Category of each rule, created if needed.
+ * @param rules Keyword and priority of each rule.
+ * @param out_added Optional; receives the number of rules inserted.
+ * @return commons::Result InvalidInput (nothing saved) if the spans differ
+ *         in length or a name or keyword has no words.
  */
-void StorageManager::disconnect() 
+commons::Result StorageManager::saveCategoryRulesEx(std::span<const std::string> category_names,
+                                                    std::span<const CategoryRule> rules,
+                                                    uint64_t* out_added)
 {
-    if (db_handle) 
+    if (out_added)
     {
-        sqlite3_close(db_handle);
-        db_handle = nullptr;
+        *out_added = 0;
     }
 
-    connected = false;
-}
+    if (category_names.size() != rules.size())
+    {
+        return commons::Result::InvalidInput;
+    }
+
+    for (std::size_t index = 0; index < rules.size(); ++index)
+    {
+        if (commons::searchTokens(category_names[index]).empty() || commons::searchTokens(rules[index].keyword).empty())
+        {
+            return commons::Result::InvalidInput;
+        }
+    }
 
-/**
- * @brief List all families in the database.
- * 
- * @return std::vector<Family> Vector of families with IDs
- */
-std::vector<Family> StorageManager::listFamilies()
-{
-    std::vector<Family> families;
     if (!connected)
     {
         if (!initializeDatabase(""))
         {
-            return families;
+            return commons::Result::DbError;
         }
     }
 
-    const char* sql = "SELECT Family_ID, Family_Name FROM FamilyInfo ORDER BY Family_ID;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
+
+    if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        return families;
+        return commons::Result::DbError;
     }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW)
+    sqlite3_stmt* insert_category = nullptr;
+    sqlite3_stmt* find_category = nullptr;
+    sqlite3_stmt* insert_rule = nullptr;
+    sqlite3_stmt* update_rule = nullptr;
+
+    auto fail = [&]()
     {
-        uint64_t id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
-        const unsigned char* name = sqlite3_column_text(stmt, 1);
-        std::string name_str = name ? reinterpret_cast<const char*>(name) : std::string();
-        families.emplace_back(id, name_str);
-    }
-    sqlite3_finalize(stmt);
-    return families;
-}
+        sqlite3_finalize(insert_category);
+        sqlite3_finalize(find_category);
+        sqlite3_finalize(insert_rule);
+        sqlite3_finalize(update_rule);
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return commons::Result::DbError;
+    };
 
-/**
- * @brief List all members of a specific family.
- * 
- * @param family_id ID of the family whose members to list
- * @return std::vector<Member> Vector of members with IDs
- */
-std::vector<Member> StorageManager::listMembersOfFamily(uint64_t family_id)
-{
-    std::vector<Member> members;
-    if (!connected)
+    // Current rules keyed by category ID followed by the normalised keyword
+    std::unordered_map<std::string, std::pair<uint64_t, int>> existing;
+
+    if (sqlite3_prepare_v2(db_handle, "SELECT Rule_ID, Category_ID, Keyword, Priority FROM CategoryRules;", -1, &find_category, nullptr) != SQLITE_OK)
     {
-        if (!initializeDatabase(""))
-        {
-            return members;
-        }
+        return fail();
     }
 
-    const char* sql = "SELECT Member_ID, Member_Name, Member_Nick_Name FROM MemberInfo WHERE Family_ID = ? ORDER BY Member_ID;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    int ret_code = SQLITE_ROW;
+
+    while ((ret_code = sqlite3_step(find_category)) == SQLITE_ROW)
     {
-        return members;
+        const unsigned char* keyword = sqlite3_column_text(find_category, 2);
+        std::string key = std::to_string(sqlite3_column_int64(find_category, 1)) +
+                          commons::normalisedKeyword(keyword ? reinterpret_cast<const char*>(keyword) : "");
+        existing.emplace(std::move(key), std::make_pair(static_cast<uint64_t>(sqlite3_column_int64(find_category, 0)),
+                                                        sqlite3_column_int(find_category, 3)));
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
-    while (sqlite3_step(stmt) == SQLITE_ROW)
+    sqlite3_finalize(find_category);
+    find_category = nullptr;
+
+    if (ret_code != SQLITE_DONE ||
+        sqlite3_prepare_v2(db_handle, "INSERT OR IGNORE INTO Categories (Category_Name) VALUES (?);", -1, &insert_category, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_handle, "SELECT Category_ID FROM Categories WHERE Category_Name = ?;", -1, &find_category, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_handle, "INSERT INTO CategoryRules (Category_ID, Keyword, Priority) VALUES (?, ?, ?);", -1, &insert_rule, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_handle, "UPDATE CategoryRules SET Priority = ? WHERE Rule_ID = ?;", -1, &update_rule, nullptr) != SQLITE_OK)
     {
-        uint64_t id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
-        const unsigned char* name = sqlite3_column_text(stmt, 1);
-        const unsigned char* nick = sqlite3_column_text(stmt, 2);
-        std::string name_str = name ? reinterpret_cast<const char*>(name) : std::string();
-        std::string nick_str = nick ? reinterpret_cast<const char*>(nick) : std::string();
-        members.emplace_back(id, name_str, nick_str);
+        return fail();
     }
-    sqlite3_finalize(stmt);
-    return members;
-}
 
-uint64_t StorageManager::getMemberCount(const uint64_t family_id, bool* out_ok)
-{
-    if (!connected)
+    // Resolve every category first: a keyword repeated in the batch is one
+    // rule, and it takes the priority of its last occurrence
+    std::vector<sqlite3_int64> category_ids;
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, int> batch_priority;
+    category_ids.reserve(rules.size());
+    keys.reserve(rules.size());
+
+    for (std::size_t index = 0; index < rules.size(); ++index)
     {
-        if (!initializeDatabase(""))
+        const std::string& category_name = category_names[index];
+
+        sqlite3_bind_text(insert_category, 1, category_name.c_str(), static_cast<int>(category_name.size()), SQLITE_STATIC);
+        ret_code = sqlite3_step(insert_category);
+        sqlite3_reset(insert_category);
+
+        if (ret_code != SQLITE_DONE)
         {
-            if (out_ok) *out_ok = false;
-            return 0;
+            return fail();
+        }
+
+        sqlite3_bind_text(find_category, 1, category_name.c_str(), static_cast<int>(category_name.size()), SQLITE_STATIC);
+
+        if (sqlite3_step(find_category) != SQLITE_ROW)
+        {
+            return fail();
         }
+
+        category_ids.push_back(sqlite3_column_int64(find_category, 0));
+        sqlite3_reset(find_category);
+        keys.push_back(std::to_string(category_ids.back()) + commons::normalisedKeyword(rules[index].keyword));
+        batch_priority[keys.back()] = rules[index].priority;
     }
 
-    const char* sql = "SELECT COUNT(1) FROM MemberInfo WHERE Family_ID = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
-    if (ret_code != SQLITE_OK)
+    uint64_t added = 0;
+
+    for (std::size_t index = 0; index < rules.size(); ++index)
     {
-        if (stmt) sqlite3_finalize(stmt);
-        if (out_ok) *out_ok = false;
-        return 0;
+        const int priority = batch_priority[keys[index]];
+        auto found = existing.find(keys[index]);
+
+        if (found != existing.end())
+        {
+            if (found->second.second != priority)
+            {
+                sqlite3_bind_int(update_rule, 1, priority);
+                sqlite3_bind_int64(update_rule, 2, static_cast<sqlite3_int64>(found->second.first));
+                ret_code = sqlite3_step(update_rule);
+                sqlite3_reset(update_rule);
+
+                if (ret_code != SQLITE_DONE)
+                {
+                    return fail();
+                }
+
+                found->second.second = priority;
+            }
+
+            continue;
+        }
+
+        const std::string& keyword = rules[index].keyword;
+        sqlite3_bind_int64(insert_rule, 1, category_ids[index]);
+        sqlite3_bind_text(insert_rule, 2, keyword.c_str(), static_cast<int>(keyword.size()), SQLITE_STATIC);
+        sqlite3_bind_int(insert_rule, 3, priority);
+        ret_code = sqlite3_step(insert_rule);
+        sqlite3_reset(insert_rule);
+
+        if (ret_code != SQLITE_DONE)
+        {
+            return fail();
+        }
+
+        existing.emplace(keys[index], std::make_pair(static_cast<uint64_t>(sqlite3_last_insert_rowid(db_handle)), priority));
+        ++added;
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(family_id));
-    ret_code = sqlite3_step(stmt);
-    if (ret_code != SQLITE_ROW)
+    sqlite3_finalize(insert_category);
+    sqlite3_finalize(find_category);
+    sqlite3_finalize(insert_rule);
+    sqlite3_finalize(update_rule);
+
+    if (sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        sqlite3_finalize(stmt);
-        if (out_ok) *out_ok = false;
-        return 0;
+        sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return commons::Result::DbError;
     }
 
-    sqlite3_int64 cnt = sqlite3_column_int64(stmt, 0);
-    sqlite3_finalize(stmt);
-
-    if (cnt < 0)
+    if (out_added)
     {
-        if (out_ok) *out_ok = false;
-        return 0;
+        *out_added = added;
     }
 
-    if (out_ok) *out_ok = true;
-    return static_cast<uint64_t>(cnt);
+    return commons::Result::Ok;
 }
 
-commons::Result StorageManager::getBankIdByName(const std::string &bank_name, uint64_t* out_bank_id)
+/**
+ * @brief Remove a keyword rule.
+ * 
+ * @param rule_id Rule to remove.
+ * @return commons::Result NotFound if there is no such rule.
+ */
+commons::Result StorageManager::deleteCategoryRuleEx(const uint64_t rule_id)
 {
     if (!connected)
     {
@@ -1141,37 +3983,41 @@ commons::Result StorageManager::getBankIdByName(const std::string &bank_name, ui
         }
     }
 
-    const char* sql = "SELECT Bank_ID FROM BankList WHERE lower(Bank_Name) = lower(?) LIMIT 1;";
+    std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
     sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
-    if (ret_code != SQLITE_OK)
+
+    if (sqlite3_prepare_v2(db_handle, "DELETE FROM CategoryRules WHERE Rule_ID = ?;", -1, &stmt, nullptr) != SQLITE_OK)
     {
-        if (stmt) sqlite3_finalize(stmt);
         return commons::Result::DbError;
     }
 
-    sqlite3_bind_text(stmt, 1, bank_name.c_str(), -1, SQLITE_TRANSIENT);
-    ret_code = sqlite3_step(stmt);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(rule_id));
+    int ret_code = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
 
-    if (ret_code != SQLITE_ROW)
+    if (ret_code != SQLITE_DONE)
     {
-        sqlite3_finalize(stmt);
-        return commons::Result::NotFound;
+        return commons::Result::DbError;
     }
 
-    sqlite3_int64 id = sqlite3_column_int64(stmt, 0);
-    sqlite3_finalize(stmt);
-    if (out_bank_id) *out_bank_id = static_cast<uint64_t>(id);
-    return commons::Result::Ok;
+    return sqlite3_changes(db_handle) == 0 ? commons::Result::NotFound : commons::Result::Ok;
 }
 
-commons::Result StorageManager::getBankNameById(const uint64_t bank_id, std::string* out_name)
+/**
+ * @brief List every category.
+ * 
+ * @param out_categories Receives the categories by ascending ID.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::listCategoriesEx(std::vector<TransactionCategory>* out_categories)
 {
-    if (!out_name)
+    if (!out_categories)
     {
         return commons::Result::InvalidInput;
     }
 
+    out_categories->clear();
+
     if (!connected)
     {
         if (!initializeDatabase(""))
@@ -1180,36 +4026,49 @@ commons::Result StorageManager::getBankNameById(const uint64_t bank_id, std::str
         }
     }
 
-    const char* sql = "SELECT Bank_Name FROM BankList WHERE Bank_ID = ? LIMIT 1;";
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
     sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
-    if (ret_code != SQLITE_OK)
+
+    if (!read_db ||
+        sqlite3_prepare_v2(read_db, "SELECT Category_ID, Category_Name FROM Categories ORDER BY Category_ID;", -1, &stmt, nullptr) != SQLITE_OK)
     {
-        if (stmt) sqlite3_finalize(stmt);
         return commons::Result::DbError;
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_id));
-    ret_code = sqlite3_step(stmt);
-    if (ret_code != SQLITE_ROW)
+    int ret_code = SQLITE_DONE;
+
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
     {
-        sqlite3_finalize(stmt);
-        return commons::Result::NotFound;
+        out_categories->push_back({static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)), columnText(stmt, 1)});
     }
 
-    const unsigned char* txt = sqlite3_column_text(stmt, 0);
-    *out_name = txt ? reinterpret_cast<const char*>(txt) : std::string();
     sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_DONE)
+    {
+        out_categories->clear();
+        return commons::Result::DbError;
+    }
+
     return commons::Result::Ok;
 }
 
-commons::Result StorageManager::getBankAccountById(const uint64_t bank_account_id, BankAccount* out_row)
+/**
+ * @brief List every keyword rule.
+ * 
+ * @param out_rules Receives the rules by ascending Rule_ID.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::listCategoryRulesEx(std::vector<CategoryRule>* out_rules)
 {
-    if (!out_row)
+    if (!out_rules)
     {
         return commons::Result::InvalidInput;
     }
 
+    out_rules->clear();
+
     if (!connected)
     {
         if (!initializeDatabase(""))
@@ -1218,70 +4077,168 @@ commons::Result StorageManager::getBankAccountById(const uint64_t bank_account_i
         }
     }
 
-    const char* sql = "SELECT BankAccount_ID, Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance FROM BankAccounts WHERE BankAccount_ID = ? LIMIT 1;";
+    ReadConnection reader(*this);
+    sqlite3* read_db = reader.get();
     sqlite3_stmt* stmt = nullptr;
-    int ret_code = sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr);
-    if (ret_code != SQLITE_OK)
+    const char* sql = "SELECT Rule_ID, Category_ID, Keyword, Priority FROM CategoryRules ORDER BY Rule_ID;";
+
+    if (!read_db || sqlite3_prepare_v2(read_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
     {
-        if (stmt) sqlite3_finalize(stmt);
         return commons::Result::DbError;
     }
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(bank_account_id));
-    ret_code = sqlite3_step(stmt);
-    if (ret_code != SQLITE_ROW)
+    int ret_code = SQLITE_DONE;
+
+    while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
     {
-        sqlite3_finalize(stmt);
-        return commons::Result::NotFound;
+        CategoryRule rule;
+        rule.rule_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        rule.category_id = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+        rule.keyword = columnText(stmt, 2);
+        rule.priority = sqlite3_column_int(stmt, 3);
+        out_rules->push_back(std::move(rule));
     }
 
-    out_row->setId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)));
-    out_row->setBankId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)));
-    out_row->setMemberId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)));
-    const unsigned char* acct = sqlite3_column_text(stmt, 3);
-    out_row->setAccountNumber(acct ? reinterpret_cast<const char*>(acct) : std::string());
-    out_row->setOpeningBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 4)));
-    out_row->setClosingBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 5)));
-
     sqlite3_finalize(stmt);
+
+    if (ret_code != SQLITE_DONE)
+    {
+        out_rules->clear();
+        return commons::Result::DbError;
+    }
+
     return commons::Result::Ok;
 }
 
-std::vector<BankAccount> StorageManager::listBankAccountsOfMember(const uint64_t member_id)
+/**
+ * @brief Re-apply the current rules to stale transactions, batch by batch.
+ * 
+ * Each batch is one IMMEDIATE transaction that picks up to `batch_size`
+ * rows with an older Rules_Version through the Transactions_Rules_Version
+ * index, categorises them and stamps the current version. The write lock
+ * is released between batches so imports are not held up for the whole
+ * run. A rule change between batches simply widens the remaining work.
+ * 
+ * @param batch_size Rows per write transaction (must be positive).
+ * @param out_changed Optional; receives the number of rows whose category changed.
+ * @return commons::Result 
+ */
+commons::Result StorageManager::recategorizeTransactionsEx(std::size_t batch_size, uint64_t* out_changed)
 {
-    std::vector<BankAccount> rows;
+    if (batch_size == 0)
+    {
+        return commons::Result::InvalidInput;
+    }
 
     if (!connected)
     {
         if (!initializeDatabase(""))
         {
-            return rows;
+            return commons::Result::DbError;
         }
     }
 
-    const char* sql = "SELECT BankAccount_ID, Bank_ID, Member_ID, Account_Number, Opening_Balance, Closing_Balance FROM BankAccounts WHERE Member_ID = ? ORDER BY BankAccount_ID;";
-    sqlite3_stmt* stmt = nullptr;
+    uint64_t changed = 0;
+    bool more = true;
 
-    if (sqlite3_prepare_v2(db_handle, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    while (more)
     {
-        return rows;
-    }
+        std::lock_guard<std::recursive_mutex> write_lock(write_mutex);
 
-    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(member_id));
+        if (sqlite3_exec(db_handle, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        {
+            return commons::Result::DbError;
+        }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW)
+        auto rollback = [this](commons::Result res)
+        {
+            sqlite3_exec(db_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return res;
+        };
+
+        if (!loadCategoryMatcher())
+        {
+            return rollback(commons::Result::DbError);
+        }
+
+        sqlite3_stmt* stmt = nullptr;
+        const char* select_sql =
+            "SELECT Transaction_ID, Description, Category_ID FROM Transactions WHERE Rules_Version < ? LIMIT ?;";
+
+        if (sqlite3_prepare_v2(db_handle, select_sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            return rollback(commons::Result::DbError);
+        }
+
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(category_rules_version));
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(std::min<std::size_t>(batch_size, std::numeric_limits<sqlite3_int64>::max())));
+
+        // Collected first: the batch is updated after the scan finishes
+        std::vector<std::pair<sqlite3_int64, uint64_t>> updates;
+        int ret_code = SQLITE_DONE;
+
+        while ((ret_code = sqlite3_step(stmt)) == SQLITE_ROW)
+        {
+            uint64_t category_id = category_matcher.categorize(columnView(stmt, 1));
+
+            if (category_id != static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)))
+            {
+                ++changed;
+            }
+
+            updates.emplace_back(sqlite3_column_int64(stmt, 0), category_id);
+        }
+
+        sqlite3_finalize(stmt);
+
+        if (ret_code != SQLITE_DONE)
+        {
+            return rollback(commons::Result::DbError);
+        }
+
+        if (sqlite3_prepare_v2(db_handle, "UPDATE Transactions SET Category_ID = ?, Rules_Version = ? WHERE Transaction_ID = ?;", -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            return rollback(commons::Result::DbError);
+        }
+
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(category_rules_version));
+
+        for (const auto &[transaction_id, category_id] : updates)
+        {
+            if (category_id != 0)
+            {
+                sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(category_id));
+            }
+            else
+            {
+                sqlite3_bind_null(stmt, 1);
+            }
+
+            sqlite3_bind_int64(stmt, 3, transaction_id);
+            ret_code = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+
+            if (ret_code != SQLITE_DONE)
+            {
+                sqlite3_finalize(stmt);
+                return rollback(commons::Result::DbError);
+            }
+        }
+
+        sqlite3_finalize(stmt);
+
+        if (sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        {
+            return rollback(commons::Result::DbError);
+        }
+
+        more = updates.size() == batch_size;
+    }
+
+    if (out_changed)
     {
-        BankAccount bankAccount;
-        bankAccount.setId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)));
-        bankAccount.setBankId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)));
-        bankAccount.setMemberId(static_cast<uint64_t>(sqlite3_column_int64(stmt, 2)));
-        const unsigned char* acct = sqlite3_column_text(stmt, 3);
-        bankAccount.setAccountNumber(acct ? reinterpret_cast<const char*>(acct) : std::string());
-        bankAccount.setOpeningBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 4)));
-        bankAccount.setClosingBalancePaise(static_cast<long long>(sqlite3_column_int64(stmt, 5)));
-        rows.push_back(bankAccount);
+        *out_changed = changed;
     }
 
-    sqlite3_finalize(stmt);
-    return rows;
+    return commons::Result::Ok;
 }
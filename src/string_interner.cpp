@@ -0,0 +1,62 @@
+#include "string_interner.hpp"
+
+namespace commons
+{
+    /**
+     * @brief Construct a table holding only the empty string.
+     */
+    StringInterner::StringInterner()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Return the handle of `text`, storing it on first use.
+     *
+     * @param text String to intern.
+     * @return NameHandle Stable handle for the string.
+     */
+    NameHandle StringInterner::intern(std::string_view text)
+    {
+        auto it = handles.find(text);
+
+        if (it != handles.end())
+        {
+            return it->second;
+        }
+
+        NameHandle handle = static_cast<NameHandle>(strings.size());
+        const std::string& stored = strings.emplace_back(text);
+        handles.emplace(std::string_view(stored), handle);
+        return handle;
+    }
+
+    /**
+     * @brief Look up a string without adding it.
+     *
+     * @param text String to look for.
+     * @return std::optional<NameHandle> Its handle, or std::nullopt if never interned.
+     */
+    std::optional<NameHandle> StringInterner::find(std::string_view text) const
+    {
+        auto it = handles.find(text);
+
+        if (it == handles.end())
+        {
+            return std::nullopt;
+        }
+
+        return it->second;
+    }
+
+    /**
+     * @brief Reset the table to just the empty string.
+     */
+    void StringInterner::clear()
+    {
+        handles.clear();
+        strings.clear();
+        strings.emplace_back();
+        handles.emplace(std::string_view(strings.front()), kEmpty);
+    }
+}
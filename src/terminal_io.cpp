@@ -1,6 +1,28 @@
 #include "terminal_io.hpp"
 #include <iostream>
 
+/**
+ * @brief Construct a new TerminalIO object.
+ * 
+ * @param mode Whether output is flushed per line or buffered.
+ */
+TerminalIO::TerminalIO(OutputMode mode)
+    : mode(mode)
+{
+    if (mode == OutputMode::Buffered)
+    {
+        out_buffer.reserve(kFlushThreshold);
+    }
+}
+
+/**
+ * @brief Destroy the TerminalIO object, writing out any pending output.
+ */
+TerminalIO::~TerminalIO()
+{
+    flush();
+}
+
 /**
  * @brief Prints a line to the terminal.
  * 
@@ -8,26 +30,86 @@
  */
 void TerminalIO::printLine(const std::string& line) 
 {
-    std::cout << line << std::endl;
+    if (mode == OutputMode::Immediate)
+    {
+        std::cout << line << std::endl;
+        return;
+    }
+
+    out_buffer.append(line);
+    out_buffer.push_back('\n');
+
+    if (out_buffer.size() >= kFlushThreshold)
+    {
+        flush();
+    }
+}
+
+/**
+ * @brief Prints a block of lines with a single write.
+ * 
+ * @param lines The lines to print.
+ */
+void TerminalIO::printLines(std::span<const std::string> lines)
+{
+    std::size_t total = 0;
+
+    for (const auto &line : lines)
+    {
+        total += line.size() + 1;
+    }
+
+    out_buffer.reserve(out_buffer.size() + total);
+
+    for (const auto &line : lines)
+    {
+        out_buffer.append(line);
+        out_buffer.push_back('\n');
+    }
+
+    if (mode == OutputMode::Immediate || out_buffer.size() >= kFlushThreshold)
+    {
+        flush();
+    }
 }
 
 /**
  * @brief Prints an error message to the terminal.
  * 
+ * Pending standard output is flushed first so messages stay in order.
+ * 
  * @param error The error message to print.
  */
 void TerminalIO::printError(const std::string& error) 
 {
+    flush();
     std::cerr << error << std::endl;
 }
 
+/**
+ * @brief Writes any buffered output to stdout.
+ */
+void TerminalIO::flush()
+{
+    if (!out_buffer.empty())
+    {
+        std::cout.write(out_buffer.data(), static_cast<std::streamsize>(out_buffer.size()));
+        out_buffer.clear();
+    }
+
+    std::cout.flush();
+}
+
 /**
  * @brief Prompts the user for a line of input.
  * 
+ * Buffered output (typically the prompt) is flushed before blocking.
+ * 
  * @param line The line to store the input.
  * @return true if input was received, false if an error occurred.
  */
 bool TerminalIO::getLine(std::string& line) 
 {
+    flush();
     return static_cast<bool>(std::getline(std::cin, line));
 }
@@ -5,13 +5,14 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <thread>
 
 /**
  * @brief Construct a new TUIManager::TUIManager object
  * 
  */
 TUIManager::TUIManager()
-    : io_ptr(std::make_unique<TerminalIO>())
+    : io_ptr(std::make_unique<TerminalIO>(TerminalIO::OutputMode::Buffered))
 {
 }
 
@@ -185,13 +186,21 @@ commons::Result TUIManager::deleteMember(const uint64_t& member_id)
  */
 commons::Result TUIManager::deleteMembers(const std::vector<uint64_t>& member_ids)
 {
-    commons::Result final_res = commons::Result::Ok;
-    for (const auto& id : member_ids) 
+    std::vector<commons::Result> results;
+    commons::Result final_res = home_manager.deleteMembers(member_ids, &results);
+
+    if (final_res != commons::Result::Ok)
     {
-        commons::Result res = home_manager.deleteMember(id);
+        showError(final_res);
+        return final_res;
+    }
+
+    for (std::size_t index = 0; index < member_ids.size(); ++index) 
+    {
+        commons::Result res = results[index];
         if (res != commons::Result::Ok) 
         {
-            // print per-member error but continue attempting to delete others
+            // print per-member error; the other members are still deleted
             showError(res);
             if (final_res == commons::Result::Ok) 
             {
@@ -200,7 +209,7 @@ commons::Result TUIManager::deleteMembers(const std::vector<uint64_t>& member_id
         } 
         else 
         {
-            io_ptr->printLine("Member " + std::to_string(id) + " deleted.");
+            io_ptr->printLine("Member " + std::to_string(member_ids[index]) + " deleted.");
         }
     }
 
@@ -232,22 +241,29 @@ void TUIManager::run()
 
     while (running) 
     {
-        // Display menu
-        io_ptr->printLine("");
-        io_ptr->printLine("Select an option:");
-        io_ptr->printLine(" 1) Add Family");
-        io_ptr->printLine(" 2) Delete Family");
-        io_ptr->printLine(" 3) Add Member to Family");
-        io_ptr->printLine(" 4) Update Member");
-        io_ptr->printLine(" 5) Delete Member");
-        io_ptr->printLine(" 6) Delete Multiple Members");
-        io_ptr->printLine(" 7) List Families");
-        io_ptr->printLine(" 8) List Members of a Family");
-        io_ptr->printLine(" 9) Import Bank Statement for a Member");
-        io_ptr->printLine("10) Compute Member Net Worth");
-        io_ptr->printLine("11) Compute Family Net Worth");
-        io_ptr->printLine("12) Exit");
-        io_ptr->printLine("Choice: ");
+        // Display menu (one write; flushed when input is read)
+        static const std::string menu_lines[] =
+        {
+            "",
+            "Select an option:",
+            " 1) Add Family",
+            " 2) Delete Family",
+            " 3) Add Member to Family",
+            " 4) Update Member",
+            " 5) Delete Member",
+            " 6) Delete Multiple Members",
+            " 7) List Families",
+            " 8) List Members of a Family",
+            " 9) Import Bank Statement for a Member",
+            "10) Compute Member Net Worth",
+            "11) Compute Family Net Worth",
+            "12) Household Net Worth Report",
+            "13) Search Transactions",
+            "14) Exit",
+            "Choice: "
+        };
+
+        io_ptr->printLines(menu_lines);
 
         std::string line;
 
@@ -484,11 +500,16 @@ void TUIManager::run()
                 }
                 else
                 {
-                    io_ptr->printLine("Families:");
+                    std::vector<std::string> lines;
+                    lines.reserve(families.size() + 1);
+                    lines.push_back("Families:");
+
                     for (const auto& fam : families)
                     {
-                        io_ptr->printLine("  ID: " + std::to_string(fam.getId()) + " - " + fam.getName());
+                        lines.push_back("  ID: " + std::to_string(fam.getId()) + " - " + fam.getName());
                     }
+
+                    io_ptr->printLines(lines);
                 }
 
                 break;
@@ -518,7 +539,9 @@ void TUIManager::run()
                     }
                     else
                     {
-                        io_ptr->printLine("Members of family " + std::to_string(fid) + ":");
+                        std::vector<std::string> lines;
+                        lines.reserve(members.size() + 1);
+                        lines.push_back("Members of family " + std::to_string(fid) + ":");
 
                         for (const auto& mem : members)
                         {
@@ -529,8 +552,10 @@ void TUIManager::run()
                                 line += " (" + mem.getNickname() + ")";
                             }
 
-                            io_ptr->printLine(line);
+                            lines.push_back(std::move(line));
                         }
+
+                        io_ptr->printLines(lines);
                     }
                 } 
                 catch (...) 
@@ -616,12 +641,14 @@ void TUIManager::run()
 
                 commons::Result res = commons::Result::InvalidInput;
                 uint64_t outBankAccountId = 0;
+                uint64_t duplicates = 0;
+                ReconciliationReport report;
 
                 if (isNumeric) {
                     try {
                         uint64_t bankId = std::stoull(bankInput);
                         // Use HomeManager convenience overload which creates reader via ReaderFactory
-                        res = home_manager.importBankStatement(path, memberId, bankId, &outBankAccountId);
+                        res = home_manager.importBankStatement(path, memberId, bankId, &outBankAccountId, &report, &duplicates);
                     } catch (...) {
                         io_ptr->printLine("Invalid bank id.");
                         break;
@@ -629,13 +656,25 @@ void TUIManager::run()
                 } else {
                     // bankInput treated as name
                     // Let HomeManager and ReaderFactory handle selecting the reader by name
-                    res = home_manager.importBankStatement(path, memberId, bankInput, &outBankAccountId);
+                    res = home_manager.importBankStatement(path, memberId, bankInput, &outBankAccountId, &report, &duplicates);
                 }
 
-                if (res != commons::Result::Ok) {
+                if (res == commons::Result::Unreconciled) {
+                    showError(res);
+
+                    if (report.first_divergent_row) {
+                        io_ptr->printLine("First divergent transaction: line " + std::to_string(*report.first_divergent_row + 1) + " of the statement's transactions.");
+                    } else {
+                        io_ptr->printLine("Transactions add up to a closing balance of " + commons::formatPaise(report.expected_closing_paise) + ".");
+                    }
+                } else if (res != commons::Result::Ok) {
                     showError(res);
                 } else {
                     io_ptr->printLine("Bank account imported successfully. ID: " + std::to_string(outBankAccountId));
+
+                    if (duplicates) {
+                        io_ptr->printLine("Skipped " + std::to_string(duplicates) + " transaction line(s) already imported.");
+                    }
                 }
 
                 break;
@@ -749,6 +788,105 @@ void TUIManager::run()
                 break;
             }
 
+            case MenuOption::HouseholdNetWorthReport:
+            {
+                NetWorthSnapshot snapshot;
+                unsigned thread_count = std::max(1u, std::thread::hardware_concurrency());
+                commons::Result res = home_manager.computeAllNetWorths(&snapshot, thread_count);
+
+                if (res != commons::Result::Ok)
+                {
+                    showError(res);
+                    break;
+                }
+
+                if (snapshot.familyCount() == 0)
+                {
+                    io_ptr->printLine("No families found.");
+                    break;
+                }
+
+                std::vector<std::string> lines;
+                lines.reserve(snapshot.familyCount() + snapshot.memberCount() + 2);
+                lines.push_back("Household net worth report:");
+
+                for (std::size_t family_index = 0; family_index < snapshot.familyCount(); ++family_index)
+                {
+                    lines.push_back("  Family " + std::to_string(snapshot.family_ids[family_index]) +
+                                    " net worth: " + commons::formatPaise(snapshot.family_totals_paise[family_index]));
+
+                    for (std::size_t member_index = snapshot.family_member_offsets[family_index];
+                         member_index < snapshot.family_member_offsets[family_index + 1];
+                         ++member_index)
+                    {
+                        lines.push_back("    Member " + std::to_string(snapshot.member_ids[member_index]) +
+                                        " net worth: " + commons::formatPaise(snapshot.member_totals_paise[member_index]));
+                    }
+                }
+
+                lines.push_back("Household total: " + commons::formatPaise(snapshot.household_total_paise));
+                io_ptr->printLines(lines);
+
+                break;
+            }
+
+            case MenuOption::SearchTransactions:
+            {
+                // Enough to scan on one screen; refine the words to narrow it
+                constexpr std::size_t result_limit = 50;
+                io_ptr->printLine("Enter words to search for in narrations or counterparties: ");
+                std::string text;
+                io_ptr->getLine(text);
+
+                std::vector<TransactionMatch> matches;
+                commons::Result res = home_manager.searchTransactions(text, result_limit, &matches);
+
+                if (res != commons::Result::Ok)
+                {
+                    showError(res);
+                    break;
+                }
+
+                if (matches.empty())
+                {
+                    io_ptr->printLine("No matching transactions.");
+                    break;
+                }
+
+                // Category names for the matches; a failed lookup just omits them
+                std::vector<TransactionCategory> categories;
+                home_manager.listCategories(&categories);
+                std::vector<std::string> lines;
+                lines.reserve(matches.size());
+
+                for (const auto &match : matches)
+                {
+                    std::string line = commons::formatDate(match.transaction.date);
+                    line.append("  ").append(commons::formatPaise(match.transaction.amount_paise));
+                    line.append("  ").append(match.transaction.description);
+
+                    if (!match.transaction.counterparty.empty())
+                    {
+                        line.append(" [").append(match.transaction.counterparty).append("]");
+                    }
+
+                    auto category = std::find_if(categories.begin(), categories.end(), [&](const TransactionCategory &entry)
+                        { return entry.id == match.transaction.category_id; });
+
+                    if (category != categories.end())
+                    {
+                        line.append(" {").append(category->name).append("}");
+                    }
+
+                    line.append("  (member ").append(std::to_string(match.member_id));
+                    line.append(", account ").append(std::to_string(match.bank_account_id)).append(")");
+                    lines.push_back(std::move(line));
+                }
+
+                io_ptr->printLines(lines);
+                break;
+            }
+
             case MenuOption::Exit:
             {
                 running = false;
@@ -767,4 +905,5 @@ void TUIManager::run()
     }
 
     io_ptr->printLine("Goodbye.");
+    io_ptr->flush();
 }
@@ -52,6 +52,10 @@ std::string UIManager::errorMessage(const commons::Result& res)
 			return "Not found: the requested family/member does not exist.";
 		case commons::Result::DbError:
 			return "Internal error: data storage operation failed. Try again or contact support.";
+		case commons::Result::Overflow:
+			return "Overflow: the total is too large to represent.";
+		case commons::Result::Unreconciled:
+			return "Statement does not reconcile: the opening balance plus its transactions does not match the balances it states.";
 		default:
 			return "An unknown error occurred.";
 	}
@@ -1,4 +1,8 @@
 #include "bank_account.hpp"
+#include "account_key.hpp"
+#include "family.hpp"
+#include <type_traits>
+#include <unordered_set>
 #include <gtest/gtest.h>
 
 TEST(BankAccountTest, PaiseToRupees)
@@ -32,6 +36,48 @@ TEST(BankAccountTest, NormalizeAccountNumber)
     EXPECT_EQ(BankAccount::normalizeAccountNumber("Acc\tNum-99"), "ACCNUM99");
 }
 
+TEST(BankAccountTest, AccountKeyPacksNormalizedNumber)
+{
+    auto key = AccountKey::fromAccountNumber("abc 123-xyz");
+    ASSERT_TRUE(key.has_value());
+    EXPECT_EQ(key->toString(), BankAccount::normalizeAccountNumber("abc 123-xyz"));
+    EXPECT_EQ(key->length(), 9u);
+    EXPECT_EQ(key, AccountKey::fromAccountNumber("ABC-123 XYZ"));
+    EXPECT_NE(key, AccountKey::fromAccountNumber("ABC123XY"));
+    EXPECT_NE(key, AccountKey::fromAccountNumber("ABC123XYZ0"));
+
+    std::string longest(AccountKey::kMaxLength, '9');
+    ASSERT_TRUE(AccountKey::fromAccountNumber(longest).has_value());
+    EXPECT_EQ(AccountKey::fromAccountNumber(longest)->toString(), longest);
+    EXPECT_FALSE(AccountKey::fromAccountNumber(longest + "9").has_value());
+    EXPECT_FALSE(AccountKey::fromAccountNumber("ACC#1").has_value());
+
+    std::unordered_set<AccountKey> distinct_keys;
+
+    for (const char* raw : {"0012 3456", "00123456", "0012-3456", "0012345"})
+    {
+        distinct_keys.insert(*AccountKey::fromAccountNumber(raw));
+    }
+
+    EXPECT_EQ(distinct_keys.size(), 2u);
+}
+
+TEST(BankAccountTest, EqualityUsesKeyOrNormalizedFallback)
+{
+    BankAccount spaced(1, 2, 3, "abc 123", 5, 6);
+    BankAccount plain(1, 2, 3, "ABC123", 5, 6);
+    EXPECT_TRUE(spaced.getAccountKey().has_value());
+    EXPECT_TRUE(spaced == plain);
+
+    plain.setAccountNumber("ABC124");
+    EXPECT_FALSE(spaced == plain);
+
+    BankAccount odd_a(1, 2, 3, "acc#1 2", 5, 6);
+    BankAccount odd_b(1, 2, 3, "ACC#12", 5, 6);
+    EXPECT_FALSE(odd_a.getAccountKey().has_value());
+    EXPECT_TRUE(odd_a == odd_b);
+}
+
 TEST(BankAccountTest, ValueEqualityByAccessors)
 {
     BankAccount bankA(1, 2, 3, "001", 500, 600);
@@ -48,3 +94,50 @@ TEST(BankAccountTest, InequalityDifferentBalances)
     EXPECT_FALSE(bankC == bankD);
     EXPECT_TRUE(bankC != bankD);
 }
+
+TEST(BankAccountTest, DomainModelIsMovable)
+{
+    static_assert(std::is_nothrow_move_constructible_v<BankAccount>);
+    static_assert(std::is_nothrow_move_constructible_v<Member>);
+    static_assert(std::is_nothrow_move_constructible_v<Family>);
+
+    Family family(7, "Moved");
+    family.reserveMembers(2);
+    family.emplaceMember(1, "Asha", "A");
+    family.addMember(Member(2, "Bala"));
+
+    // Accessors hand out views of the stored data rather than copies
+    const Member* first = &family.getMembers().front();
+    Family moved(std::move(family));
+    EXPECT_EQ(&moved.getMembers().front(), first);
+    EXPECT_EQ(moved.getMembers()[1].getName(), "Bala");
+}
+
+TEST(FamilyTest, IndexedLookupTracksAddAndRemove)
+{
+    Family family(1, "Indexed");
+
+    // Out-of-order IDs and unsaved members (ID 0) mixed in
+    for (uint64_t member_id : {5u, 3u, 9u, 0u, 7u, 0u})
+    {
+        family.emplaceMember(member_id, "M" + std::to_string(member_id), "");
+    }
+
+    ASSERT_NE(family.getMember(3), nullptr);
+    EXPECT_EQ(family.getMember(3)->getName(), "M3");
+    EXPECT_EQ(family.getMember(0), &family.getMembers()[3]);
+    EXPECT_EQ(family.getMember(4), nullptr);
+
+    EXPECT_TRUE(family.removeMember(5));
+    EXPECT_FALSE(family.removeMember(5));
+    EXPECT_TRUE(family.removeMember(0));
+    ASSERT_EQ(family.getMembers().size(), 3u);
+
+    // Positions shifted after the erase; the index follows them
+    EXPECT_EQ(family.getMember(9)->getName(), "M9");
+    EXPECT_EQ(family.getMember(7), &family.getMembers()[2]);
+
+    family.addMember(Member(4, "M4"));
+    const Family& view = family;
+    EXPECT_EQ(view.getMember(4)->getName(), "M4");
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "cli_manager.hpp"
+#include "memory_storage.hpp"
+#include "mock_io.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * Test fixture for CLIManager: an in-memory HomeManager and MockIO so each
+ * subcommand can be checked without a database file or a terminal.
+ */
+class CLIManagerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        auto io = std::make_unique<MockIO>();
+        auto home = std::make_unique<HomeManager>(std::make_unique<MemoryStorage>());
+        io_raw = io.get();
+        home_raw = home.get();
+        cli = std::make_unique<CLIManager>(std::move(io), std::move(home));
+    }
+
+    int run(const std::vector<std::string>& args)
+    {
+        io_raw->clear();
+        return cli->run(args);
+    }
+
+    MockIO* io_raw{nullptr};
+    HomeManager* home_raw{nullptr};
+    std::unique_ptr<CLIManager> cli;
+};
+
+TEST_F(CLIManagerTest, AddAndListFamiliesAsTsv)
+{
+    ASSERT_EQ(run({"add", "family", "Kumar", "--format=tsv"}), 0);
+    ASSERT_EQ(io_raw->getOutput().size(), 1u);
+    std::string family_id = io_raw->getOutput().front();
+
+    ASSERT_EQ(run({"add", "member", "--family", family_id, "Anil", "Ani", "--format", "tsv"}), 0);
+
+    ASSERT_EQ(run({"list", "families", "--format=tsv"}), 0);
+    ASSERT_EQ(io_raw->getOutput().size(), 1u);
+    EXPECT_EQ(io_raw->getOutput().front(), family_id + "\tKumar");
+
+    ASSERT_EQ(run({"list", "members", "--family=" + family_id, "--format=tsv"}), 0);
+    ASSERT_EQ(io_raw->getOutput().size(), 1u);
+    EXPECT_NE(io_raw->getOutput().front().find("\tAnil\tAni"), std::string::npos);
+}
+
+TEST_F(CLIManagerTest, ImportSeveralFilesThenNetWorth)
+{
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    ASSERT_EQ(home_raw->addFamily(Family("Rao"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(home_raw->addMemberToFamily(Member("Ravi", ""), family_id, &member_id), commons::Result::Ok);
+
+    auto csv1 = std::filesystem::temp_directory_path() / "cli_canara1.csv";
+    auto csv2 = std::filesystem::temp_directory_path() / "cli_canara2.csv";
+
+    {
+        std::ofstream ofs(csv1);
+        ofs << "Account Number,=\"500012456\"\n";
+        ofs << "Opening Balance,\"Rs.1,000.00\"\n";
+        ofs << "Closing Balance,\"Rs.1,500.25\"\n";
+    }
+
+    {
+        std::ofstream ofs(csv2);
+        ofs << "Account Number,=\"600012456\"\n";
+        ofs << "Opening Balance,\"Rs.0.00\"\n";
+        ofs << "Closing Balance,\"Rs.499.75\"\n";
+    }
+
+    EXPECT_EQ(run({"import", "--member", std::to_string(member_id), "--bank", "canara",
+                   csv1.string(), csv2.string(), "--format=tsv"}), 0);
+    EXPECT_EQ(io_raw->getOutput().size(), 2u);
+
+    EXPECT_EQ(run({"networth", "--family", std::to_string(family_id), "--format=tsv"}), 0);
+    ASSERT_EQ(io_raw->getOutput().size(), 1u);
+    EXPECT_EQ(io_raw->getOutput().front(), "family\t" + std::to_string(family_id) + "\t200000");
+
+    EXPECT_EQ(run({"networth", "--member", std::to_string(member_id)}), 0);
+    EXPECT_EQ(io_raw->getOutput().front(), "Member " + std::to_string(member_id) + " net worth: 2000.00");
+
+    // A missing file fails on its own without stopping the others
+    EXPECT_EQ(run({"import", "--member", std::to_string(member_id), "--bank", "canara",
+                   "/nonexistent/statement.csv", csv1.string()}), 1);
+    EXPECT_EQ(io_raw->getErrors().size(), 1u);
+    EXPECT_EQ(io_raw->getOutput().size(), 1u);
+
+    std::filesystem::remove(csv1);
+    std::filesystem::remove(csv2);
+}
+
+TEST_F(CLIManagerTest, UsageErrorsReturnTwo)
+{
+    EXPECT_EQ(run({"networth"}), 2);
+    EXPECT_EQ(run({"networth", "--family", "abc"}), 2);
+    EXPECT_EQ(run({"list", "families", "--bogus"}), 2);
+    EXPECT_EQ(run({"list", "families", "--format=xml"}), 2);
+    EXPECT_EQ(run({"import", "--member", "1", "--bank", "canara"}), 2);
+
+    // --db is meaningless for the in-memory backend
+    EXPECT_EQ(run({"list", "families", "--db", "/tmp/x.db"}), 1);
+    EXPECT_EQ(run({"networth", "--family", "42"}), 1);
+}
+
+TEST_F(CLIManagerTest, CategoryRulesLoadListAndRecategorize)
+{
+    auto rules_path = std::filesystem::temp_directory_path() / "cli_category_rules.csv";
+
+    {
+        std::ofstream ofs(rules_path);
+        ofs << "Category,Keyword,Priority\n";
+        ofs << "# utilities\n";
+        ofs << "Electricity, bescom\n";
+        ofs << "EMI,home loan,5\n";
+    }
+
+    ASSERT_EQ(run({"categories", "load", rules_path.string(), "--format=tsv"}), 0);
+    EXPECT_EQ(io_raw->getOutput().front(), "2");
+
+    ASSERT_EQ(run({"categories", "list", "--format=tsv"}), 0);
+    ASSERT_EQ(io_raw->getOutput().size(), 9u);
+    EXPECT_EQ(io_raw->getOutput()[7], "8\tElectricity\tbescom\t0");
+    EXPECT_EQ(io_raw->getOutput()[8], "9\tEMI\thome loan\t5");
+
+    // Loading the file again adds nothing
+    ASSERT_EQ(run({"categories", "load", rules_path.string(), "--format=tsv"}), 0);
+    EXPECT_EQ(io_raw->getOutput().front(), "0");
+    ASSERT_EQ(run({"categories", "list", "--format=tsv"}), 0);
+    EXPECT_EQ(io_raw->getOutput().size(), 9u);
+
+    ASSERT_EQ(run({"categories", "add", "Fuel", "indian oil", "--priority", "2", "--format=tsv"}), 0);
+    EXPECT_EQ(io_raw->getOutput().front(), "10");
+    EXPECT_EQ(run({"categories", "delete", "10"}), 0);
+    EXPECT_EQ(run({"categories", "delete", "10"}), 1);
+    EXPECT_EQ(run({"categories", "add", "Fuel", "--priority", "high"}), 2);
+    EXPECT_EQ(run({"categories", "recategorize", "--format=tsv"}), 0);
+    EXPECT_EQ(io_raw->getOutput().front(), "0");
+
+    // A malformed line rejects the whole file
+    {
+        std::ofstream ofs(rules_path);
+        ofs << "Fuel,petrol\n";
+        ofs << "Fuel,diesel,soon\n";
+    }
+
+    EXPECT_EQ(run({"categories", "load", rules_path.string()}), 1);
+    ASSERT_EQ(run({"categories", "list"}), 0);
+    EXPECT_EQ(io_raw->getOutput().size(), 9u);
+    std::filesystem::remove(rules_path);
+}
+
+/**
+ * --startup-time opens the database named by --db, wherever the two flags
+ * appear on the command line. Runs the application binary itself.
+ */
+TEST(StartupTimeTest, HonoursDbGivenAfterTheFlag)
+{
+    auto db_path = std::filesystem::temp_directory_path() / "startup_time_test.db";
+    auto output_path = std::filesystem::temp_directory_path() / "startup_time_test.out";
+    std::filesystem::remove(db_path);
+
+    const std::string command = std::string("\"") + HOME_FINANCIALS_BINARY + "\" --startup-time --db \"" +
+                                db_path.string() + "\" > \"" + output_path.string() + "\"";
+    ASSERT_EQ(std::system(command.c_str()), 0);
+    EXPECT_TRUE(std::filesystem::exists(db_path));
+
+    std::ifstream output(output_path);
+    std::string line;
+    ASSERT_TRUE(std::getline(output, line));
+    EXPECT_EQ(line.rfind("Startup time: ", 0), 0u);
+
+    std::filesystem::remove(db_path);
+    std::filesystem::remove(std::filesystem::path(db_path.string() + "-wal"));
+    std::filesystem::remove(std::filesystem::path(db_path.string() + "-shm"));
+    std::filesystem::remove(output_path);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,5 +1,15 @@
 #include <gtest/gtest.h>
+#include "bank_transaction.hpp"
+#include "bloom_filter.hpp"
+#include "category_matcher.hpp"
 #include "commons.hpp"
+#include "string_interner.hpp"
+#include "statement_reconciliation.hpp"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 TEST(ParseMoneyToPaise, BasicFormats)
 {
@@ -25,3 +35,269 @@ TEST(ParseMoneyToPaise, NegativeAndMalformed)
     auto bad = commons::parseMoneyToPaise("not a number");
     EXPECT_FALSE(bad.has_value());
 }
+
+TEST(CheckedAccumulator, DetectsOverflowAndSaturates)
+{
+    commons::CheckedAccumulator accumulator;
+    accumulator.add(std::numeric_limits<long long>::max());
+    accumulator.add(1);
+
+    long long total = 0;
+    EXPECT_FALSE(accumulator.fits());
+    EXPECT_EQ(accumulator.toPaise(&total), commons::Result::Overflow);
+    EXPECT_EQ(total, std::numeric_limits<long long>::max());
+
+    // Coming back into range is still exact because intermediates are 128-bit
+    accumulator.add(-2);
+    EXPECT_EQ(accumulator.toPaise(&total), commons::Result::Ok);
+    EXPECT_EQ(total, std::numeric_limits<long long>::max() - 1);
+
+    commons::CheckedAccumulator negative;
+    negative.add(std::numeric_limits<long long>::min());
+    negative.add(-1);
+    EXPECT_EQ(negative.saturated(), std::numeric_limits<long long>::min());
+}
+
+TEST(CheckedAccumulator, VectorisedSumMatchesScalar)
+{
+    std::vector<long long> values;
+
+    for (long long index = 0; index < 1000; ++index)
+    {
+        values.push_back((index % 7 == 0 ? -1 : 1) * index * 123456789ll);
+    }
+
+    values.push_back(std::numeric_limits<long long>::max());
+    values.push_back(std::numeric_limits<long long>::min());
+    values.push_back(-1);
+
+    commons::CheckedAccumulator scalar;
+
+    for (long long value : values)
+    {
+        scalar.add(value);
+    }
+
+    commons::CheckedAccumulator vectorised;
+    vectorised.addAll(values);
+    EXPECT_TRUE(vectorised.wide() == scalar.wide());
+
+    long long total = 0;
+    EXPECT_EQ(commons::sumPaise(values, &total), commons::Result::Ok);
+    EXPECT_EQ(total, scalar.saturated());
+
+    // Two maxima do not fit
+    std::vector<long long> too_large{std::numeric_limits<long long>::max(), std::numeric_limits<long long>::max()};
+    EXPECT_EQ(commons::sumPaise(too_large, &total), commons::Result::Overflow);
+}
+
+TEST(ParseDate, StatementFormats)
+{
+    using namespace std::chrono;
+    const commons::Date expected = 2024y / April / 30d;
+
+    for (const char* text : {"2024-04-30", "30-04-2024", "30/04/2024", "30-Apr-2024", "30 APR 2024"})
+    {
+        auto parsed = commons::parseDate(text);
+        ASSERT_TRUE(parsed.has_value()) << text;
+        EXPECT_EQ(*parsed, expected) << text;
+    }
+
+    EXPECT_FALSE(commons::parseDate("31-04-2024").has_value());
+    EXPECT_FALSE(commons::parseDate("2024/04/30").has_value());
+    EXPECT_FALSE(commons::parseDate("30-Foo-2024").has_value());
+    EXPECT_FALSE(commons::parseDate("").has_value());
+    EXPECT_EQ(commons::formatDate(2024y / March / 5d), "2024-03-05");
+}
+
+TEST(StringInterner, EqualNamesShareOneHandle)
+{
+    commons::StringInterner interner;
+    EXPECT_EQ(interner.intern(""), commons::StringInterner::kEmpty);
+
+    commons::NameHandle canara = interner.intern("Canara");
+    std::string_view stored = interner.view(canara);
+
+    // Enough distinct strings to grow the table many times over
+    for (int index = 0; index < 1000; ++index)
+    {
+        interner.intern("Member " + std::to_string(index));
+    }
+
+    EXPECT_EQ(interner.intern(std::string("Canara")), canara);
+    EXPECT_EQ(interner.view(canara).data(), stored.data());
+    EXPECT_EQ(interner.size(), 1002u);
+    EXPECT_EQ(interner.find("Member 999"), interner.intern("Member 999"));
+    EXPECT_FALSE(interner.find("SBI").has_value());
+
+    interner.clear();
+    EXPECT_EQ(interner.size(), 1u);
+    EXPECT_FALSE(interner.find("Canara").has_value());
+}
+
+TEST(StringInterner, MovedTableKeepsItsViews)
+{
+    static_assert(!std::is_copy_constructible_v<commons::StringInterner>);
+    static_assert(!std::is_copy_assignable_v<commons::StringInterner>);
+
+    auto source = std::make_unique<commons::StringInterner>();
+    commons::NameHandle rao = source->intern("Rao");
+    commons::NameHandle iyer = source->intern("Iyer");
+    std::string_view stored = source->view(iyer);
+
+    commons::StringInterner moved(std::move(*source));
+    commons::StringInterner assigned;
+    assigned.intern("Stale");
+    assigned = std::move(moved);
+    source.reset();
+
+    EXPECT_EQ(assigned.find("Rao"), rao);
+    EXPECT_EQ(assigned.intern("Iyer"), iyer);
+    EXPECT_EQ(assigned.view(iyer).data(), stored.data());
+    EXPECT_FALSE(assigned.find("Stale").has_value());
+    EXPECT_EQ(assigned.size(), 3u);
+}
+
+TEST(ReconcileStatement, FindsFirstDivergentRunningBalance)
+{
+    // Long enough to cross several blocks of the kernel
+    const std::size_t rows = 5000;
+    std::vector<long long> amounts(rows);
+    std::vector<long long> balances(rows);
+    long long balance = 100000;
+
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        amounts[row] = (row % 3 == 0) ? -1234 : 2500;
+        balance += amounts[row];
+        balances[row] = balance;
+    }
+
+    ReconciliationReport report;
+    ASSERT_EQ(reconcileStatement(100000, balance, amounts, balances, &report), commons::Result::Ok);
+    EXPECT_TRUE(report.balanced);
+    EXPECT_EQ(report.expected_closing_paise, balance);
+    EXPECT_FALSE(report.first_divergent_row.has_value());
+
+    // A mis-parsed amount shows up at its own row, not at the end
+    amounts[3071] += 1;
+    ASSERT_EQ(reconcileStatement(100000, balance, amounts, balances, &report), commons::Result::Ok);
+    EXPECT_FALSE(report.balanced);
+    EXPECT_EQ(report.first_divergent_row, std::optional<std::size_t>(3071));
+    amounts[3071] -= 1;
+
+    // The first row is checked against the opening balance
+    ASSERT_EQ(reconcileStatement(99999, balance, amounts, balances, &report), commons::Result::Ok);
+    EXPECT_EQ(report.first_divergent_row, std::optional<std::size_t>(0));
+
+    // Without running balances only the closing balance can be checked
+    ASSERT_EQ(reconcileStatement(100000, balance + 1, amounts, {}, &report), commons::Result::Ok);
+    EXPECT_FALSE(report.balanced);
+    EXPECT_FALSE(report.first_divergent_row.has_value());
+
+    EXPECT_EQ(reconcileStatement(100000, balance, amounts, std::span<const long long>(balances).first(10), &report),
+              commons::Result::InvalidInput);
+    const std::vector<long long> huge = {std::numeric_limits<long long>::max()};
+    EXPECT_EQ(reconcileStatement(1, 0, huge, {}, &report), commons::Result::Overflow);
+}
+
+TEST(BloomFilter, NoFalseNegativesAndFewFalsePositives)
+{
+    const uint64_t keys = 100000;
+    const std::vector<BankTransaction> lines(keys, BankTransaction{});
+    std::vector<uint64_t> fingerprints = transactionFingerprints(7, lines);
+
+    commons::BloomFilter filter;
+    EXPECT_FALSE(filter.mayContain(fingerprints[0]));
+    filter.reset(keys);
+
+    for (uint64_t fingerprint : fingerprints)
+    {
+        filter.insert(fingerprint);
+    }
+
+    EXPECT_EQ(filter.size(), keys);
+    EXPECT_TRUE(std::all_of(fingerprints.begin(), fingerprints.end(), [&](uint64_t key) { return filter.mayContain(key); }));
+
+    // Identical lines on another account are fresh keys: about 1% collide
+    std::vector<uint64_t> others = transactionFingerprints(8, lines);
+    auto false_positives = std::count_if(others.begin(), others.end(), [&](uint64_t key) { return filter.mayContain(key); });
+    EXPECT_LT(false_positives, static_cast<std::ptrdiff_t>(keys / 50));
+}
+
+TEST(TransactionFingerprints, RepeatedLinesGetDistinctOccurrences)
+{
+    using namespace std::chrono;
+    const std::vector<BankTransaction> statement = {
+        {2024y / February / 3d, "Tea stall", -20, "", 49980},
+        {2024y / February / 3d, "Tea stall", -20, "", 49980},
+        {2024y / February / 3d, "Tea stall", -20, "", 49960},
+        {2024y / February / 3d, "Tea stall", -20},
+    };
+    std::vector<uint64_t> fingerprints = transactionFingerprints(1, statement);
+    std::vector<uint64_t> sorted = fingerprints;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(std::adjacent_find(sorted.begin(), sorted.end()), sorted.end());
+
+    // Stable across calls, and the first occurrence does not depend on what follows
+    EXPECT_EQ(transactionFingerprints(1, statement), fingerprints);
+    EXPECT_EQ(transactionFingerprints(1, std::span(statement).first(1))[0], fingerprints[0]);
+    EXPECT_NE(transactionFingerprints(2, statement)[0], fingerprints[0]);
+}
+
+TEST(CategoryMatcher, WholeWordsWithPriorityThenLength)
+{
+    const std::vector<CategoryRule> rules = {
+        {1, 10, "rent"},
+        {2, 20, "emi"},
+        {3, 30, "home loan emi", 0},
+        {4, 40, "salary"},
+        {5, 50, "salary arrears", 0},
+        {6, 60, "neft", -1},
+        {7, 70, "  "},
+    };
+    CategoryMatcher matcher;
+    EXPECT_EQ(matcher.categorize("RENT"), 0u);
+    matcher.compile(rules);
+    EXPECT_EQ(matcher.ruleCount(), 6u);
+
+    EXPECT_EQ(matcher.categorize("UPI/DR/HOUSE RENT/APR"), 10u);
+    EXPECT_EQ(matcher.categorize("Current account fee"), 0u);
+    EXPECT_EQ(matcher.categorize("Rental income"), 0u);
+    EXPECT_EQ(matcher.categorize("PREMIUM"), 0u);
+
+    // Keyword words match across any run of separators; longest keyword wins
+    EXPECT_EQ(matcher.categorize("ACH/HOME-LOAN//EMI 42"), 30u);
+    EXPECT_EQ(matcher.categorize("EMI 42"), 20u);
+    EXPECT_EQ(matcher.categorize("NEFT SALARY ARREARS"), 50u);
+    EXPECT_EQ(matcher.categorize("NEFT-SALARY"), 40u);
+    EXPECT_EQ(matcher.categorize("NEFT"), 60u);
+
+    // A higher priority beats a longer keyword; equal rules go to the older one
+    std::vector<CategoryRule> boosted = rules;
+    boosted.push_back({8, 80, "neft", 9});
+    boosted.push_back({9, 90, "rent"});
+    matcher.compile(boosted);
+    EXPECT_EQ(matcher.categorize("NEFT SALARY ARREARS"), 80u);
+    EXPECT_EQ(matcher.categorize("rent"), 10u);
+}
+
+TEST(CategoryMatcher, ThousandsOfRulesStayExact)
+{
+    std::vector<CategoryRule> rules;
+
+    for (uint64_t index = 1; index <= 5000; ++index)
+    {
+        rules.push_back({index, index, "merchant" + std::to_string(index)});
+    }
+
+    CategoryMatcher matcher;
+    matcher.compile(rules);
+
+    for (uint64_t index = 1; index <= 5000; index += 499)
+    {
+        EXPECT_EQ(matcher.categorize("POS/MERCHANT" + std::to_string(index) + "/BLR"), index);
+    }
+
+    EXPECT_EQ(matcher.categorize("POS/MERCHANT50000/BLR"), 0u);
+}
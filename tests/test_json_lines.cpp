@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "json_value.hpp"
+#include "json_lines_server.hpp"
+#include "memory_storage.hpp"
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+
+
+TEST(JsonValueTest, ParsesAndDumpsRoundTrip)
+{
+    auto value = JsonValue::parse(R"( {"id": 18446744073709551615, "neg": -12, "s": "a\"b\\c\u00e9\ud83d\ude00", "arr": [true, false, null, 1.5e3], "o": {}} )");
+    ASSERT_TRUE(value.has_value());
+
+    EXPECT_EQ(value->find("id")->asUint64(), 18446744073709551615ull);
+    EXPECT_EQ(value->find("neg")->asInt64(), -12);
+    EXPECT_FALSE(value->find("neg")->asUint64().has_value());
+    EXPECT_EQ(value->find("s")->asString(), std::string("a\"b\\c\xC3\xA9\xF0\x9F\x98\x80"));
+    EXPECT_EQ(value->find("arr")->items().size(), 4u);
+    EXPECT_FALSE(value->find("arr")->items()[3].asInt64().has_value());
+    EXPECT_EQ(value->find("missing"), nullptr);
+
+    auto reparsed = JsonValue::parse(value->dump());
+    ASSERT_TRUE(reparsed.has_value());
+    EXPECT_EQ(reparsed->dump(), value->dump());
+}
+
+TEST(JsonValueTest, RejectsMalformedInput)
+{
+    const char* bad_inputs[] = {"", "{", "{\"a\":}", "[1,]", "01", "\"unterminated", "{} trailing",
+                                "tru", "\"\\x\"", "\"\\ud800\"", "-", "1."};
+
+    for (const char* input : bad_inputs)
+    {
+        EXPECT_FALSE(JsonValue::parse(input).has_value()) << input;
+    }
+
+    std::string deep(1000, '[');
+    EXPECT_FALSE(JsonValue::parse(deep).has_value());
+}
+
+/**
+ * Pipelined requests on several workers: every request gets exactly one
+ * response, tagged with its id.
+ */
+TEST(JsonLinesServerTest, PipelinedRequestsAreAllAnswered)
+{
+    HomeManager home(std::make_unique<MemoryStorage>());
+    uint64_t family_id = 0;
+    ASSERT_EQ(home.addFamily(Family("Seed"), &family_id), commons::Result::Ok);
+
+    std::ostringstream requests;
+    const int request_count = 200;
+
+    for (int index = 0; index < request_count; ++index)
+    {
+        if (index % 2 == 0)
+        {
+            requests << R"({"id":)" << index << R"(,"method":"addMember","params":{"family_id":)" << family_id
+                     << R"(,"name":"M)" << index << R"("}})" << "\n";
+        }
+        else
+        {
+            requests << R"({"id":)" << index << R"(,"method":"listFamilies"})" << "\n";
+        }
+    }
+
+    requests << "not json\n";
+
+    std::istringstream in(requests.str());
+    std::ostringstream out;
+    JsonLinesServer server(home, in, out, 4);
+    server.run();
+
+    std::istringstream responses(out.str());
+    std::string line;
+    std::set<long long> seen_ids;
+    int malformed = 0;
+
+    while (std::getline(responses, line))
+    {
+        auto response = JsonValue::parse(line);
+        ASSERT_TRUE(response.has_value()) << line;
+
+        if (response->find("id")->isNull())
+        {
+            EXPECT_EQ(response->find("error")->asString(), std::string("InvalidInput"));
+            ++malformed;
+            continue;
+        }
+
+        EXPECT_EQ(response->find("ok")->asBool(), true) << line;
+        seen_ids.insert(*response->find("id")->asInt64());
+    }
+
+    EXPECT_EQ(seen_ids.size(), static_cast<std::size_t>(request_count));
+    EXPECT_EQ(malformed, 1);
+    EXPECT_EQ(home.listMembersOfFamily(family_id).size(), static_cast<std::size_t>(request_count / 2));
+}
+
+TEST(JsonLinesServerTest, ErrorsCarryResultName)
+{
+    HomeManager home(std::make_unique<MemoryStorage>());
+    RequestDispatcher dispatcher(home);
+
+    auto response = JsonValue::parse(dispatcher.handleLine(R"({"id":"a","method":"networth","params":{"member_id":5}})"));
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->find("id")->asString(), std::string("a"));
+    EXPECT_EQ(response->find("ok")->asBool(), false);
+    EXPECT_EQ(response->find("error")->asString(), std::string("NotFound"));
+
+    response = JsonValue::parse(dispatcher.handleLine(R"({"id":2,"method":"frobnicate"})"));
+    EXPECT_EQ(response->find("error")->asString(), std::string("InvalidInput"));
+
+    response = JsonValue::parse(dispatcher.handleLine(R"({"id":3,"method":"addMember","params":{"family_id":-1,"name":"X"}})"));
+    EXPECT_EQ(response->find("error")->asString(), std::string("InvalidInput"));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,722 @@
+#include <gtest/gtest.h>
+#include "memory_storage.hpp"
+#include "home_manager.hpp"
+#include "bank_account.hpp"
+#include "family.hpp"
+#include "member.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+
+
+/**
+ * Basic CRUD against the in-memory engine, mirroring the SQLite behaviour.
+ */
+TEST(MemoryStorageTest, SaveGetUpdateDelete)
+{
+    MemoryStorage storage;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Kumar"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("Anil", "Ani"), family_id, &member_id), commons::Result::Ok);
+    EXPECT_EQ(storage.saveMemberDataEx(Member("Ghost", ""), family_id + 1), commons::Result::NotFound);
+    EXPECT_EQ(storage.saveFamilyDataEx(Family("")), commons::Result::InvalidInput);
+
+    std::unique_ptr<Member> member(storage.getMemberData(member_id));
+    ASSERT_NE(member, nullptr);
+    EXPECT_EQ(member->getId(), member_id);
+    EXPECT_EQ(member->getName(), "Anil");
+
+    std::unique_ptr<Family> family(storage.getFamilyData(family_id));
+    ASSERT_NE(family, nullptr);
+    EXPECT_EQ(family->getId(), family_id);
+    ASSERT_EQ(family->getMembers().size(), 1u);
+
+    EXPECT_EQ(storage.updateMemberDataEx(member_id, "", "AK"), commons::Result::Ok);
+    member.reset(storage.getMemberData(member_id));
+    EXPECT_EQ(member->getName(), "Anil");
+    EXPECT_EQ(member->getNickname(), "AK");
+
+    EXPECT_EQ(storage.updateFamilyDataEx(family_id, "Sharma"), commons::Result::Ok);
+    EXPECT_EQ(storage.listFamilies().front().getName(), "Sharma");
+
+    EXPECT_EQ(storage.deleteMemberDataEx(member_id), commons::Result::Ok);
+    EXPECT_EQ(storage.deleteMemberDataEx(member_id), commons::Result::NotFound);
+    EXPECT_EQ(storage.getMemberCount(family_id), 0u);
+}
+
+/**
+ * Deleting a family removes its members and their bank accounts.
+ */
+TEST(MemoryStorageTest, DeleteFamilyCascades)
+{
+    MemoryStorage storage;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    uint64_t bank_id = 0;
+    uint64_t account_id = 0;
+
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Rao"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("Ravi", ""), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage.getBankIdByName("canara", &bank_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(bank_id, member_id, "1234", 100, 250, &account_id), commons::Result::Ok);
+
+    EXPECT_EQ(storage.deleteFamilyDataEx(family_id), commons::Result::Ok);
+    EXPECT_EQ(storage.getMemberData(member_id), nullptr);
+
+    BankAccount account;
+    EXPECT_EQ(storage.getBankAccountById(account_id, &account), commons::Result::NotFound);
+    EXPECT_TRUE(storage.listBankAccountsOfMember(member_id).empty());
+}
+
+TEST(MemoryStorageTest, BatchDeleteAndLookupMatchSqliteSemantics)
+{
+    MemoryStorage storage;
+    uint64_t family_id = 0;
+    uint64_t first_id = 0;
+    uint64_t second_id = 0;
+
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Iyer"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("Uma", ""), family_id, &first_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("Vik", ""), family_id, &second_id), commons::Result::Ok);
+
+    std::vector<commons::Result> results;
+    ASSERT_EQ(storage.deleteMembersEx({first_id, 999, first_id}, &results), commons::Result::Ok);
+
+    std::vector<commons::Result> expected = {commons::Result::Ok, commons::Result::NotFound, commons::Result::NotFound};
+    EXPECT_EQ(results, expected);
+    EXPECT_EQ(storage.getMemberCount(family_id), 1u);
+
+    std::vector<uint64_t> lookup_ids = {second_id, first_id, second_id};
+    std::vector<std::optional<Member>> members;
+    ASSERT_EQ(storage.getMembersEx(lookup_ids, &members), commons::Result::Ok);
+    ASSERT_EQ(members.size(), 3u);
+    EXPECT_EQ(members[0]->getName(), "Vik");
+    EXPECT_FALSE(members[1].has_value());
+    EXPECT_EQ(members[2]->getId(), second_id);
+}
+
+/**
+ * A snapshot reloads into an identical store; garbage files are rejected.
+ */
+TEST(MemoryStorageTest, SnapshotRoundTrip)
+{
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_snapshot_test.bin";
+    MemoryStorage original;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+
+    ASSERT_EQ(original.saveFamilyDataEx(Family("Iyer"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(original.saveMemberDataEx(Member("Meera", "Mee"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(original.saveBankAccountEx(2, member_id, "9876", 0, 5000), commons::Result::Ok);
+    ASSERT_EQ(original.saveSnapshot(path.string()), commons::Result::Ok);
+
+    MemoryStorage restored;
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+
+    auto accounts = restored.listBankAccountsOfMember(member_id);
+    ASSERT_EQ(accounts.size(), 1u);
+    EXPECT_EQ(accounts.front().getClosingBalancePaise(), 5000);
+    EXPECT_EQ(restored.listMembersOfFamily(family_id).front().getNickname(), "Mee");
+
+    // New rows continue after the restored IDs
+    uint64_t next_family_id = 0;
+    ASSERT_EQ(restored.saveFamilyDataEx(Family("Next"), &next_family_id), commons::Result::Ok);
+    EXPECT_GT(next_family_id, family_id);
+
+    {
+        std::ofstream garbage(path, std::ios::binary | std::ios::trunc);
+        garbage << "not a snapshot";
+    }
+
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    EXPECT_EQ(restored.listFamilies().size(), 2u);
+    std::filesystem::remove(path);
+}
+
+/**
+ * Balance history answers as-of queries like the SQLite backend and
+ * survives a snapshot round trip.
+ */
+TEST(MemoryStorageTest, BalanceHistoryMatchesSqliteSemantics)
+{
+    MemoryStorage storage;
+
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t first_member = 0;
+    uint64_t second_member = 0;
+    uint64_t first_account = 0;
+    uint64_t second_account = 0;
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Timeline"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("One"), family_id, &first_member), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("Two"), family_id, &second_member), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(1, first_member, "A1", 0, 0, &first_account), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(1, second_member, "B1", 0, 0, &second_account), commons::Result::Ok);
+
+    ASSERT_EQ(storage.saveBalanceSnapshotEx(first_account, 2024y / January / 1d, 2024y / January / 31d, 0, 100), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBalanceSnapshotEx(first_account, std::nullopt, 2024y / March / 31d, 100, 300), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBalanceSnapshotEx(second_account, std::nullopt, 2024y / February / 29d, 0, 50), commons::Result::Ok);
+    // Re-importing a period replaces it; an older period does not touch the account row
+    ASSERT_EQ(storage.saveBalanceSnapshotEx(first_account, std::nullopt, 2024y / January / 31d, 0, 120), commons::Result::Ok);
+    EXPECT_EQ(storage.saveBalanceSnapshotEx(999999, std::nullopt, 2024y / January / 31d, 0, 1), commons::Result::NotFound);
+    EXPECT_EQ(storage.saveBalanceSnapshotEx(first_account, 2024y / May / 1d, 2024y / April / 30d, 0, 1), commons::Result::InvalidInput);
+
+    BankAccount account;
+    ASSERT_EQ(storage.getBankAccountById(first_account, &account), commons::Result::Ok);
+    EXPECT_EQ(account.getClosingBalancePaise(), 300);
+
+    const std::vector<commons::Date> dates = {2023y / December / 31d, 2024y / January / 31d, 2024y / February / 29d, 2024y / March / 31d};
+    std::vector<long long> totals;
+    ASSERT_EQ(storage.getNetWorthAsOfEx(NetWorthScope::Family, family_id, dates, &totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{0, 120, 170, 350}));
+    ASSERT_EQ(storage.getNetWorthAsOfEx(NetWorthScope::Member, first_member, dates, &totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{0, 120, 120, 300}));
+    EXPECT_EQ(storage.getNetWorthAsOfEx(NetWorthScope::Member, 999999, dates, &totals), commons::Result::NotFound);
+
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_history_test.bin";
+    ASSERT_EQ(storage.saveSnapshot(path.string()), commons::Result::Ok);
+    MemoryStorage restored;
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    ASSERT_EQ(restored.getNetWorthAsOfEx(NetWorthScope::Family, family_id, dates, &totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{0, 120, 170, 350}));
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(storage.deleteMemberDataEx(first_member), commons::Result::Ok);
+    ASSERT_EQ(storage.getNetWorthAsOfEx(NetWorthScope::Family, family_id, dates, &totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{0, 0, 50, 50}));
+}
+
+/**
+ * Version 1 snapshots (names stored inline) still load.
+ */
+TEST(MemoryStorageTest, LoadsVersionOneSnapshot)
+{
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_snapshot_v1_test.bin";
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        auto writeU64 = [&](uint64_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        auto writeString = [&](const std::string &value)
+        {
+            writeU64(value.size());
+            out.write(value.data(), static_cast<std::streamsize>(value.size()));
+        };
+
+        out.write("HFMEMv1\n", 8);
+        writeU64(2);
+        writeU64(3);
+        writeU64(1);
+        writeU64(1);
+        writeU64(1);
+        writeString("Canara");
+        writeU64(1);
+        writeU64(1);
+        writeString("Rao");
+        writeU64(2);
+
+        for (uint64_t member_id : {1, 2})
+        {
+            writeU64(member_id);
+            writeU64(1);
+            writeString("Rao " + std::to_string(member_id));
+            writeString("R");
+        }
+
+        writeU64(0);
+    }
+
+    MemoryStorage restored;
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    auto members = restored.listMembersOfFamily(1);
+    ASSERT_EQ(members.size(), 2u);
+    EXPECT_EQ(members[1].getName(), "Rao 2");
+    EXPECT_EQ(members[1].getNickname(), "R");
+
+    std::string bank_name;
+    EXPECT_EQ(restored.getBankNameById(1, &bank_name), commons::Result::Ok);
+    EXPECT_EQ(bank_name, "Canara");
+    EXPECT_EQ(restored.getBankNameById(2, &bank_name), commons::Result::NotFound);
+    std::filesystem::remove(path);
+}
+
+/**
+ * Snapshots whose IDs are out of order or whose references dangle are
+ * rejected instead of breaking later lookups.
+ */
+TEST(MemoryStorageTest, RejectsSnapshotWithBrokenReferences)
+{
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_snapshot_refs_test.bin";
+
+    // One family (ID 1); members as (id, family) and accounts as (id, member)
+    auto writeSnapshot = [&](const std::vector<std::pair<uint64_t, uint64_t>> &member_rows,
+                             const std::vector<std::pair<uint64_t, uint64_t>> &account_rows)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        auto writeU64 = [&](uint64_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        auto writeString = [&](const std::string &value)
+        {
+            writeU64(value.size());
+            out.write(value.data(), static_cast<std::streamsize>(value.size()));
+        };
+
+        out.write("HFMEMv1\n", 8);
+        writeU64(2);
+        writeU64(10);
+        writeU64(10);
+        writeU64(1);
+        writeU64(1);
+        writeString("Canara");
+        writeU64(1);
+        writeU64(1);
+        writeString("Rao");
+        writeU64(member_rows.size());
+
+        for (const auto &[member_id, family_id] : member_rows)
+        {
+            writeU64(member_id);
+            writeU64(family_id);
+            writeString("Member");
+            writeString("");
+        }
+
+        writeU64(account_rows.size());
+
+        for (const auto &[account_id, member_id] : account_rows)
+        {
+            writeU64(account_id);
+            writeU64(1);
+            writeU64(member_id);
+            writeString("ACC" + std::to_string(account_id));
+            writeU64(0);
+            writeU64(100);
+        }
+    };
+
+    MemoryStorage restored;
+    writeSnapshot({{1, 1}, {2, 1}}, {{1, 2}});
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    ASSERT_EQ(restored.listBankAccountsOfMember(2).size(), 1u);
+
+    writeSnapshot({{2, 1}, {1, 1}}, {});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot({{1, 1}, {1, 1}}, {});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot({{1, 7}}, {});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot({{1, 1}}, {{1, 5}});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot({{1, 1}, {12, 1}}, {});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+
+    // The rejected files left the earlier contents in place
+    EXPECT_EQ(restored.listBankAccountsOfMember(2).size(), 1u);
+    std::filesystem::remove(path);
+}
+
+TEST(MemoryStorageTest, RejectsSnapshotWithBrokenCategoryRules)
+{
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_snapshot_rules_test.bin";
+
+    // An empty store's snapshot ends with its categories and rules; keep
+    // everything before them and write a tail of our own
+    MemoryStorage empty;
+    ASSERT_EQ(empty.saveSnapshot(path.string()), commons::Result::Ok);
+    std::vector<TransactionCategory> default_categories;
+    std::vector<CategoryRule> default_rules;
+    ASSERT_EQ(empty.listCategoriesEx(&default_categories), commons::Result::Ok);
+    ASSERT_EQ(empty.listCategoryRulesEx(&default_rules), commons::Result::Ok);
+    std::size_t tail_size = 5 * sizeof(uint64_t);
+
+    for (const auto &category : default_categories)
+    {
+        tail_size += 2 * sizeof(uint64_t) + category.name.size();
+    }
+
+    for (const auto &rule : default_rules)
+    {
+        tail_size += 4 * sizeof(uint64_t) + rule.keyword.size();
+    }
+
+    std::string prefix;
+    {
+        std::ifstream in(path, std::ios::binary);
+        prefix.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ASSERT_GT(prefix.size(), tail_size);
+    prefix.resize(prefix.size() - tail_size);
+
+    // Categories as IDs (named "C<id>") and rules as (id, category)
+    auto writeSnapshot = [&](uint64_t next_category, uint64_t next_rule,
+                             const std::vector<uint64_t> &category_ids,
+                             const std::vector<std::pair<uint64_t, uint64_t>> &rule_rows)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        auto writeU64 = [&](uint64_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        auto writeString = [&](const std::string &value)
+        {
+            writeU64(value.size());
+            out.write(value.data(), static_cast<std::streamsize>(value.size()));
+        };
+
+        out.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+        writeU64(next_category);
+        writeU64(next_rule);
+        writeU64(1);
+        writeU64(category_ids.size());
+
+        for (uint64_t category_id : category_ids)
+        {
+            writeU64(category_id);
+            writeString("C" + std::to_string(category_id));
+        }
+
+        writeU64(rule_rows.size());
+
+        for (const auto &[rule_id, category_id] : rule_rows)
+        {
+            writeU64(rule_id);
+            writeU64(category_id);
+            writeString("keyword");
+            writeU64(0);
+        }
+    };
+
+    MemoryStorage restored;
+    writeSnapshot(3, 3, {1, 2}, {{1, 2}, {2, 1}});
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    std::vector<CategoryRule> rules;
+    ASSERT_EQ(restored.listCategoryRulesEx(&rules), commons::Result::Ok);
+    EXPECT_EQ(rules.size(), 2u);
+
+    writeSnapshot(3, 3, {2, 1}, {});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot(3, 3, {1, 1}, {});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot(3, 3, {1, 2}, {{2, 1}, {1, 1}});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot(3, 3, {1, 2}, {{1, 7}});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot(2, 3, {1, 2}, {});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+    writeSnapshot(3, 2, {1, 2}, {{2, 1}});
+    EXPECT_EQ(restored.loadSnapshot(path.string()), commons::Result::InvalidInput);
+
+    // The rejected files left the earlier rules in place
+    ASSERT_EQ(restored.listCategoryRulesEx(&rules), commons::Result::Ok);
+    EXPECT_EQ(rules.size(), 2u);
+    std::filesystem::remove(path);
+}
+
+TEST(MemoryStorageTest, ConcurrentImportsOfNewAccountShareIt)
+{
+    using namespace std::chrono;
+    MemoryStorage storage;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Race"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+
+    const std::vector<BankTransaction> lines = {
+        {2024y / January / 5d, "Salary", 50000},
+        {2024y / January / 9d, "Rent", -20000},
+    };
+    constexpr int kImports = 8;
+    std::vector<uint64_t> account_ids(kImports);
+    std::vector<uint64_t> duplicates(kImports);
+    std::vector<commons::Result> results(kImports, commons::Result::DbError);
+    std::vector<std::thread> threads;
+
+    for (int index = 0; index < kImports; ++index)
+    {
+        threads.emplace_back([&, index]()
+        {
+            StatementImport statement;
+            statement.bank_id = 1;
+            statement.member_id = member_id;
+            statement.account_number = index % 2 == 0 ? "5000 1245" : "5000-1245";
+            statement.closing_paise = 30000;
+            statement.transactions = lines;
+            results[index] = storage.importStatementEx(statement, &account_ids[index], &duplicates[index]);
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    uint64_t total_duplicates = 0;
+
+    for (int index = 0; index < kImports; ++index)
+    {
+        EXPECT_EQ(results[index], commons::Result::Ok);
+        EXPECT_EQ(account_ids[index], account_ids[0]);
+        total_duplicates += duplicates[index];
+    }
+
+    EXPECT_EQ(total_duplicates, (kImports - 1) * lines.size());
+    EXPECT_EQ(storage.listBankAccountsOfMember(member_id).size(), 1u);
+}
+
+/**
+ * HomeManager and NetWorth run unchanged on top of the in-memory engine.
+ */
+TEST(MemoryStorageTest, HomeManagerNetWorth)
+{
+    HomeManager home(std::make_unique<MemoryStorage>());
+    StorageInterface* storage = home.getStorage();
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+
+    ASSERT_EQ(home.addFamily(Family("Das"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(home.addMemberToFamily(Member("Dev", ""), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage->saveBankAccountEx(1, member_id, "A1", 0, 1500), commons::Result::Ok);
+    ASSERT_EQ(storage->saveBankAccountEx(3, member_id, "A2", 0, 2500), commons::Result::Ok);
+
+    long long family_total = 0;
+    EXPECT_EQ(home.computeFamilyNetWorth(family_id, &family_total), commons::Result::Ok);
+    EXPECT_EQ(family_total, 4000);
+
+    NetWorthSnapshot snapshot;
+    EXPECT_EQ(home.computeAllNetWorths(&snapshot, 2), commons::Result::Ok);
+    EXPECT_EQ(snapshot.household_total_paise, 4000);
+    EXPECT_EQ(home.getStorageManager(), nullptr);
+}
+
+TEST(MemoryStorageTest, CashFlowRollupsMatchSqliteSemantics)
+{
+    MemoryStorage storage;
+
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t first_member = 0;
+    uint64_t second_member = 0;
+    uint64_t first_account = 0;
+    uint64_t second_account = 0;
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Flows"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("One"), family_id, &first_member), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("Two"), family_id, &second_member), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(1, first_member, "A1", 0, 0, &first_account), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(2, second_member, "B1", 0, 0, &second_account), commons::Result::Ok);
+
+    const std::vector<BankTransaction> first_lines = {
+        {2024y / January / 5d, "Salary", 50000},
+        {2024y / January / 20d, "Rent", -20000},
+        {2024y / March / 1d, "Refund", 700},
+    };
+    const std::vector<BankTransaction> second_lines = {
+        {2024y / January / 31d, "Groceries", -3000},
+        {2024y / February / 2d, "Interest", 150},
+    };
+    ASSERT_EQ(storage.saveTransactionsEx(first_account, first_lines), commons::Result::Ok);
+    ASSERT_EQ(storage.saveTransactionsEx(second_account, second_lines), commons::Result::Ok);
+    EXPECT_EQ(storage.saveTransactionsEx(999999, first_lines), commons::Result::NotFound);
+
+    std::vector<CashFlowMonth> months;
+    ASSERT_EQ(storage.getCashFlowEx(NetWorthScope::Family, family_id, 2023y / December, 2024y / March, &months), commons::Result::Ok);
+    ASSERT_EQ(months.size(), 4u);
+    EXPECT_EQ(months[1].credit_paise, 50000);
+    EXPECT_EQ(months[1].debit_paise, 23000);
+    EXPECT_EQ(months[1].debit_count, 2u);
+    EXPECT_EQ(months[2].credit_paise, 150);
+    EXPECT_EQ(months[3].credit_paise, 700);
+    EXPECT_EQ(storage.getCashFlowEx(NetWorthScope::Family, family_id, 2024y / March, 2024y / January, &months), commons::Result::InvalidInput);
+
+    uint64_t mismatched = 99;
+    ASSERT_EQ(storage.checkCashFlowRollupsEx(&mismatched), commons::Result::Ok);
+    EXPECT_EQ(mismatched, 0u);
+
+    // Transactions survive a snapshot and the rollups are recomputed on load
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_cashflow_test.bin";
+    ASSERT_EQ(storage.saveSnapshot(path.string()), commons::Result::Ok);
+    MemoryStorage restored;
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    ASSERT_EQ(restored.getCashFlowEx(NetWorthScope::Member, first_member, 2024y / January, 2024y / January, &months), commons::Result::Ok);
+    EXPECT_EQ(months[0].credit_paise, 50000);
+    EXPECT_EQ(months[0].debit_paise, 20000);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(storage.deleteMemberDataEx(first_member), commons::Result::Ok);
+    ASSERT_EQ(storage.getCashFlowEx(NetWorthScope::Family, family_id, 2024y / January, 2024y / March, &months), commons::Result::Ok);
+    EXPECT_EQ(months[0].credit_paise, 0);
+    EXPECT_EQ(months[0].debit_paise, 3000);
+    EXPECT_EQ(months[2].credit_paise, 0);
+    ASSERT_EQ(storage.checkCashFlowRollupsEx(&mismatched), commons::Result::Ok);
+    EXPECT_EQ(mismatched, 0u);
+}
+
+TEST(MemoryStorageTest, TransactionSearchMatchesSqliteSemantics)
+{
+    MemoryStorage storage;
+
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    uint64_t first_account = 0;
+    uint64_t second_account = 0;
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Search"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(1, member_id, "A1", 0, 0, &first_account), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(2, member_id, "B1", 0, 0, &second_account), commons::Result::Ok);
+
+    const std::vector<BankTransaction> first_lines = {
+        {2024y / January / 5d, "UPI/DR/4123/RAVI KUMAR/SBIN", -5000, "RAVI KUMAR"},
+        {2024y / February / 5d, "ATM WDL", -2000, ""},
+        {2024y / March / 5d, "UPI/DR/4124/Ravi Kumar/SBIN", -7000, "Ravi Kumar"},
+    };
+    const std::vector<BankTransaction> second_lines = {
+        {2024y / March / 5d, "Rent to landlord", -20000, "Ravindra"},
+    };
+    ASSERT_EQ(storage.saveTransactionsEx(first_account, first_lines), commons::Result::Ok);
+    ASSERT_EQ(storage.saveTransactionsEx(second_account, second_lines), commons::Result::Ok);
+
+    std::vector<TransactionMatch> matches;
+    ASSERT_EQ(storage.searchTransactionsEx("ravi", 10, &matches), commons::Result::Ok);
+    ASSERT_EQ(matches.size(), 3u);
+    EXPECT_EQ(matches[0].transaction.amount_paise, -7000);
+    EXPECT_EQ(matches[1].bank_account_id, second_account);
+    EXPECT_EQ(matches[2].transaction.date, 2024y / January / 5d);
+    ASSERT_EQ(storage.searchTransactionsEx("Ravi KUMAR", 10, &matches), commons::Result::Ok);
+    EXPECT_EQ(matches.size(), 2u);
+    ASSERT_EQ(storage.searchTransactionsEx("ravi", 1, &matches), commons::Result::Ok);
+    EXPECT_EQ(matches.size(), 1u);
+
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_search_test.bin";
+    ASSERT_EQ(storage.saveSnapshot(path.string()), commons::Result::Ok);
+    MemoryStorage restored;
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    ASSERT_EQ(restored.searchTransactionsEx("ravindra", 10, &matches), commons::Result::Ok);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].transaction.counterparty, "Ravindra");
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(storage.deleteMemberDataEx(member_id), commons::Result::Ok);
+    ASSERT_EQ(storage.searchTransactionsEx("ravi", 10, &matches), commons::Result::Ok);
+    EXPECT_TRUE(matches.empty());
+}
+
+TEST(MemoryStorageTest, DuplicateTransactionsMatchSqliteSemantics)
+{
+    MemoryStorage storage;
+
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    uint64_t account_id = 0;
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Dedup"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(1, member_id, "A1", 0, 0, &account_id), commons::Result::Ok);
+
+    const std::vector<BankTransaction> quarter = {
+        {2024y / January / 5d, "Salary", 50000, "", 50000},
+        {2024y / February / 3d, "Tea stall", -20, "", 49980},
+        {2024y / February / 3d, "Tea stall", -20, "", 49960},
+        {2024y / March / 1d, "Rent", -20000, "", 29960},
+    };
+    const std::vector<BankTransaction> march_and_april = {
+        {2024y / March / 1d, "Rent", -20000, "", 29960},
+        {2024y / April / 2d, "Interest", 150, "", 30110},
+    };
+
+    uint64_t duplicates = 99;
+    ASSERT_EQ(storage.saveTransactionsEx(account_id, quarter, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 0u);
+    ASSERT_EQ(storage.saveTransactionsEx(account_id, march_and_april, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 1u);
+
+    std::vector<CashFlowMonth> months;
+    ASSERT_EQ(storage.getCashFlowEx(NetWorthScope::Member, member_id, 2024y / February, 2024y / March, &months), commons::Result::Ok);
+    ASSERT_EQ(months.size(), 2u);
+    EXPECT_EQ(months[0].debit_count, 2u);
+    EXPECT_EQ(months[1].debit_paise, 20000);
+
+    // Fingerprints are rebuilt from the snapshot, running balances included
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_dedup_test.bin";
+    ASSERT_EQ(storage.saveSnapshot(path.string()), commons::Result::Ok);
+    MemoryStorage restored;
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    ASSERT_EQ(restored.saveTransactionsEx(account_id, quarter, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 4u);
+    std::vector<TransactionMatch> matches;
+    ASSERT_EQ(restored.searchTransactionsEx("rent", 10, &matches), commons::Result::Ok);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].transaction.balance_after_paise, 29960);
+    std::filesystem::remove(path);
+
+    // Deleting the member forgets the fingerprints with the rows
+    ASSERT_EQ(storage.deleteMemberDataEx(member_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(1, member_id, "A1", 0, 0, &account_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveTransactionsEx(account_id, quarter, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 0u);
+}
+
+TEST(MemoryStorageTest, CategoryRulesMatchSqliteSemantics)
+{
+    MemoryStorage storage;
+
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    uint64_t account_id = 0;
+    ASSERT_EQ(storage.saveFamilyDataEx(Family("Tags"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage.saveBankAccountEx(1, member_id, "A1", 0, 0, &account_id), commons::Result::Ok);
+
+    const std::vector<BankTransaction> lines = {
+        {2024y / January / 1d, "NEFT/ACME LTD/SALARY JAN", 50000},
+        {2024y / January / 9d, "BESCOM BILL PAY", -1500},
+    };
+    ASSERT_EQ(storage.saveTransactionsEx(account_id, lines), commons::Result::Ok);
+
+    auto categoryOf = [](MemoryStorage& store, const std::string& text)
+    {
+        std::vector<TransactionMatch> matches;
+        EXPECT_EQ(store.searchTransactionsEx(text, 1, &matches), commons::Result::Ok);
+        return matches.empty() ? ~uint64_t{0} : matches[0].transaction.category_id;
+    };
+
+    EXPECT_EQ(categoryOf(storage, "salary"), 1u);
+    uint64_t rule_id = 0;
+    ASSERT_EQ(storage.saveCategoryRuleEx("Electricity", "bescom", 0, &rule_id), commons::Result::Ok);
+    EXPECT_EQ(rule_id, 8u);
+    EXPECT_EQ(categoryOf(storage, "bescom"), 0u);
+
+    // A batch skips keywords its category already has
+    const std::vector<std::string> names = {"electricity", "Electricity"};
+    const std::vector<CategoryRule> batch = {{0, 0, "BESCOM", 0}, {0, 0, "power bill", 0}};
+    uint64_t added = 0;
+    ASSERT_EQ(storage.saveCategoryRulesEx(names, batch, &added), commons::Result::Ok);
+    EXPECT_EQ(added, 1u);
+    ASSERT_EQ(storage.saveCategoryRulesEx(names, batch, &added), commons::Result::Ok);
+    EXPECT_EQ(added, 0u);
+
+    // Rules, categories and the pending recategorisation survive a snapshot
+    auto path = std::filesystem::temp_directory_path() / "homefinancials_memory_category_test.bin";
+    ASSERT_EQ(storage.saveSnapshot(path.string()), commons::Result::Ok);
+    MemoryStorage restored;
+    ASSERT_EQ(restored.loadSnapshot(path.string()), commons::Result::Ok);
+    std::filesystem::remove(path);
+
+    std::vector<TransactionCategory> categories;
+    ASSERT_EQ(restored.listCategoriesEx(&categories), commons::Result::Ok);
+    ASSERT_EQ(categories.size(), 5u);
+    EXPECT_EQ(categories.back().name, "Electricity");
+
+    uint64_t changed = 99;
+    ASSERT_EQ(restored.recategorizeTransactionsEx(10, &changed), commons::Result::Ok);
+    EXPECT_EQ(changed, 1u);
+    EXPECT_EQ(categoryOf(restored, "bescom"), categories.back().id);
+    ASSERT_EQ(restored.recategorizeTransactionsEx(10, &changed), commons::Result::Ok);
+    EXPECT_EQ(changed, 0u);
+
+    ASSERT_EQ(restored.deleteCategoryRuleEx(1), commons::Result::Ok);
+    EXPECT_EQ(restored.deleteCategoryRuleEx(1), commons::Result::NotFound);
+    ASSERT_EQ(restored.recategorizeTransactionsEx(10, &changed), commons::Result::Ok);
+    EXPECT_EQ(changed, 1u);
+    EXPECT_EQ(categoryOf(restored, "salary"), 0u);
+}
@@ -2,9 +2,11 @@
 #include "test_helpers.hpp"
 #include "storage_manager.hpp"
 #include "net_worth.hpp"
+#include "analytics_snapshot.hpp"
 #include "family.hpp"
 #include "member.hpp"
 #include <filesystem>
+#include <limits>
 #include <memory>
 
 class NetWorthClassTest : public TestDbFixture
@@ -76,3 +78,159 @@ TEST_F(NetWorthClassTest, MemberNotFound)
     long long out = 0;
     EXPECT_EQ(nw.computeMemberNetWorth(9999, &out), commons::Result::NotFound);
 }
+
+TEST_F(NetWorthClassTest, AllNetWorthsSnapshot)
+{
+    uint64_t bank_id = 0;
+    ASSERT_EQ(storage()->getBankIdByName("Canara", &bank_id), commons::Result::Ok);
+
+    // Five families; family N has N members with one account each of N * 100 paise,
+    // except the last family which has no members at all.
+    std::vector<uint64_t> family_ids;
+
+    for (int family_index = 1; family_index <= 5; ++family_index)
+    {
+        Family family("Household" + std::to_string(family_index));
+        uint64_t family_id = 0;
+        ASSERT_EQ(storage()->saveFamilyDataEx(family, &family_id), commons::Result::Ok);
+        family_ids.push_back(family_id);
+
+        if (family_index == 5)
+        {
+            continue;
+        }
+
+        for (int member_index = 0; member_index < family_index; ++member_index)
+        {
+            Member member("M" + std::to_string(family_index) + "_" + std::to_string(member_index));
+            uint64_t member_id = 0;
+            ASSERT_EQ(storage()->saveMemberDataEx(member, family_id, &member_id), commons::Result::Ok);
+            ASSERT_EQ(storage()->saveBankAccountEx(bank_id, member_id, "ACC", 0, family_index * 100, nullptr), commons::Result::Ok);
+        }
+    }
+
+    NetWorth nw(storage());
+
+    for (unsigned thread_count : {1u, 3u, 8u})
+    {
+        NetWorthSnapshot snapshot;
+        ASSERT_EQ(nw.computeAllNetWorths(&snapshot, thread_count), commons::Result::Ok);
+
+        ASSERT_EQ(snapshot.familyCount(), 5u);
+        ASSERT_EQ(snapshot.memberCount(), 1u + 2u + 3u + 4u);
+        ASSERT_EQ(snapshot.family_member_offsets.size(), 6u);
+        EXPECT_EQ(snapshot.family_ids, family_ids);
+
+        for (std::size_t family_index = 0; family_index < 5; ++family_index)
+        {
+            long long per_member = static_cast<long long>(family_index + 1) * 100;
+            std::size_t member_count = (family_index == 4) ? 0 : family_index + 1;
+            EXPECT_EQ(snapshot.family_member_offsets[family_index + 1] - snapshot.family_member_offsets[family_index], member_count);
+            EXPECT_EQ(snapshot.family_totals_paise[family_index], per_member * static_cast<long long>(member_count));
+
+            for (std::size_t member_index = snapshot.family_member_offsets[family_index];
+                 member_index < snapshot.family_member_offsets[family_index + 1];
+                 ++member_index)
+            {
+                EXPECT_EQ(snapshot.member_family_ids[member_index], family_ids[family_index]);
+                EXPECT_EQ(snapshot.member_totals_paise[member_index], per_member);
+            }
+        }
+
+        EXPECT_EQ(snapshot.household_total_paise, 100 + 400 + 900 + 1600);
+    }
+}
+
+TEST_F(NetWorthClassTest, AnalyticsSnapshotGroupsByFamilyMemberAndBank)
+{
+    uint64_t canara_id = 0;
+    uint64_t sbi_id = 0;
+    ASSERT_EQ(storage()->getBankIdByName("Canara", &canara_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->getBankIdByName("SBI", &sbi_id), commons::Result::Ok);
+
+    // Family 1: two members (one without accounts); family 2: no members;
+    // family 3: one member with accounts at both banks.
+    uint64_t first_family = 0;
+    uint64_t empty_family = 0;
+    uint64_t last_family = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("First"), &first_family), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Empty"), &empty_family), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Last"), &last_family), commons::Result::Ok);
+
+    uint64_t saver = 0;
+    uint64_t idle = 0;
+    uint64_t spender = 0;
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("Saver"), first_family, &saver), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("Idle"), first_family, &idle), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("Spender"), last_family, &spender), commons::Result::Ok);
+
+    ASSERT_EQ(storage()->saveBankAccountEx(sbi_id, saver, "S1", 0, 700), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(canara_id, saver, "C1", 0, 300), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(canara_id, spender, "C2", 0, -50), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(sbi_id, spender, "S2", 0, 25), commons::Result::Ok);
+
+    AnalyticsSnapshot snapshot;
+    ASSERT_EQ(snapshot.load(storage()), commons::Result::Ok);
+    EXPECT_EQ(snapshot.family_ids, (std::vector<uint64_t>{first_family, empty_family, last_family}));
+    EXPECT_EQ(snapshot.member_ids, (std::vector<uint64_t>{saver, idle, spender}));
+    EXPECT_EQ(snapshot.member_family_index, (std::vector<uint32_t>{0, 0, 2}));
+    EXPECT_EQ(snapshot.family_member_offsets, (std::vector<std::size_t>{0, 2, 2, 3}));
+    EXPECT_EQ(snapshot.accountCount(), 4u);
+    ASSERT_EQ(snapshot.bank_ids.size(), 2u);
+    EXPECT_LT(snapshot.bank_ids[0], snapshot.bank_ids[1]);
+
+    std::vector<long long> totals;
+    ASSERT_EQ(snapshot.totalsByFamily(&totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{1000, 0, -25}));
+    ASSERT_EQ(snapshot.totalsByMember(&totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{1000, 0, -25}));
+    ASSERT_EQ(snapshot.totalsByBank(&totals), commons::Result::Ok);
+    long long canara_total = snapshot.bank_ids[0] == canara_id ? totals[0] : totals[1];
+    long long sbi_total = snapshot.bank_ids[0] == sbi_id ? totals[0] : totals[1];
+    EXPECT_EQ(canara_total, 250);
+    EXPECT_EQ(sbi_total, 725);
+
+    long long household = 0;
+    ASSERT_EQ(snapshot.householdTotal(&household), commons::Result::Ok);
+    EXPECT_EQ(household, 975);
+
+    // Same family totals as the streaming report
+    NetWorthSnapshot report;
+    ASSERT_EQ(NetWorth(storage()).computeAllNetWorths(&report), commons::Result::Ok);
+    ASSERT_EQ(snapshot.totalsByFamily(&totals), commons::Result::Ok);
+    EXPECT_EQ(totals, report.family_totals_paise);
+
+    // Sums are exact even when lanes pass the long long range mid-way
+    const long long big = std::numeric_limits<long long>::max();
+    ASSERT_EQ(storage()->saveBankAccountEx(sbi_id, idle, "S3", 0, big), commons::Result::Ok);
+    ASSERT_EQ(snapshot.load(storage()), commons::Result::Ok);
+    EXPECT_EQ(snapshot.totalsByBank(&totals), commons::Result::Overflow);
+    EXPECT_EQ(snapshot.totalsByFamily(&totals), commons::Result::Overflow);
+    EXPECT_EQ(totals[0], big);
+}
+
+TEST_F(NetWorthClassTest, MemberNetWorthOverflowIsReported)
+{
+    Family family("OverflowFamily");
+    uint64_t family_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(family, &family_id), commons::Result::Ok);
+
+    Member member("Rich", "R");
+    uint64_t member_id = 0;
+    ASSERT_EQ(storage()->saveMemberDataEx(member, family_id, &member_id), commons::Result::Ok);
+
+    uint64_t bank_id = 0;
+    ASSERT_EQ(storage()->getBankIdByName("Canara", &bank_id), commons::Result::Ok);
+
+    const long long huge = std::numeric_limits<long long>::max();
+    ASSERT_EQ(storage()->saveBankAccountEx(bank_id, member_id, "BIG1", 0, huge, nullptr), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(bank_id, member_id, "BIG2", 0, huge, nullptr), commons::Result::Ok);
+
+    NetWorth nw(storage());
+    long long net_paise = 0;
+    EXPECT_EQ(nw.computeMemberNetWorth(member_id, &net_paise), commons::Result::Overflow);
+    EXPECT_EQ(net_paise, huge);
+
+    NetWorthSnapshot snapshot;
+    EXPECT_EQ(nw.computeAllNetWorths(&snapshot, 2), commons::Result::Overflow);
+}
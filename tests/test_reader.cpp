@@ -155,3 +155,198 @@ TEST_F(HomeManagerImportByIdTest, ImportUsingBankId)
 
     std::filesystem::remove(csv_path);
 }
+
+TEST_F(ReaderFactoryHomeManagerTest, DatedStatementsBuildBalanceHistory)
+{
+    using namespace std::chrono;
+    Family family("HistoryFamily");
+    ASSERT_EQ(home()->addFamily(family), commons::Result::Ok);
+    Member member("Esha", "E");
+    ASSERT_EQ(home()->addMemberToFamily(member, 1), commons::Result::Ok);
+
+    auto csv_path = std::filesystem::temp_directory_path() / "canara_dated_statement.csv";
+    auto writeStatement = [&](const std::string &account, const std::string &period, const std::string &closing)
+    {
+        std::ofstream ofs(csv_path, std::ios::trunc);
+        ofs << "Account Number,=\"" << account << "\"\n";
+        ofs << "Statement Period,\"" << period << "\"\n";
+        ofs << "Opening Balance,\"Rs.100.00\"\n";
+        ofs << "Closing Balance,\"" << closing << "\"\n";
+    };
+
+    // March is imported after April; a differently formatted number is the same account
+    uint64_t april_id = 0;
+    uint64_t march_id = 0;
+    writeStatement("5000 12456", "01-04-2024 to 30-04-2024", "Rs.400.00");
+    ASSERT_EQ(home()->importBankStatement(csv_path.string(), 1, std::string("Canara"), &april_id), commons::Result::Ok);
+    writeStatement("500012456", "01-Mar-2024 to 31-Mar-2024", "Rs.300.00");
+    ASSERT_EQ(home()->importBankStatement(csv_path.string(), 1, std::string("Canara"), &march_id), commons::Result::Ok);
+    EXPECT_EQ(march_id, april_id);
+    EXPECT_EQ(home()->getStorageManager()->listBankAccountsOfMember(1).size(), 1u);
+
+    // The account keeps the latest period's balances
+    BankAccount row;
+    ASSERT_EQ(home()->getStorageManager()->getBankAccountById(april_id, &row), commons::Result::Ok);
+    EXPECT_EQ(row.getClosingBalancePaise(), 40000);
+
+    std::vector<NetWorthPoint> points;
+    ASSERT_EQ(home()->computeMonthlyNetWorth(NetWorthScope::Family, 1, 2024y / February, 2024y / May, &points), commons::Result::Ok);
+    ASSERT_EQ(points.size(), 4u);
+    EXPECT_EQ(points[0].date, 2024y / February / 29d);
+    EXPECT_EQ(points[0].net_worth_paise, 0);
+    EXPECT_EQ(points[1].net_worth_paise, 30000);
+    EXPECT_EQ(points[2].net_worth_paise, 40000);
+    EXPECT_EQ(points[3].net_worth_paise, 40000);
+
+    std::filesystem::remove(csv_path);
+}
+
+TEST_F(ReaderFactoryHomeManagerTest, StatementLinesFeedCashFlow)
+{
+    using namespace std::chrono;
+    Family family("FlowFamily");
+    ASSERT_EQ(home()->addFamily(family), commons::Result::Ok);
+    Member member("Farah", "F");
+    ASSERT_EQ(home()->addMemberToFamily(member, 1), commons::Result::Ok);
+
+    auto csv_path = std::filesystem::temp_directory_path() / "canara_statement_lines.csv";
+    {
+        std::ofstream ofs(csv_path);
+        ofs << "Account Number,=\"500012456\"\n";
+        ofs << "Statement Period,\"01-04-2024 to 30-04-2024\"\n";
+        ofs << "Opening Balance,\"Rs.1,000.00\"\n";
+        ofs << "Closing Balance,\"Rs.1,350.50\"\n";
+        ofs << "Txn Date,Value Date,Cheque No.,Description,Branch Code,Debit,Credit,Balance\n";
+        ofs << "02-04-2024,02-04-2024,,NEFT/N0123456789/ACME LTD/HDFC,101,,\"1,000.00\",\"2,000.00\"\n";
+        ofs << "15-04-2024,15-04-2024,,UPI GROCER,101,649.50,,\"1,350.50\"\n";
+        ofs << "Total,,,,,649.50,\"1,000.00\",\n";
+    }
+
+    CanaraBankReader reader;
+    ASSERT_EQ(reader.parseFile(csv_path.string()), commons::Result::Ok);
+    ASSERT_EQ(reader.transactions().size(), 2u);
+    EXPECT_EQ(reader.transactions()[0].date, 2024y / April / 2d);
+    EXPECT_EQ(reader.transactions()[0].description, "NEFT/N0123456789/ACME LTD/HDFC");
+    EXPECT_EQ(reader.transactions()[0].counterparty, "ACME LTD");
+    EXPECT_EQ(reader.transactions()[1].counterparty, "");
+    EXPECT_EQ(reader.transactions()[0].amount_paise, 100000);
+    EXPECT_EQ(reader.transactions()[1].amount_paise, -64950);
+
+    uint64_t bank_account_id = 0;
+    ASSERT_EQ(home()->importBankStatement(csv_path.string(), 1, std::string("Canara"), &bank_account_id), commons::Result::Ok);
+
+    std::vector<CashFlowMonth> months;
+    ASSERT_EQ(home()->getCashFlow(NetWorthScope::Member, 1, 2024y / April, 2024y / April, &months), commons::Result::Ok);
+    ASSERT_EQ(months.size(), 1u);
+    EXPECT_EQ(months[0].credit_paise, 100000);
+    EXPECT_EQ(months[0].debit_paise, 64950);
+
+    uint64_t mismatched = 99;
+    ASSERT_EQ(home()->checkCashFlowRollups(&mismatched), commons::Result::Ok);
+    EXPECT_EQ(mismatched, 0u);
+
+    std::vector<TransactionMatch> matches;
+    ASSERT_EQ(home()->searchTransactions("acme", 10, &matches), commons::Result::Ok);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].bank_account_id, bank_account_id);
+
+    std::filesystem::remove(csv_path);
+}
+
+TEST_F(ReaderFactoryHomeManagerTest, UndatedStatementsShareAccountAndSkipDuplicates)
+{
+    using namespace std::chrono;
+    Family family("UndatedFamily");
+    ASSERT_EQ(home()->addFamily(family), commons::Result::Ok);
+    Member member("Hema", "H");
+    ASSERT_EQ(home()->addMemberToFamily(member, 1), commons::Result::Ok);
+
+    auto csv_path = std::filesystem::temp_directory_path() / "canara_undated_statement.csv";
+    auto writeStatement = [&](const std::string &closing, const std::vector<std::string> &lines)
+    {
+        std::ofstream ofs(csv_path, std::ios::trunc);
+        ofs << "Account Number,=\"500012456\"\n";
+        ofs << "Opening Balance,\"Rs.1,000.00\"\n";
+        ofs << "Closing Balance,\"" << closing << "\"\n";
+        ofs << "Txn Date,Description,Debit,Credit,Balance\n";
+
+        for (const auto &line : lines)
+        {
+            ofs << line << "\n";
+        }
+    };
+
+    const std::string interest = "02-04-2024,Interest,,100.00,\"1,100.00\"";
+    const std::string fee = "04-04-2024,Fee,50.00,,\"1,050.00\"";
+    const std::string refund = "09-05-2024,Refund,,20.00,\"1,070.00\"";
+
+    uint64_t first_id = 0;
+    uint64_t duplicates = 99;
+    writeStatement("Rs.1,050.00", {interest, fee});
+    ASSERT_EQ(home()->importBankStatement(csv_path.string(), 1, std::string("Canara"), &first_id, nullptr, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 0u);
+
+    // The same statement again, then one overlapping it
+    uint64_t second_id = 0;
+    ASSERT_EQ(home()->importBankStatement(csv_path.string(), 1, std::string("Canara"), &second_id, nullptr, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(second_id, first_id);
+    EXPECT_EQ(duplicates, 2u);
+
+    writeStatement("Rs.1,070.00", {interest, fee, refund});
+    ASSERT_EQ(home()->importBankStatement(csv_path.string(), 1, std::string("Canara"), &second_id, nullptr, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(second_id, first_id);
+    EXPECT_EQ(duplicates, 2u);
+    EXPECT_EQ(home()->getStorageManager()->listBankAccountsOfMember(1).size(), 1u);
+
+    long long net_worth = 0;
+    ASSERT_EQ(home()->computeMemberNetWorth(1, &net_worth), commons::Result::Ok);
+    EXPECT_EQ(net_worth, 107000);
+
+    std::vector<CashFlowMonth> months;
+    ASSERT_EQ(home()->getCashFlow(NetWorthScope::Member, 1, 2024y / April, 2024y / May, &months), commons::Result::Ok);
+    ASSERT_EQ(months.size(), 2u);
+    EXPECT_EQ(months[0].credit_paise, 10000);
+    EXPECT_EQ(months[0].debit_paise, 5000);
+    EXPECT_EQ(months[1].credit_paise, 2000);
+
+    // Each statement is taken to end on its last line
+    std::vector<NetWorthPoint> points;
+    ASSERT_EQ(home()->computeMonthlyNetWorth(NetWorthScope::Member, 1, 2024y / April, 2024y / May, &points), commons::Result::Ok);
+    ASSERT_EQ(points.size(), 2u);
+    EXPECT_EQ(points[0].net_worth_paise, 105000);
+    EXPECT_EQ(points[1].net_worth_paise, 107000);
+
+    std::filesystem::remove(csv_path);
+}
+
+TEST_F(ReaderFactoryHomeManagerTest, UnreconciledStatementIsRejected)
+{
+    Family family("ReconcileFamily");
+    ASSERT_EQ(home()->addFamily(family), commons::Result::Ok);
+    Member member("Gita", "G");
+    ASSERT_EQ(home()->addMemberToFamily(member, 1), commons::Result::Ok);
+
+    auto csv_path = std::filesystem::temp_directory_path() / "canara_unreconciled.csv";
+    {
+        std::ofstream ofs(csv_path);
+        ofs << "Account Number,=\"500012456\"\n";
+        ofs << "Opening Balance,\"Rs.1,000.00\"\n";
+        ofs << "Closing Balance,\"Rs.1,250.00\"\n";
+        ofs << "Txn Date,Description,Debit,Credit,Balance\n";
+        ofs << "02-04-2024,Interest,,100.00,\"1,100.00\"\n";
+        // Stated balance implies a credit of 200.00, not 150.00
+        ofs << "03-04-2024,Refund,,150.00,\"1,300.00\"\n";
+        ofs << "04-04-2024,Fee,50.00,,\"1,250.00\"\n";
+    }
+
+    uint64_t bank_account_id = 0;
+    ReconciliationReport report;
+    EXPECT_EQ(home()->importBankStatement(csv_path.string(), 1, std::string("Canara"), &bank_account_id, &report),
+              commons::Result::Unreconciled);
+    EXPECT_FALSE(report.balanced);
+    EXPECT_EQ(report.first_divergent_row, std::optional<std::size_t>(1));
+    EXPECT_EQ(report.expected_closing_paise, 120000);
+    EXPECT_TRUE(home()->getStorageManager()->listBankAccountsOfMember(1).empty());
+
+    std::filesystem::remove(csv_path);
+}
@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+#include "socket_server.hpp"
+#include "memory_storage.hpp"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    RequestQueue::Item makeItem(uint64_t connection_id)
+    {
+        return {connection_id, JsonValue()};
+    }
+
+    /**
+     * Connect to the server, send all requests in one write and collect one
+     * response line per request. With `half_close` the client shuts down its
+     * sending side before reading.
+     */
+    std::vector<std::string> exchange(const std::string& socket_path, const std::string& requests, std::size_t expected,
+                                      bool half_close = false)
+    {
+        std::vector<std::string> lines;
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", socket_path.c_str());
+
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            ::close(fd);
+            return lines;
+        }
+
+        std::size_t offset = 0;
+
+        while (offset < requests.size())
+        {
+            ssize_t sent = ::send(fd, requests.data() + offset, requests.size() - offset, MSG_NOSIGNAL);
+
+            if (sent <= 0)
+            {
+                break;
+            }
+
+            offset += static_cast<std::size_t>(sent);
+        }
+
+        if (half_close)
+        {
+            ::shutdown(fd, SHUT_WR);
+        }
+
+        std::string pending;
+        char chunk[4096];
+
+        while (lines.size() < expected)
+        {
+            ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+
+            if (received <= 0)
+            {
+                break;
+            }
+
+            pending.append(chunk, static_cast<std::size_t>(received));
+            std::size_t newline = 0;
+
+            while ((newline = pending.find('\n')) != std::string::npos)
+            {
+                lines.push_back(pending.substr(0, newline));
+                pending.erase(0, newline + 1);
+            }
+        }
+
+        ::close(fd);
+        return lines;
+    }
+}
+
+TEST(RequestQueueTest, ReadsFirstWithBoundedWriteStarvation)
+{
+    RequestQueue queue;
+    queue.push(makeItem(100), false);
+
+    for (uint64_t index = 0; index < RequestQueue::kMaxConsecutiveReads + 2; ++index)
+    {
+        queue.push(makeItem(index), true);
+    }
+
+    // kMaxConsecutiveReads reads, then the waiting write, then the rest
+    for (uint64_t index = 0; index < RequestQueue::kMaxConsecutiveReads; ++index)
+    {
+        EXPECT_EQ(queue.pop()->connection_id, index);
+    }
+
+    EXPECT_EQ(queue.pop()->connection_id, 100u);
+    EXPECT_EQ(queue.pop()->connection_id, RequestQueue::kMaxConsecutiveReads);
+    EXPECT_EQ(queue.size(), 1u);
+
+    queue.close();
+    EXPECT_TRUE(queue.pop().has_value());
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+/**
+ * Several clients pipeline mixed reads and writes at once; each gets one
+ * response per request and every write lands.
+ */
+TEST(SocketServerTest, ConcurrentClientsAreAllAnswered)
+{
+    HomeManager home(std::make_unique<MemoryStorage>());
+    uint64_t family_id = 0;
+    ASSERT_EQ(home.addFamily(Family("Seed"), &family_id), commons::Result::Ok);
+
+    std::string socket_path = (std::filesystem::temp_directory_path() /
+                               ("hf_test_" + std::to_string(::getpid()) + ".sock")).string();
+    SocketServer server(home, socket_path, 4);
+    ASSERT_TRUE(server.start());
+    std::thread loop([&server]() { server.run(); });
+
+    const int client_count = 6;
+    const int requests_per_client = 50;
+    std::vector<std::vector<std::string>> responses(client_count);
+    std::vector<std::thread> clients;
+
+    for (int client = 0; client < client_count; ++client)
+    {
+        clients.emplace_back([&, client]()
+        {
+            std::ostringstream requests;
+
+            for (int index = 0; index < requests_per_client; ++index)
+            {
+                if (index % 5 == 0)
+                {
+                    requests << R"({"id":)" << index << R"(,"method":"addMember","params":{"family_id":)" << family_id
+                             << R"(,"name":"C)" << client << "_" << index << R"("}})" << "\n";
+                }
+                else
+                {
+                    requests << R"({"id":)" << index << R"(,"method":"listMembers","params":{"family_id":)" << family_id << "}}\n";
+                }
+            }
+
+            requests << "not json\n";
+            responses[client] = exchange(socket_path, requests.str(), requests_per_client + 1);
+        });
+    }
+
+    for (auto &client : clients)
+    {
+        client.join();
+    }
+
+    server.stop();
+    loop.join();
+
+    for (int client = 0; client < client_count; ++client)
+    {
+        ASSERT_EQ(responses[client].size(), static_cast<std::size_t>(requests_per_client + 1)) << "client " << client;
+        std::set<long long> seen_ids;
+        int malformed = 0;
+
+        for (const auto &line : responses[client])
+        {
+            auto response = JsonValue::parse(line);
+            ASSERT_TRUE(response.has_value()) << line;
+
+            if (response->find("id")->isNull())
+            {
+                ++malformed;
+                continue;
+            }
+
+            EXPECT_EQ(response->find("ok")->asBool(), true) << line;
+            seen_ids.insert(*response->find("id")->asInt64());
+        }
+
+        EXPECT_EQ(seen_ids.size(), static_cast<std::size_t>(requests_per_client));
+        EXPECT_EQ(malformed, 1);
+    }
+
+    EXPECT_EQ(home.listMembersOfFamily(family_id).size(), static_cast<std::size_t>(client_count * requests_per_client / 5));
+}
+
+/**
+ * One client pipelines far more requests than may be in flight and then
+ * half-closes; reading pauses and resumes until every request is answered.
+ */
+TEST(SocketServerTest, PipelinedRequestsBeyondInFlightLimitAreAnswered)
+{
+    HomeManager home(std::make_unique<MemoryStorage>());
+    uint64_t family_id = 0;
+    ASSERT_EQ(home.addFamily(Family("Seed"), &family_id), commons::Result::Ok);
+
+    std::string socket_path = (std::filesystem::temp_directory_path() /
+                               ("hf_test_pipeline_" + std::to_string(::getpid()) + ".sock")).string();
+    SocketServer server(home, socket_path, 2);
+    ASSERT_TRUE(server.start());
+    std::thread loop([&server]() { server.run(); });
+
+    const std::size_t request_count = SocketServer::kMaxInFlight * 20;
+    std::ostringstream requests;
+
+    for (std::size_t index = 0; index < request_count; ++index)
+    {
+        requests << R"({"id":)" << index << R"(,"method":"listMembers","params":{"family_id":)" << family_id << "}}\n";
+    }
+
+    std::vector<std::string> responses = exchange(socket_path, requests.str(), request_count, true);
+    server.stop();
+    loop.join();
+
+    ASSERT_EQ(responses.size(), request_count);
+    std::set<long long> seen_ids;
+
+    for (const auto &line : responses)
+    {
+        auto response = JsonValue::parse(line);
+        ASSERT_TRUE(response.has_value()) << line;
+        seen_ids.insert(*response->find("id")->asInt64());
+    }
+
+    EXPECT_EQ(seen_ids.size(), request_count);
+}
+
+/**
+ * start() replaces only a stale socket: other files and sockets with a live
+ * server behind them are left alone. The new socket is owner-only.
+ */
+TEST(SocketServerTest, StartReplacesOnlyStaleSockets)
+{
+    HomeManager home(std::make_unique<MemoryStorage>());
+    std::filesystem::path socket_path = std::filesystem::temp_directory_path() /
+                                        ("hf_test_start_" + std::to_string(::getpid()) + ".sock");
+    std::filesystem::remove(socket_path);
+
+    {
+        std::ofstream regular(socket_path);
+        regular << "not a socket";
+    }
+
+    {
+        SocketServer server(home, socket_path.string(), 1);
+        EXPECT_FALSE(server.start());
+    }
+
+    ASSERT_TRUE(std::filesystem::is_regular_file(socket_path));
+    std::filesystem::remove(socket_path);
+
+    // A socket file whose listener is gone
+    {
+        int stale_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", socket_path.c_str());
+        ASSERT_EQ(::bind(stale_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        ::close(stale_fd);
+    }
+
+    SocketServer server(home, socket_path.string(), 1);
+    ASSERT_TRUE(server.start());
+
+    struct stat status{};
+    ASSERT_EQ(::lstat(socket_path.c_str(), &status), 0);
+    EXPECT_EQ(status.st_mode & 0777, 0600u);
+
+    {
+        SocketServer second(home, socket_path.string(), 1);
+        EXPECT_FALSE(second.start());
+    }
+
+    // The live server's socket survived the refused start
+    EXPECT_TRUE(std::filesystem::is_socket(socket_path));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,12 +1,17 @@
 #include <gtest/gtest.h>
 #include "test_helpers.hpp"
 #include "storage_manager.hpp"
+#include "bank_account.hpp"
 #include "home_manager.hpp"
 #include "family.hpp"
 #include "member.hpp"
 #include <filesystem>
 #include <sqlite3.h>
+#include <atomic>
 #include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
 
 
 /**
@@ -133,8 +138,25 @@ TEST_F(StorageManagerTest, SaveAndGetFamilyData)
     // Get family by ID 1 (first inserted row)
     std::unique_ptr<Family> retrieved(storage()->getFamilyData(1));
     ASSERT_NE(retrieved, nullptr);
+    EXPECT_EQ(retrieved->getId(), 1u);
     EXPECT_EQ(retrieved->getName(), "Doe Family");
-    EXPECT_EQ(retrieved->getMembers().size(), 2);
+    ASSERT_EQ(retrieved->getMembers().size(), 2);
+
+    // Members come back with their database IDs, in ID order
+    EXPECT_EQ(retrieved->getMembers()[0].getId(), 1u);
+    EXPECT_EQ(retrieved->getMembers()[1].getId(), 2u);
+    EXPECT_EQ(retrieved->getMembers()[1].getNickname(), "Jane");
+
+    std::unique_ptr<Member> member(storage()->getMemberData(2));
+    ASSERT_NE(member, nullptr);
+    EXPECT_EQ(member->getId(), 2u);
+
+    // A family without members still loads
+    uint64_t empty_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Empty"), &empty_id), commons::Result::Ok);
+    retrieved.reset(storage()->getFamilyData(empty_id));
+    ASSERT_NE(retrieved, nullptr);
+    EXPECT_TRUE(retrieved->getMembers().empty());
 }
 
 TEST_F(StorageManagerTest, DeleteMemberData) 
@@ -364,6 +386,90 @@ TEST_F(StorageManagerTest, ExtendedAPIsDeleteOperations)
     EXPECT_EQ(getTableRowCount("MemberInfo"), 0);  // Cascade delete worked
 }
 
+TEST_F(StorageManagerTest, BatchLookupsAlignWithRequestedIds)
+{
+    // Enough members to span several IN-list chunks (families hold at most 255)
+    std::vector<uint64_t> member_ids;
+    uint64_t family_id = 0;
+
+    for (int index = 0; index < 1200; ++index)
+    {
+        if (index % 200 == 0)
+        {
+            ASSERT_EQ(storage()->saveFamilyDataEx(Family("Lookup Family"), &family_id), commons::Result::Ok);
+        }
+
+        uint64_t member_id = 0;
+        ASSERT_EQ(storage()->saveMemberDataEx(Member("Member " + std::to_string(index), "N"), family_id, &member_id), commons::Result::Ok);
+        member_ids.push_back(member_id);
+    }
+
+    std::vector<uint64_t> requested(member_ids.rbegin(), member_ids.rend());
+    requested.push_back(0);
+    requested.push_back(member_ids[7]);
+
+    std::vector<std::optional<Member>> members;
+    ASSERT_EQ(storage()->getMembersEx(requested, &members), commons::Result::Ok);
+    ASSERT_EQ(members.size(), requested.size());
+    EXPECT_EQ(members[0]->getId(), member_ids.back());
+    EXPECT_EQ(members[0]->getName(), "Member 1199");
+    EXPECT_FALSE(members[1200].has_value());
+    EXPECT_EQ(members[1201]->getId(), member_ids[7]);
+
+    std::vector<uint64_t> family_ids = {999, family_id};
+    std::vector<std::optional<Family>> families;
+    ASSERT_EQ(storage()->getFamiliesEx(family_ids, &families), commons::Result::Ok);
+    EXPECT_FALSE(families[0].has_value());
+    ASSERT_TRUE(families[1].has_value());
+    EXPECT_EQ(families[1]->getId(), family_id);
+    ASSERT_EQ(families[1]->getMembers().size(), 200u);
+    EXPECT_EQ(families[1]->getMembers().front().getId(), member_ids[1000]);
+
+    uint64_t account_id = 0;
+    ASSERT_EQ(storage()->saveBankAccountEx(1, member_ids[3], "ACC-3", 10, 20, &account_id), commons::Result::Ok);
+    std::vector<uint64_t> account_ids = {account_id, account_id + 1};
+    std::vector<std::optional<BankAccount>> accounts;
+    ASSERT_EQ(storage()->getBankAccountsEx(account_ids, &accounts), commons::Result::Ok);
+    ASSERT_TRUE(accounts[0].has_value());
+    EXPECT_EQ(accounts[0]->getMemberId(), member_ids[3]);
+    EXPECT_EQ(accounts[0]->getClosingBalancePaise(), 20);
+    EXPECT_FALSE(accounts[1].has_value());
+}
+
+TEST_F(StorageManagerTest, BatchDeleteMembersReportsEachId)
+{
+    Family family("Batch Family");
+    uint64_t family_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(family, &family_id), commons::Result::Ok);
+
+    std::vector<uint64_t> member_ids;
+
+    for (int index = 0; index < 5; ++index)
+    {
+        uint64_t member_id = 0;
+        ASSERT_EQ(storage()->saveMemberDataEx(Member("Member " + std::to_string(index)), family_id, &member_id), commons::Result::Ok);
+        member_ids.push_back(member_id);
+    }
+
+    ASSERT_EQ(storage()->saveBankAccountEx(1, member_ids[0], "ACC-1", 0, 100), commons::Result::Ok);
+
+    // Two existing members, one unknown ID and a repeat
+    std::vector<uint64_t> to_delete = {member_ids[0], 999, member_ids[2], member_ids[0]};
+    std::vector<commons::Result> results;
+    ASSERT_EQ(storage()->deleteMembersEx(to_delete, &results), commons::Result::Ok);
+
+    std::vector<commons::Result> expected = {commons::Result::Ok, commons::Result::NotFound,
+                                             commons::Result::Ok, commons::Result::NotFound};
+    EXPECT_EQ(results, expected);
+    EXPECT_EQ(getTableRowCount("MemberInfo"), 3);
+    EXPECT_EQ(getTableRowCount("BankAccounts"), 0);  // Cascade from member
+
+    // Staging table is left empty for the next batch
+    ASSERT_EQ(storage()->deleteMembersEx({member_ids[1]}, &results), commons::Result::Ok);
+    EXPECT_EQ(results, std::vector<commons::Result>{commons::Result::Ok});
+    EXPECT_EQ(getTableRowCount("MemberInfo"), 2);
+}
+
 // Storage-related small tests consolidated here (previously in test_storage_banklist_and_save_errors.cpp)
 class StorageBankListTest : public TestDbFixture
 {
@@ -416,8 +522,640 @@ TEST_F(StorageBankListTest, SaveBankAccountErrorsWhenMissingRefs)
     EXPECT_EQ(res2, commons::Result::NotFound);
 }
 
+TEST_F(StorageManagerTest, ConcurrentReadersAndWriter)
+{
+    Family family("ConcurrentFamily");
+    uint64_t family_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(family, &family_id), commons::Result::Ok);
+    storage()->setMaxReadConnections(3);
+
+    const int members_to_add = 50;
+    std::atomic<bool> reader_failed{false};
+
+    // Writer thread keeps adding members while readers list them
+    std::thread writer([&]()
+    {
+        for (int index = 0; index < members_to_add; ++index)
+        {
+            Member member("Member" + std::to_string(index));
+            EXPECT_EQ(storage()->saveMemberDataEx(member, family_id, nullptr), commons::Result::Ok);
+        }
+    });
+
+    std::vector<std::thread> readers;
+
+    for (int reader_index = 0; reader_index < 6; ++reader_index)
+    {
+        readers.emplace_back([&]()
+        {
+            std::size_t last_seen = 0;
+
+            for (int iteration = 0; iteration < 100; ++iteration)
+            {
+                auto members = storage()->listMembersOfFamily(family_id);
+
+                // Committed rows never disappear, so each snapshot is at least as large as the last
+                if (members.size() < last_seen || storage()->listFamilies().size() != 1)
+                {
+                    reader_failed = true;
+                }
+
+                last_seen = members.size();
+            }
+        });
+    }
+
+    writer.join();
+
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_FALSE(reader_failed);
+    EXPECT_EQ(storage()->getMemberCount(family_id), static_cast<uint64_t>(members_to_add));
+}
+
+/**
+ * Bootstrap records the schema version, skips migration on reopen and adopts
+ * a database created before versioning (user_version 0, tables present).
+ */
+TEST_F(StorageManagerTest, SchemaVersionRecordedAndLegacyDbAdopted)
+{
+    EXPECT_EQ(storage()->getSchemaVersion(), StorageManager::kSchemaVersion);
+    destroyStorage();
+    std::filesystem::remove(tmp_path);
+
+    // Simulate an unversioned database from an older build
+    sqlite3 *db = nullptr;
+    ASSERT_EQ(sqlite3_open(tmp_path.string().c_str(), &db), SQLITE_OK);
+    const char* legacy_sql =
+        "CREATE TABLE FamilyInfo (Family_ID INTEGER PRIMARY KEY AUTOINCREMENT, Family_Name TEXT NOT NULL);"
+        "CREATE TABLE MemberInfo (Member_ID INTEGER PRIMARY KEY AUTOINCREMENT, Family_ID INTEGER NOT NULL,"
+        " Member_Name TEXT NOT NULL, Member_Nick_Name TEXT,"
+        " FOREIGN KEY(Family_ID) REFERENCES FamilyInfo(Family_ID) ON DELETE CASCADE);"
+        "INSERT INTO FamilyInfo (Family_Name) VALUES ('Legacy');"
+        "INSERT INTO MemberInfo (Family_ID, Member_Name) VALUES (1, 'A'), (1, 'B');";
+    ASSERT_EQ(sqlite3_exec(db, legacy_sql, nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(db);
+
+    StorageManager reopened;
+    ASSERT_TRUE(reopened.initializeDatabase(tmp_path.string()));
+    EXPECT_EQ(reopened.getSchemaVersion(), StorageManager::kSchemaVersion);
+    EXPECT_EQ(reopened.listFamilies().size(), 1u);
+    EXPECT_EQ(getTableRowCount("BankList"), 5);
+
+    // Member_Count is backfilled from the existing rows
+    bool ok = false;
+    EXPECT_EQ(reopened.getMemberCount(1, &ok), 2u);
+    EXPECT_TRUE(ok);
+}
+
+/**
+ * The trigger-maintained Member_Count follows inserts, deletes and cascades,
+ * and the conditional INSERT enforces the REQ-3 cap.
+ */
+TEST_F(StorageManagerTest, MemberCountMaintainedAndCapEnforced)
+{
+    uint64_t family_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Full"), &family_id), commons::Result::Ok);
+    std::vector<uint64_t> member_ids;
+
+    for (uint64_t index = 0; index < StorageInterface::kMaxFamilyMembers; ++index)
+    {
+        uint64_t member_id = 0;
+        ASSERT_EQ(storage()->saveMemberDataEx(Member("M" + std::to_string(index)), family_id, &member_id), commons::Result::Ok);
+        member_ids.push_back(member_id);
+    }
+
+    EXPECT_EQ(storage()->getMemberCount(family_id), StorageInterface::kMaxFamilyMembers);
+    EXPECT_EQ(storage()->saveMemberDataEx(Member("Overflow"), family_id), commons::Result::MaxMembersExceeded);
+    EXPECT_EQ(storage()->saveMemberDataEx(Member("Orphan"), family_id + 1), commons::Result::NotFound);
+
+    ASSERT_EQ(storage()->deleteMemberDataEx(member_ids[0]), commons::Result::Ok);
+    ASSERT_EQ(storage()->deleteMembersEx({member_ids[1], member_ids[2]}, nullptr), commons::Result::Ok);
+    EXPECT_EQ(storage()->getMemberCount(family_id), StorageInterface::kMaxFamilyMembers - 3);
+    EXPECT_EQ(storage()->saveMemberDataEx(Member("Fits"), family_id), commons::Result::Ok);
+    EXPECT_EQ(getTableRowCount("MemberInfo"), static_cast<int>(StorageInterface::kMaxFamilyMembers - 2));
+}
+
+TEST_F(StorageManagerTest, ArenaListingsMatchOwningListings)
+{
+    uint64_t family_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("A family name long enough to need the heap"), &family_id), commons::Result::Ok);
+    uint64_t member_id = 0;
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("Asha with a long enough name", "Ash"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("Ravi"), family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(1, member_id, "ACCOUNT-NUMBER-000000000042", 10, 20), commons::Result::Ok);
+
+    std::pmr::monotonic_buffer_resource arena;
+    auto families = storage()->listFamilies(&arena);
+    auto members = storage()->listMembersOfFamily(family_id, &arena);
+    auto accounts = storage()->listBankAccountsOfMember(member_id, &arena);
+    auto owning_members = storage()->listMembersOfFamily(family_id);
+
+    ASSERT_EQ(families.size(), 1u);
+    EXPECT_EQ(families[0].id, family_id);
+    EXPECT_EQ(families[0].name, "A family name long enough to need the heap");
+    EXPECT_EQ(families[0].name.get_allocator().resource(), &arena);
+
+    ASSERT_EQ(members.size(), owning_members.size());
+
+    for (size_t index = 0; index < members.size(); ++index)
+    {
+        EXPECT_EQ(members[index].id, owning_members[index].getId());
+        EXPECT_EQ(std::string_view(members[index].name), owning_members[index].getName());
+        EXPECT_EQ(std::string_view(members[index].nickname), owning_members[index].getNickname());
+        EXPECT_EQ(members[index].name.get_allocator().resource(), &arena);
+    }
+
+    ASSERT_EQ(accounts.size(), 1u);
+    EXPECT_EQ(accounts[0].member_id, member_id);
+    EXPECT_EQ(accounts[0].account_number, "ACCOUNT-NUMBER-000000000042");
+    EXPECT_EQ(accounts[0].opening_balance_paise, 10);
+    EXPECT_EQ(accounts[0].closing_balance_paise, 20);
+    EXPECT_EQ(accounts.get_allocator().resource(), &arena);
+
+    EXPECT_TRUE(storage()->listMembersOfFamily(family_id + 1, &arena).empty());
+}
+
+TEST_F(StorageManagerTest, BalanceSnapshotsAnswerAsOfQueries)
+{
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t first_member = 0;
+    uint64_t second_member = 0;
+    uint64_t first_account = 0;
+    uint64_t second_account = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Timeline"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("One"), family_id, &first_member), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("Two"), family_id, &second_member), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(1, first_member, "A1", 0, 0, &first_account), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(1, second_member, "B1", 0, 0, &second_account), commons::Result::Ok);
+
+    ASSERT_EQ(storage()->saveBalanceSnapshotEx(first_account, 2024y / January / 1d, 2024y / January / 31d, 0, 100), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBalanceSnapshotEx(first_account, std::nullopt, 2024y / March / 31d, 100, 300), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBalanceSnapshotEx(second_account, std::nullopt, 2024y / February / 29d, 0, 50), commons::Result::Ok);
+    // Re-importing a period replaces it; an older period does not touch the account row
+    ASSERT_EQ(storage()->saveBalanceSnapshotEx(first_account, std::nullopt, 2024y / January / 31d, 0, 120), commons::Result::Ok);
+    EXPECT_EQ(storage()->saveBalanceSnapshotEx(999999, std::nullopt, 2024y / January / 31d, 0, 1), commons::Result::NotFound);
+    EXPECT_EQ(storage()->saveBalanceSnapshotEx(first_account, 2024y / May / 1d, 2024y / April / 30d, 0, 1), commons::Result::InvalidInput);
+
+    BankAccount account;
+    ASSERT_EQ(storage()->getBankAccountById(first_account, &account), commons::Result::Ok);
+    EXPECT_EQ(account.getClosingBalancePaise(), 300);
+
+    const std::vector<commons::Date> dates = {2023y / December / 31d, 2024y / January / 31d, 2024y / February / 29d, 2024y / March / 31d};
+    std::vector<long long> totals;
+    ASSERT_EQ(storage()->getNetWorthAsOfEx(NetWorthScope::Family, family_id, dates, &totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{0, 120, 170, 350}));
+    ASSERT_EQ(storage()->getNetWorthAsOfEx(NetWorthScope::Member, first_member, dates, &totals), commons::Result::Ok);
+    EXPECT_EQ(totals, (std::vector<long long>{0, 120, 120, 300}));
+    EXPECT_EQ(storage()->getNetWorthAsOfEx(NetWorthScope::Member, 999999, dates, &totals), commons::Result::NotFound);
+
+    // Deleting a member cascades to its accounts' history
+    ASSERT_EQ(storage()->deleteMemberDataEx(first_member), commons::Result::Ok);
+    EXPECT_EQ(getTableRowCount("BalanceSnapshots"), 1);
+}
+
 int main(int argc, char **argv) 
 {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
+
+TEST_F(StorageManagerTest, CashFlowRollupsTrackTransactions)
+{
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t first_member = 0;
+    uint64_t second_member = 0;
+    uint64_t first_account = 0;
+    uint64_t second_account = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Flows"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("One"), family_id, &first_member), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("Two"), family_id, &second_member), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(1, first_member, "A1", 0, 0, &first_account), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(2, second_member, "B1", 0, 0, &second_account), commons::Result::Ok);
+
+    const std::vector<BankTransaction> first_lines = {
+        {2024y / January / 5d, "Salary", 50000},
+        {2024y / January / 20d, "Rent", -20000},
+        {2024y / March / 1d, "Refund", 700},
+    };
+    const std::vector<BankTransaction> second_lines = {
+        {2024y / January / 31d, "Groceries", -3000},
+        {2024y / February / 2d, "Interest", 150},
+    };
+    ASSERT_EQ(storage()->saveTransactionsEx(first_account, first_lines), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveTransactionsEx(second_account, second_lines), commons::Result::Ok);
+    EXPECT_EQ(storage()->saveTransactionsEx(999999, first_lines), commons::Result::NotFound);
+    EXPECT_EQ(getTableRowCount("CashFlowRollups"), 4);
+
+    std::vector<CashFlowMonth> months;
+    ASSERT_EQ(storage()->getCashFlowEx(NetWorthScope::Family, family_id, 2023y / December, 2024y / March, &months), commons::Result::Ok);
+    ASSERT_EQ(months.size(), 4u);
+    EXPECT_EQ(months[0].month, 2023y / December);
+    EXPECT_EQ(months[0].credit_count + months[0].debit_count, 0u);
+    EXPECT_EQ(months[1].credit_paise, 50000);
+    EXPECT_EQ(months[1].credit_count, 1u);
+    EXPECT_EQ(months[1].debit_paise, 23000);
+    EXPECT_EQ(months[1].debit_count, 2u);
+    EXPECT_EQ(months[2].credit_paise, 150);
+    EXPECT_EQ(months[3].credit_paise, 700);
+
+    ASSERT_EQ(storage()->getCashFlowEx(NetWorthScope::Member, second_member, 2024y / January, 2024y / January, &months), commons::Result::Ok);
+    ASSERT_EQ(months.size(), 1u);
+    EXPECT_EQ(months[0].debit_paise, 3000);
+    EXPECT_EQ(storage()->getCashFlowEx(NetWorthScope::Member, 999999, 2024y / January, 2024y / January, &months), commons::Result::NotFound);
+    EXPECT_EQ(storage()->getCashFlowEx(NetWorthScope::Family, family_id, 2024y / March, 2024y / January, &months), commons::Result::InvalidInput);
+
+    uint64_t mismatched = 99;
+    ASSERT_EQ(storage()->checkCashFlowRollupsEx(&mismatched), commons::Result::Ok);
+    EXPECT_EQ(mismatched, 0u);
+
+    // Deleting a transaction unwinds its rollup; tampering is caught and repaired
+    sqlite3 *db = nullptr;
+    ASSERT_EQ(sqlite3_open(tmp_path.string().c_str(), &db), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "DELETE FROM Transactions WHERE Description = 'Refund';", nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "UPDATE CashFlowRollups SET Credit_Total = 1 WHERE Month = '2024-02';", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(db);
+
+    EXPECT_EQ(getTableRowCount("CashFlowRollups"), 3);
+    ASSERT_EQ(storage()->checkCashFlowRollupsEx(&mismatched), commons::Result::Ok);
+    EXPECT_EQ(mismatched, 2u);
+    ASSERT_EQ(storage()->rebuildCashFlowRollupsEx(), commons::Result::Ok);
+    ASSERT_EQ(storage()->checkCashFlowRollupsEx(&mismatched), commons::Result::Ok);
+    EXPECT_EQ(mismatched, 0u);
+
+    // Removing a member drops their transactions and rollups with the account
+    ASSERT_EQ(storage()->deleteMemberDataEx(first_member), commons::Result::Ok);
+    EXPECT_EQ(getTableRowCount("Transactions"), 2);
+    EXPECT_EQ(getTableRowCount("CashFlowRollups"), 2);
+    ASSERT_EQ(storage()->checkCashFlowRollupsEx(&mismatched), commons::Result::Ok);
+    EXPECT_EQ(mismatched, 0u);
+}
+
+TEST_F(StorageManagerTest, TransactionSearchMatchesNarrationAndCounterparty)
+{
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    uint64_t first_account = 0;
+    uint64_t second_account = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Search"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(1, member_id, "A1", 0, 0, &first_account), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(2, member_id, "B1", 0, 0, &second_account), commons::Result::Ok);
+
+    const std::vector<BankTransaction> first_lines = {
+        {2024y / January / 5d, "UPI/DR/4123/RAVI KUMAR/SBIN", -5000, "RAVI KUMAR"},
+        {2024y / February / 5d, "ATM WDL", -2000, ""},
+        {2024y / March / 5d, "UPI/DR/4124/Ravi Kumar/SBIN", -7000, "Ravi Kumar"},
+    };
+    const std::vector<BankTransaction> second_lines = {
+        {2024y / March / 5d, "Rent to landlord", -20000, "Ravindra"},
+    };
+    ASSERT_EQ(storage()->saveTransactionsEx(first_account, first_lines), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveTransactionsEx(second_account, second_lines), commons::Result::Ok);
+
+    // Prefix terms, case-insensitive, newest first then by account
+    std::vector<TransactionMatch> matches;
+    ASSERT_EQ(storage()->searchTransactionsEx("ravi", 10, &matches), commons::Result::Ok);
+    ASSERT_EQ(matches.size(), 3u);
+    EXPECT_EQ(matches[0].bank_account_id, first_account);
+    EXPECT_EQ(matches[0].transaction.amount_paise, -7000);
+    EXPECT_EQ(matches[1].bank_account_id, second_account);
+    EXPECT_EQ(matches[1].transaction.counterparty, "Ravindra");
+    EXPECT_EQ(matches[2].transaction.date, 2024y / January / 5d);
+    EXPECT_EQ(matches[2].member_id, member_id);
+
+    // Every word must match; FTS syntax in the input is treated as text
+    ASSERT_EQ(storage()->searchTransactionsEx("Ravi KUMAR", 10, &matches), commons::Result::Ok);
+    EXPECT_EQ(matches.size(), 2u);
+    ASSERT_EQ(storage()->searchTransactionsEx("ravi\" OR atm*", 10, &matches), commons::Result::Ok);
+    EXPECT_TRUE(matches.empty());
+    ASSERT_EQ(storage()->searchTransactionsEx("ravi", 1, &matches), commons::Result::Ok);
+    EXPECT_EQ(matches.size(), 1u);
+    ASSERT_EQ(storage()->searchTransactionsEx(" -- ", 10, &matches), commons::Result::Ok);
+    EXPECT_TRUE(matches.empty());
+
+    // Deleting the member removes their rows from the index
+    ASSERT_EQ(storage()->deleteMemberDataEx(member_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->searchTransactionsEx("ravi", 10, &matches), commons::Result::Ok);
+    EXPECT_TRUE(matches.empty());
+}
+
+/**
+ * A statement import files the account, the balance snapshot and the lines
+ * in one transaction: when a line is rejected nothing is left behind, and
+ * the retry behaves like a first import.
+ */
+TEST_F(StorageManagerTest, StatementImportIsAtomic)
+{
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Atomic"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+
+    sqlite3 *db = nullptr;
+    ASSERT_EQ(sqlite3_open(tmp_path.string().c_str(), &db), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db,
+                           "CREATE TRIGGER Reject_Poison BEFORE INSERT ON Transactions WHEN NEW.Description = 'Poison' "
+                           "BEGIN SELECT RAISE(ABORT, 'rejected'); END;",
+                           nullptr, nullptr, nullptr), SQLITE_OK);
+
+    std::vector<BankTransaction> lines = {
+        {2024y / January / 5d, "Salary", 50000},
+        {2024y / January / 9d, "Poison", -10},
+    };
+    StatementImport statement;
+    statement.bank_id = 1;
+    statement.member_id = member_id;
+    statement.account_number = "A1";
+    statement.closing_paise = 49990;
+    statement.period_end = 2024y / January / 31d;
+    statement.transactions = lines;
+
+    uint64_t account_id = 0;
+    EXPECT_EQ(storage()->importStatementEx(statement, &account_id), commons::Result::DbError);
+    EXPECT_EQ(account_id, 0u);
+    EXPECT_EQ(getTableRowCount("BankAccounts"), 0);
+    EXPECT_EQ(getTableRowCount("BalanceSnapshots"), 0);
+    EXPECT_EQ(getTableRowCount("Transactions"), 0);
+    EXPECT_EQ(getTableRowCount("CashFlowRollups"), 0);
+
+    ASSERT_EQ(sqlite3_exec(db, "DROP TRIGGER Reject_Poison;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(db);
+
+    uint64_t duplicates = 99;
+    ASSERT_EQ(storage()->importStatementEx(statement, &account_id, &duplicates), commons::Result::Ok);
+    EXPECT_NE(account_id, 0u);
+    EXPECT_EQ(duplicates, 0u);
+    EXPECT_EQ(getTableRowCount("BankAccounts"), 1);
+    EXPECT_EQ(getTableRowCount("BalanceSnapshots"), 1);
+    EXPECT_EQ(getTableRowCount("Transactions"), 2);
+
+    // Filing into the existing account only adds what is new
+    statement.bank_account_id = account_id;
+    statement.period_end = 2024y / February / 29d;
+    lines.push_back({2024y / February / 1d, "Interest", 10});
+    statement.transactions = lines;
+    uint64_t same_account = 0;
+    ASSERT_EQ(storage()->importStatementEx(statement, &same_account, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(same_account, account_id);
+    EXPECT_EQ(duplicates, 2u);
+    EXPECT_EQ(getTableRowCount("BankAccounts"), 1);
+    EXPECT_EQ(getTableRowCount("BalanceSnapshots"), 2);
+    EXPECT_EQ(getTableRowCount("Transactions"), 3);
+
+    statement.bank_account_id = 999999;
+    EXPECT_EQ(storage()->importStatementEx(statement), commons::Result::NotFound);
+    statement.bank_account_id = 0;
+    statement.account_number.clear();
+    EXPECT_EQ(storage()->importStatementEx(statement), commons::Result::InvalidInput);
+}
+
+TEST_F(StorageManagerTest, ConcurrentImportsOfNewAccountShareIt)
+{
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Race"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+
+    const std::vector<BankTransaction> lines = {
+        {2024y / January / 5d, "Salary", 50000},
+        {2024y / January / 9d, "Rent", -20000},
+    };
+    constexpr int kImports = 8;
+    std::vector<uint64_t> account_ids(kImports);
+    std::vector<uint64_t> duplicates(kImports);
+    std::vector<commons::Result> results(kImports, commons::Result::DbError);
+    std::vector<std::thread> threads;
+
+    for (int index = 0; index < kImports; ++index)
+    {
+        threads.emplace_back([&, index]()
+        {
+            StatementImport statement;
+            statement.bank_id = 1;
+            statement.member_id = member_id;
+            statement.account_number = index % 2 == 0 ? "5000 1245" : "5000-1245";
+            statement.closing_paise = 30000;
+            statement.transactions = lines;
+            results[index] = storage()->importStatementEx(statement, &account_ids[index], &duplicates[index]);
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    uint64_t total_duplicates = 0;
+
+    for (int index = 0; index < kImports; ++index)
+    {
+        EXPECT_EQ(results[index], commons::Result::Ok);
+        EXPECT_EQ(account_ids[index], account_ids[0]);
+        total_duplicates += duplicates[index];
+    }
+
+    EXPECT_EQ(total_duplicates, (kImports - 1) * lines.size());
+    EXPECT_EQ(getTableRowCount("BankAccounts"), 1);
+    EXPECT_EQ(getTableRowCount("Transactions"), 2);
+}
+
+/**
+ * Re-importing lines from an overlapping statement skips the ones already
+ * stored, while genuine identical lines within one statement are all kept;
+ * rows from before fingerprinting are backfilled on upgrade.
+ */
+TEST_F(StorageManagerTest, OverlappingStatementsSkipDuplicateTransactions)
+{
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    uint64_t account_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Dedup"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(1, member_id, "A1", 0, 0, &account_id), commons::Result::Ok);
+
+    const std::vector<BankTransaction> quarter = {
+        {2024y / January / 5d, "Salary", 50000, "", 50000},
+        {2024y / February / 3d, "Tea stall", -20, "", 49980},
+        {2024y / February / 3d, "Tea stall", -20, "", 49960},
+        {2024y / March / 1d, "Rent", -20000, "", 29960},
+    };
+    const std::vector<BankTransaction> march_and_april = {
+        {2024y / March / 1d, "Rent", -20000, "", 29960},
+        {2024y / April / 2d, "Interest", 150, "", 30110},
+    };
+
+    uint64_t duplicates = 99;
+    ASSERT_EQ(storage()->saveTransactionsEx(account_id, quarter, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 0u);
+    ASSERT_EQ(storage()->saveTransactionsEx(account_id, march_and_april, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 1u);
+    ASSERT_EQ(storage()->saveTransactionsEx(account_id, quarter, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 4u);
+    EXPECT_EQ(getTableRowCount("Transactions"), 5);
+
+    std::vector<CashFlowMonth> months;
+    ASSERT_EQ(storage()->getCashFlowEx(NetWorthScope::Member, member_id, 2024y / February, 2024y / March, &months), commons::Result::Ok);
+    ASSERT_EQ(months.size(), 2u);
+    EXPECT_EQ(months[0].debit_count, 2u);
+    EXPECT_EQ(months[1].debit_paise, 20000);
+
+    std::vector<TransactionMatch> matches;
+    ASSERT_EQ(storage()->searchTransactionsEx("rent", 10, &matches), commons::Result::Ok);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].transaction.balance_after_paise, 29960);
+
+    // The same lines in another account are not duplicates
+    uint64_t other_account = 0;
+    ASSERT_EQ(storage()->saveBankAccountEx(2, member_id, "B1", 0, 0, &other_account), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveTransactionsEx(other_account, quarter, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 0u);
+
+    // Downgrade to a version 5 file holding an unfingerprinted double import
+    destroyStorage();
+    sqlite3 *db = nullptr;
+    ASSERT_EQ(sqlite3_open(tmp_path.string().c_str(), &db), SQLITE_OK);
+    const std::string downgrade_sql =
+        "DROP TABLE CategoryRules; DROP TABLE Categories; DROP TABLE CategoryRuleVersion;"
+        "DROP INDEX Transactions_Rules_Version;"
+        "ALTER TABLE Transactions DROP COLUMN Rules_Version;"
+        "ALTER TABLE Transactions DROP COLUMN Category_ID;"
+        "DROP INDEX Transactions_Account_Fingerprint;"
+        "ALTER TABLE Transactions DROP COLUMN Fingerprint;"
+        "ALTER TABLE Transactions DROP COLUMN Balance_After;"
+        "INSERT INTO Transactions (BankAccount_ID, Txn_Date, Description, Amount) VALUES (" +
+        std::to_string(other_account) + ", '2024-01-05', 'Salary', 50000);"
+        "PRAGMA user_version = 5;";
+    ASSERT_EQ(sqlite3_exec(db, downgrade_sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(db);
+
+    StorageManager reopened;
+    ASSERT_TRUE(reopened.initializeDatabase(tmp_path.string()));
+    EXPECT_EQ(reopened.getSchemaVersion(), StorageManager::kSchemaVersion);
+    EXPECT_EQ(getTableRowCount("Transactions WHERE Fingerprint IS NULL"), 0);
+
+    const std::vector<BankTransaction> legacy_lines = {
+        {2024y / January / 5d, "Salary", 50000},
+        {2024y / January / 5d, "Salary", 50000},
+        {2024y / January / 5d, "Salary", 50000},
+    };
+    // The account's history now holds Salary twice (occurrences 0 and 1)
+    ASSERT_EQ(reopened.saveTransactionsEx(other_account, legacy_lines, &duplicates), commons::Result::Ok);
+    EXPECT_EQ(duplicates, 2u);
+    EXPECT_EQ(getTableRowCount("Transactions"), 11);
+}
+
+/**
+ * Lines are categorised on import; a rule change only affects existing
+ * rows once recategorisation runs, and that job only visits stale rows.
+ */
+TEST_F(StorageManagerTest, CategoryRulesApplyOnImportAndRecategorizeIncrementally)
+{
+    using namespace std::chrono;
+    uint64_t family_id = 0;
+    uint64_t member_id = 0;
+    uint64_t account_id = 0;
+    ASSERT_EQ(storage()->saveFamilyDataEx(Family("Tags"), &family_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveMemberDataEx(Member("One"), family_id, &member_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveBankAccountEx(1, member_id, "A1", 0, 0, &account_id), commons::Result::Ok);
+
+    std::vector<TransactionCategory> categories;
+    ASSERT_EQ(storage()->listCategoriesEx(&categories), commons::Result::Ok);
+    ASSERT_EQ(categories.size(), 4u);
+    EXPECT_EQ(categories[0].name, "Salary");
+
+    const std::vector<BankTransaction> lines = {
+        {2024y / January / 1d, "NEFT/ACME LTD/SALARY JAN", 50000},
+        {2024y / January / 3d, "UPI/DR/HOUSE RENT", -20000},
+        {2024y / January / 9d, "BESCOM BILL PAY", -1500},
+    };
+    ASSERT_EQ(storage()->saveTransactionsEx(account_id, lines), commons::Result::Ok);
+
+    auto categoryOf = [&](const std::string& text)
+    {
+        std::vector<TransactionMatch> matches;
+        EXPECT_EQ(storage()->searchTransactionsEx(text, 1, &matches), commons::Result::Ok);
+        return matches.empty() ? ~uint64_t{0} : matches[0].transaction.category_id;
+    };
+
+    EXPECT_EQ(categoryOf("salary"), 1u);
+    EXPECT_EQ(categoryOf("rent"), 2u);
+    EXPECT_EQ(categoryOf("bescom"), 0u);
+
+    uint64_t rule_id = 0;
+    EXPECT_EQ(storage()->saveCategoryRuleEx(" - ", "bescom", 0, &rule_id), commons::Result::InvalidInput);
+    ASSERT_EQ(storage()->saveCategoryRuleEx("Electricity", "bescom", 0, &rule_id), commons::Result::Ok);
+    ASSERT_EQ(storage()->saveCategoryRuleEx("ELECTRICITY", "power bill", 0), commons::Result::Ok);
+    ASSERT_EQ(storage()->listCategoriesEx(&categories), commons::Result::Ok);
+    ASSERT_EQ(categories.size(), 5u);
+    const uint64_t electricity = categories.back().id;
+    EXPECT_EQ(categoryOf("bescom"), 0u);
+
+    // Two batches of two: every stale row is visited exactly once
+    uint64_t changed = 99;
+    ASSERT_EQ(storage()->recategorizeTransactionsEx(2, &changed), commons::Result::Ok);
+    EXPECT_EQ(changed, 1u);
+    EXPECT_EQ(categoryOf("bescom"), electricity);
+    EXPECT_EQ(getTableRowCount("Transactions WHERE Rules_Version < (SELECT Version FROM CategoryRuleVersion)"), 0);
+    ASSERT_EQ(storage()->recategorizeTransactionsEx(2, &changed), commons::Result::Ok);
+    EXPECT_EQ(changed, 0u);
+    EXPECT_EQ(storage()->recategorizeTransactionsEx(0, &changed), commons::Result::InvalidInput);
+
+    // Removing the rent rule uncategorises its row on the next run
+    std::vector<CategoryRule> rules;
+    ASSERT_EQ(storage()->listCategoryRulesEx(&rules), commons::Result::Ok);
+    ASSERT_EQ(rules.size(), 9u);
+    EXPECT_EQ(rules[1].keyword, "rent");
+    ASSERT_EQ(storage()->deleteCategoryRuleEx(rules[1].rule_id), commons::Result::Ok);
+    EXPECT_EQ(storage()->deleteCategoryRuleEx(rules[1].rule_id), commons::Result::NotFound);
+    ASSERT_EQ(storage()->recategorizeTransactionsEx(100, &changed), commons::Result::Ok);
+    EXPECT_EQ(changed, 1u);
+    EXPECT_EQ(categoryOf("rent"), 0u);
+    EXPECT_EQ(categoryOf("salary"), 1u);
+}
+
+TEST_F(StorageManagerTest, CategoryRuleBatchSkipsExistingKeywords)
+{
+    const std::vector<std::string> names = {"salary", "Fuel", "Fuel", "Fuel"};
+    const std::vector<CategoryRule> batch = {
+        {0, 0, "SALARY", 0},
+        {0, 0, "petrol pump", 1},
+        {0, 0, "Petrol-Pump", 3},
+        {0, 0, "diesel", 0},
+    };
+
+    uint64_t added = 99;
+    EXPECT_EQ(storage()->saveCategoryRulesEx(std::span(names).first(3), batch, &added), commons::Result::InvalidInput);
+    ASSERT_EQ(storage()->saveCategoryRulesEx(names, batch, &added), commons::Result::Ok);
+    EXPECT_EQ(added, 2u);
+    EXPECT_EQ(getTableRowCount("CategoryRules"), 9);
+    EXPECT_EQ(getTableRowCount("CategoryRules WHERE Keyword = 'petrol pump' AND Priority = 3"), 1);
+
+    // Loading the same rules again changes nothing, not even the rule version
+    sqlite3* db = nullptr;
+    ASSERT_EQ(sqlite3_open(tmp_path.string().c_str(), &db), SQLITE_OK);
+    auto ruleVersion = [&]()
+    {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db, "SELECT Version FROM CategoryRuleVersion;", -1, &stmt, nullptr);
+        sqlite3_step(stmt);
+        sqlite3_int64 version = sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+        return version;
+    };
+    const sqlite3_int64 version = ruleVersion();
+    ASSERT_EQ(storage()->saveCategoryRulesEx(names, batch, &added), commons::Result::Ok);
+    EXPECT_EQ(added, 0u);
+    EXPECT_EQ(getTableRowCount("CategoryRules"), 9);
+    EXPECT_EQ(ruleVersion(), version);
+    sqlite3_close(db);
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include "tui_manager.hpp"
 #include "mock_io.hpp"
+#include "terminal_io.hpp"
+#include <iostream>
 #include <memory>
+#include <sstream>
 
 class TUIManagerTest : public ::testing::Test 
 {
@@ -955,3 +958,75 @@ TEST_F(TUIManagerTest, ListMembersOfFamily_InvalidId)
     }
     EXPECT_TRUE(found_error);
 }
+
+TEST_F(TUIManagerTest, HouseholdNetWorthReport_ListsAddedFamily) 
+{
+    // Add a family so the report has at least one entry
+    simulateMenuChoice("1", {"ReportFamily"});
+    tui->run();
+
+    mock_io_ptr->clear();
+    simulateMenuChoice(std::to_string(static_cast<int>(TUIManager::MenuOption::HouseholdNetWorthReport)));
+    tui->run();
+
+    const auto& output = mock_io_ptr->getOutput();
+    bool found_header = false;
+    bool found_total = false;
+
+    for (const auto& line : output) 
+    {
+        if (line.find("Household net worth report:") != std::string::npos) 
+        {
+            found_header = true;
+        }
+
+        if (line.find("Household total: ") != std::string::npos) 
+        {
+            found_total = true;
+        }
+    }
+    EXPECT_TRUE(found_header);
+    EXPECT_TRUE(found_total);
+}
+
+TEST_F(TUIManagerTest, SearchTransactions_NoMatches)
+{
+    simulateMenuChoice(std::to_string(static_cast<int>(TUIManager::MenuOption::SearchTransactions)), {"zzqxv nonexistent payee"});
+
+    tui->run();
+
+    const auto& output = mock_io_ptr->getOutput();
+    bool found_prompt = false;
+    bool found_empty = false;
+    for (const auto& line : output)
+    {
+        found_prompt = found_prompt || line.find("Enter words to search for") != std::string::npos;
+        found_empty = found_empty || line.find("No matching transactions.") != std::string::npos;
+    }
+    EXPECT_TRUE(found_prompt);
+    EXPECT_TRUE(found_empty);
+}
+
+// Buffered TerminalIO holds output until an explicit flush point
+TEST(TerminalIOTest, BufferedOutputWaitsForFlush)
+{
+    std::ostringstream captured;
+    std::streambuf* original = std::cout.rdbuf(captured.rdbuf());
+
+    {
+        TerminalIO io(TerminalIO::OutputMode::Buffered);
+        io.printLine("first");
+        const std::string block[] = {"second", "third"};
+        io.printLines(block);
+        EXPECT_TRUE(captured.str().empty());
+
+        io.flush();
+        EXPECT_EQ(captured.str(), "first\nsecond\nthird\n");
+
+        // Pending output is written when the object goes away
+        io.printLine("last");
+    }
+
+    std::cout.rdbuf(original);
+    EXPECT_EQ(captured.str(), "first\nsecond\nthird\nlast\n");
+}